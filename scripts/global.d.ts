@@ -783,15 +783,114 @@ declare class selection {
      * Creates and returns an iterator for all chunks inside this selection
      */
     chunks(): chunk[];
-    
+
+    /**
+     * Returns the heights of all vertices inside this selection,
+     * in the same order as verts().
+     */
+    get_heights(): number[];
+
+    /**
+     * Sets the heights of all vertices inside this selection.
+     * @param heights - one value per vertex, in the same order as verts()
+     */
+    set_heights(heights: number[]): void;
+
+    /**
+     * Adds an offset to the heights of all vertices inside this selection.
+     * @param offsets - one value per vertex, in the same order as verts()
+     */
+    add_heights(offsets: number[]): void;
+
+    /**
+     * Returns the vertex colors inside this selection as consecutive
+     * r, g, b values, in the same order as verts().
+     */
+    get_colors(): number[];
+
+    /**
+     * Sets the vertex colors inside this selection.
+     * @param colors - consecutive r, g, b values, in the same order as verts()
+     */
+    set_colors(colors: number[]): void;
+
+    /**
+     * Returns the alpha of a texture layer around all vertices inside
+     * this selection, in the same order as verts().
+     * @param layer - texture layer, between 0-3
+     */
+    get_alphas(layer: number): number[];
+
+    /**
+     * Sets the alpha of a texture layer around all vertices inside
+     * this selection.
+     * @param layer - texture layer, between 0-3
+     * @param alphas - one value per vertex, in the same order as verts()
+     */
+    set_alphas(layer: number, alphas: number[]): void;
+
+    /**
+     * Sets the height of all vertices inside this selection to the
+     * noise value at their position multiplied by amplitude.
+     * @param noise
+     * @param amplitude
+     */
+    set_heights_from_noise(noise: noisemap, amplitude: number): void;
+
+    /**
+     * Adds the noise value at their position multiplied by amplitude
+     * to the height of all vertices inside this selection.
+     * @param noise
+     * @param amplitude
+     */
+    add_heights_from_noise(noise: noisemap, amplitude: number): void;
+
+    /**
+     * Runs a chunk kernel for every chunk inside this selection, spread
+     * over all cores. The kernel is lua source code that runs in its own
+     * restricted lua state: it cannot see the globals, functions or
+     * objects of the calling script, only the math functions, vector_3d,
+     * random and these globals:
+     *
+     * - chunk: the kernel_chunk being processed
+     * - rand: a random generator seeded from 'seed' and the chunk position,
+     *         so the result is the same no matter how chunks are scheduled
+     * - params: a copy of the params table
+     *
+     * @param source - lua source code of the kernel
+     * @param seed
+     * @param params - a table of numbers, booleans and strings
+     */
+    run_kernel(source: string, seed: string, params?: any): void;
+
     /**
      * Applies all changes made inside this selection. 
      * You almost always want to call this function when you're done
      * with a selection.
+     * 
+     * @note If only the bulk functions (get_heights, set_heights, ...)
+     * were used on this selection, only the chunks they changed are applied.
      */
     apply(): void;
 }
 
+/**
+ * The chunk a kernel started by selection.run_kernel works on.
+ * Only the vertices inside the selection are visible, addressed
+ * from 0 to count() - 1.
+ */
+declare class kernel_chunk {
+    count(): number;
+    get_x(index: number): number;
+    get_z(index: number): number;
+    get_height(index: number): number;
+    set_height(index: number, height: number): void;
+    get_color(index: number): vector_3d;
+    set_color(index: number, r: number, g: number, b: number): void;
+    get_alpha(index: number, layer: number): number;
+    set_alpha(index: number, layer: number, alpha: number): void;
+}
+
 /**
  * Makes and returns a rectangular selection between two points.
  * @param point1 
@@ -0,0 +1,24 @@
+-- This file is part of Noggit3, licensed under GNU General Public License (version 3).
+local jitter_brush = brush("Height Jitter")
+
+local seed = jitter_brush:add_string_tag("Seed","noggit")
+local amplitude = jitter_brush:add_real_tag("Amplitude",0.0,100.0,2.0,2)
+
+-- runs on worker threads, one chunk at a time: only 'chunk', 'rand',
+-- 'params' and the math functions are visible in here.
+local kernel = [[
+    local amplitude = params.amplitude
+    for i = 0, chunk:count() - 1 do
+        chunk:set_height(i, chunk:get_height(i) + rand:real(-amplitude, amplitude))
+    end
+]]
+
+function jitter_brush:on_left_click(evt)
+    local sel = select_origin(
+        evt:pos(),
+        evt:outer_radius(),
+        evt:outer_radius()
+    )
+    sel:run_kernel(kernel, seed:get(), { amplitude = amplitude:get() })
+    sel:apply()
+end
@@ -17,11 +17,6 @@ function noise_brush:on_left_hold(evt)
         algo:get(),
         seed:get()
     )
-    for i,vert in pairs(sel:verts()) do
-        local height = map:get(
-            vert:get_pos()
-        ) * amplitude:get()
-        vert:set_height(height)
-    end
+    sel:set_heights_from_noise(map, amplitude:get())
     sel:apply()
 end
\ No newline at end of file
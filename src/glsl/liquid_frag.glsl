@@ -1,7 +1,7 @@
 // This file is part of Noggit3, licensed under GNU General Public License (version 3).
 #version 330 core
 
-uniform sampler2D tex;
+uniform sampler2DArray tex;
 uniform vec4 ocean_color_light;
 uniform vec4 ocean_color_dark;
 uniform vec4 river_color_light;
@@ -10,6 +10,7 @@ uniform vec4 river_color_dark;
 uniform int type;
 uniform float animtime;
 uniform vec2 param;
+uniform int frame_count;
 
 in float depth_;
 in vec2 tex_coord_;
@@ -24,15 +25,18 @@ vec2 rot2(vec2 p, float degree)
 
 void main()
 {
+  // animtime is the time in ms / 2880, frames change every 60ms
+  float frame = float(int(animtime * 48.0) % frame_count);
+
   // lava || slime
   if(type == 2 || type == 3)
   {
-    out_color = texture(tex, tex_coord_ + vec2(param.x*animtime, param.y*animtime));
+    out_color = texture(tex, vec3(tex_coord_ + vec2(param.x*animtime, param.y*animtime), frame));
   }
   else
   {
     vec2 uv = rot2(tex_coord_ * param.x, param.y);
-    vec4 texel = texture(tex, uv);
+    vec4 texel = texture(tex, vec3(uv, frame));
     vec4 lerp = (type == 1)
               ? mix (ocean_color_light, ocean_color_dark, depth_) 
               : mix (river_color_light, river_color_dark, depth_)
@@ -1,7 +1,9 @@
 // This file is part of Noggit3, licensed under GNU General Public License (version 3).
 
 #include <math/frustum.hpp>
+#include <math/simd.hpp>
 
+#include <cmath>
 #include <vector>
 
 namespace math
@@ -19,6 +21,15 @@ namespace math
     _planes[BOTTOM] = column_3 + column_1;
     _planes[BACK] = column_3 - column_2;
     _planes[FRONT] = column_3 + column_2;
+
+    for (std::size_t i (0); i < 8; ++i)
+    {
+      bool const padding (i >= SIDES_MAX);
+      _plane_x[i] = padding ? 0.f : _planes[i].normal().x;
+      _plane_y[i] = padding ? 0.f : _planes[i].normal().y;
+      _plane_z[i] = padding ? 0.f : _planes[i].normal().z;
+      _plane_d[i] = padding ? 1.f : _planes[i].distance();
+    }
   }
 
   bool frustum::contains (const vector_3d& point) const
@@ -58,20 +69,12 @@ namespace math
                            , const vector_3d& v2
                            ) const
   {
-    std::vector<vector_3d> points;
-    points.emplace_back (v1.x, v1.y, v1.z);
-    points.emplace_back (v1.x, v1.y, v2.z);
-    points.emplace_back (v1.x, v2.y, v1.z);
-    points.emplace_back (v1.x, v2.y, v2.z);
-    points.emplace_back (v2.x, v1.y, v1.z);
-    points.emplace_back (v2.x, v1.y, v2.z);
-    points.emplace_back (v2.x, v2.y, v1.z);
-    points.emplace_back (v2.x, v2.y, v2.z);
-
-    return intersects (points);
+    std::array<vector_3d, 2> const box {v1, v2};
+    bool result;
+    intersects (&box, 1, &result);
+    return result;
   }
 
-
   bool frustum::intersectsSphere ( const vector_3d& position
                                  , const float& radius
                                  ) const
@@ -92,4 +95,150 @@ namespace math
     }
     return true;
   }
+
+#ifdef NOGGIT_MATH_SSE
+  // A box is outside a plane when even its corner furthest along the
+  // normal is behind it, i.e. when n * center + d + |n| * half_size <= 0.
+  // Each box is tested against all 8 (padded) planes in two registers.
+  void frustum::intersects ( std::array<vector_3d, 2> const* boxes
+                           , std::size_t count
+                           , bool* results
+                           ) const
+  {
+    __m128 const abs_mask (_mm_castsi128_ps (_mm_set1_epi32 (0x7fffffff)));
+    __m128 const zero (_mm_setzero_ps());
+    __m128 const half (_mm_set1_ps (0.5f));
+
+    __m128 const x[2] = {_mm_loadu_ps (_plane_x), _mm_loadu_ps (_plane_x + 4)};
+    __m128 const y[2] = {_mm_loadu_ps (_plane_y), _mm_loadu_ps (_plane_y + 4)};
+    __m128 const z[2] = {_mm_loadu_ps (_plane_z), _mm_loadu_ps (_plane_z + 4)};
+    __m128 const d[2] = {_mm_loadu_ps (_plane_d), _mm_loadu_ps (_plane_d + 4)};
+    __m128 const abs_x[2] = {_mm_and_ps (x[0], abs_mask), _mm_and_ps (x[1], abs_mask)};
+    __m128 const abs_y[2] = {_mm_and_ps (y[0], abs_mask), _mm_and_ps (y[1], abs_mask)};
+    __m128 const abs_z[2] = {_mm_and_ps (z[0], abs_mask), _mm_and_ps (z[1], abs_mask)};
+
+    for (std::size_t i (0); i < count; ++i)
+    {
+      vector_3d const& min (boxes[i][0]);
+      vector_3d const& max (boxes[i][1]);
+
+      __m128 const center_x (_mm_mul_ps (_mm_add_ps (_mm_set1_ps (min.x), _mm_set1_ps (max.x)), half));
+      __m128 const center_y (_mm_mul_ps (_mm_add_ps (_mm_set1_ps (min.y), _mm_set1_ps (max.y)), half));
+      __m128 const center_z (_mm_mul_ps (_mm_add_ps (_mm_set1_ps (min.z), _mm_set1_ps (max.z)), half));
+      __m128 const extent_x (_mm_mul_ps (_mm_sub_ps (_mm_set1_ps (max.x), _mm_set1_ps (min.x)), half));
+      __m128 const extent_y (_mm_mul_ps (_mm_sub_ps (_mm_set1_ps (max.y), _mm_set1_ps (min.y)), half));
+      __m128 const extent_z (_mm_mul_ps (_mm_sub_ps (_mm_set1_ps (max.z), _mm_set1_ps (min.z)), half));
+
+      int outside (0);
+
+      for (std::size_t p (0); p < 2; ++p)
+      {
+        __m128 distance (_mm_mul_ps (x[p], center_x));
+        distance = _mm_add_ps (distance, _mm_mul_ps (y[p], center_y));
+        distance = _mm_add_ps (distance, _mm_mul_ps (z[p], center_z));
+        distance = _mm_add_ps (distance, d[p]);
+
+        __m128 radius (_mm_mul_ps (abs_x[p], extent_x));
+        radius = _mm_add_ps (radius, _mm_mul_ps (abs_y[p], extent_y));
+        radius = _mm_add_ps (radius, _mm_mul_ps (abs_z[p], extent_z));
+
+        outside |= _mm_movemask_ps (_mm_cmple_ps (_mm_add_ps (distance, radius), zero));
+      }
+
+      results[i] = !outside;
+    }
+  }
+
+  void frustum::intersects_spheres ( vector_4d const* spheres
+                                   , std::size_t count
+                                   , bool* results
+                                   ) const
+  {
+    __m128 const x[2] = {_mm_loadu_ps (_plane_x), _mm_loadu_ps (_plane_x + 4)};
+    __m128 const y[2] = {_mm_loadu_ps (_plane_y), _mm_loadu_ps (_plane_y + 4)};
+    __m128 const z[2] = {_mm_loadu_ps (_plane_z), _mm_loadu_ps (_plane_z + 4)};
+    __m128 const d[2] = {_mm_loadu_ps (_plane_d), _mm_loadu_ps (_plane_d + 4)};
+
+    for (std::size_t i (0); i < count; ++i)
+    {
+      __m128 const center_x (_mm_set1_ps (spheres[i].x));
+      __m128 const center_y (_mm_set1_ps (spheres[i].y));
+      __m128 const center_z (_mm_set1_ps (spheres[i].z));
+      __m128 const negative_radius (_mm_set1_ps (-spheres[i].w));
+
+      int outside (0);
+
+      for (std::size_t p (0); p < 2; ++p)
+      {
+        __m128 distance (_mm_mul_ps (x[p], center_x));
+        distance = _mm_add_ps (distance, _mm_mul_ps (y[p], center_y));
+        distance = _mm_add_ps (distance, _mm_mul_ps (z[p], center_z));
+        distance = _mm_add_ps (distance, d[p]);
+
+        outside |= _mm_movemask_ps (_mm_cmplt_ps (distance, negative_radius));
+      }
+
+      results[i] = !outside;
+    }
+  }
+#else
+  void frustum::intersects ( std::array<vector_3d, 2> const* boxes
+                           , std::size_t count
+                           , bool* results
+                           ) const
+  {
+    for (std::size_t i (0); i < count; ++i)
+    {
+      vector_3d const& min (boxes[i][0]);
+      vector_3d const& max (boxes[i][1]);
+
+      results[i] = true;
+
+      for (std::size_t p (0); p < SIDES_MAX; ++p)
+      {
+        float const distance ( _plane_x[p] * ((min.x + max.x) * 0.5f)
+                             + _plane_y[p] * ((min.y + max.y) * 0.5f)
+                             + _plane_z[p] * ((min.z + max.z) * 0.5f)
+                             + _plane_d[p]
+                             );
+        float const radius ( std::abs (_plane_x[p]) * ((max.x - min.x) * 0.5f)
+                           + std::abs (_plane_y[p]) * ((max.y - min.y) * 0.5f)
+                           + std::abs (_plane_z[p]) * ((max.z - min.z) * 0.5f)
+                           );
+
+        if (distance + radius <= 0.f)
+        {
+          results[i] = false;
+          break;
+        }
+      }
+    }
+  }
+
+  void frustum::intersects_spheres ( vector_4d const* spheres
+                                   , std::size_t count
+                                   , bool* results
+                                   ) const
+  {
+    for (std::size_t i (0); i < count; ++i)
+    {
+      results[i] = true;
+
+      for (std::size_t p (0); p < SIDES_MAX; ++p)
+      {
+        float const distance ( _plane_x[p] * spheres[i].x
+                             + _plane_y[p] * spheres[i].y
+                             + _plane_z[p] * spheres[i].z
+                             + _plane_d[p]
+                             );
+
+        if (distance < -spheres[i].w)
+        {
+          results[i] = false;
+          break;
+        }
+      }
+    }
+  }
+#endif
 }
@@ -58,6 +58,13 @@ namespace math
     };
     std::array<plane, SIDES_MAX> _planes;
 
+    //! the planes again as structure of arrays for the batched tests,
+    //! padded to 8 with planes nothing can be outside of
+    float _plane_x[8];
+    float _plane_y[8];
+    float _plane_z[8];
+    float _plane_d[8];
+
   public:
     frustum (matrix_4x4 const& matrix);
 
@@ -69,5 +76,19 @@ namespace math
     bool intersectsSphere ( const vector_3d& position
                           , const float& radius
                           ) const;
+
+    //! Batched intersects (min, max): results[i] is false when boxes[i] is
+    //! fully behind one of the planes.
+    void intersects ( std::array<vector_3d, 2> const* boxes
+                    , std::size_t count
+                    , bool* results
+                    ) const;
+    //! Batched sphere test, spheres given as (center, radius). Unlike
+    //! intersectsSphere() this checks every plane, so results[i] is false
+    //! whenever the sphere is fully behind any of them.
+    void intersects_spheres ( vector_4d const* spheres
+                            , std::size_t count
+                            , bool* results
+                            ) const;
   };
 }
@@ -2,6 +2,7 @@
 
 #include <math/matrix_4x4.hpp>
 #include <math/quaternion.hpp>
+#include <math/simd.hpp>
 #include <math/vector_3d.hpp>
 
 #include <cmath>
@@ -96,6 +97,92 @@ namespace math
     *this *= rotate_axis<z>(angle.z);
   }
 
+#ifdef NOGGIT_MATH_SSE
+  namespace
+  {
+    struct sse_columns
+    {
+      sse_columns (matrix_4x4 const& mat)
+        : c0 (_mm_loadu_ps (mat._m[0]))
+        , c1 (_mm_loadu_ps (mat._m[1]))
+        , c2 (_mm_loadu_ps (mat._m[2]))
+        , c3 (_mm_loadu_ps (mat._m[3]))
+      {
+        _MM_TRANSPOSE4_PS (c0, c1, c2, c3);
+      }
+
+      //! same summation order as the scalar code: m[j][0] * x + ... + m[j][3] * w
+      __m128 multiply (float x, float y, float z, float w) const
+      {
+        __m128 result (_mm_mul_ps (c0, _mm_set1_ps (x)));
+        result = _mm_add_ps (result, _mm_mul_ps (c1, _mm_set1_ps (y)));
+        result = _mm_add_ps (result, _mm_mul_ps (c2, _mm_set1_ps (z)));
+        return _mm_add_ps (result, _mm_mul_ps (c3, _mm_set1_ps (w)));
+      }
+      __m128 multiply_point (vector_3d const& v) const
+      {
+        __m128 result (_mm_mul_ps (c0, _mm_set1_ps (v.x)));
+        result = _mm_add_ps (result, _mm_mul_ps (c1, _mm_set1_ps (v.y)));
+        result = _mm_add_ps (result, _mm_mul_ps (c2, _mm_set1_ps (v.z)));
+        return _mm_add_ps (result, c3);
+      }
+
+      __m128 c0, c1, c2, c3;
+    };
+
+    vector_3d to_vector_3d (__m128 v)
+    {
+      alignas (16) float data[4];
+      _mm_store_ps (data, v);
+      return {data[0], data[1], data[2]};
+    }
+  }
+
+  vector_3d matrix_4x4::operator* (vector_3d const& v) const
+  {
+    return to_vector_3d (sse_columns (*this).multiply_point (v));
+  }
+  vector_4d matrix_4x4::operator* (const vector_4d& v) const
+  {
+    vector_4d result;
+    _mm_storeu_ps (result._data, sse_columns (*this).multiply (v.x, v.y, v.z, v.w));
+    return result;
+  }
+
+  matrix_4x4 matrix_4x4::operator* (matrix_4x4 const& other) const
+  {
+    __m128 const r0 (_mm_loadu_ps (other._m[0]));
+    __m128 const r1 (_mm_loadu_ps (other._m[1]));
+    __m128 const r2 (_mm_loadu_ps (other._m[2]));
+    __m128 const r3 (_mm_loadu_ps (other._m[3]));
+
+    matrix_4x4 result (uninitialized);
+
+    for (std::size_t j (0); j < 4; ++j)
+    {
+      __m128 row (_mm_mul_ps (_mm_set1_ps (_m[j][0]), r0));
+      row = _mm_add_ps (row, _mm_mul_ps (_mm_set1_ps (_m[j][1]), r1));
+      row = _mm_add_ps (row, _mm_mul_ps (_mm_set1_ps (_m[j][2]), r2));
+      row = _mm_add_ps (row, _mm_mul_ps (_mm_set1_ps (_m[j][3]), r3));
+      _mm_storeu_ps (result._m[j], row);
+    }
+
+    return result;
+  }
+
+  std::vector<math::vector_3d> matrix_4x4::operator*
+    (std::vector<math::vector_3d> points) const
+  {
+    sse_columns const columns (*this);
+
+    for (auto& point : points)
+    {
+      point = to_vector_3d (columns.multiply_point (point));
+    }
+
+    return points;
+  }
+#else
   vector_3d matrix_4x4::operator* (vector_3d const& v) const
   {
     return { _m[0][0] * v[0] + _m[0][1] * v[1] + _m[0][2] * v[2] + _m[0][3]
@@ -143,6 +230,7 @@ namespace math
                  , points
                  );
   }
+#endif
 
   namespace
   {
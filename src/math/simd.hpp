@@ -0,0 +1,12 @@
+// This file is part of Noggit3, licensed under GNU General Public License (version 3).
+
+#pragma once
+
+//! SSE2 is part of every x86-64 target, so the vectorised paths need no
+//! additional compiler flags there. Everything else uses the scalar code.
+//! Define NOGGIT_MATH_NO_SIMD to force the scalar code, e.g. for comparisons.
+#if !defined (NOGGIT_MATH_NO_SIMD) \
+  && (defined (__SSE2__) || defined (_M_X64) || (defined (_M_IX86_FP) && _M_IX86_FP >= 2))
+  #define NOGGIT_MATH_SSE 1
+  #include <emmintrin.h>
+#endif
@@ -0,0 +1,247 @@
+// This file is part of Noggit3, licensed under GNU General Public License (version 3).
+
+#include <math/triangle_bvh.hpp>
+
+#include <algorithm>
+#include <array>
+#include <limits>
+#include <numeric>
+#include <utility>
+
+namespace math
+{
+  namespace
+  {
+    std::uint32_t const max_leaf_size = 4;
+
+    float component (vector_3d const& v, int axis)
+    {
+      return axis == 0 ? v.x : axis == 1 ? v.y : v.z;
+    }
+
+    void extend (vector_3d& min, vector_3d& max, vector_3d const& point)
+    {
+      min = {std::min (min.x, point.x), std::min (min.y, point.y), std::min (min.z, point.z)};
+      max = {std::max (max.x, point.x), std::max (max.y, point.y), std::max (max.z, point.z)};
+    }
+
+    vector_3d const empty_min ( std::numeric_limits<float>::max()
+                              , std::numeric_limits<float>::max()
+                              , std::numeric_limits<float>::max()
+                              );
+    vector_3d const empty_max ( std::numeric_limits<float>::lowest()
+                              , std::numeric_limits<float>::lowest()
+                              , std::numeric_limits<float>::lowest()
+                              );
+  }
+
+  triangle_bvh::triangle_bvh (std::vector<vector_3d> vertices, std::vector<std::uint32_t> const& indices)
+    : _vertices (std::move (vertices))
+  {
+    std::uint32_t const count (indices.size() / 3);
+
+    std::vector<vector_3d> centers;
+    centers.reserve (count);
+    for (std::uint32_t i (0); i < count; ++i)
+    {
+      centers.emplace_back ( ( _vertices[indices[3 * i]]
+                             + _vertices[indices[3 * i + 1]]
+                             + _vertices[indices[3 * i + 2]]
+                             ) * (1.f / 3.f)
+                           );
+    }
+
+    // the tree is built on triangle numbers, the indices are laid out in
+    // their final order afterwards
+    std::vector<std::uint32_t> order (count);
+    std::iota (order.begin(), order.end(), 0);
+
+    if (count > 0)
+    {
+      _nodes.reserve (2 * count / max_leaf_size + 1);
+      build (order, 0, count, centers);
+    }
+
+    _triangles.resize (3 * count);
+    for (std::uint32_t i (0); i < count; ++i)
+    {
+      for (std::uint32_t corner (0); corner < 3; ++corner)
+      {
+        _triangles[3 * i + corner] = indices[3 * order[i] + corner];
+      }
+    }
+
+    if (!_nodes.empty())
+    {
+      update_bounds (0);
+    }
+  }
+
+  std::uint32_t triangle_bvh::build ( std::vector<std::uint32_t>& order
+                                    , std::uint32_t first
+                                    , std::uint32_t count
+                                    , std::vector<vector_3d> const& centers
+                                    )
+  {
+    std::uint32_t const index (_nodes.size());
+    _nodes.push_back ({empty_min, empty_max, first, count});
+
+    if (count <= max_leaf_size)
+    {
+      return index;
+    }
+
+    vector_3d min (empty_min);
+    vector_3d max (empty_max);
+    for (std::uint32_t i (first); i < first + count; ++i)
+    {
+      extend (min, max, centers[order[i]]);
+    }
+
+    vector_3d const size (max - min);
+    int const axis (size.x >= size.y && size.x >= size.z ? 0 : size.y >= size.z ? 1 : 2);
+
+    auto const begin (order.begin() + first);
+    std::nth_element ( begin, begin + count / 2, begin + count
+                     , [&] (std::uint32_t lhs, std::uint32_t rhs)
+                       {
+                         return component (centers[lhs], axis) < component (centers[rhs], axis);
+                       }
+                     );
+
+    build (order, first, count / 2, centers);
+    std::uint32_t const second (build (order, first + count / 2, count - count / 2, centers));
+
+    _nodes[index].offset = second;
+    _nodes[index].count = 0;
+
+    return index;
+  }
+
+  void triangle_bvh::refit (std::vector<vector_3d> vertices)
+  {
+    _vertices = std::move (vertices);
+
+    if (!_nodes.empty())
+    {
+      update_bounds (0);
+    }
+  }
+
+  void triangle_bvh::update_bounds (std::uint32_t index)
+  {
+    node& current (_nodes[index]);
+
+    if (current.count == 0)
+    {
+      update_bounds (index + 1);
+      update_bounds (current.offset);
+
+      node const& left (_nodes[index + 1]);
+      node const& right (_nodes[current.offset]);
+      current.min = left.min;
+      current.max = left.max;
+      extend (current.min, current.max, right.min);
+      extend (current.min, current.max, right.max);
+      return;
+    }
+
+    current.min = empty_min;
+    current.max = empty_max;
+    for (std::uint32_t i (3 * current.offset); i < 3 * (current.offset + current.count); ++i)
+    {
+      extend (current.min, current.max, _vertices[_triangles[i]]);
+    }
+
+    // the triangle test isn't exact, don't let rounding cull grazing hits
+    vector_3d const padding ((current.max - current.min) * 1e-4f + vector_3d (1e-5f, 1e-5f, 1e-5f));
+    current.min = current.min - padding;
+    current.max = current.max + padding;
+  }
+
+  void triangle_bvh::intersect (ray const& ray, std::vector<float>& distances) const
+  {
+    if (_nodes.empty())
+    {
+      return;
+    }
+
+    vector_3d const& origin (ray.origin());
+    vector_3d const& direction (ray.direction());
+
+    auto const hits_box
+      ( [&] (node const& box)
+        {
+          float tmin (0.f);
+          float tmax (std::numeric_limits<float>::max());
+
+          for (int axis (0); axis < 3; ++axis)
+          {
+            float const o (component (origin, axis));
+            float const d (component (direction, axis));
+            float const low (component (box.min, axis));
+            float const high (component (box.max, axis));
+
+            if (d == 0.f)
+            {
+              if (o < low || o > high)
+              {
+                return false;
+              }
+              continue;
+            }
+
+            float t1 ((low - o) / d);
+            float t2 ((high - o) / d);
+            if (t1 > t2)
+            {
+              std::swap (t1, t2);
+            }
+
+            tmin = std::max (tmin, t1);
+            tmax = std::min (tmax, t2);
+
+            if (tmin > tmax)
+            {
+              return false;
+            }
+          }
+
+          return true;
+        }
+      );
+
+    std::array<std::uint32_t, 64> stack;
+    std::size_t size (0);
+    stack[size++] = 0;
+
+    while (size > 0)
+    {
+      node const& current (_nodes[stack[--size]]);
+
+      if (!hits_box (current))
+      {
+        continue;
+      }
+
+      if (current.count == 0)
+      {
+        stack[size++] = current.offset;
+        stack[size++] = &current - _nodes.data() + 1;
+        continue;
+      }
+
+      for (std::uint32_t i (current.offset); i < current.offset + current.count; ++i)
+      {
+        if ( auto distance = ray.intersect_triangle ( _vertices[_triangles[3 * i]]
+                                                    , _vertices[_triangles[3 * i + 1]]
+                                                    , _vertices[_triangles[3 * i + 2]]
+                                                    )
+           )
+        {
+          distances.emplace_back (*distance);
+        }
+      }
+    }
+  }
+}
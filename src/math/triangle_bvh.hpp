@@ -0,0 +1,56 @@
+// This file is part of Noggit3, licensed under GNU General Public License (version 3).
+
+#pragma once
+
+#include <math/ray.hpp>
+#include <math/vector_3d.hpp>
+
+#include <cstdint>
+#include <vector>
+
+namespace math
+{
+  //! Bounding volume hierarchy over a triangle list, for picking. It keeps
+  //! its own copy of the vertex positions: refit() takes new positions of
+  //! animated geometry and only recomputes the bounds, the tree is kept.
+  class triangle_bvh
+  {
+  public:
+    //! three indices into vertices per triangle
+    triangle_bvh (std::vector<vector_3d> vertices, std::vector<std::uint32_t> const& indices);
+
+    //! vertices has to have the size the tree was built with
+    void refit (std::vector<vector_3d> vertices);
+
+    //! appends the distance of every triangle hit, the same as testing all
+    //! of them with ray::intersect_triangle() but in no particular order
+    void intersect (ray const&, std::vector<float>& distances) const;
+
+    std::size_t triangle_count() const { return _triangles.size() / 3; }
+
+  private:
+    struct node
+    {
+      vector_3d min;
+      vector_3d max;
+      //! leaves: first triangle, inner nodes: second child, the first
+      //! one directly follows its parent
+      std::uint32_t offset;
+      //! number of triangles, 0 for inner nodes
+      std::uint32_t count;
+    };
+
+    std::uint32_t build ( std::vector<std::uint32_t>& order
+                        , std::uint32_t first
+                        , std::uint32_t count
+                        , std::vector<vector_3d> const& centers
+                        );
+    void update_bounds (std::uint32_t index);
+
+    std::vector<vector_3d> _vertices;
+    //! three vertex indices per triangle, sorted so that every leaf holds
+    //! a contiguous range
+    std::vector<std::uint32_t> _triangles;
+    std::vector<node> _nodes;
+  };
+}
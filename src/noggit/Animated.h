@@ -5,6 +5,7 @@
 #include <math/quaternion.hpp>
 #include <noggit/MPQ.h>
 #include <noggit/ModelHeaders.h>
+#include <noggit/animation_track.hpp>
 
 #include <cassert>
 #include <map>
@@ -13,21 +14,6 @@
 
 namespace Animation
 {
-  namespace Interpolation
-  {
-    //! \todo C++0x: Change namespace to "enum class Type : int16_t", remove typedef.
-    namespace Type
-    {
-      typedef int16_t Type_t;
-      enum
-      {
-        NONE,
-        LINEAR,
-        HERMITE
-      };
-    }
-  }
-
   template<class FROM, class TO>
   struct Conversion
   {
@@ -64,9 +50,6 @@ namespace Animation
     typedef uint32_t TimestampType;
     typedef uint32_t AnimationIdType;
 
-    typedef std::vector<AnimatedType> AnimatedTypeVectorType;
-    typedef std::vector<TimestampType> TimestampTypeVectorType;
-
     Animation::Conversion<DataType, AnimatedType> _conversion;
 
     static const int32_t NO_GLOBAL_SEQUENCE = -1;
@@ -75,12 +58,7 @@ namespace Animation
 
     Animation::Interpolation::Type::Type_t _interpolationType;
 
-    std::map<AnimationIdType, TimestampTypeVectorType> times;
-    std::map<AnimationIdType, AnimatedTypeVectorType> data;
-
-    // for nonlinear interpolations:
-    std::map<AnimationIdType, AnimatedTypeVectorType> in;
-    std::map<AnimationIdType, AnimatedTypeVectorType> out;
+    std::map<AnimationIdType, track<AnimatedType>> tracks;
 
   public:
     bool uses(AnimationIdType anim)
@@ -90,7 +68,7 @@ namespace Animation
         anim = AnimationIdType();
       }
 
-      return !data[anim].empty();
+      return !tracks[anim].data.empty();
     }
 
     AnimatedType getValue (AnimationIdType anim, TimestampType time, int animtime)
@@ -108,68 +86,7 @@ namespace Animation
         anim = AnimationIdType();
       }
 
-      TimestampTypeVectorType& timestampVector = times[anim];
-      AnimatedTypeVectorType& dataVector = data[anim];
-      AnimatedTypeVectorType& inVector = in[anim];
-      AnimatedTypeVectorType& outVector = out[anim];
-
-      if (dataVector.empty())
-      {
-        return AnimatedType();
-      }
-
-      AnimatedType result = dataVector[0];
-
-      if (!timestampVector.empty())
-      {
-        TimestampType max_time = timestampVector.back();
-        if (max_time > 0)
-        {
-          time %= max_time;
-        }
-        else
-        {
-          time = TimestampType();
-        }
-
-        size_t pos = 0;
-        for (size_t i = 0; i < timestampVector.size() - 1; ++i)
-        {
-          if (time >= timestampVector[i] && time < timestampVector[i + 1])
-          {
-            pos = i;
-            break;
-          }
-        }
-
-        if (pos == timestampVector.size() - 1 || _interpolationType == Animation::Interpolation::Type::NONE)
-        {
-          result = dataVector[pos];
-        }
-        else
-        {
-          TimestampType t1 = timestampVector[pos];
-          TimestampType t2 = timestampVector[pos + 1];
-          const float percentage = (time - t1) / static_cast<float>(t2 - t1);
-
-          switch (_interpolationType)
-          {
-          case Animation::Interpolation::Type::LINEAR:
-          {
-            result = math::interpolation::linear (percentage, dataVector[pos], dataVector[pos + 1]);
-          }
-            break;
-
-          case Animation::Interpolation::Type::HERMITE:
-          {
-            result = math::interpolation::hermite(percentage, dataVector[pos], dataVector[pos + 1], inVector[pos], outVector[pos]);
-          }
-            break;
-          }
-        }
-      }
-
-      return result;
+      return tracks[anim].value (time, _interpolationType);
     }
 
     //! \todo Use a vector of MPQFile& for the anim files instead for safety.
@@ -197,8 +114,9 @@ namespace Animation
 
         for (size_t i = 0; i < timestampHeaders[j].nEntries; ++i)
         {
-          times[j].push_back(timestamps[i]);
+          tracks[j].times.push_back(timestamps[i]);
         }
+        tracks[j].timestamps_changed();
       }
 
       for (size_t j = 0; j < animationBlock.nKeys; ++j)
@@ -213,16 +131,16 @@ namespace Animation
         case Animation::Interpolation::Type::LINEAR:
           for (size_t i = 0; i < keyHeaders[j].nEntries; ++i)
           {
-            data[j].push_back(_conversion(keys[i]));
+            tracks[j].data.push_back(_conversion(keys[i]));
           }
           break;
 
         case Animation::Interpolation::Type::HERMITE:
           for (size_t i = 0; i < keyHeaders[j].nEntries; ++i)
           {
-            data[j].push_back(_conversion(keys[i * 3]));
-            in[j].push_back(_conversion(keys[i * 3 + 1]));
-            out[j].push_back(_conversion(keys[i * 3 + 2]));
+            tracks[j].data.push_back(_conversion(keys[i * 3]));
+            tracks[j].in.push_back(_conversion(keys[i * 3 + 1]));
+            tracks[j].out.push_back(_conversion(keys[i * 3 + 2]));
           }
           break;
         }
@@ -235,23 +153,23 @@ namespace Animation
       {
       case Animation::Interpolation::Type::NONE:
       case Animation::Interpolation::Type::LINEAR:
-        for (size_t i = 0; i < data.size(); ++i)
+        for (auto& track : tracks)
         {
-          for (size_t j = 0; j < data[i].size(); ++j)
+          for (size_t j = 0; j < track.second.data.size(); ++j)
           {
-            data[i][j] = function(data[i][j]);
+            track.second.data[j] = function(track.second.data[j]);
           }
         }
         break;
 
       case Animation::Interpolation::Type::HERMITE:
-        for (size_t i = 0; i < data.size(); ++i)
+        for (auto& track : tracks)
         {
-          for (size_t j = 0; j < data[i].size(); ++j)
+          for (size_t j = 0; j < track.second.data.size(); ++j)
           {
-            data[i][j] = function(data[i][j]);
-            in[i][j] = function(in[i][j]);
-            out[i][j] = function(out[i][j]);
+            track.second.data[j] = function(track.second.data[j]);
+            track.second.in[j] = function(track.second.in[j]);
+            track.second.out[j] = function(track.second.out[j]);
           }
         }
         break;
@@ -2,8 +2,7 @@
 
 #include <noggit/AsyncLoader.h>
 #include <noggit/errorHandling.h>
-
-#include <QtCore/QSettings>
+#include <noggit/settings_snapshot.hpp>
 
 #include <algorithm>
 #include <list>
@@ -12,9 +11,6 @@ void AsyncLoader::process()
 {
   AsyncObject* object = nullptr;
 
-  QSettings settings;
-  bool additional_log = settings.value("additional_file_loading_log", false).toBool();
-
   while (!_stop)
   {
     {    
@@ -50,6 +46,8 @@ void AsyncLoader::process()
       }
     }
 
+    bool const additional_log (noggit::current_settings().additional_file_loading_log);
+
     try
     {
       if (additional_log)
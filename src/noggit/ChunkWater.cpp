@@ -176,8 +176,6 @@ void ChunkWater::draw ( math::frustum const& frustum
                       , const math::vector_3d& camera
                       , bool camera_moved
                       , liquid_render& render
-                      , opengl::scoped::use_program& water_shader
-                      , int animtime
                       , int layer
                       , display_mode display
                       )
@@ -191,12 +189,12 @@ void ChunkWater::draw ( math::frustum const& frustum
   {
     for (liquid_layer& lq_layer : _layers)
     {
-      lq_layer.draw (render, water_shader, camera, camera_moved, animtime);
+      lq_layer.draw (render, camera, camera_moved);
     }
   }
   else if (layer < _layers.size())
   {
-    _layers[layer].draw (render, water_shader, camera, camera_moved, animtime);
+    _layers[layer].draw (render, camera, camera_moved);
   }
 }
 
@@ -2,9 +2,11 @@
 
 #include <noggit/DBC.h>
 #include <noggit/Log.h>
+#include <noggit/MPQ.h>
 #include <noggit/Misc.h>
 
 #include <string>
+#include <string_view>
 
 AreaDB gAreaDB;
 MapDB gMapDB;
@@ -18,6 +20,22 @@ GroundEffectDoodadDB gGroundEffectDoodadDB;
 GroundEffectTextureDB gGroundEffectTextureDB;
 LiquidTypeDB gLiquidTypeDB;
 
+void DBCFile::open()
+{
+  MPQFile f (filename);
+
+  if (f.isEof())
+  {
+    LogError << "The DBC file \"" << filename << "\" could not be opened. This application may crash soon as the file is most likely needed." << std::endl;
+    return;
+  }
+  LogDebug << "Opening DBC \"" << filename << "\"" << std::endl;
+
+  open (f.getBuffer(), f.getSize());
+
+  f.close();
+}
+
 void OpenDBs()
 {
   gAreaDB.open();
@@ -43,31 +61,37 @@ std::string AreaDB::getAreaName(int pAreaID)
   }    
 
   unsigned int regionID = 0;
-  std::string areaName = "";
+  std::string_view areaName;
   try
   {
     AreaDB::Record rec = gAreaDB.getByID(pAreaID);
-    areaName = rec.getLocalizedString(AreaDB::Name);
+    areaName = rec.getLocalizedStringView(AreaDB::Name);
     regionID = rec.getUInt(AreaDB::Region);
   }
   catch (AreaDB::NotFound)
   {
-    areaName = "Unknown location";
+    return "Unknown location";
   }
-  if (regionID != 0)
+  if (regionID == 0)
   {
-    try
-    {
-      AreaDB::Record rec = gAreaDB.getByID(regionID);
-      areaName = std::string(rec.getLocalizedString(AreaDB::Name)) + std::string(": ") + areaName;
-    }
-    catch (AreaDB::NotFound)
-    {
-      areaName = "Unknown location";
-    }
+    return std::string(areaName);
   }
 
-  return areaName;
+  std::string_view regionName;
+  try
+  {
+    regionName = gAreaDB.getByID(regionID).getLocalizedStringView(AreaDB::Name);
+  }
+  catch (AreaDB::NotFound)
+  {
+    return "Unknown location";
+  }
+
+  // the views point into the string block, only the result is copied
+  std::string name;
+  name.reserve(regionName.size() + 2 + areaName.size());
+  name.append(regionName).append(": ").append(areaName);
+  return name;
 }
 
 std::uint32_t AreaDB::get_area_parent(int area_id)
@@ -92,18 +116,14 @@ std::uint32_t AreaDB::get_area_parent(int area_id)
 std::string MapDB::getMapName(int pMapID)
 {
   if (pMapID<0) return "Unknown map";
-  std::string mapName = "";
   try
   {
-    MapDB::Record rec = gMapDB.getByID(pMapID);
-    mapName = std::string(rec.getLocalizedString(MapDB::Name));
+    return std::string(gMapDB.getByID(pMapID).getLocalizedStringView(MapDB::Name));
   }
   catch (MapDB::NotFound)
   {
-    mapName = "Unknown map";
+    return "Unknown map";
   }
-
-  return mapName;
 }
 
 const char * getGroundEffectDoodad(unsigned int effectID, int DoodadNum)
@@ -137,16 +157,12 @@ int LiquidTypeDB::getLiquidType(int pID)
 
 std::string  LiquidTypeDB::getLiquidName(int pID)
 {
-  std::string type = "";
   try
   {
-    LiquidTypeDB::Record rec = gLiquidTypeDB.getByID(pID);
-    type = std::string(rec.getString(LiquidTypeDB::Name));
+    return std::string(gLiquidTypeDB.getByID(pID).getStringView(LiquidTypeDB::Name));
   }
   catch (MapDB::NotFound)
   {
-    type = "Unknown type";
+    return "Unknown type";
   }
-
-  return type;
 }
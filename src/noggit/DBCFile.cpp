@@ -1,45 +1,88 @@
 // This file is part of Noggit3, licensed under GNU General Public License (version 3).
 
 #include <noggit/DBCFile.h>
-#include <noggit/Log.h>
-#include <noggit/MPQ.h>
 
+#include <algorithm>
+#include <cstring>
 #include <string>
 
+// open() itself lives in DBC.cpp, keeping this file independent of the MPQ
+// layer so the parsing and the index can be tested on their own.
+
 DBCFile::DBCFile(const std::string& _filename)
   : filename(_filename)
 {}
 
-void DBCFile::open()
+void DBCFile::open(char const* buffer, std::size_t size)
 {
-  MPQFile f (filename);
-
-  if (f.isEof())
+  if (size < 20 || std::memcmp(buffer, "WDBC", 4))
   {
-    LogError << "The DBC file \"" << filename << "\" could not be opened. This application may crash soon as the file is most likely needed." << std::endl;
-    return;
+    throw std::runtime_error("\"" + filename + "\" is not a valid DBC file");
   }
-  LogDebug << "Opening DBC \"" << filename << "\"" << std::endl;
 
-  char header[4];
+  std::uint32_t header[4];
+  std::memcpy(header, buffer + 4, sizeof(header));
 
-  f.read(header, 4); // Number of records
-  assert(header[0] == 'W' && header[1] == 'D' && header[2] == 'B' && header[3] == 'C');
-  f.read(&recordCount, 4);
-  f.read(&fieldCount, 4);
-  f.read(&recordSize, 4);
-  f.read(&stringSize, 4);
+  recordCount = header[0];
+  fieldCount = header[1];
+  recordSize = header[2];
+  stringSize = header[3];
 
   if (fieldCount * 4 != recordSize)
   {
     throw std::logic_error ("non four-byte-columns not supported");
   }
+  if (20 + recordSize * recordCount + stringSize > size)
+  {
+    throw std::runtime_error("\"" + filename + "\" is truncated");
+  }
+
+  char const* records (buffer + 20);
+  data.assign (records, records + recordSize * recordCount);
+  stringTable.assign (records + data.size(), records + data.size() + stringSize);
 
-  data.resize (recordSize * recordCount);
-  f.read (data.data(), data.size());
+  build_id_index();
+}
+
+void DBCFile::build_id_index()
+{
+  _dense_index.clear();
+  _hashed_index.clear();
 
-  stringTable.resize (stringSize);
-  f.read (stringTable.data(), stringTable.size());
+  if (!recordCount || !fieldCount)
+  {
+    return;
+  }
 
-  f.close();
+  unsigned int min_id (getRecord(0).getUInt(0));
+  unsigned int max_id (min_id);
+
+  for (Iterator i = begin(); i != end(); ++i)
+  {
+    min_id = std::min(min_id, i->getUInt(0));
+    max_id = std::max(max_id, i->getUInt(0));
+  }
+
+  // a few holes are fine, spending more than about four slots per record isn't
+  std::size_t const range (static_cast<std::size_t>(max_id) - min_id + 1);
+
+  if (range <= recordCount * 4 + 256)
+  {
+    _dense_index_min_id = min_id;
+    _dense_index.assign(range, no_record);
+
+    for (std::size_t record (recordCount); record-- > 0;)
+    {
+      _dense_index[getRecord(record).getUInt(0) - min_id] = record;
+    }
+  }
+  else
+  {
+    _hashed_index.reserve(recordCount);
+
+    for (std::size_t record (0); record < recordCount; ++record)
+    {
+      _hashed_index.emplace(getRecord(record).getUInt(0), record);
+    }
+  }
 }
@@ -3,7 +3,11 @@
 #pragma once
 
 #include <cassert>
+#include <cstddef>
+#include <cstdint>
 #include <string>
+#include <string_view>
+#include <unordered_map>
 #include <vector>
 #include <stdexcept>
 
@@ -14,6 +18,8 @@ public:
 
   // Open database. It must be openened before it can be used.
   void open();
+  //! parse a DBC already in memory, open() reads the file and calls this
+  void open(char const* buffer, std::size_t size);
 
   class NotFound : public std::runtime_error
   {
@@ -48,6 +54,11 @@ public:
       assert(stringOffset < file.stringSize);
       return file.stringTable.data() + stringOffset;
     }
+    //! \note points into the string block, valid as long as the file is
+    std::string_view getStringView(size_t field) const
+    {
+      return getString(field);
+    }
     const char *getLocalizedString(size_t field, int locale = -1) const
     {
       int loc = locale;
@@ -67,6 +78,10 @@ public:
       assert(stringOffset < file.stringSize);
       return file.stringTable.data() + stringOffset;
     }
+    std::string_view getLocalizedStringView(size_t field, int locale = -1) const
+    {
+      return getLocalizedString(field, locale);
+    }
   private:
     Record(const DBCFile &pfile, unsigned char *poffset) : file(pfile), offset(poffset) {}
     const DBCFile &file;
@@ -121,8 +136,20 @@ public:
 
   inline size_t getRecordCount() const { return recordCount; }
   inline size_t getFieldCount() const { return fieldCount; }
+  //! \note ids in the first field are looked up in the index built on
+  //! open(), other fields are scanned
   inline Record getByID(unsigned int id, size_t field = 0)
   {
+    if (field == 0)
+    {
+      std::size_t const record (find_record(id));
+      if (record == no_record)
+      {
+        throw NotFound();
+      }
+      return getRecord(record);
+    }
+
     for (Iterator i = begin(); i != end(); ++i)
     {
       if (i->getUInt(field) == id)
@@ -132,11 +159,35 @@ public:
   }
 
 private:
+  static constexpr std::size_t no_record = static_cast<std::size_t>(-1);
+
+  void build_id_index();
+
+  inline std::size_t find_record(unsigned int id) const
+  {
+    if (!_dense_index.empty())
+    {
+      std::size_t const slot (static_cast<std::size_t>(id) - _dense_index_min_id);
+      // ids below the minimum wrap around to huge slots
+      return slot < _dense_index.size() ? _dense_index[slot] : no_record;
+    }
+
+    auto const it (_hashed_index.find(id));
+    return it != _hashed_index.end() ? it->second : no_record;
+  }
+
   std::string filename;
-  size_t recordSize;
-  size_t recordCount;
-  size_t fieldCount;
-  size_t stringSize;
+  size_t recordSize = 0;
+  size_t recordCount = 0;
+  size_t fieldCount = 0;
+  size_t stringSize = 0;
   std::vector<unsigned char> data;
   std::vector<char> stringTable;
+
+  //! id of the first field to record number, as an array when the ids
+  //! are dense enough and hashed otherwise. Duplicated ids resolve to
+  //! the first record, like the linear scan did.
+  std::vector<std::size_t> _dense_index;
+  std::size_t _dense_index_min_id = 0;
+  std::unordered_map<unsigned int, std::size_t> _hashed_index;
 };
@@ -3,13 +3,13 @@
 #include <noggit/AsyncLoader.h> // AsyncLoader
 #include <noggit/Log.h>
 #include <noggit/MPQ.h>
+#include <noggit/settings_snapshot.hpp>
 
 #include <boost/algorithm/string.hpp>
 #include <boost/filesystem.hpp>
+#include <boost/range/iterator_range.hpp>
 #include <boost/thread.hpp>
 
-#include <QtCore/QSettings>
-
 #include <algorithm>
 #include <cstdint>
 #include <cstdio>
@@ -29,6 +29,109 @@ namespace
 
   boost::mutex gListfileLoadingMutex;
   boost::mutex gMPQFileMutex;
+
+  //! fills noggit::mpq::assets() once the listfiles are read, so nothing
+  //! has to scan gListfile or the project folder by itself. Filled again
+  //! when the project path changes.
+  class asset_catalog_loader : public AsyncObject
+  {
+  public:
+    asset_catalog_loader()
+      : AsyncObject ("asset catalog")
+      , _project_path (noggit::current_settings().project_path)
+      , _settings_changed ( [this] (noggit::settings_snapshot const& settings)
+                            {
+                              project_path_changed (settings.project_path);
+                            }
+                          )
+    {}
+
+    virtual void finishLoading() override
+    {
+      MPQArchive::allFinishLoading();
+
+      std::string project_path;
+      {
+        std::lock_guard<std::mutex> const lock (_mutex);
+        project_path = _project_path;
+      }
+
+      for (;;)
+      {
+        fill (project_path);
+
+        std::lock_guard<std::mutex> const lock (_mutex);
+        // the path changed while listing the files, start over with it
+        if (project_path != _project_path)
+        {
+          project_path = _project_path;
+          continue;
+        }
+
+        finished = true;
+        _state_changed.notify_all();
+        return;
+      }
+    }
+
+  private:
+    void fill (std::string const& project_path)
+    {
+      noggit::mpq::assets().clear();
+
+      std::vector<std::string> listfile;
+      {
+        boost::mutex::scoped_lock const lock (gListfileLoadingMutex);
+        listfile.assign (gListfile.begin(), gListfile.end());
+      }
+      noggit::mpq::assets().add (listfile);
+
+      boost::filesystem::path const prefix (project_path);
+      auto const prefix_size (prefix.string().length());
+
+      if (!project_path.empty() && boost::filesystem::exists (prefix))
+      {
+        for ( auto const& entry
+            : boost::make_iterator_range
+                (boost::filesystem::recursive_directory_iterator (prefix), {})
+            )
+        {
+          noggit::mpq::assets().add
+            (noggit::mpq::normalized_filename (entry.path().string().substr (prefix_size)));
+        }
+      }
+
+      LogDebug << "Asset catalog: " << noggit::mpq::assets().size() << " files" << std::endl;
+    }
+
+    void project_path_changed (std::string const& project_path)
+    {
+      std::lock_guard<std::mutex> const lock (_mutex);
+
+      if (project_path == _project_path)
+      {
+        return;
+      }
+
+      _project_path = project_path;
+
+      // a queued or running load picks the new path up by itself
+      if (finished.load())
+      {
+        finished = false;
+        AsyncLoader::instance().queue_for_load (this);
+      }
+    }
+
+    std::string _project_path;
+    noggit::settings_subscription _settings_changed;
+  };
+
+  asset_catalog_loader& asset_loader()
+  {
+    static asset_catalog_loader instance;
+    return instance;
+  }
 }
 
 std::unordered_set<std::string> gListfile;
@@ -39,6 +142,97 @@ void MPQArchive::loadMPQ (AsyncLoader* loader, std::string const& filename, bool
   loader->queue_for_load(_openArchives.back().second.get());
 }
 
+void MPQArchive::loadClientMPQs (AsyncLoader* loader, boost::filesystem::path const& wowpath)
+{
+  std::vector<std::string> archiveNames;
+  archiveNames.push_back("common.MPQ");
+  archiveNames.push_back("common-2.MPQ");
+  archiveNames.push_back("expansion.MPQ");
+  archiveNames.push_back("lichking.MPQ");
+  archiveNames.push_back("patch.MPQ");
+  archiveNames.push_back("patch-{number}.MPQ");
+  archiveNames.push_back("patch-{character}.MPQ");
+
+  //archiveNames.push_back( "{locale}/backup-{locale}.MPQ" );
+  //archiveNames.push_back( "{locale}/base-{locale}.MPQ" );
+  archiveNames.push_back("{locale}/locale-{locale}.MPQ");
+  //archiveNames.push_back( "{locale}/speech-{locale}.MPQ" );
+  archiveNames.push_back("{locale}/expansion-locale-{locale}.MPQ");
+  //archiveNames.push_back( "{locale}/expansion-speech-{locale}.MPQ" );
+  archiveNames.push_back("{locale}/lichking-locale-{locale}.MPQ");
+  //archiveNames.push_back( "{locale}/lichking-speech-{locale}.MPQ" );
+  archiveNames.push_back("{locale}/patch-{locale}.MPQ");
+  archiveNames.push_back("{locale}/patch-{locale}-{number}.MPQ");
+  archiveNames.push_back("{locale}/patch-{locale}-{character}.MPQ");
+
+  archiveNames.push_back("development.MPQ");
+
+  const char * locales[] = { "enGB", "enUS", "deDE", "koKR", "frFR", "zhCN", "zhTW", "esES", "esMX", "ruRU" };
+  const char * locale("****");
+
+  // Find locale, take first one.
+  for (int i(0); i < 10; ++i)
+  {
+    if (boost::filesystem::exists (wowpath / "Data" / locales[i] / "realmlist.wtf"))
+    {
+      locale = locales[i];
+      NOGGIT_LOG << "Locale: " << locale << std::endl;
+      break;
+    }
+  }
+  if (!strcmp(locale, "****"))
+  {
+    LogError << "Could not find locale directory. Be sure, that there is one containing the file \"realmlist.wtf\"." << std::endl;
+    //return -1;
+  }
+
+
+  //! \todo  This may be done faster. Maybe.
+  for (size_t i(0); i < archiveNames.size(); ++i)
+  {
+    std::string path((wowpath / "Data" / archiveNames[i]).string());
+    std::string::size_type location(std::string::npos);
+
+    do
+    {
+      location = path.find("{locale}");
+      if (location != std::string::npos)
+      {
+        path.replace(location, 8, locale);
+      }
+    } while (location != std::string::npos);
+
+    if (path.find("{number}") != std::string::npos)
+    {
+      location = path.find("{number}");
+      path.replace(location, 8, " ");
+      for (char j = '2'; j <= '9'; j++)
+      {
+        path.replace(location, 1, std::string(&j, 1));
+        if (boost::filesystem::exists(path))
+          loadMPQ (loader, path, true);
+      }
+    }
+    else if (path.find("{character}") != std::string::npos)
+    {
+      location = path.find("{character}");
+      path.replace(location, 11, " ");
+      for (char c = 'a'; c <= 'z'; c++)
+      {
+        path.replace(location, 1, std::string(&c, 1));
+        if (boost::filesystem::exists(path))
+          loadMPQ (loader, path, true);
+      }
+    }
+    else
+      if (boost::filesystem::exists(path))
+        loadMPQ (loader, path, true);
+  }
+
+  // queued after the archives, so their listfiles are usually read by then
+  loader->queue_for_load (&asset_loader());
+}
+
 MPQArchive::MPQArchive(std::string const& filename_, bool doListfile)
   : AsyncObject(filename_)
   ,_archiveHandle(nullptr)
@@ -162,8 +356,7 @@ namespace
 {
   boost::filesystem::path getDiskPath (std::string const& pFilename)
   {
-    QSettings settings;
-    return boost::filesystem::path (settings.value ("project/path").toString().toStdString())
+    return boost::filesystem::path (noggit::current_settings().project_path)
       / noggit::mpq::normalized_filename (pFilename);
   }
 
@@ -186,6 +379,7 @@ MPQFile::MPQFile(std::string const& filename)
   , pointer(0)
   , External(false)
   , _disk_path (getDiskPath (filename))
+  , _mpq_path (noggit::mpq::normalized_filename (filename))
 {
   if (filename.empty())
     throw std::runtime_error("MPQFile: filename empty");
@@ -226,6 +420,14 @@ MPQFile::MPQFile(std::string const& filename)
   throw std::invalid_argument ("File '" + filename + "' does not exist.");
 }
 
+MPQFile::MPQFile(char const* data, std::size_t size)
+  : eof(size == 0)
+  , buffer(data, data + size)
+  , pointer(0)
+  , External(false)
+{
+}
+
 MPQFile::~MPQFile()
 {
   close();
@@ -321,6 +523,11 @@ void MPQFile::SaveFile()
     output.close();
 
     External = true;
+
+    if (!_mpq_path.empty())
+    {
+      noggit::mpq::assets().add (_mpq_path);
+    }
   }
 }
 
@@ -350,5 +557,16 @@ namespace noggit
                      );
       return filename;
     }
+
+    asset_catalog& assets()
+    {
+      static asset_catalog catalog;
+      return catalog;
+    }
+
+    void wait_for_assets()
+    {
+      asset_loader().wait_until_loaded();
+    }
   }
 }
@@ -3,6 +3,7 @@
 #pragma once
 
 #include <noggit/AsyncObject.h>
+#include <noggit/asset_catalog.hpp>
 
 #include <StormLib.h>
 
@@ -37,6 +38,8 @@ public:
   static void allFinishLoading();
 
   static void loadMPQ (AsyncLoader*, const std::string& filename, bool doListfile = false);
+  //! loads every client archive found in wowpath/Data, in patch order
+  static void loadClientMPQs (AsyncLoader*, boost::filesystem::path const& wowpath);
   static void unloadAllMPQs();
   static void unloadMPQ(const std::string& filename);
 
@@ -57,6 +60,9 @@ class MPQFile
 
 public:
   explicit MPQFile(const std::string& pFilename);  // filenames are not case sensitive, the are if u dont use a filesystem which is kinda shitty...
+  //! a copy of part of an already read file, e.g. one chunk to be parsed
+  //! on another thread. It has no path and can't be saved.
+  MPQFile(char const* data, std::size_t size);
 
   MPQFile() = delete;
   ~MPQFile();
@@ -104,5 +110,12 @@ namespace noggit
   {
     std::string normalized_filename (std::string filename);
     std::string normalized_filename_insane (std::string filename);
+
+    //! The models, wmos and tilesets of the client's listfiles and the
+    //! project folder. Filled in the background after loadClientMPQs() and
+    //! extended by MPQFile::SaveFile().
+    asset_catalog& assets();
+    //! blocks until assets() holds every listfile and project file
+    void wait_for_assets();
   }
 }
@@ -23,7 +23,6 @@
 MapChunk::MapChunk(MapTile *maintile, MPQFile *f, bool bigAlpha, tile_mode mode)
   : _mode(mode)
   , mt(maintile)
-  , use_big_alphamap(bigAlpha)
 {
   uint32_t fourcc;
   uint32_t size;
@@ -237,9 +236,6 @@ void MapChunk::update_intersect_points()
   // update the center of the chunk and visibility when the vertices changed
   vcenter = (vmin + vmax) * 0.5f;
   _need_visibility_update = true;
-
-  _intersect_points.clear();
-  _intersect_points = misc::intersection_points(vmin, vmax);
 }
 
 void MapChunk::upload()
@@ -483,6 +479,9 @@ void MapChunk::clearHeight()
   vmin.y = 0.0f;
   vmax.y = 0.0f;
 
+  _dirty |= mcnk_dirty_height;
+  mt->horizon_outdated = true;
+
   update_intersect_points();
 
   if (_uploaded)
@@ -494,11 +493,10 @@ void MapChunk::clearHeight()
   }
 }
 
-bool MapChunk::is_visible ( const float& cull_distance
-                          , const math::frustum& frustum
-                          , const math::vector_3d& camera
-                          , display_mode display
-                          ) const
+bool MapChunk::in_cull_distance ( const float& cull_distance
+                                , const math::vector_3d& camera
+                                , display_mode display
+                                ) const
 {
   static const float chunk_radius = std::sqrt (CHUNKSIZE * CHUNKSIZE / 2.0f); //was (vmax - vmin).length() * 0.5f;
 
@@ -506,8 +504,17 @@ bool MapChunk::is_visible ( const float& cull_distance
              ? (camera - vcenter).length() - chunk_radius
              : std::abs(camera.y - vmax.y);
 
-  return frustum.intersects (_intersect_points)
-      && dist < cull_distance;
+  return dist < cull_distance;
+}
+
+bool MapChunk::is_visible ( const float& cull_distance
+                          , const math::frustum& frustum
+                          , const math::vector_3d& camera
+                          , display_mode display
+                          ) const
+{
+  return frustum.intersects (vmin, vmax)
+      && in_cull_distance (cull_distance, camera, display);
 }
 
 
@@ -529,10 +536,19 @@ void MapChunk::update_visibility ( const float& cull_distance
                                  , const math::vector_3d& camera
                                  , display_mode display
                                  )
+{
+  update_visibility (frustum.intersects (vmin, vmax), cull_distance, camera, display);
+}
+
+void MapChunk::update_visibility ( bool in_frustum
+                                 , const float& cull_distance
+                                 , const math::vector_3d& camera
+                                 , display_mode display
+                                 )
 {
   auto lod = get_lod_level(camera, display);
 
-  _is_visible = is_visible(cull_distance, frustum, camera, display);
+  _is_visible = in_frustum && in_cull_distance(cull_distance, camera, display);
   _need_visibility_update = false;
   _need_lod_update |= lod != _lod_level;
   _lod_level = lod;
@@ -695,6 +711,11 @@ void MapChunk::intersect (math::ray const& ray, selection_result* results)
 }
 
 void MapChunk::updateVerticesData()
+{
+  updateVerticesData (noggit::vertex_mask().set());
+}
+
+void MapChunk::updateVerticesData (noggit::vertex_mask const& changed)
 {
   vmin.y = std::numeric_limits<float>::max();
   vmax.y = std::numeric_limits<float>::lowest();
@@ -705,16 +726,44 @@ void MapChunk::updateVerticesData()
     vmax.y = std::max(vmax.y, mVertices[i].y);
   }
 
+  _dirty |= mcnk_dirty_height;
+  mt->horizon_outdated = true;
+
   update_intersect_points();
 
   if (_uploaded)
   {
-    gl.bufferData<GL_ARRAY_BUFFER>(_vertices_vbo, sizeof(mVertices), mVertices, GL_STATIC_DRAW);
-    _need_vao_update = true;
+    auto const range (noggit::vertex_range (changed));
+    if (range.second - range.first == changed.size())
+    {
+      gl.bufferData<GL_ARRAY_BUFFER>(_vertices_vbo, sizeof(mVertices), mVertices, GL_STATIC_DRAW);
+      _need_vao_update = true;
+    }
+    else if (range.first != range.second)
+    {
+      gl.bufferSubData<GL_ARRAY_BUFFER> ( _vertices_vbo
+                                        , range.first * sizeof (*mVertices)
+                                        , (range.second - range.first) * sizeof (*mVertices)
+                                        , mVertices + range.first
+                                        );
+    }
   }
 }
 
 void MapChunk::recalcNorms (std::function<boost::optional<float> (float, float)> height)
+{
+  compute_normals (height);
+  upload_normals();
+}
+
+void MapChunk::compute_normals (std::function<boost::optional<float> (float, float)> const& height)
+{
+  compute_normals (height, noggit::vertex_mask().set());
+}
+
+void MapChunk::compute_normals ( std::function<boost::optional<float> (float, float)> const& height
+                               , noggit::vertex_mask const& vertices
+                               )
 {
   auto point
   (
@@ -732,6 +781,11 @@ void MapChunk::recalcNorms (std::function<boost::optional<float> (float, float)>
 
   for (int i = 0; i<mapbufsize; ++i)
   {
+    if (!vertices[i])
+    {
+      continue;
+    }
+
     math::vector_3d const P1 (point(mVertices[i], -half_unit, -half_unit));
     math::vector_3d const P2 (point(mVertices[i],  half_unit, -half_unit));
     math::vector_3d const P3 (point(mVertices[i],  half_unit,  half_unit));
@@ -753,6 +807,11 @@ void MapChunk::recalcNorms (std::function<boost::optional<float> (float, float)>
     mNormals[i] = {-Norm.z, Norm.y, -Norm.x};
   }
 
+  _dirty |= mcnk_dirty_normals;
+}
+
+void MapChunk::upload_normals()
+{
   if (_uploaded)
   {
     gl.bufferData<GL_ARRAY_BUFFER> (_normals_vbo, sizeof(mNormals), mNormals, GL_STATIC_DRAW);
@@ -760,6 +819,23 @@ void MapChunk::recalcNorms (std::function<boost::optional<float> (float, float)>
   }
 }
 
+void MapChunk::upload_normals (noggit::vertex_mask const& changed)
+{
+  auto const range (noggit::vertex_range (changed));
+  if (range.second - range.first == changed.size())
+  {
+    upload_normals();
+  }
+  else if (_uploaded && range.first != range.second)
+  {
+    gl.bufferSubData<GL_ARRAY_BUFFER> ( _normals_vbo
+                                      , range.first * sizeof (*mNormals)
+                                      , (range.second - range.first) * sizeof (*mNormals)
+                                      , mNormals + range.first
+                                      );
+  }
+}
+
 bool MapChunk::changeTerrain(math::vector_3d const& pos, float change, float radius, int BrushType, float inner_radius)
 {
   float dist, xdiff, zdiff;
@@ -832,6 +908,7 @@ void MapChunk::maybe_create_mccv()
   {
     std::fill (mccv, mccv + mapbufsize, math::vector_3d (1.f, 1.f, 1.f));
     hasMCCV = true;
+    _dirty |= mcnk_dirty_mccv;
   }
 }
 
@@ -880,6 +957,11 @@ bool MapChunk::ChangeMCCV(math::vector_3d const& pos, math::vector_4d const& col
       changed = true;
     }
   }
+  if (changed)
+  {
+    _dirty |= mcnk_dirty_mccv;
+  }
+
   if (changed && _uploaded)
   {
     gl.bufferData<GL_ARRAY_BUFFER> (_mccv_vbo, sizeof(mccv), mccv, GL_STATIC_DRAW);
@@ -891,6 +973,8 @@ bool MapChunk::ChangeMCCV(math::vector_3d const& pos, math::vector_4d const& col
 
 void MapChunk::UpdateMCCV()
 {
+  _dirty |= mcnk_dirty_mccv;
+
   if(_uploaded)
   {
     gl.bufferData<GL_ARRAY_BUFFER> (_mccv_vbo, sizeof(mccv), mccv, GL_STATIC_DRAW);
@@ -1107,6 +1191,7 @@ void MapChunk::clear_shadows()
 {
   _has_shadow = false;
   memset(_shadow_map, 0, 64 * 64);
+  _dirty |= mcnk_dirty_shadow;
 
   if (_uploaded)
   {
@@ -1131,12 +1216,15 @@ void MapChunk::setHole(math::vector_3d const& pos, bool big, bool add)
     holes = add ? (holes | v) : (holes & ~v);
   }
 
+  _dirty |= mcnk_dirty_header;
+
   initStrip();
 }
 
 void MapChunk::setAreaID(int ID)
 {
   areaID = ID;
+  _dirty |= mcnk_dirty_header;
 }
 
 int MapChunk::getAreaID()
@@ -1155,13 +1243,125 @@ void MapChunk::setFlag(bool changeto, uint32_t flag)
   {
     header_flags.value &= ~flag;
   }
+
+  _dirty |= mcnk_dirty_header;
+}
+
+void MapChunk::write_heightmap(float* heightmap) const
+{
+  for (int i = 0; i < mapbufsize; ++i)
+    heightmap[i] = mVertices[i].y - mVertices[0].y;
+}
+
+void MapChunk::write_mccv(unsigned int* mccv_data) const
+{
+  for (int i = 0; i < mapbufsize; ++i)
+  {
+    mccv_data[i] = (((unsigned char)(mccv[i].z * 127.0f) & 0xFF) <<  0)
+                 + (((unsigned char)(mccv[i].y * 127.0f) & 0xFF) <<  8)
+                 + (((unsigned char)(mccv[i].x * 127.0f) & 0xFF) << 16);
+  }
+}
+
+void MapChunk::write_normals(char* normals) const
+{
+  for (int i = 0; i < mapbufsize; ++i)
+  {
+    normals[i * 3 + 0] = static_cast<char>(mNormals[i].x * 127);
+    normals[i * 3 + 1] = static_cast<char>(mNormals[i].z * 127);
+    normals[i * 3 + 2] = static_cast<char>(mNormals[i].y * 127);
+  }
 }
 
-void MapChunk::save(util::sExtendableArray &lADTFile, int &lCurrentPosition, int &lMCIN_Position, std::map<std::string, int> &lTextures, std::vector<WMOInstance> &lObjectInstances, std::vector<ModelInstance>& lModelInstances)
+void MapChunk::save(util::sExtendableArray &lADTFile, int &lCurrentPosition, int &lMCIN_Position, std::map<std::string, int> &lTextures, std::vector<WMOInstance> &lObjectInstances, std::vector<ModelInstance>& lModelInstances, bool big_alphamap)
 {
   int lID;
   int lMCNK_Size = 0x80;
   int lMCNK_Position = lCurrentPosition;
+
+  // texture ids and references depend on the whole tile, compare them
+  // with the ones of the last save instead of tracking them
+  std::vector<int> lTextureIDs;
+  for (size_t j = 0; j < texture_set->num(); ++j)
+  {
+    lTextureIDs.push_back(lTextures.find(texture_set->filename(j))->second);
+  }
+
+  std::vector<int> lDoodadIDs;
+  std::vector<int> lObjectIDs;
+
+  math::vector_3d lChunkExtents[2];
+  lChunkExtents[0] = math::vector_3d(xbase, 0.0f, zbase);
+  lChunkExtents[1] = math::vector_3d(xbase + CHUNKSIZE, 0.0f, zbase + CHUNKSIZE);
+
+  // search all wmos that are inside this chunk
+  lID = 0;
+  for(auto const& wmo : lObjectInstances)
+  {
+    if (wmo.isInsideRect(lChunkExtents))
+    {
+      lObjectIDs.push_back(lID);
+    }
+
+    lID++;
+  }
+
+  // search all models that are inside this chunk
+  lID = 0;
+  for(auto const& model : lModelInstances)
+  {
+    if (model.isInsideRect (lChunkExtents))
+    {
+      lDoodadIDs.push_back(lID);
+    }
+    lID++;
+  }
+
+  // nothing changing the layout of the chunk: splice in the last saved
+  // MCNK and only rewrite the header and the dirty fixed size parts
+  if ( !_saved_mcnk.empty()
+    && !(_dirty & mcnk_dirty_shadow)
+    && _saved_with_mccv == hasMCCV
+    && !texture_set->changed_since_save(big_alphamap)
+    && lTextureIDs == _saved_texture_ids
+    && lDoodadIDs == _saved_doodad_refs
+    && lObjectIDs == _saved_object_refs
+     )
+  {
+    lADTFile.Extend(_saved_mcnk.size());
+    memcpy(lADTFile.GetPointer<char>(lMCNK_Position).get(), _saved_mcnk.data(), _saved_mcnk.size());
+
+    auto const lMCNK_header = lADTFile.GetPointer<MapChunkHeader>(lMCNK_Position + 8);
+
+    lMCNK_header->flags = header_flags.value;
+    lMCNK_header->holes = holes;
+    lMCNK_header->areaid = areaID;
+    lMCNK_header->ypos = mVertices[0].y;
+
+    if (_dirty & mcnk_dirty_height)
+    {
+      write_heightmap(lADTFile.GetPointer<float>(lMCNK_Position + lMCNK_header->ofsHeight + 8).get());
+    }
+    if ((_dirty & mcnk_dirty_mccv) && hasMCCV)
+    {
+      write_mccv(lADTFile.GetPointer<unsigned int>(lMCNK_Position + lMCNK_header->ofsMCCV + 8).get());
+    }
+    if (_dirty & mcnk_dirty_normals)
+    {
+      write_normals(lADTFile.GetPointer<char>(lMCNK_Position + lMCNK_header->ofsNormal + 8).get());
+    }
+
+    memcpy(_saved_mcnk.data(), lADTFile.GetPointer<char>(lMCNK_Position).get(), _saved_mcnk.size());
+
+    lADTFile.GetPointer<MCIN>(lMCIN_Position + 8)->mEntries[py * 16 + px].offset = lMCNK_Position;
+    lADTFile.GetPointer<MCIN>(lMCIN_Position + 8)->mEntries[py * 16 + px].size = _saved_mcnk.size();
+
+    lCurrentPosition += _saved_mcnk.size();
+    _dirty = 0;
+
+    return;
+  }
+
   lADTFile.Extend(8 + 0x80);  // This is only the size of the header. More chunks will increase the size.
   SetChunkHeader(lADTFile, lCurrentPosition, 'MCNK', lMCNK_Size);
   lADTFile.GetPointer<MCIN>(lMCIN_Position + 8)->mEntries[py * 16 + px].offset = lCurrentPosition; // check this
@@ -1223,10 +1423,7 @@ void MapChunk::save(util::sExtendableArray &lADTFile, int &lCurrentPosition, int
 
   lADTFile.GetPointer<MapChunkHeader>(lMCNK_Position + 8)->ofsHeight = lCurrentPosition - lMCNK_Position;
 
-  auto const lHeightmap = lADTFile.GetPointer<float>(lCurrentPosition + 8);
-
-  for (int i = 0; i < mapbufsize; ++i)
-    lHeightmap[i] = mVertices[i].y - mVertices[0].y;
+  write_heightmap(lADTFile.GetPointer<float>(lCurrentPosition + 8).get());
 
   lCurrentPosition += 8 + lMCVT_Size;
   lMCNK_Size += 8 + lMCVT_Size;
@@ -1240,14 +1437,7 @@ void MapChunk::save(util::sExtendableArray &lADTFile, int &lCurrentPosition, int
     SetChunkHeader(lADTFile, lCurrentPosition, 'MCCV', lMCCV_Size);
     lADTFile.GetPointer<MapChunkHeader>(lMCNK_Position + 8)->ofsMCCV = lCurrentPosition - lMCNK_Position;
 
-    auto const lmccv = lADTFile.GetPointer<unsigned int>(lCurrentPosition + 8);
-
-    for (int i = 0; i < mapbufsize; ++i)
-    {
-      lmccv[i] = (((unsigned char)(mccv[i].z * 127.0f) & 0xFF) <<  0)
-               + (((unsigned char)(mccv[i].y * 127.0f) & 0xFF) <<  8)
-               + (((unsigned char)(mccv[i].x * 127.0f) & 0xFF) << 16);
-    }
+    write_mccv(lADTFile.GetPointer<unsigned int>(lCurrentPosition + 8).get());
 
     lCurrentPosition += 8 + lMCCV_Size;
     lMCNK_Size += 8 + lMCCV_Size;
@@ -1265,14 +1455,7 @@ void MapChunk::save(util::sExtendableArray &lADTFile, int &lCurrentPosition, int
 
   lADTFile.GetPointer<MapChunkHeader>(lMCNK_Position + 8)->ofsNormal = lCurrentPosition - lMCNK_Position;
 
-  auto const lNormals = lADTFile.GetPointer<char>(lCurrentPosition + 8);
-
-  for (int i = 0; i < mapbufsize; ++i)
-  {
-    lNormals[i * 3 + 0] = static_cast<char>(mNormals[i].x * 127);
-    lNormals[i * 3 + 1] = static_cast<char>(mNormals[i].z * 127);
-    lNormals[i * 3 + 2] = static_cast<char>(mNormals[i].y * 127);
-  }
+  write_normals(lADTFile.GetPointer<char>(lCurrentPosition + 8).get());
 
   lCurrentPosition += 8 + lMCNR_Size;
   lMCNK_Size += 8 + lMCNR_Size;
@@ -1296,7 +1479,7 @@ void MapChunk::save(util::sExtendableArray &lADTFile, int &lCurrentPosition, int
   lADTFile.GetPointer<MapChunkHeader>(lMCNK_Position + 8)->ofsLayer = lCurrentPosition - lMCNK_Position;
   lADTFile.GetPointer<MapChunkHeader>(lMCNK_Position + 8)->nLayers = texture_set->num();
 
-  std::vector<std::vector<uint8_t>> alphamaps = texture_set->save_alpha(use_big_alphamap);
+  std::vector<std::vector<uint8_t>> alphamaps = texture_set->save_alpha(big_alphamap);
   int lMCAL_Size = 0;
 
   // MCLY data
@@ -1304,7 +1487,7 @@ void MapChunk::save(util::sExtendableArray &lADTFile, int &lCurrentPosition, int
   {
     auto const lLayer = lADTFile.GetPointer<ENTRY_MCLY>(lCurrentPosition + 8 + 0x10 * j);
 
-    lLayer->textureID = lTextures.find(texture_set->filename(j))->second;
+    lLayer->textureID = lTextureIDs[j];
     lLayer->flags = texture_set->flag(j);
     lLayer->ofsAlpha = lMCAL_Size;
     lLayer->effectID = texture_set->effect(j);
@@ -1329,36 +1512,6 @@ void MapChunk::save(util::sExtendableArray &lADTFile, int &lCurrentPosition, int
 
   // MCRF
   //        {
-  std::list<int> lDoodadIDs;
-  std::list<int> lObjectIDs;
-
-  math::vector_3d lChunkExtents[2];
-  lChunkExtents[0] = math::vector_3d(xbase, 0.0f, zbase);
-  lChunkExtents[1] = math::vector_3d(xbase + CHUNKSIZE, 0.0f, zbase + CHUNKSIZE);
-
-  // search all wmos that are inside this chunk
-  lID = 0;
-  for(auto const& wmo : lObjectInstances)
-  {
-    if (wmo.isInsideRect(lChunkExtents))
-    {
-      lObjectIDs.push_back(lID);
-    }
-
-    lID++;
-  }
-
-  // search all models that are inside this chunk
-  lID = 0;
-  for(auto const& model : lModelInstances)
-  {
-    if (model.isInsideRect (lChunkExtents))
-    {
-      lDoodadIDs.push_back(lID);
-    }
-    lID++;
-  }
-
   int lMCRF_Size = 4 * (lDoodadIDs.size() + lObjectIDs.size());
   lADTFile.Extend(8 + lMCRF_Size);
   SetChunkHeader(lADTFile, lCurrentPosition, 'MCRF', lMCRF_Size);
@@ -1371,15 +1524,15 @@ void MapChunk::save(util::sExtendableArray &lADTFile, int &lCurrentPosition, int
   auto const lReferences = lADTFile.GetPointer<int>(lCurrentPosition + 8);
 
   lID = 0;
-  for (std::list<int>::iterator it = lDoodadIDs.begin(); it != lDoodadIDs.end(); ++it)
+  for (int id : lDoodadIDs)
   {
-    lReferences[lID] = *it;
+    lReferences[lID] = id;
     lID++;
   }
 
-  for (std::list<int>::iterator it = lObjectIDs.begin(); it != lObjectIDs.end(); ++it)
+  for (int id : lObjectIDs)
   {
-    lReferences[lID] = *it;
+    lReferences[lID] = id;
     lID++;
   }
 
@@ -1449,136 +1602,50 @@ void MapChunk::save(util::sExtendableArray &lADTFile, int &lCurrentPosition, int
 
   lADTFile.GetPointer<sChunkHeader>(lMCNK_Position)->mSize = lMCNK_Size;
   lADTFile.GetPointer<MCIN>(lMCIN_Position + 8)->mEntries[py * 16 + px].size = lMCNK_Size + sizeof (sChunkHeader);
-}
-
-
-bool MapChunk::fixGapLeft(const MapChunk* chunk)
-{
-  if (!chunk)
-    return false;
-
-  bool changed = false;
-
-  for (size_t i = 0; i <= 136; i+= 17)
-  {
-    float h = chunk->mVertices[i + 8].y;
-    if (mVertices[i].y != h)
-    {
-      mVertices[i].y = h;
-      changed = true;
-    }
-  }
 
-  if (changed)
-  {
-    updateVerticesData();
-  }
-
-  return changed;
+  auto const lMCNK_Data = lADTFile.GetPointer<char>(lMCNK_Position);
+  _saved_mcnk.assign(lMCNK_Data.get(), lMCNK_Data.get() + lMCNK_Size + sizeof (sChunkHeader));
+  _saved_texture_ids = std::move(lTextureIDs);
+  _saved_doodad_refs = std::move(lDoodadIDs);
+  _saved_object_refs = std::move(lObjectIDs);
+  _saved_with_mccv = hasMCCV;
+  _dirty = 0;
 }
 
-bool MapChunk::fixGapAbove(const MapChunk* chunk)
-{
-  if (!chunk)
-    return false;
 
-  bool changed = false;
-
-  for (size_t i = 0; i < 9; i++)
-  {
-    float h = chunk->mVertices[i + 136].y;
-    if (mVertices[i].y != h)
-    {
-      mVertices[i].y = h;
-      changed = true;
-    }
-  }
-
-  if (changed)
-  {
-    updateVerticesData();
-  }
-
-  return changed;
-}
-
-
-void MapChunk::selectVertex(math::vector_3d const& pos, float radius, std::set<math::vector_3d*>& vertices)
+noggit::vertex_mask MapChunk::selectVertex(math::vector_3d const& pos, float radius) const
 {
+  noggit::vertex_mask vertices;
+
   if (misc::getShortestDist(pos.x, pos.z, xbase, zbase, CHUNKSIZE) > radius)
   {
-    return;
+    return vertices;
   }
 
   for (int i = 0; i < mapbufsize; ++i)
   {
-    if (misc::dist(pos.x, pos.z, mVertices[i].x, mVertices[i].z) <= radius)
-    {
-      vertices.emplace(&mVertices[i]);
-    }
+    vertices[i] = misc::dist(pos.x, pos.z, mVertices[i].x, mVertices[i].z) <= radius;
   }
+
+  return vertices;
 }
 
-void MapChunk::selectVertex(math::vector_3d const& pos1, math::vector_3d const& pos2, std::set<math::vector_3d*>& vertices)
+noggit::vertex_mask MapChunk::selectVertex(math::vector_3d const& pos1, math::vector_3d const& pos2) const
 {
+  noggit::vertex_mask vertices;
+
   for(int i = 0; i< mapbufsize; ++i)
   {
-    if(
-      pos1.x<=mVertices[i].x && pos2.x>=mVertices[i].x &&
-      pos1.z<=mVertices[i].z && pos2.z>=mVertices[i].z
-    )
-    {
-      vertices.emplace(&mVertices[i]);
-    }
+    vertices[i] = pos1.x <= mVertices[i].x && pos2.x >= mVertices[i].x
+               && pos1.z <= mVertices[i].z && pos2.z >= mVertices[i].z;
   }
-}
-
-void MapChunk::fixVertices(std::set<math::vector_3d*>& selected)
-{
-  std::vector<int> ids ={ 0, 1, 17, 18 };
-  // iterate through each "square" of vertices
-  for (int i = 0; i < 64; ++i)
-  {
-    int not_selected = 0, count = 0, mid_vertex = ids[0] + 9;
-    float h = 0.0f;
 
-    for (int& index : ids)
-    {
-      if (selected.find(&mVertices[index]) == selected.end())
-      {
-        not_selected = index;
-      }
-      else
-      {
-        count++;
-      }
-      h += mVertices[index].y;
-      index += (((i+1) % 8) == 0) ? 10 : 1;
-    }
-
-    if (count == 2)
-    {
-      mVertices[mid_vertex].y = h * 0.25f;
-    }
-    else if (count == 3)
-    {
-      mVertices[mid_vertex].y = (h - mVertices[not_selected].y) / 3.0f;
-    }
-  }
+  return vertices;
 }
 
-bool MapChunk::isBorderChunk(std::set<math::vector_3d*>& selected)
+noggit::vertex_mask MapChunk::fixVertices(noggit::vertex_mask const& selected)
 {
-  for (int i = 0; i < mapbufsize; ++i)
-  {
-    // border chunk if at least a vertex isn't selected
-    if (selected.find(&mVertices[i]) == selected.end())
-    {
-      return true;
-    }
-  }
-
-  return false;
+  return noggit::fix_cell_centers (mVertices, selected);
 }
 
 ChunkWater* MapChunk::liquid_chunk() const
@@ -12,12 +12,15 @@
 #include <noggit/map_enums.hpp>
 #include <noggit/texture_set.hpp>
 #include <noggit/tool_enums.hpp>
+#include <noggit/vertex_selection.hpp>
 #include <opengl/scoped.hpp>
 #include <opengl/texture.hpp>
 #include <util/sExtendableArray.hpp>
 
+#include <cstdint>
 #include <map>
 #include <memory>
+#include <vector>
 
 class MPQFile;
 namespace math
@@ -31,6 +34,19 @@ class ChunkWater;
 using StripType = uint16_t;
 static const int mapbufsize = 9 * 9 + 8 * 8; // chunk size
 
+//! parts of a MCNK changed since it was last saved. MCLY/MCAL changes are
+//! tracked by the TextureSet and MCRF is compared against the tile's
+//! instance lists on save, liquids are saved in the tile's MH2O.
+enum mcnk_dirty_flags : std::uint32_t
+{
+  mcnk_dirty_height = 0x1,
+  mcnk_dirty_normals = 0x2,
+  mcnk_dirty_mccv = 0x4,
+  mcnk_dirty_shadow = 0x8,
+  mcnk_dirty_header = 0x10, // flags, holes, area id
+  mcnk_dirty_all = 0x1F,
+};
+
 class MapChunk
 {
 private:
@@ -60,8 +76,6 @@ private:
   int indexNoLoD(int z, int x);
   int indexLoD(int z, int x);
 
-  std::vector<math::vector_3d> _intersect_points;
-
   void update_intersect_points();
 
   boost::optional<int> get_lod_level( math::vector_3d const& camera_pos
@@ -86,6 +100,19 @@ private:
   GLuint const& _mccv_vbo = _buffers[3];
   opengl::scoped::deferred_upload_buffers<4> lod_indices;
 
+  std::uint32_t _dirty = mcnk_dirty_all;
+  //! the MCNK as written by the last save(), spliced back in by the next
+  //! one with only the dirty fixed size parts rewritten
+  std::vector<char> _saved_mcnk;
+  std::vector<int> _saved_texture_ids;
+  std::vector<int> _saved_doodad_refs;
+  std::vector<int> _saved_object_refs;
+  bool _saved_with_mccv = false;
+
+  void write_heightmap(float* heightmap) const;
+  void write_mccv(unsigned int* mccv_data) const;
+  void write_normals(char* normals) const;
+
 public:
   MapChunk(MapTile* mt, MPQFile* f, bool bigAlpha, tile_mode mode);
 
@@ -98,7 +125,6 @@ public:
   float xbase, ybase, zbase;
 
   mcnk_flags header_flags;
-  bool use_big_alphamap;
 
   std::unique_ptr<TextureSet> texture_set;
 
@@ -111,12 +137,23 @@ public:
                   , const math::vector_3d& camera
                   , display_mode display
                   ) const;
+
+  //! \note in_frustum comes from MapTile culling all its chunks at once
+  void update_visibility ( bool in_frustum
+                         , const float& cull_distance
+                         , const math::vector_3d& camera
+                         , display_mode display
+                         );
 private:
   void update_visibility ( const float& cull_distance
                          , const math::frustum& frustum
                          , const math::vector_3d& camera
                          , display_mode display
                          );
+  bool in_cull_distance ( const float& cull_distance
+                        , const math::vector_3d& camera
+                        , display_mode display
+                        ) const;
 
   bool _is_visible = true; // visible by default
   bool _need_visibility_update = true;
@@ -155,7 +192,18 @@ public:
   ChunkWater* liquid_chunk() const;
 
   void updateVerticesData();
+  //! updateVerticesData() uploading only the range of the changed vertices
+  void updateVerticesData (noggit::vertex_mask const& changed);
   void recalcNorms (std::function<boost::optional<float> (float, float)> height);
+  //! recalcNorms() without the upload, so it can run for many chunks in
+  //! parallel as long as their heights don't change meanwhile
+  void compute_normals (std::function<boost::optional<float> (float, float)> const& height);
+  //! computes the normals of the given vertices only
+  void compute_normals ( std::function<boost::optional<float> (float, float)> const& height
+                       , noggit::vertex_mask const& vertices
+                       );
+  void upload_normals();
+  void upload_normals (noggit::vertex_mask const& changed);
 
   //! \todo implement Action stack for these
   bool changeTerrain(math::vector_3d const& pos, float change, float radius, int BrushType, float inner_radius);
@@ -164,10 +212,9 @@ public:
                    , std::function<boost::optional<float> (float, float)> height
                    );
 
-  void selectVertex(math::vector_3d const& pos, float radius, std::set<math::vector_3d*>& vertices);
-  void fixVertices(std::set<math::vector_3d*>& selected);
-  // for the vertex tool
-  bool isBorderChunk(std::set<math::vector_3d*>& selected);
+  noggit::vertex_mask selectVertex(math::vector_3d const& pos, float radius) const;
+  //! see noggit::fix_cell_centers(), returns the vertices it moved
+  noggit::vertex_mask fixVertices(noggit::vertex_mask const& selected);
 
   //! \todo implement Action stack for these
   bool paintTexture(math::vector_3d const& pos, Brush *brush, float strength, float pressure, scoped_blp_texture_reference texture);
@@ -197,12 +244,7 @@ public:
   void clearHeight();
 
   //! \todo this is ugly create a build struct or sth
-  void save(util::sExtendableArray &lADTFile, int &lCurrentPosition, int &lMCIN_Position, std::map<std::string, int> &lTextures, std::vector<WMOInstance> &lObjectInstances, std::vector<ModelInstance>& lModelInstances);
-
-  // fix the gaps with the chunk to the left
-  bool fixGapLeft(const MapChunk* chunk);
-  // fix the gaps with the chunk above
-  bool fixGapAbove(const MapChunk* chunk);
+  void save(util::sExtendableArray &lADTFile, int &lCurrentPosition, int &lMCIN_Position, std::map<std::string, int> &lTextures, std::vector<WMOInstance> &lObjectInstances, std::vector<ModelInstance>& lModelInstances, bool big_alphamap);
 
-  void selectVertex(math::vector_3d const& minPos, math::vector_3d const& maxPos, std::set<math::vector_3d*>& vertices);
+  noggit::vertex_mask selectVertex(math::vector_3d const& minPos, math::vector_3d const& maxPos) const;
 };
@@ -11,6 +11,7 @@
 #include <noggit/World.h>
 #include <noggit/alphamap.hpp>
 #include <noggit/map_index.hpp>
+#include <noggit/parallel_for.hpp>
 #include <noggit/texture_set.hpp>
 #include <opengl/scoped.hpp>
 #include <opengl/shader.hpp>
@@ -19,9 +20,12 @@
 #include <QtCore/QSettings>
 
 #include <algorithm>
+#include <array>
 #include <cassert>
+#include <cstdint>
 #include <list>
 #include <map>
+#include <memory>
 #include <string>
 #include <utility>
 #include <vector>
@@ -41,6 +45,7 @@ MapTile::MapTile( int pX
   , xbase(pX * TILESIZE)
   , zbase(pZ * TILESIZE)
   , changed(false)
+  , horizon_outdated(false)
   , Water (this, xbase, zbase, use_mclq_green_lava)
   , _mode(mode)
   , _tile_is_being_reloaded(reloading_tile)
@@ -55,11 +60,30 @@ MapTile::~MapTile()
   _world->remove_models_if_needed(uids);
 }
 
+void MapTile::load_from(std::vector<char> adt)
+{
+  _adt_data = std::move(adt);
+}
+
 void MapTile::finishLoading()
 {
-  MPQFile theFile(filename);
+  bool const from_memory (!_adt_data.empty());
+  std::unique_ptr<MPQFile> const file
+    ( from_memory
+    ? std::make_unique<MPQFile> (_adt_data.data(), _adt_data.size())
+    : std::make_unique<MPQFile> (filename)
+    );
+  MPQFile& theFile (*file);
+
+  NOGGIT_LOG << "Opening tile " << index.x << ", " << index.z << " (\"" << filename << "\") from " << (from_memory ? "memory" : theFile.isExternal() ? "disk" : "MPQ") << "." << std::endl;
 
-  NOGGIT_LOG << "Opening tile " << index.x << ", " << index.z << " (\"" << filename << "\") from " << (theFile.isExternal() ? "disk" : "MPQ") << "." << std::endl;
+  if (from_memory)
+  {
+    // the data is unsaved, keep the tile marked until it is saved. The
+    // horizon was queued when the tile was parked.
+    std::vector<char>().swap(_adt_data);
+    changed = true;
+  }
 
   // - Parsing the file itself. --------------------------
 
@@ -299,20 +323,53 @@ void MapTile::finishLoading()
 
   // - Load chunks ---------------------------------------
 
+  // every chunk gets a copy of its bytes, up to the next chunk in the file,
+  // so that they can be parsed in parallel with their own read position
+  std::array<std::uint32_t, 256> sorted_offsets;
+  std::copy (std::begin (lMCNKOffsets), std::end (lMCNKOffsets), sorted_offsets.begin());
+  std::sort (sorted_offsets.begin(), sorted_offsets.end());
+
+  std::vector<std::unique_ptr<MPQFile>> chunk_files;
+  chunk_files.reserve (256);
+
   for (int nextChunk = 0; nextChunk < 256; ++nextChunk)
   {
-    theFile.seek(lMCNKOffsets[nextChunk]);
-    mChunks[nextChunk / 16][nextChunk % 16] = std::make_unique<MapChunk> (this, &theFile, mBigAlpha, _mode);
+    std::size_t const begin (std::min<std::size_t> (lMCNKOffsets[nextChunk], theFile.getSize()));
+    auto const next (std::upper_bound (sorted_offsets.begin(), sorted_offsets.end(), lMCNKOffsets[nextChunk]));
+    std::size_t const end
+      (next == sorted_offsets.end() ? theFile.getSize() : std::min<std::size_t> (*next, theFile.getSize()));
+
+    chunk_files.emplace_back (std::make_unique<MPQFile> (theFile.getBuffer() + begin, end - begin));
   }
 
   theFile.close();
 
+  noggit::parallel_for
+    ( 256
+    , [&] (std::size_t nextChunk)
+      {
+        mChunks[nextChunk / 16][nextChunk % 16] = std::make_unique<MapChunk> (this, chunk_files[nextChunk].get(), mBigAlpha || from_memory, _mode);
+        chunk_files[nextChunk].reset();
+      }
+    );
+
   // - Really done. --------------------------------------
 
   LogDebug << "Done loading tile " << index.x << "," << index.z << "." << std::endl;
   finished = true;
   _tile_is_being_reloaded = false;
   _state_changed.notify_all();
+
+  // the uid fix loads tiles on its own, they aren't part of the index
+  if (_mode == tile_mode::edit)
+  {
+    _world->mapIndex.tile_finished_loading (*this);
+  }
+}
+
+void MapTile::set_changed()
+{
+  _world->mapIndex.setChanged (this);
 }
 
 bool MapTile::isTile(int pX, int pZ)
@@ -332,14 +389,8 @@ float MapTile::getMaxHeight()
 
 void MapTile::convert_alphamap(bool to_big_alpha)
 {
-  mBigAlpha = true;
-  for (size_t i = 0; i < 16; i++)
-  {
-    for (size_t j = 0; j < 16; j++)
-    {
-      mChunks[i][j]->use_big_alphamap = to_big_alpha;
-    }
-  }
+  // the alphamaps always are big in memory, only the saved format changes
+  mBigAlpha = to_big_alpha;
 }
 
 void MapTile::draw ( math::frustum const& frustum
@@ -366,6 +417,31 @@ void MapTile::draw ( math::frustum const& frustum
     return;
   }
 
+  // cull all the chunks at once instead of one box at a time
+  if (need_visibility_update)
+  {
+    std::array<std::array<math::vector_3d, 2>, 256> boxes;
+    bool in_frustum[256];
+
+    for (int j = 0; j < 16; ++j)
+    {
+      for (int i = 0; i < 16; ++i)
+      {
+        boxes[j * 16 + i] = {mChunks[j][i]->vmin, mChunks[j][i]->vmax};
+      }
+    }
+
+    frustum.intersects (boxes.data(), boxes.size(), in_frustum);
+
+    for (int j = 0; j < 16; ++j)
+    {
+      for (int i = 0; i < 16; ++i)
+      {
+        mChunks[j][i]->update_visibility (in_frustum[j * 16 + i], cull_distance, camera, display);
+      }
+    }
+  }
+
   for (int j = 0; j<16; ++j)
   {
     for (int i = 0; i<16; ++i)
@@ -375,7 +451,7 @@ void MapTile::draw ( math::frustum const& frustum
                           , tex_coord_vbo
                           , cull_distance
                           , camera
-                          , need_visibility_update
+                          , false
                           , show_unpaintable_chunks
                           , draw_paintability_overlay
                           , draw_chunk_flag_overlay
@@ -462,8 +538,6 @@ void MapTile::drawWater ( math::frustum const& frustum
                         , const math::vector_3d& camera
                         , bool camera_moved
                         , liquid_render& render
-                        , opengl::scoped::use_program& water_shader
-                        , int animtime
                         , int layer
                         , display_mode display
                         )
@@ -478,8 +552,6 @@ void MapTile::drawWater ( math::frustum const& frustum
              , camera
              , camera_moved
              , render
-             , water_shader
-             , animtime
              , layer
              , display
              );
@@ -552,6 +624,13 @@ void MapTile::saveTile(World* world)
 {
   NOGGIT_LOG << "Saving ADT \"" << filename << "\"." << std::endl;
 
+  MPQFile f(filename);
+  f.setBuffer(write_adt(world, mBigAlpha));
+  f.SaveFile();
+}
+
+std::vector<char> MapTile::write_adt(World* world, bool big_alpha)
+{
   int lID;  // This is a global counting variable. Do not store something in here you need later.
   std::vector<WMOInstance> lObjectInstances;
   std::vector<ModelInstance> lModelInstances;
@@ -864,7 +943,7 @@ void MapTile::saveTile(World* world)
   {
     for (int x = 0; x < 16; ++x)
     {
-      mChunks[y][x]->save(lADTFile, lCurrentPosition, lMCIN_Position, lTextures, lObjectInstances, lModelInstances);
+      mChunks[y][x]->save(lADTFile, lCurrentPosition, lMCIN_Position, lTextures, lObjectInstances, lModelInstances, big_alpha);
     }
   }
 
@@ -910,17 +989,9 @@ void MapTile::saveTile(World* world)
   }
 #endif
 
-  {
-    MPQFile f(filename);
-    // \todo This sounds wrong. There shouldn't *be* unused nulls to
-    // begin with.
-    f.setBuffer(lADTFile.data_up_to (lCurrentPosition)); // cleaning unused nulls at the end of file
-    f.SaveFile();
-  }
-
-  lObjectInstances.clear();
-  lModelInstances.clear();
-  lModels.clear();
+  // \todo This sounds wrong. There shouldn't *be* unused nulls to
+  // begin with.
+  return lADTFile.data_up_to (lCurrentPosition); // cleaning unused nulls at the end of file
 }
 
 
@@ -956,3 +1027,26 @@ void MapTile::add_model(uint32_t uid)
     uids.push_back(uid);
   }
 }
+
+void MapTile::update_models(std::vector<uint32_t> const& removed, std::vector<uint32_t> const& added)
+{
+  std::lock_guard<std::mutex> const lock(_mutex);
+
+  for (uint32_t uid : removed)
+  {
+    auto it = std::find(uids.begin(), uids.end(), uid);
+
+    if (it != uids.end())
+    {
+      uids.erase(it);
+    }
+  }
+
+  for (uint32_t uid : added)
+  {
+    if (std::find(uids.begin(), uids.end(), uid) == uids.end())
+    {
+      uids.push_back(uid);
+    }
+  }
+}
@@ -72,6 +72,10 @@ public:
   float xbase, zbase;
 
   std::atomic<bool> changed;
+  //! sets changed through the map index, which tracks it for the minimap
+  void set_changed();
+  //! heights were edited since the horizon was last regenerated
+  std::atomic<bool> horizon_outdated;
 
   void draw ( math::frustum const& frustum
             , opengl::scoped::use_program& mcnk_shader
@@ -97,8 +101,6 @@ public:
                  , const math::vector_3d& camera
                  , bool camera_moved
                  , liquid_render& render
-                 , opengl::scoped::use_program& water_shader
-                 , int animtime
                  , int layer
                  , display_mode display
                  );
@@ -108,6 +110,13 @@ public:
   bool GetVertex(float x, float z, math::vector_3d *V);
 
   void saveTile(World*);
+  //! the ADT saveTile() writes, without writing it, with big or old
+  //! alphamaps whatever the map uses
+  std::vector<char> write_adt(World*, bool big_alpha);
+  //! loads the given ADT instead of the file, e.g. the one of a parked
+  //! tile, and keeps the tile marked as changed. Call before loading. The
+  //! ADT has to use big alphamaps, see MapIndex::park_tile().
+  void load_from(std::vector<char> adt);
 	void CropWater();
 
   bool isTile(int pX, int pZ);
@@ -124,6 +133,8 @@ public:
 
   void remove_model(uint32_t uid);
   void add_model(uint32_t uid);
+  //! removes then adds, same result as calling the above one by one
+  void update_models(std::vector<uint32_t> const& removed, std::vector<uint32_t> const& added);
 
   TileWater Water;
 
@@ -162,6 +173,9 @@ private:
   bool _load_models;
   World* _world;
 
+  //! set by load_from(), released once loaded
+  std::vector<char> _adt_data;
+
   friend class MapChunk;
   friend class TextureSet;
 };
@@ -13,7 +13,9 @@
 #include <noggit/WMOInstance.h> // WMOInstance
 #include <noggit/World.h>
 #include <noggit/map_index.hpp>
+#include <noggit/settings_snapshot.hpp>
 #include <noggit/uid_storage.hpp>
+#include <noggit/upload_scheduler.hpp>
 #include <noggit/ui/CurrentTexture.h>
 #include <noggit/ui/CursorSwitcher.h> // cursor_switcher
 #include <noggit/ui/DetailInfos.h> // detailInfos
@@ -52,6 +54,7 @@
 #include <QtWidgets/QApplication>
 #include <QtWidgets/QMenuBar>
 #include <QtWidgets/QMessageBox>
+#include <QtWidgets/QProgressDialog>
 #include <QtWidgets/QPushButton>
 #include <QtWidgets/QStatusBar>
 #include <QtWidgets/QComboBox>
@@ -132,6 +135,67 @@ void MapView::setToolPropertyWidgetVisibility(editing_mode mode)
   }
 }
 
+void MapView::convert_alphamap (bool to_big_alpha)
+{
+  makeCurrent();
+  opengl::context::scoped_setter const _ (::gl, context());
+
+  QProgressDialog progress ( to_big_alpha ? "Converting the map to big alpha..." : "Converting the map to old alpha..."
+                           , "Cancel"
+                           , 0
+                           , 0
+                           , this
+                           );
+  progress.setWindowModality (Qt::WindowModal);
+  progress.setMinimumDuration (0);
+
+  _batch_operation_running = true;
+
+  bool converted (false);
+  boost::optional<std::string> error;
+  try
+  {
+    converted = _world->convert_alphamap
+      ( to_big_alpha
+      , [&] (std::size_t done, std::size_t total)
+        {
+          progress.setMaximum (static_cast<int> (total));
+          progress.setValue (static_cast<int> (done));
+          return !progress.wasCanceled();
+        }
+      );
+  }
+  catch (std::exception const& e)
+  {
+    error = e.what();
+  }
+  catch (...)
+  {
+    error = "unknown error";
+  }
+
+  _batch_operation_running = false;
+
+  if (error)
+  {
+    LogError << "Alphamap conversion failed: " << *error << std::endl;
+    QMessageBox::critical ( this
+                          , "Alphamap conversion failed"
+                          , QString ("The conversion failed, the tiles converted so far were reverted.\n\n%1")
+                              .arg (QString::fromStdString (*error))
+                          );
+    return;
+  }
+
+  if (!converted)
+  {
+    QMessageBox::information ( this
+                             , "Alphamap conversion cancelled"
+                             , "The conversion was cancelled, the tiles converted so far were reverted."
+                             );
+  }
+}
+
 void MapView::ResetSelectedObjectRotation()
 {
   for (auto& selection : _world->current_selection())
@@ -650,18 +714,14 @@ void MapView::createGUI()
                 , "Map to big alpha"
                 , [this]
                   {
-                    makeCurrent();
-                    opengl::context::scoped_setter const _ (::gl, context());
-                    _world->convert_alphamap(true);
+                    convert_alphamap (true);
                   }
                 );
   ADD_ACTION_NS ( assist_menu
                 , "Map to old alpha"
                 , [this]
                   {
-                    makeCurrent();
-                    opengl::context::scoped_setter const _ (::gl, context());
-                    _world->convert_alphamap(false);
+                    convert_alphamap (false);
                   }
                 );
 
@@ -1531,11 +1591,19 @@ void MapView::initializeGL()
 
 void MapView::paintGL()
 {
+  if (_batch_operation_running)
+  {
+    return;
+  }
+
   opengl::context::scoped_setter const _ (::gl, context());
   const qreal now(_startup_time.elapsed() / 1000.0);
 
   _last_frame_durations.emplace_back (now - _last_update);
 
+  // textures decoded by the loader threads, a few megabytes per frame
+  noggit::upload_scheduler::instance().run_frame();
+
   gl.clear (GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
   draw_map();
@@ -1625,7 +1693,7 @@ void MapView::tick (float dt)
     update_cursor_pos();
   }
 
-  if (_tablet_active && _settings->value ("tablet/enabled", false).toBool())
+  if (_tablet_active && noggit::current_settings().tablet_enabled)
   {
     switch (terrainMode)
     {
@@ -1753,13 +1821,15 @@ void MapView::tick (float dt)
             {
 	      float minX = 0, maxX = 0, minY = 0, maxY = 0, minZ = 0, maxZ = 0;
 
-	      if (_settings->value("model/random_rotation", false).toBool())
+	      noggit::settings_snapshot const& settings (noggit::current_settings());
+
+	      if (settings.model_random_rotation)
 	      {
 		minY = _object_paste_params.minRotation;
 		maxY = _object_paste_params.maxRotation;
 	      }
 
-	      if (_settings->value("model/random_tilt", false).toBool())
+	      if (settings.model_random_tilt)
 	      {
 		minX = _object_paste_params.minTilt;
 		maxX = _object_paste_params.maxTilt;
@@ -1769,7 +1839,7 @@ void MapView::tick (float dt)
 
 	      _world->rotate_selected_models_randomly (minX, maxX, minY, maxY, minZ, maxZ);
 
-	      if (_settings->value("model/random_size", false).toBool())
+	      if (settings.model_random_size)
 	      {
 		float min = _object_paste_params.minScale;
 		float max = _object_paste_params.maxScale;
@@ -2097,7 +2167,7 @@ void MapView::tick (float dt)
              << std::setw (2) << (time % 60);
 
 
-    if (_tablet_active && _settings->value ("tablet/enabled", false).toBool())
+    if (_tablet_active && noggit::current_settings().tablet_enabled)
     {
       timestrs << ", Pres: " << _tablet_pressure;
     }
@@ -2117,8 +2187,13 @@ void MapView::tick (float dt)
                         )
       / qreal (_last_frame_durations.size())
       );
+    auto const& uploads (noggit::upload_scheduler::instance().last_frame());
     _status_fps->setText ( "FPS: " + QString::number (int (1. / avg_frame_duration)) 
                          + " - Average frame time: " + QString::number(avg_frame_duration*1000.0) + "ms"
+                         + ( uploads.queue_depth
+                           ? " - Pending uploads: " + QString::number (uploads.queue_depth)
+                           : QString()
+                           )
                          );
 
     _last_frame_durations.clear();
@@ -2224,8 +2299,8 @@ void MapView::tick (float dt)
                   select_info << "\nliquid type: " << liquid._liquid_id << " (\"" << gLiquidTypeDB.getLiquidName(liquid._liquid_id) << "\")"
                               << "\nliquid flags: "
                                 // getting flags from the center tile
-                              << ((liquid_render.fishable >> (4 * 8 + 4)) & 1 ? "fishable " : "")
-                              << ((liquid_render.fatigue >> (4 * 8 + 4)) & 1 ? "fatigue" : "");
+                              << ((liquid_render.fishable >> (4 * 8 + 4)) & 1 ? "fishable " : "")
+                              << ((liquid_render.fatigue >> (4 * 8 + 4)) & 1 ? "fatigue" : "");
 
               }
           }
@@ -2389,7 +2464,7 @@ math::matrix_4x4 MapView::model_view() const
 }
 math::matrix_4x4 MapView::projection() const
 {
-  float far_z = _settings->value("farZ", 2048).toFloat();
+  float far_z = noggit::current_settings().far_z;
 
   if (_display_mode == display_mode::in_2D)
   {
@@ -130,6 +130,7 @@ private:
   float mTimespeed;
 
   void ResetSelectedObjectRotation();
+  void convert_alphamap (bool to_big_alpha);
   void snap_selected_models_to_the_ground();
   void DeleteSelectedObject();
   void changeZoneIDValue (int set);
@@ -173,6 +174,8 @@ private:
   bool _from_bookmark;
 
   bool Saving = false;
+  //! tiles are modified by other threads, don't draw or load/unload any
+  bool _batch_operation_running = false;
 
   noggit::ui::toolbar* _toolbar;
 
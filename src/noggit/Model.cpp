@@ -13,6 +13,7 @@
 #include <algorithm>
 #include <cassert>
 #include <map>
+#include <memory>
 #include <sstream>
 #include <string>
 
@@ -1085,6 +1086,7 @@ void Model::animate(math::matrix_4x4 const& model_view, int anim_id, int anim_ti
     if (_current_vertices.empty())
     {
       _current_vertices = _vertices;
+      _bvh_needs_refit = true;
 
       opengl::scoped::buffer_binder<GL_ARRAY_BUFFER> const binder(_vertices_buffer);
       gl.bufferData(GL_ARRAY_BUFFER, _current_vertices.size() * sizeof(ModelVertex), _current_vertices.data(), GL_STATIC_DRAW);
@@ -1145,6 +1147,8 @@ void Model::animate(math::matrix_4x4 const& model_view, int anim_id, int anim_ti
       vertex.normal = n.normalized();
     }
 
+    _bvh_needs_refit = true;
+
     opengl::scoped::buffer_binder<GL_ARRAY_BUFFER> const binder (_vertices_buffer);
     gl.bufferData (GL_ARRAY_BUFFER, _current_vertices.size() * sizeof (ModelVertex), _current_vertices.data(), GL_STREAM_DRAW);
   }
@@ -1441,14 +1445,29 @@ void Model::draw ( math::matrix_4x4 const& model_view
     animcalc = true;
   }
 
-  std::vector<math::matrix_4x4> transform_matrix;
+  std::vector<ModelInstance*> in_range;
+  std::vector<math::vector_4d> spheres;
 
   for (ModelInstance* mi : instances)
   {
-    if (mi->is_visible(frustum, cull_distance, camera, display))
+    if (mi->in_view_distance(cull_distance, camera, display))
     {
-      transform_matrix.push_back(mi->transform_matrix_transposed());
-    }    
+      in_range.push_back(mi);
+      spheres.emplace_back(mi->get_pos(), rad * mi->scale);
+    }
+  }
+
+  std::unique_ptr<bool[]> in_frustum(new bool[spheres.size()]);
+  frustum.intersects_spheres(spheres.data(), spheres.size(), in_frustum.get());
+
+  std::vector<math::matrix_4x4> transform_matrix;
+
+  for (std::size_t i = 0; i < in_range.size(); ++i)
+  {
+    if (in_frustum[i])
+    {
+      transform_matrix.push_back(in_range[i]->transform_matrix_transposed());
+    }
   }
 
   if (transform_matrix.empty())
@@ -1544,49 +1563,65 @@ std::vector<float> Model::intersect (math::matrix_4x4 const& model_view, math::r
     return results;
   }
 
-  if (animated && (!animcalc || _per_instance_animation))
+  // every instance is drawn and picked with the same view and time, so the
+  // geometry animated once this frame is the one on screen for all of them:
+  // animating again per instance would only refit the tree per instance
+  if (animated && !animcalc)
   {
     animate (model_view, 0, animtime);
     animcalc = true;
   }
 
-  if (use_fake_geometry())
+  if (!_bvh)
   {
-    auto& fake_geom = _fake_geometry.get();
+    std::vector<std::uint32_t> indices;
 
-    for (size_t i = 0; i < fake_geom.indices.size(); i += 3)
+    if (use_fake_geometry())
     {
-      if (auto distance
-        = ray.intersect_triangle(fake_geom.vertices[fake_geom.indices[i + 0]],
-          fake_geom.vertices[fake_geom.indices[i + 1]],
-          fake_geom.vertices[fake_geom.indices[i + 2]])
-        )
+      auto const& fake_geom = _fake_geometry.get();
+      indices.assign (fake_geom.indices.begin(), fake_geom.indices.end());
+    }
+    else
+    {
+      for (auto&& pass : _render_passes)
       {
-        results.emplace_back (*distance);
+        indices.insert ( indices.end()
+                       , _indices.begin() + pass.index_start
+                       , _indices.begin() + pass.index_start + pass.index_count
+                       );
       }
     }
 
-    return results;
+    _bvh = std::make_unique<math::triangle_bvh> (pickable_positions(), indices);
+    _bvh_needs_refit = false;
   }
-
-  for (auto&& pass : _render_passes)
+  else if (_bvh_needs_refit && !use_fake_geometry())
   {
-    for (size_t i (pass.index_start); i < pass.index_start + pass.index_count; i += 3)
-    {
-      if ( auto distance
-          = ray.intersect_triangle( _current_vertices[_indices[i + 0]].position,
-                                    _current_vertices[_indices[i + 1]].position,
-                                    _current_vertices[_indices[i + 2]].position)
-          )
-      {
-        results.emplace_back (*distance);
-      }
-    }
+    _bvh->refit (pickable_positions());
+    _bvh_needs_refit = false;
   }
 
+  _bvh->intersect (ray, results);
+
   return results;
 }
 
+std::vector<math::vector_3d> Model::pickable_positions() const
+{
+  if (use_fake_geometry())
+  {
+    return _fake_geometry.get().vertices;
+  }
+
+  std::vector<math::vector_3d> positions;
+  positions.reserve (_current_vertices.size());
+  for (auto const& vertex : _current_vertices)
+  {
+    positions.emplace_back (vertex.position);
+  }
+  return positions;
+}
+
 void Model::lightsOn(opengl::light lbase)
 {
   // setup lights
@@ -6,6 +6,7 @@
 #include <math/matrix_4x4.hpp>
 #include <math/quaternion.hpp>
 #include <math/ray.hpp>
+#include <math/triangle_bvh.hpp>
 #include <math/vector_3d.hpp>
 #include <noggit/Animated.h> // Animation::M2Value
 #include <noggit/AsyncObject.h> // AsyncObject
@@ -17,6 +18,7 @@
 #include <opengl/scoped.hpp>
 #include <opengl/shader.fwd.hpp>
 
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -311,6 +313,8 @@ private:
   void lightsOn(opengl::light lbase);
   void lightsOff(opengl::light lbase);
 
+  std::vector<math::vector_3d> pickable_positions() const;
+
   void upload();
 
   bool _finished_upload;
@@ -340,6 +344,13 @@ private:
   std::vector<ModelRenderPass> _render_passes;
   boost::optional<FakeGeometry> _fake_geometry;
 
+  //! picking geometry in model space, built on the first intersect() and
+  //! shared by all instances
+  std::unique_ptr<math::triangle_bvh> _bvh;
+  //! set when animate() changed _current_vertices, the tree is refitted
+  //! by the next intersect(), so at most once per frame
+  bool _bvh_needs_refit = false;
+
   // ===============================
   // Animation
   // ===============================
@@ -7,7 +7,7 @@
 #include <noggit/Model.h> // Model, etc.
 #include <noggit/ModelInstance.h>
 #include <noggit/WMOInstance.h>
-#include <opengl/primitives.hpp>
+#include <opengl/debug_geometry.hpp>
 #include <opengl/scoped.hpp>
 #include <opengl/shader.hpp>
 
@@ -46,49 +46,35 @@ bool ModelInstance::is_a_duplicate_of(ModelInstance const& other)
       && misc::float_equals(scale, other.scale);
 }
 
-void ModelInstance::draw_box ( math::matrix_4x4 const& model_view
-                             , math::matrix_4x4 const& projection
+void ModelInstance::draw_box ( opengl::debug_geometry& debug_geometry
                              , bool is_current_selection
                              )
 {
-  gl.enable(GL_BLEND);
-  gl.blendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+  math::matrix_4x4 const transform (_transform_mat_transposed.transposed());
 
   if (is_current_selection)
   {
-    opengl::primitives::wire_box ( misc::transform_model_box_coords(model->header.collision_box_min)
-                                 , misc::transform_model_box_coords(model->header.collision_box_max)
-                                 ).draw ( model_view
-                                        , projection
-                                        , transform_matrix_transposed()
-                                        , { 1.0f, 1.0f, 0.0f, 1.0f }
-                                        );
-
-    opengl::primitives::wire_box ( misc::transform_model_box_coords(model->header.bounding_box_min)
-                                 , misc::transform_model_box_coords(model->header.bounding_box_max)
-                                 ).draw ( model_view
-                                        , projection
-                                        , transform_matrix_transposed()
-                                        , {1.0f, 1.0f, 1.0f, 1.0f}
-                                        );
-
-    opengl::primitives::wire_box ( _extents[0]
-                                 , _extents[1]
-                                 ).draw ( model_view
-                                        , projection
-                                        , math::matrix_4x4(math::matrix_4x4::unit)
-                                        , {0.0f, 1.0f, 0.0f, 1.0f}
-                                        );
+    debug_geometry.add_box ( misc::transform_model_box_coords(model->header.collision_box_min)
+                           , misc::transform_model_box_coords(model->header.collision_box_max)
+                           , {1.0f, 1.0f, 0.0f, 1.0f}
+                           , transform
+                           );
+
+    debug_geometry.add_box ( misc::transform_model_box_coords(model->header.bounding_box_min)
+                           , misc::transform_model_box_coords(model->header.bounding_box_max)
+                           , {1.0f, 1.0f, 1.0f, 1.0f}
+                           , transform
+                           );
+
+    debug_geometry.add_box (_extents[0], _extents[1], {0.0f, 1.0f, 0.0f, 1.0f});
   }
   else
   {
-    opengl::primitives::wire_box ( misc::transform_model_box_coords(model->header.bounding_box_min)
-                                 , misc::transform_model_box_coords(model->header.bounding_box_max)
-                                 ).draw ( model_view
-                                        , projection
-                                        , transform_matrix_transposed()
-                                        , {0.5f, 0.5f, 0.5f, 1.0f}
-                                        );
+    debug_geometry.add_box ( misc::transform_model_box_coords(model->header.bounding_box_min)
+                           , misc::transform_model_box_coords(model->header.bounding_box_max)
+                           , {0.5f, 0.5f, 0.5f, 1.0f}
+                           , transform
+                           );
   }
 }
 
@@ -148,6 +134,15 @@ bool ModelInstance::is_visible( math::frustum const& frustum
                               , const math::vector_3d& camera
                               , display_mode display
                               )
+{
+  return in_view_distance(cull_distance, camera, display)
+      && frustum.intersectsSphere(get_pos(), model->rad * scale);
+}
+
+bool ModelInstance::in_view_distance( const float& cull_distance
+                                    , const math::vector_3d& camera
+                                    , display_mode display
+                                    )
 {
   if (_need_recalc_extents && model->finishedLoading())
   {
@@ -182,8 +177,8 @@ bool ModelInstance::is_visible( math::frustum const& frustum
   {
     return false;
   }
-  
-  return frustum.intersectsSphere(get_pos(), model->rad * scale);
+
+  return true;
 }
 
 void ModelInstance::recalcExtents()
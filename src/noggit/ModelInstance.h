@@ -8,11 +8,13 @@
 #include <noggit/MapHeaders.h> // ENTRY_MDDF
 #include <noggit/ModelManager.h>
 #include <noggit/Selection.h>
+#include <noggit/selection_set.hpp>
 #include <noggit/tile_index.hpp>
 #include <noggit/tool_enums.hpp>
 #include <opengl/shader.fwd.hpp>
 
 namespace math { class frustum; }
+namespace opengl { class debug_geometry; }
 class Model;
 class WMOInstance;
 
@@ -37,6 +39,9 @@ public:
   // longest side of an AABB transformed model's bounding box from the M2 header
   float size_cat;
 
+  //! maintained by the world's selection
+  noggit::selection_flag selected;
+
   explicit ModelInstance(std::string const& filename);
   explicit ModelInstance(std::string const& filename, ENTRY_MDDF const*d);
 
@@ -75,8 +80,7 @@ public:
 
   bool is_a_duplicate_of(ModelInstance const& other);
 
-  void draw_box ( math::matrix_4x4 const& model_view
-                , math::matrix_4x4 const& projection
+  void draw_box ( opengl::debug_geometry&
                 , bool is_current_selection
                 );
 
@@ -93,6 +97,8 @@ public:
 
   bool isInsideRect(math::vector_3d rect[2]) const;
   bool is_visible(math::frustum const& frustum, const float& cull_distance, const math::vector_3d& camera, display_mode display);
+  //! is_visible() without the frustum test, for callers culling many instances at once
+  bool in_view_distance(const float& cull_distance, const math::vector_3d& camera, display_mode display);
 
   virtual math::vector_3d get_pos() const { return pos; }
 
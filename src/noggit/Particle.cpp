@@ -5,17 +5,10 @@
 #include <opengl/context.hpp>
 #include <opengl/shader.hpp>
 
-#include <list>
+#include <algorithm>
 
 static const unsigned int MAX_PARTICLES = 10000;
 
-template<class T>
-T lifeRamp(float life, float mid, const T &a, const T &b, const T &c)
-{
-  if (life <= mid) return math::interpolation::linear(life / mid, a, b);
-  else return math::interpolation::linear((life - mid) / (1.0f - mid), b, c);
-}
-
 ParticleSystem::ParticleSystem(Model* model_, const MPQFile& f, const ModelParticleEmitterDef &mta, int *globals)
   : model (model_)
   , emitter_type(mta.EmitterType)
@@ -38,6 +31,7 @@ ParticleSystem::ParticleSystem(Model* model_, const MPQFile& f, const ModelParti
   , slowdown (mta.p.slowdown)
   , pos (fixCoordSystem(mta.pos))
   , _texture_id (mta.texture)
+  , particles (MAX_PARTICLES)
   , blend (mta.blend)
   , order (mta.ParticleType > 0 ? -1 : 0)
   , type (mta.ParticleType)
@@ -196,11 +190,10 @@ void ParticleSystem::update(float dt)
     else {
       int tospawn = (int)ftospawn;
 
-      if ((tospawn + particles.size()) > MAX_PARTICLES) // Error check to prevent the program from trying to load insane amounts of particles.
-        tospawn = particles.size() - MAX_PARTICLES;
-
       rem = ftospawn - static_cast<float>(tospawn);
 
+      // Error check to prevent the program from trying to load insane amounts of particles.
+      tospawn = std::min(tospawn, static_cast<int>(particles.available()));
 
       float w = areal.getValue(manim, mtime, manimtime) * 0.5f;
       float l = areaw.getValue(manim, mtime, manimtime) * 0.5f;
@@ -215,42 +208,13 @@ void ParticleSystem::update(float dt)
       //rem = 0;
       if (en) {
         for (int i = 0; i<tospawn; ++i) {
-          Particle p = emitter->newParticle(this, manim, mtime, manimtime, w, l, spd, var, spr, spr2);
-          // sanity check:
-          //if (particles.size() < MAX_PARTICLES) // No need to check this every loop iteration. Already checked above.
-          particles.push_back(p);
+          particles.push_back(emitter->newParticle(this, manim, mtime, manimtime, w, l, spd, var, spr, spr2));
         }
       }
     }
   }
 
-  float mspeed = 1.0f;
-
-  for (ParticleList::iterator it = particles.begin(); it != particles.end();) {
-    Particle &p = *it;
-    p.speed += p.down * grav * dt - p.dir * deaccel * dt;
-
-    if (slowdown>0) {
-      mspeed = expf(-1.0f * slowdown * p.life);
-    }
-    p.pos += p.speed * mspeed * dt;
-
-    p.life += dt;
-    float rlife = p.life / p.maxlife;
-    // calculate size and color based on lifetime
-    p.size = lifeRamp<float>(rlife, mid, sizes[0], sizes[1], sizes[2]);
-    p.color = lifeRamp<math::vector_4d>(rlife, mid, colors[0], colors[1], colors[2]);
-
-    // kill off old particles
-    if (rlife >= 1.0f)
-    {
-      it = particles.erase (it);
-    }
-    else
-    {
-      ++it;
-    }
-  }
+  particles.update(dt, {grav, deaccel, slowdown, mid, sizes, colors});
 }
 
 void ParticleSystem::setup(int anim, int time, int animtime)
@@ -307,13 +271,10 @@ void ParticleSystem::draw( math::matrix_4x4 const& model_view
   math::vector_3d bv0 = math::vector_3d(-f, +f, 0);
   math::vector_3d bv1 = math::vector_3d(+f, +f, 0);
 
-  std::vector<std::uint16_t> indices;
-  std::vector<math::vector_3d> vertices;
-  std::vector<math::vector_3d> offsets;
-  std::vector<math::vector_4d> colors_data;
-  std::vector<math::vector_2d> texcoords;
-
-  std::uint16_t indice = 0;
+  _vertices_data.clear();
+  _offsets_data.clear();
+  _colors_data.clear();
+  _texcoords_data.clear();
 
   if (billboard) 
   {
@@ -322,17 +283,17 @@ void ParticleSystem::draw( math::matrix_4x4 const& model_view
     //vUp = math::vector_3d(0,1,0); // Cylindrical billboarding
   }
 
-  auto add_quad_indices([&indices] (std::uint16_t& start)
-  {
-    indices.push_back(start + 0);
-    indices.push_back(start + 1);
-    indices.push_back(start + 2);
-
-    indices.push_back(start + 2);
-    indices.push_back(start + 3);
-    indices.push_back(start + 0);
+  std::size_t const count = particles.size();
 
-    start += 4;
+  auto add_quad([&] (std::size_t i, math::vector_3d const* corners)
+  {
+    math::vector_4d const color = particles.color(i);
+    for (int c = 0; c < 4; ++c)
+    {
+      _texcoords_data.push_back(tiles[particles.tile(i)].tc[c]);
+      _vertices_data.push_back(corners[c]);
+      _colors_data.push_back(color);
+    }
   });
 
   /*
@@ -349,65 +310,45 @@ void ParticleSystem::draw( math::matrix_4x4 const& model_view
 
     if (billboard) 
     {
+      math::vector_3d const offsets[4] = { -(vRight + vUp), (vRight - vUp), (vRight + vUp), -(vRight - vUp) };
+
       //! \todo per-particle rotation in a non-expensive way?? :|
-      for (ParticleList::iterator it = particles.begin(); it != particles.end(); ++it) 
+      for (std::size_t i = 0; i < count; ++i) 
       {
-        if (tiles.size() - 1 < it->tile) // Alfred, 2009.08.07, error prevent
+        if (tiles.size() - 1 < particles.tile(i)) // Alfred, 2009.08.07, error prevent
         {
           break;
         }
 
-        const float size = it->size;// / 2;
-
-        texcoords.push_back(tiles[it->tile].tc[0]);
-        vertices.push_back(it->pos);
-        offsets.push_back(-(vRight + vUp) * size);
-        colors_data.push_back(it->color);
-
-        texcoords.push_back(tiles[it->tile].tc[1]);
-        vertices.push_back(it->pos);
-        offsets.push_back((vRight - vUp) * size);
-        colors_data.push_back(it->color);
-
-        texcoords.push_back(tiles[it->tile].tc[2]);
-        vertices.push_back(it->pos);
-        offsets.push_back((vRight + vUp) * size);
-        colors_data.push_back(it->color);
+        math::vector_3d const position = particles.position(i);
+        math::vector_3d const corners[4] = { position, position, position, position };
+        add_quad(i, corners);
 
-        texcoords.push_back(tiles[it->tile].tc[3]);
-        vertices.push_back(it->pos);
-        offsets.push_back(-(vRight - vUp) * size);
-        colors_data.push_back(it->color);
-
-        add_quad_indices(indice);
+        const float size = particles.size(i);// / 2;
+        for (int c = 0; c < 4; ++c)
+        {
+          _offsets_data.push_back(offsets[c] * size);
+        }
       }
     }
     else 
     {
-      for (ParticleList::iterator it = particles.begin(); it != particles.end(); ++it) 
+      for (std::size_t i = 0; i < count; ++i) 
       {
-        if (tiles.size() - 1 < it->tile) // Alfred, 2009.08.07, error prevent
+        if (tiles.size() - 1 < particles.tile(i)) // Alfred, 2009.08.07, error prevent
         {
           break;
         }
 
-        texcoords.push_back(tiles[it->tile].tc[0]);
-        vertices.push_back(it->pos + it->corners[0] * it->size);
-        colors_data.push_back(it->color);
-
-        texcoords.push_back(tiles[it->tile].tc[1]);
-        vertices.push_back(it->pos + it->corners[1] * it->size);
-        colors_data.push_back(it->color);
-
-        texcoords.push_back(tiles[it->tile].tc[2]);
-        vertices.push_back(it->pos + it->corners[2] * it->size);
-        colors_data.push_back(it->color);
-
-        texcoords.push_back(tiles[it->tile].tc[3]);
-        vertices.push_back(it->pos + it->corners[3] * it->size);
-        colors_data.push_back(it->color);
-
-        add_quad_indices(indice);
+        math::vector_3d const position = particles.position(i);
+        auto const& particle_corners = particles.corners(i);
+        const float size = particles.size(i);
+        math::vector_3d const corners[4] = { position + particle_corners[0] * size
+                                           , position + particle_corners[1] * size
+                                           , position + particle_corners[2] * size
+                                           , position + particle_corners[3] * size
+                                           };
+        add_quad(i, corners);
       }
     }
   }  
@@ -423,37 +364,56 @@ void ParticleSystem::draw( math::matrix_4x4 const& model_view
     bv1 = mbb * math::vector_3d(1.0f,0,0);
     */
 
-    for (ParticleList::iterator it = particles.begin(); it != particles.end(); ++it) 
+    for (std::size_t i = 0; i < count; ++i) 
     {
-      if (tiles.size() - 1 < it->tile) // Alfred, 2009.08.07, error prevent
+      if (tiles.size() - 1 < particles.tile(i)) // Alfred, 2009.08.07, error prevent
       {
         break;
       }
 
-      texcoords.push_back(tiles[it->tile].tc[0]);
-      vertices.push_back(it->pos + bv0 * it->size);
-      colors_data.push_back(it->color);
+      math::vector_3d const position = particles.position(i);
+      math::vector_3d const& origin = particles.origin(i);
+      const float size = particles.size(i);
+      math::vector_3d const corners[4] = { position + bv0 * size
+                                         , position + bv1 * size
+                                         , origin + bv1 * size
+                                         , origin + bv0 * size
+                                         };
+      add_quad(i, corners);
+    }
+  }
 
-      texcoords.push_back(tiles[it->tile].tc[1]);
-      vertices.push_back(it->pos + bv1 * it->size);
-      colors_data.push_back(it->color);
+  std::size_t const quads = _vertices_data.size() / 4;
 
-      texcoords.push_back(tiles[it->tile].tc[2]);
-      vertices.push_back(it->origin + bv1 * it->size);
-      colors_data.push_back(it->color);
+  if (quads == 0)
+  {
+    return;
+  }
 
-      texcoords.push_back(tiles[it->tile].tc[3]);
-      vertices.push_back(it->origin + bv0 * it->size);
-      colors_data.push_back(it->color);
+  if (quads > _indexed_quads)
+  {
+    _indexed_quads = std::max<std::size_t>(quads, std::min<std::size_t>(_indexed_quads * 2, MAX_PARTICLES));
 
-      add_quad_indices(indice);
+    std::vector<std::uint16_t> indices;
+    indices.reserve(_indexed_quads * 6);
+    for (std::size_t quad = 0; quad < _indexed_quads; ++quad)
+    {
+      std::uint16_t const start = static_cast<std::uint16_t>(quad * 4);
+      indices.push_back(start + 0);
+      indices.push_back(start + 1);
+      indices.push_back(start + 2);
+
+      indices.push_back(start + 2);
+      indices.push_back(start + 3);
+      indices.push_back(start + 0);
     }
+
+    gl.bufferData<GL_ELEMENT_ARRAY_BUFFER, std::uint16_t>(_indices_vbo, indices, GL_STATIC_DRAW);
   }
 
-  gl.bufferData<GL_ARRAY_BUFFER, math::vector_3d>(_vertices_vbo, vertices, GL_STREAM_DRAW);
-  gl.bufferData<GL_ARRAY_BUFFER, math::vector_4d>(_colors_vbo, colors_data, GL_STREAM_DRAW);
-  gl.bufferData<GL_ARRAY_BUFFER, math::vector_2d>(_texcoord_vbo, texcoords, GL_STREAM_DRAW);
-  gl.bufferData<GL_ELEMENT_ARRAY_BUFFER, std::uint16_t>(_indices_vbo, indices, GL_STREAM_DRAW);
+  gl.bufferData<GL_ARRAY_BUFFER, math::vector_3d>(_vertices_vbo, _vertices_data, GL_STREAM_DRAW);
+  gl.bufferData<GL_ARRAY_BUFFER, math::vector_4d>(_colors_vbo, _colors_data, GL_STREAM_DRAW);
+  gl.bufferData<GL_ARRAY_BUFFER, math::vector_2d>(_texcoord_vbo, _texcoords_data, GL_STREAM_DRAW);
 
   shader.uniform("alpha_test", alpha_test);
   shader.uniform("billboard", (int)billboard);
@@ -465,7 +425,7 @@ void ParticleSystem::draw( math::matrix_4x4 const& model_view
   if(billboard)
   {
     // \todo duplicate bind
-    gl.bufferData<GL_ARRAY_BUFFER, math::vector_3d>(_offsets_vbo, offsets, GL_STREAM_DRAW);
+    gl.bufferData<GL_ARRAY_BUFFER, math::vector_3d>(_offsets_vbo, _offsets_data, GL_STREAM_DRAW);
     shader.attrib(_, "offset", _offsets_vbo, 3, GL_FLOAT, GL_FALSE, 0, 0);
   }
 
@@ -476,7 +436,7 @@ void ParticleSystem::draw( math::matrix_4x4 const& model_view
     shader.attrib(_, "transform", opengl::array_buffer_is_already_bound{}, static_cast<math::matrix_4x4*> (nullptr), 1);
   }
 
-  gl.drawElementsInstanced(GL_TRIANGLES, indices.size(), instances_count, GL_UNSIGNED_SHORT, _indices_vbo);
+  gl.drawElementsInstanced(GL_TRIANGLES, quads * 6, instances_count, GL_UNSIGNED_SHORT, _indices_vbo);
 }
 
 void ParticleSystem::upload()
@@ -771,7 +731,7 @@ RibbonEmitter::RibbonEmitter(Model* model_, const MPQFile &f, ModelRibbonEmitter
   _material_ids = Model::M2Array<uint16_t>(f, mta.ofsMaterials, mta.nMaterials);
 
    // create first segment
-  segs.emplace_back(tpos, 0);
+  segs.push_back(RibbonSegment(tpos, 0));
 }
 
 RibbonEmitter::RibbonEmitter(RibbonEmitter const& other)
@@ -832,7 +792,7 @@ void RibbonEmitter::setup(int anim, int time, int animtime)
   mtime = time;
 
   // move first segment
-  RibbonSegment &first = *segs.begin();
+  RibbonSegment &first = segs.front();
   if (first.len > seglen) {
     // add new segment
     first.back = (tpos - ntpos).normalize();
@@ -849,19 +809,13 @@ void RibbonEmitter::setup(int anim, int time, int animtime)
 
   // kill stuff from the end
   float l = 0;
-  bool erasemode = false;
-  for (std::list<RibbonSegment>::iterator it = segs.begin(); it != segs.end();) {
-    if (!erasemode) {
-      l += it->len;
-      if (l > length) {
-        it->len = l - length;
-        erasemode = true;
-      }
-    }
-    else {
-      segs.erase(it);
+  for (std::size_t i = 0; i < segs.size(); ++i) {
+    l += segs[i].len;
+    if (l > length) {
+      segs[i].len = l - length;
+      segs.truncate(i + 1);
+      break;
     }
-    ++it;
   }
 
   tpos = ntpos;
@@ -905,18 +859,18 @@ void RibbonEmitter::draw( opengl::scoped::use_program& shader
     start += 2;
   });
 
-  std::list<RibbonSegment>::iterator it = segs.begin();
   float l = 0;
-  for (; it != segs.end(); ++it) 
+  for (std::size_t i = 0; i < segs.size(); ++i) 
   {
+    RibbonSegment const& seg = segs[i];
     float u = l / length;
 
     texcoords.emplace_back(u, 0);
-    vertices.push_back(it->pos + tabove * it->up);
+    vertices.push_back(seg.pos + tabove * seg.up);
     texcoords.emplace_back(u, 1);
-    vertices.push_back(it->pos - tbelow * it->up);
+    vertices.push_back(seg.pos - tbelow * seg.up);
 
-    l += it->len;
+    l += seg.len;
 
     add_quad_indices(indice);
   }
@@ -924,11 +878,11 @@ void RibbonEmitter::draw( opengl::scoped::use_program& shader
   if (segs.size() > 1) 
   {
     // last segment...?
-    --it;
+    RibbonSegment const& seg = segs.back();
     texcoords.emplace_back(1, 0);
-    vertices.push_back(it->pos + tabove * it->up + (it->len / it->len0) * it->back);
+    vertices.push_back(seg.pos + tabove * seg.up + (seg.len / seg.len0) * seg.back);
     texcoords.emplace_back(1, 1);
-    vertices.push_back(it->pos - tbelow * it->up + (it->len / it->len0) * it->back);
+    vertices.push_back(seg.pos - tbelow * seg.up + (seg.len / seg.len0) * seg.back);
   }
 
   gl.bufferData<GL_ARRAY_BUFFER, math::vector_3d>(_vertices_vbo, vertices, GL_STREAM_DRAW);
@@ -5,10 +5,11 @@
 #include <noggit/Animated.h> // Animation::M2Value
 #include <noggit/Model.h>
 #include <noggit/TextureManager.h>
+#include <noggit/particle_pool.hpp>
+#include <noggit/ring_buffer.hpp>
 #include <opengl/scoped.hpp>
 #include <opengl/shader.fwd.hpp>
 
-#include <list>
 #include <memory>
 #include <vector>
 
@@ -17,17 +18,6 @@ class Model;
 class ParticleSystem;
 class RibbonEmitter;
 
-struct Particle {
-  math::vector_3d pos, speed, down, origin, dir;
-  math::vector_3d  corners[4];
-  //math::vector_3d tpos;
-  float size, life, maxlife;
-  unsigned int tile;
-  math::vector_4d color;
-};
-
-typedef std::list<Particle> ParticleList;
-
 class ParticleEmitter {
 public:
   explicit ParticleEmitter() {}
@@ -63,7 +53,7 @@ class ParticleSystem
   float mid, slowdown;
   math::vector_3d pos;
   uint16_t _texture_id;
-  ParticleList particles;
+  noggit::particle_pool particles;
   int blend, order, type;
   int manim, mtime;
   int manimtime;
@@ -104,6 +94,15 @@ private:
   bool _uploaded = false;
   void upload();
 
+  //! per-vertex data rebuilt every frame, kept to reuse the allocations
+  std::vector<math::vector_3d> _vertices_data;
+  std::vector<math::vector_3d> _offsets_data;
+  std::vector<math::vector_4d> _colors_data;
+  std::vector<math::vector_2d> _texcoords_data;
+  //! the quad indices only depend on the particle count, so the buffer is
+  //! only refilled when more quads are needed than it holds
+  std::size_t _indexed_quads = 0;
+
   opengl::scoped::deferred_upload_vertex_arrays<1> _vertex_array;
   GLuint const& _vao = _vertex_array[0];
   opengl::scoped::deferred_upload_buffers<5> _buffers;
@@ -119,6 +118,7 @@ struct RibbonSegment
 {
   math::vector_3d pos, up, back;
   float len, len0;
+  RibbonSegment() = default;
   RibbonSegment (::math::vector_3d pos_, float len_)
     : pos (pos_)
     , len (len_)
@@ -148,7 +148,7 @@ class RibbonEmitter
   std::vector<uint16_t> _texture_ids;
   std::vector<uint16_t> _material_ids;
 
-  std::list<RibbonSegment> segs;
+  noggit::ring_buffer<RibbonSegment> segs;
 
 public:
   RibbonEmitter(Model*, const MPQFile &f, ModelRibbonEmitterDef const& mta, int *globals);
@@ -1,17 +1,12 @@
 // This file is part of Noggit3, licensed under GNU General Public License (version 3).
 
-#include <math/vector_2d.hpp>
 #include <noggit/TextureManager.h>
 #include <noggit/Log.h> // LogDebug
+#include <noggit/blp_decoder.hpp>
+#include <noggit/blp_thumbnail.hpp>
 #include <opengl/context.hpp>
-#include <opengl/scoped.hpp>
-#include <opengl/shader.hpp>
 
-#include <QtCore/QString>
-#include <QtGui/QOffscreenSurface>
-#include <QtGui/QOpenGLFramebufferObjectFormat>
 #include <QtGui/QPixmap>
-#include <QtOpenGL/QGLPixelBuffer>
 
 #include <algorithm>
 
@@ -30,24 +25,6 @@ void TextureManager::report()
   LogDebug << output;
 }
 
-#include <cstdint>
-//! \todo Cross-platform syntax for packed structs.
-#pragma pack(push,1)
-struct BLPHeader
-{
-  int32_t magix;
-  int32_t version;
-  uint8_t attr_0_compression;
-  uint8_t attr_1_alphadepth;
-  uint8_t attr_2_alphatype;
-  uint8_t attr_3_mipmaplevels;
-  int32_t resx;
-  int32_t resy;
-  int32_t offsets[16];
-  int32_t sizes[16];
-};
-#pragma pack(pop)
-
 #include <boost/thread.hpp>
 #include <noggit/MPQ.h>
 
@@ -55,15 +32,7 @@ void blp_texture::bind()
 {
   opengl::texture::bind();
 
-  if (!finished)
-  {
-    return;
-  }
-
-  if (!_uploaded)
-  {
-    upload();
-  }
+  // until the scheduled upload ran this is an empty texture
 }
 
 void blp_texture::upload()
@@ -256,6 +225,26 @@ void blp_texture::finishLoading()
   }
 
   f.close();
+
+  std::size_t bytes = 0;
+  for (auto const& level : _data)
+  {
+    bytes += level.second.size() * sizeof (std::uint32_t);
+  }
+  for (auto const& level : _compressed_data)
+  {
+    bytes += level.second.size();
+  }
+
+  _upload = noggit::upload_scheduler::instance().enqueue
+    ( bytes
+    , [this]
+      {
+        opengl::texture::bind();
+        upload();
+      }
+    );
+
   finished = true;
   _state_changed.notify_all();
 }
@@ -267,126 +256,7 @@ namespace noggit
                                , int height
                                )
   {
-    opengl::context::save_current_context const context_save (::gl);
-
-    QOpenGLContext context;
-    context.create();
-
-    QOpenGLFramebufferObjectFormat fmt;
-    fmt.setSamples(1);
-    fmt.setInternalTextureFormat(GL_RGBA8);
-
-    QOffscreenSurface surface;
-    surface.create();
-
-    context.makeCurrent(&surface);
-
-    opengl::context::scoped_setter const context_set (::gl, &context);
-
-    opengl::scoped::bool_setter<GL_CULL_FACE, GL_FALSE> cull;
-    opengl::scoped::bool_setter<GL_DEPTH_TEST, GL_FALSE> depth;
-
-    opengl::scoped::deferred_upload_vertex_arrays<1> vao;
-    vao.upload();
-    opengl::scoped::deferred_upload_buffers<3> buffers;
-    buffers.upload();
-    GLuint const& indices_vbo = buffers[0];
-    GLuint const& vertices_vbo = buffers[1];
-    GLuint const& texcoords_vbo = buffers[2];
-
-    opengl::texture::set_active_texture(0);
-    blp_texture texture(blp_filename);
-    texture.finishLoading();
-
-    width = width == -1 ? texture.width() : width;
-    height = height == -1 ? texture.height() : height;
-
-    float h = static_cast<float>(height);
-    float w = static_cast<float>(width);
-    float half_h = h * 0.5f;
-    float half_w = w * 0.5f;
-
-    std::vector<math::vector_2d> vertices =
-    {
-       {-half_w, -half_h}
-      ,{-half_w, half_h}
-      ,{ half_w, half_h}
-      ,{ half_w, -half_h}
-    };
-    std::vector<math::vector_2d> texcoords =
-    {
-       {0.f, 0.f}
-      ,{0.f, h}
-      ,{w, h}
-      ,{w, 0.f}
-    };
-    std::vector<std::uint16_t> indices = {0,1,2, 2,3,0};
-
-    gl.bufferData<GL_ARRAY_BUFFER, math::vector_2d>(vertices_vbo, vertices, GL_STATIC_DRAW);
-    gl.bufferData<GL_ARRAY_BUFFER, math::vector_2d>(texcoords_vbo, texcoords, GL_STATIC_DRAW);
-    gl.bufferData<GL_ELEMENT_ARRAY_BUFFER, std::uint16_t>(indices_vbo, indices, GL_STATIC_DRAW);
-
-    QOpenGLFramebufferObject pixel_buffer(width, height, fmt);
-    pixel_buffer.bind();
-
-    gl.viewport(0, 0, w, h);
-    gl.clearColor(.0f, .0f, .0f, 1.f);
-    gl.clear(GL_COLOR_BUFFER_BIT);
-
-    opengl::program program
-    (
-      {
-        {
-          GL_VERTEX_SHADER, R"code(
-#version 330 core
-
-in vec4 position;
-in vec2 tex_coord;
-out vec2 f_tex_coord;
-
-void main()
-{
-f_tex_coord = vec2(tex_coord.x, -tex_coord.y);
-gl_Position = position;
-}
-)code"
-        },
-        {
-          GL_FRAGMENT_SHADER,
-          R"code(
-#version 330 core
-
-uniform sampler2D tex;
-
-in vec2 f_tex_coord;
-
-layout(location = 0) out vec4 out_color;
-
-void main()
-{
-out_color = vec4(texture(tex, f_tex_coord/2.f + vec2(0.5)).rgb, 1.);
-}
-)code"
-        }
-      }
-    );
-
-    opengl::scoped::use_program shader (program);
-
-    shader.uniform("tex", 0);
-    texture.bind();
-
-    opengl::scoped::vao_binder const _ (vao[0]);
-
-    shader.attrib(_, "position", vertices_vbo, 2, GL_FLOAT, GL_FALSE, 0, 0);
-    shader.attrib(_, "tex_coord", texcoords_vbo, 2, GL_FLOAT, GL_FALSE, 0, 0);
-    opengl::scoped::buffer_binder<GL_ELEMENT_ARRAY_BUFFER> indices_binder(indices_vbo);
-
-    gl.drawElements(GL_TRIANGLES, 6, GL_UNSIGNED_SHORT, indices_vbo);
-
-    QPixmap pixmap (QPixmap::fromImage (pixel_buffer.toImage()));
-
-    pixel_buffer.release();
+    QPixmap pixmap (QPixmap::fromImage (blp_thumbnail (blp_filename, width, height)));
 
     if (pixmap.isNull())
     {
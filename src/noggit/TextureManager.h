@@ -4,6 +4,7 @@
 
 #include <noggit/AsyncObject.h>
 #include <noggit/multimap_with_normalized_key.hpp>
+#include <noggit/upload_scheduler.hpp>
 #include <opengl/texture.hpp>
 
 #include <boost/optional.hpp>
@@ -46,6 +47,8 @@ private:
   std::map<int, std::vector<uint8_t>> _compressed_data;
   boost::optional<GLint> _compression_format;
 
+  noggit::upload_scheduler::ticket _upload;
+
   static std::atomic<int> blp_tex_counter;
 };
 
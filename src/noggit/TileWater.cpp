@@ -37,8 +37,6 @@ void TileWater::draw ( math::frustum const& frustum
                      , const math::vector_3d& camera
                      , bool camera_moved
                      , liquid_render& render
-                     , opengl::scoped::use_program& water_shader
-                     , int animtime
                      , int layer
                      , display_mode display
                      )
@@ -52,8 +50,6 @@ void TileWater::draw ( math::frustum const& frustum
                          , camera
                          , camera_moved
                          , render
-                         , water_shader                         
-                         , animtime
                          , layer
                          , display
                          );
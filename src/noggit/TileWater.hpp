@@ -28,8 +28,6 @@ public:
             , const math::vector_3d& camera
             , bool camera_moved
             , liquid_render& render
-            , opengl::scoped::use_program& water_shader
-            , int animtime
             , int layer
             , display_mode display
             );
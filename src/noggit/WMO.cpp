@@ -7,7 +7,7 @@
 #include <noggit/TextureManager.h> // TextureManager, Texture
 #include <noggit/WMO.h>
 #include <noggit/World.h>
-#include <opengl/primitives.hpp>
+#include <opengl/debug_geometry.hpp>
 #include <opengl/scoped.hpp>
 
 #include <boost/algorithm/string.hpp>
@@ -321,8 +321,7 @@ void WMO::finishLoading ()
 }
 
 void WMO::draw ( opengl::scoped::use_program& wmo_shader
-               , math::matrix_4x4 const& model_view
-               , math::matrix_4x4 const& projection
+               , opengl::debug_geometry& debug_geometry
                , math::matrix_4x4 const& transform_matrix
                , math::matrix_4x4 const& transform_matrix_transposed
                , bool boundingbox
@@ -365,27 +364,20 @@ void WMO::draw ( opengl::scoped::use_program& wmo_shader
 
   if (boundingbox)
   {
-    opengl::scoped::bool_setter<GL_BLEND, GL_TRUE> const blend;
-    gl.blendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-
     for (auto& group : groups)
     {
-      opengl::primitives::wire_box(group.BoundingBoxMin, group.BoundingBoxMax)
-        .draw( model_view
-             , projection
-             , transform_matrix_transposed
-             , {1.0f, 1.0f, 1.0f, 1.0f}
-             );
+      debug_geometry.add_box ( group.BoundingBoxMin
+                             , group.BoundingBoxMax
+                             , {1.0f, 1.0f, 1.0f, 1.0f}
+                             , transform_matrix
+                             );
     }
 
-    opengl::primitives::wire_box ( math::vector_3d(extents[0].x, extents[0].z, -extents[0].y)
-                                 , math::vector_3d(extents[1].x, extents[1].z, -extents[1].y)
-                                 ).draw ( model_view
-                                        , projection
-                                        , transform_matrix_transposed
-                                        , {1.0f, 0.0f, 0.0f, 1.0f}
-                                        );
-
+    debug_geometry.add_box ( math::vector_3d(extents[0].x, extents[0].z, -extents[0].y)
+                           , math::vector_3d(extents[1].x, extents[1].z, -extents[1].y)
+                           , {1.0f, 0.0f, 0.0f, 1.0f}
+                           , transform_matrix
+                           );
   }
 }
 
@@ -262,8 +262,7 @@ public:
   explicit WMO(const std::string& name);
 
   void draw ( opengl::scoped::use_program& wmo_shader
-            , math::matrix_4x4 const& model_view
-            , math::matrix_4x4 const& projection
+            , opengl::debug_geometry& debug_geometry
             , math::matrix_4x4 const& transform_matrix
             , math::matrix_4x4 const& transform_matrix_transposed
             , bool boundingbox
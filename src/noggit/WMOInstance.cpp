@@ -7,7 +7,7 @@
 #include <noggit/ModelInstance.h>
 #include <noggit/WMO.h> // WMO
 #include <noggit/WMOInstance.h>
-#include <opengl/primitives.hpp>
+#include <opengl/debug_geometry.hpp>
 #include <opengl/scoped.hpp>
 
 WMOInstance::WMOInstance(std::string const& filename, ENTRY_MODF const* d)
@@ -46,8 +46,7 @@ bool WMOInstance::is_a_duplicate_of(WMOInstance const& other)
 }
 
 void WMOInstance::draw ( opengl::scoped::use_program& wmo_shader
-                       , math::matrix_4x4 const& model_view
-                       , math::matrix_4x4 const& projection
+                       , opengl::debug_geometry& debug_geometry
                        , math::frustum const& frustum
                        , const float& cull_distance
                        , const math::vector_3d& camera
@@ -55,7 +54,6 @@ void WMOInstance::draw ( opengl::scoped::use_program& wmo_shader
                        , bool draw_doodads
                        , bool draw_fog
                        , liquid_render& render
-                       , std::vector<selection_type> selection
                        , int animtime
                        , bool world_has_skies
                        , display_mode display
@@ -67,16 +65,13 @@ void WMOInstance::draw ( opengl::scoped::use_program& wmo_shader
     return;
   }
 
-  const uint id = this->mUniqueID;
-  bool const is_selected = selection.size() > 0 &&
-                           std::find_if(selection.begin(), selection.end(), [id](selection_type type) {return type.type() == typeid(selected_wmo_type) && boost::get<selected_wmo_type>(type)->mUniqueID == id; }) != selection.end();
+  bool const is_selected (selected);
 
   {
     wmo_shader.uniform("transform", _transform_mat_transposed);
 
     wmo->draw ( wmo_shader
-              , model_view
-              , projection
+              , debug_geometry
               , _transform_mat
               , _transform_mat_transposed
               , is_selected
@@ -95,11 +90,8 @@ void WMOInstance::draw ( opengl::scoped::use_program& wmo_shader
 
   if (force_box || is_selected)
   {
-    gl.enable(GL_BLEND);
-    gl.blendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-
     math::vector_4d color = force_box ? math::vector_4d(0.0f, 0.0f, 1.0f, 1.0f) : math::vector_4d(0.0f, 1.0f, 0.0f, 1.0f);
-    opengl::primitives::wire_box (extents[0], extents[1]).draw (model_view, projection, math::matrix_4x4(math::matrix_4x4::unit), color);
+    debug_geometry.add_box (extents[0], extents[1], color);
   }
 }
 
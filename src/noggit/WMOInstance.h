@@ -5,6 +5,7 @@
 #include <math/ray.hpp>
 #include <math/vector_3d.hpp> // math::vector_3d
 #include <noggit/WMO.h>
+#include <noggit/selection_set.hpp>
 
 #include <cstdint>
 #include <set>
@@ -25,6 +26,9 @@ public:
   uint16_t mUnknown;
   uint16_t mNameset; 
 
+  //! maintained by the world's selection
+  noggit::selection_flag selected;
+
   uint16_t doodadset() const { return _doodadset; }
   void change_doodadset(uint16_t doodad_set);
 
@@ -94,8 +98,7 @@ public:
   bool is_a_duplicate_of(WMOInstance const& other);
 
   void draw ( opengl::scoped::use_program& wmo_shader
-            , math::matrix_4x4 const& model_view
-            , math::matrix_4x4 const& projection
+            , opengl::debug_geometry& debug_geometry
             , math::frustum const& frustum
             , const float& cull_distance
             , const math::vector_3d& camera
@@ -103,7 +106,6 @@ public:
             , bool draw_doodads
             , bool draw_fog
             , liquid_render& render
-            , std::vector<selection_type> selection
             , int animtime
             , bool world_has_skies
             , display_mode display
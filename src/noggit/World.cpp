@@ -14,11 +14,15 @@
 #include <noggit/TextureManager.h>
 #include <noggit/TileWater.hpp>// tile water
 #include <noggit/WMOInstance.h> // WMOInstance
+#include <noggit/chunk_stitching.hpp>
 #include <noggit/map_index.hpp>
+#include <noggit/parallel_for.hpp>
+#include <noggit/settings_snapshot.hpp>
 #include <noggit/texture_set.hpp>
 #include <noggit/tool_enums.hpp>
 #include <noggit/ui/ObjectEditor.h>
 #include <noggit/ui/TexturingGUI.h>
+#include <opengl/program_cache.hpp>
 #include <opengl/scoped.hpp>
 #include <opengl/shader.hpp>
 
@@ -35,6 +39,7 @@
 #include <fstream>
 #include <iostream>
 #include <map>
+#include <mutex>
 #include <sstream>
 #include <string>
 #include <unordered_set>
@@ -104,7 +109,6 @@ World::World(const std::string& name, int map_id)
   , culldistance(fogdistance)
   , skies(nullptr)
   , outdoorLightStats(OutdoorLightStats())
-  , _current_selection()
   , _settings (new QSettings())
   , _view_distance(_settings->value ("view_distance", 1000.f).toFloat())
 {
@@ -118,7 +122,7 @@ void World::update_selection_pivot()
     math::vector_3d pivot;
     int model_count = 0;
 
-    for (auto const& entry : _current_selection)
+    for (auto const& entry : _current_selection.entries())
     {
       if (entry.which() == eEntry_Model)
       {
@@ -142,71 +146,19 @@ void World::update_selection_pivot()
 
 bool World::is_selected(selection_type selection) const
 {
-  if (selection.which() == eEntry_Model)
-  {
-    uint uid = boost::get<selected_model_type>(selection)->uid;
-    auto const& it = std::find_if(_current_selection.begin()
-                                  , _current_selection.end()
-                                  , [uid] (selection_type type)
-    {
-      return type.type() == typeid(selected_model_type)
-        && boost::get<selected_model_type>(type)->uid == uid;
-    }
-    );
-
-    if (it != _current_selection.end())
-    {
-      return true;
-    }
-  }
-  else if (selection.which() == eEntry_WMO)
-  {
-    uint uid = boost::get<selected_wmo_type>(selection)->mUniqueID;
-    auto const& it = std::find_if(_current_selection.begin()
-                            , _current_selection.end()
-                            , [uid] (selection_type type)
-    {
-      return type.type() == typeid(selected_wmo_type)
-        && boost::get<selected_wmo_type>(type)->mUniqueID == uid;
-    }
-    );
-    if (it != _current_selection.end())
-    {
-      return true;
-    }
-  }
-
-  return false;
+  return _current_selection.contains(selection);
 }
 
 bool World::is_selected(std::uint32_t uid) const
 {
-  for (selection_type const& entry : _current_selection)
-  {
-    if (entry.which() == eEntry_WMO)
-    {
-      if (boost::get<selected_wmo_type>(entry)->mUniqueID == uid)
-      {
-        return true;
-      }
-    }
-    else if (entry.which() == eEntry_Model)
-    {
-      if (boost::get<selected_model_type>(entry)->uid == uid)
-      {
-        return true;
-      }
-    }
-  }
-
-  return false;
+  return _current_selection.contains(uid);
 }
 
 boost::optional<selection_type> World::get_last_selected_model() const
 {
   auto const it
-    ( std::find_if ( _current_selection.rbegin()
-                   , _current_selection.rend()
+    ( std::find_if ( current_selection().rbegin()
+                   , current_selection().rend()
                    , [&] (selection_type const& entry)
                      {
                        return entry.which() != eEntry_MapChunk;
@@ -214,61 +166,38 @@ boost::optional<selection_type> World::get_last_selected_model() const
                    )
     );
 
-  return it == _current_selection.rend()
+  return it == current_selection().rend()
     ? boost::optional<selection_type>() : boost::optional<selection_type> (*it);
 }
 
 void World::set_current_selection(selection_type entry)
 {
   _current_selection.clear();
-  _current_selection.push_back(entry);
+  _current_selection.add(entry);
   _multi_select_pivot = boost::none;
-
-  _selected_model_count = entry.which() == eEntry_MapChunk ? 0 : 1;
 }
 
 void World::add_to_selection(selection_type entry)
 {
-  if (entry.which() != eEntry_MapChunk)
+  if (_current_selection.add(entry))
   {
-    _selected_model_count++;
+    update_selection_pivot();
   }
-
-  _current_selection.push_back(entry);
-  update_selection_pivot();
 }
 
 void World::remove_from_selection(selection_type entry)
 {
-  std::vector<selection_type>::iterator position = std::find(_current_selection.begin(), _current_selection.end(), entry);
-  if (position != _current_selection.end())
+  if (_current_selection.remove(entry))
   {
-    if (entry.which() != eEntry_MapChunk)
-    {
-      _selected_model_count--;
-    }
-
-    _current_selection.erase(position);
     update_selection_pivot();
   }
 }
 
 void World::remove_from_selection(std::uint32_t uid)
 {
-  for (auto it = _current_selection.begin(); it != _current_selection.end(); ++it)
+  if (_current_selection.remove(uid))
   {
-    if (it->which() == eEntry_Model && boost::get<selected_model_type>(*it)->uid == uid)
-    {
-      _current_selection.erase(it);
-      update_selection_pivot();
-      return;
-    }
-    else if (it->which() == eEntry_WMO && boost::get<selected_wmo_type>(*it)->mUniqueID == uid)
-    {
-      _current_selection.erase(it);
-      update_selection_pivot();
-      return;
-    }
+    update_selection_pivot();
   }
 }
 
@@ -276,27 +205,23 @@ void World::reset_selection()
 {
   _current_selection.clear();
   _multi_select_pivot = boost::none;
-  _selected_model_count = 0;
 }
 
 void World::delete_selected_models()
 {
-  _model_instance_storage.delete_instances(_current_selection);
-  need_model_updates = true;
+  // the instances have to leave the selection before they are destroyed
+  std::vector<selection_type> const selection (_current_selection.entries());
   reset_selection();
+
+  _model_instance_storage.delete_instances(selection);
+  need_model_updates = true;
 }
 
 void World::snap_selected_models_to_the_ground()
 {
-  for (auto& entry : _current_selection)
+  transform_selected_models([&] (selection_type const& entry)
   {
-    auto type = entry.which();
-    if (type == eEntry_MapChunk)
-    {
-      continue;
-    }
-
-    bool entry_is_m2 = type == eEntry_Model;
+    bool entry_is_m2 = entry.which() == eEntry_Model;
 
     math::vector_3d& pos = entry_is_m2
       ? boost::get<selected_model_type>(entry)->pos
@@ -309,98 +234,70 @@ void World::snap_selected_models_to_the_ground()
     if (!height)
     {
       LogError << "Snap to ground ray intersection failed" << std::endl;
-      continue;
+      return false;
     }
 
     // the ground can only be intersected once
     pos.y = height.get();
 
-    if (entry_is_m2)
-    {
-      boost::get<selected_model_type>(entry)->recalcExtents();
-    }
-    else
-    {
-      boost::get<selected_wmo_type>(entry)->recalcExtents();
-    }
-
-    updateTilesEntry(entry, model_update::add);
-  }
+    return true;
+  });
 
   update_selection_pivot();
 }
 
 void World::scale_selected_models(float v, m2_scaling_type type)
 {
-  for (auto& entry : _current_selection)
+  transform_selected_models([&] (selection_type const& entry)
   {
-    if (entry.which() == eEntry_Model)
+    if (entry.which() != eEntry_Model)
     {
-      ModelInstance* mi = boost::get<selected_model_type>(entry);
+      return false;
+    }
 
-      float scale = mi->scale;
+    ModelInstance* mi = boost::get<selected_model_type>(entry);
 
-      switch (type)
-      {
-        case World::m2_scaling_type::set:
-          scale = v;
-          break;
-        case World::m2_scaling_type::add:
-          scale += v;
-          break;
-        case World::m2_scaling_type::mult:
-          scale *= v;
-          break;
-      }
+    float scale = mi->scale;
 
-      // if the change is too small, do nothing
-      if (std::abs(scale - mi->scale) < ModelInstance::min_scale())
-      {
-        continue;
-      }
+    switch (type)
+    {
+      case World::m2_scaling_type::set:
+        scale = v;
+        break;
+      case World::m2_scaling_type::add:
+        scale += v;
+        break;
+      case World::m2_scaling_type::mult:
+        scale *= v;
+        break;
+    }
 
-      updateTilesModel(mi, model_update::remove);
-      mi->scale = std::min(ModelInstance::max_scale(), std::max(ModelInstance::min_scale(), scale));
-      mi->recalcExtents();
-      updateTilesModel(mi, model_update::add);
+    // if the change is too small, do nothing
+    if (std::abs(scale - mi->scale) < ModelInstance::min_scale())
+    {
+      return false;
     }
-  }
+
+    mi->scale = std::min(ModelInstance::max_scale(), std::max(ModelInstance::min_scale(), scale));
+    return true;
+  });
 }
 
 void World::move_selected_models(float dx, float dy, float dz)
 {
-  for (auto& entry : _current_selection)
+  transform_selected_models([&] (selection_type const& entry)
   {
-    auto type = entry.which();
-    if (type == eEntry_MapChunk)
-    {
-      continue;
-    }
-
-    bool entry_is_m2 = type == eEntry_Model;
-
-    math::vector_3d& pos = entry_is_m2
+    math::vector_3d& pos = entry.which() == eEntry_Model
       ? boost::get<selected_model_type>(entry)->pos
       : boost::get<selected_wmo_type>(entry)->pos
       ;
 
-    updateTilesEntry(entry, model_update::remove);
-
     pos.x += dx;
     pos.y += dy;
     pos.z += dz;
 
-    if (entry_is_m2)
-    {
-      boost::get<selected_model_type>(entry)->recalcExtents();
-    }
-    else
-    {
-      boost::get<selected_wmo_type>(entry)->recalcExtents();
-    }
-
-    updateTilesEntry(entry, model_update::add);
-  }
+    return true;
+  });
 
   update_selection_pivot();
 }
@@ -424,33 +321,19 @@ void World::set_selected_models_pos(math::vector_3d const& pos, bool change_heig
     return;
   }
 
-  for (auto& entry : _current_selection)
+  transform_selected_models([&] (selection_type const& entry)
   {
-    auto type = entry.which();
-    if (type == eEntry_MapChunk)
-    {
-      continue;
-    }
-
-    bool entry_is_m2 = type == eEntry_Model;
-
-    updateTilesEntry(entry, model_update::remove);
-
-    if (entry_is_m2)
+    if (entry.which() == eEntry_Model)
     {
-      ModelInstance* mi = boost::get<selected_model_type>(entry);
-      mi->pos = pos;
-      mi->recalcExtents();
+      boost::get<selected_model_type>(entry)->pos = pos;
     }
     else
     {
-      WMOInstance* wi = boost::get<selected_wmo_type>(entry);
-      wi->pos = pos;
-      wi->recalcExtents();
+      boost::get<selected_wmo_type>(entry)->pos = pos;
     }
 
-    updateTilesEntry(entry, model_update::add);
-  }
+    return true;
+  });
 
   update_selection_pivot();
 }
@@ -460,17 +343,9 @@ void World::rotate_selected_models(math::degrees rx, math::degrees ry, math::deg
   math::degrees::vec3 dir_change(rx, ry, rz);
   bool has_multi_select = has_multiple_model_selected();
 
-  for (auto& entry : _current_selection)
+  transform_selected_models([&] (selection_type const& entry)
   {
-    auto type = entry.which();
-    if (type == eEntry_MapChunk)
-    {
-      continue;
-    }
-
-    bool entry_is_m2 = type == eEntry_Model;
-
-    updateTilesEntry(entry, model_update::remove);
+    bool entry_is_m2 = entry.which() == eEntry_Model;
 
     if (use_pivot && has_multi_select)
     {
@@ -492,34 +367,15 @@ void World::rotate_selected_models(math::degrees rx, math::degrees ry, math::deg
 
     dir += dir_change;
 
-    if (entry_is_m2)
-    {
-      boost::get<selected_model_type>(entry)->recalcExtents();
-    }
-    else
-    {
-      boost::get<selected_wmo_type>(entry)->recalcExtents();
-    }
-
-    updateTilesEntry(entry, model_update::add);
-  }
+    return true;
+  });
 }
 
 void World::rotate_selected_models_randomly(float minX, float maxX, float minY, float maxY, float minZ, float maxZ)
 {
-  for (auto& entry : _current_selection)
+  transform_selected_models([&] (selection_type const& entry)
   {
-    auto type = entry.which();
-    if (type == eEntry_MapChunk)
-    {
-      continue;
-    }
-
-    bool entry_is_m2 = type == eEntry_Model;
-
-    updateTilesEntry(entry, model_update::remove);
-
-    math::degrees::vec3& dir = entry_is_m2
+    math::degrees::vec3& dir = entry.which() == eEntry_Model
       ? boost::get<selected_model_type>(entry)->dir
       : boost::get<selected_wmo_type>(entry)->dir
       ;
@@ -535,53 +391,25 @@ void World::rotate_selected_models_randomly(float minX, float maxX, float minY,
 
     dir = finalRotation.ToEulerAngles();
 
-    if (entry_is_m2)
-    {
-      boost::get<selected_model_type>(entry)->recalcExtents();
-    }
-    else
-    {
-      boost::get<selected_wmo_type>(entry)->recalcExtents();
-    }
-
-    updateTilesEntry(entry, model_update::add);
-  }
+    return true;
+  });
 }
 
 void World::set_selected_models_rotation(math::degrees rx, math::degrees ry, math::degrees rz)
 {
   math::degrees::vec3 new_dir(rx, ry, rz);
 
-  for (auto& entry : _current_selection)
+  transform_selected_models([&] (selection_type const& entry)
   {
-    auto type = entry.which();
-    if (type == eEntry_MapChunk)
-    {
-      continue;
-    }
-
-    bool entry_is_m2 = type == eEntry_Model;
-
-    updateTilesEntry(entry, model_update::remove);
-
-    math::degrees::vec3& dir = entry_is_m2
+    math::degrees::vec3& dir = entry.which() == eEntry_Model
       ? boost::get<selected_model_type>(entry)->dir
       : boost::get<selected_wmo_type>(entry)->dir
       ;
 
     dir = new_dir;
 
-    if (entry_is_m2)
-    {
-      boost::get<selected_model_type>(entry)->recalcExtents();
-    }
-    else
-    {
-      boost::get<selected_wmo_type>(entry)->recalcExtents();
-    }
-
-    updateTilesEntry(entry, model_update::add);
-  }
+    return true;
+  });
 }
 
 namespace
@@ -609,17 +437,9 @@ namespace
 
 void World::rotate_selected_models_to_ground_normal(bool smoothNormals)
 {
-  for (auto& entry : _current_selection)
+  transform_selected_models([&] (selection_type const& entry)
   {
-    auto type = entry.which();
-    if (type == eEntry_MapChunk)
-    {
-      continue;
-    }
-
-    bool entry_is_m2 = type == eEntry_Model;
-
-    updateTilesEntry(entry, model_update::remove);
+    bool entry_is_m2 = entry.which() == eEntry_Model;
 
     math::vector_3d rayPos = entry_is_m2
       ? boost::get<selected_model_type>(entry)->pos
@@ -649,9 +469,8 @@ void World::rotate_selected_models_to_ground_normal(bool smoothNormals)
     // !\ todo We shouldn't end up with empty ever (but we do, on completely flat ground)
     if (results.empty())
     {
-      // just to avoid models disappearing when this happens
-      updateTilesEntry(entry, model_update::add);
-      continue;
+      // unchanged, but re-added to its tiles like the others
+      return true;
     }
 
     // We hit the terrain, now we take the normal of this position and use it to get the rotation we want.
@@ -711,17 +530,8 @@ void World::rotate_selected_models_to_ground_normal(bool smoothNormals)
     // To euler, because wow
     dir = q.ToEulerAngles();
 
-    if (entry_is_m2)
-    {
-      boost::get<selected_model_type>(entry)->recalcExtents();
-    }
-    else
-    {
-      boost::get<selected_wmo_type>(entry)->recalcExtents();
-    }
-
-    updateTilesEntry(entry, model_update::add);
-  }
+    return true;
+  });
 }
 
 void World::initGlobalVBOs(GLuint* pDetailTexCoords, GLuint* pAlphaTexCoords)
@@ -772,6 +582,10 @@ void World::initGlobalVBOs(GLuint* pDetailTexCoords, GLuint* pAlphaTexCoords)
 
 void World::initDisplay()
 {
+  // the programs of the world and its renderers, the cached binaries are
+  // read in parallel here instead of one by one on first use
+  opengl::program_cache::instance().warm_up();
+
   initGlobalVBOs(&detailtexcoords, &alphatexcoords);
 
   mapIndex.setAdt(false);
@@ -792,6 +606,26 @@ void World::initDisplay()
   ol = std::make_unique<OutdoorLighting> ("World\\dnc.db");
 }
 
+namespace
+{
+  opengl::registered_program const m2_shaders
+    ({ {GL_VERTEX_SHADER, "m2_vs", {}}, {GL_FRAGMENT_SHADER, "m2_fs", {}} });
+  opengl::registered_program const m2_instanced_shaders
+    ({ {GL_VERTEX_SHADER, "m2_vs", {"instanced"}}, {GL_FRAGMENT_SHADER, "m2_fs", {}} });
+  opengl::registered_program const m2_box_shaders
+    ({ {GL_VERTEX_SHADER, "m2_box_vs", {}}, {GL_FRAGMENT_SHADER, "m2_box_fs", {}} });
+  opengl::registered_program const m2_ribbons_shaders
+    ({ {GL_VERTEX_SHADER, "ribbon_vs", {}}, {GL_FRAGMENT_SHADER, "ribbon_fs", {}} });
+  opengl::registered_program const m2_particles_shaders
+    ({ {GL_VERTEX_SHADER, "particle_vs", {}}, {GL_FRAGMENT_SHADER, "particle_fs", {}} });
+  opengl::registered_program const mcnk_shaders
+    ({ {GL_VERTEX_SHADER, "terrain_vs", {}}, {GL_FRAGMENT_SHADER, "terrain_fs", {}} });
+  opengl::registered_program const mfbo_shaders
+    ({ {GL_VERTEX_SHADER, "mfbo_vs", {}}, {GL_FRAGMENT_SHADER, "mfbo_fs", {}} });
+  opengl::registered_program const wmo_shaders
+    ({ {GL_VERTEX_SHADER, "wmo_vs", {}}, {GL_FRAGMENT_SHADER, "wmo_fs", {}} });
+}
+
 void World::draw ( math::matrix_4x4 const& model_view
                  , math::matrix_4x4 const& projection
                  , math::vector_3d const& cursor_pos
@@ -844,66 +678,31 @@ void World::draw ( math::matrix_4x4 const& model_view
 
   if (!_m2_program)
   {
-    _m2_program.reset
-      ( new opengl::program
-          { { GL_VERTEX_SHADER,   opengl::shader::src_from_qrc("m2_vs") }
-          , { GL_FRAGMENT_SHADER, opengl::shader::src_from_qrc("m2_fs") }
-          }
-      );
+    _m2_program.reset (new opengl::program (m2_shaders.sources()));
   }
   if (!_m2_instanced_program)
   {
-    _m2_instanced_program.reset
-      ( new opengl::program
-          { { GL_VERTEX_SHADER,   opengl::shader::src_from_qrc("m2_vs", {"instanced"}) }
-          , { GL_FRAGMENT_SHADER, opengl::shader::src_from_qrc("m2_fs") }
-          }
-      );
+    _m2_instanced_program.reset (new opengl::program (m2_instanced_shaders.sources()));
   }
   if (!_m2_box_program)
   {
-    _m2_box_program.reset
-      ( new opengl::program
-          { { GL_VERTEX_SHADER,   opengl::shader::src_from_qrc("m2_box_vs") }
-          , { GL_FRAGMENT_SHADER, opengl::shader::src_from_qrc("m2_box_fs") }
-          }
-      );
+    _m2_box_program.reset (new opengl::program (m2_box_shaders.sources()));
   }
   if (!_m2_ribbons_program)
   {
-    _m2_ribbons_program.reset
-      ( new opengl::program
-        { { GL_VERTEX_SHADER,   opengl::shader::src_from_qrc("ribbon_vs") }
-        , { GL_FRAGMENT_SHADER, opengl::shader::src_from_qrc("ribbon_fs") }
-        }
-      );
+    _m2_ribbons_program.reset (new opengl::program (m2_ribbons_shaders.sources()));
   }
   if (!_m2_particles_program)
   {
-    _m2_particles_program.reset
-      ( new opengl::program
-          { { GL_VERTEX_SHADER,   opengl::shader::src_from_qrc("particle_vs") }
-          , { GL_FRAGMENT_SHADER, opengl::shader::src_from_qrc("particle_fs") }
-          }
-      );
+    _m2_particles_program.reset (new opengl::program (m2_particles_shaders.sources()));
   }
   if (!_mcnk_program)
   {
-    _mcnk_program.reset
-      ( new opengl::program
-          { { GL_VERTEX_SHADER,   opengl::shader::src_from_qrc("terrain_vs") }
-          , { GL_FRAGMENT_SHADER, opengl::shader::src_from_qrc("terrain_fs") }
-          }
-      );
+    _mcnk_program.reset (new opengl::program (mcnk_shaders.sources()));
   }
   if (!_mfbo_program)
   {
-    _mfbo_program.reset
-      ( new opengl::program
-          { { GL_VERTEX_SHADER,   opengl::shader::src_from_qrc("mfbo_vs") }
-          , { GL_FRAGMENT_SHADER, opengl::shader::src_from_qrc("mfbo_fs") }
-          }
-      );
+    _mfbo_program.reset (new opengl::program (mfbo_shaders.sources()));
   }
   if (!_liquid_render)
   {
@@ -911,12 +710,7 @@ void World::draw ( math::matrix_4x4 const& model_view
   }
   if (!_wmo_program)
   {
-    _wmo_program.reset
-      ( new opengl::program
-          { { GL_VERTEX_SHADER,   opengl::shader::src_from_qrc("wmo_vs") }
-          , { GL_FRAGMENT_SHADER, opengl::shader::src_from_qrc("wmo_fs") }
-          }
-      );
+    _wmo_program.reset (new opengl::program (wmo_shaders.sources()));
   }
 
   gl.disable(GL_DEPTH_TEST);
@@ -999,6 +793,14 @@ void World::draw ( math::matrix_4x4 const& model_view
 
   culldistance = draw_fog ? fogdistance : _view_distance;
 
+  horizon.queue_outdated_tiles(mapIndex);
+  horizon.apply_finished_updates();
+
+  if (_horizon_render)
+  {
+    _horizon_render->update(horizon);
+  }
+
   // Draw verylowres heightmap
   if (draw_fog && draw_terrain)
   {
@@ -1029,14 +831,13 @@ void World::draw ( math::matrix_4x4 const& model_view
       mcnk_shader.uniform ("draw_impassible_flag", 0);
     }
 
+    noggit::settings_snapshot const& settings (noggit::current_settings());
+
     mcnk_shader.uniform ("draw_wireframe", (int)draw_wireframe);
-    mcnk_shader.uniform ("wireframe_type", _settings->value("wireframe/type", 0).toInt());
-    mcnk_shader.uniform ("wireframe_radius", _settings->value("wireframe/radius", 1.5f).toFloat());
-    mcnk_shader.uniform ("wireframe_width", _settings->value ("wireframe/width", 1.f).toFloat());
-    // !\ todo store the color somewhere ?
-    QColor c = _settings->value("wireframe/color").value<QColor>();
-    math::vector_4d wireframe_color(c.redF(), c.greenF(), c.blueF(), c.alphaF());
-    mcnk_shader.uniform ("wireframe_color", wireframe_color);
+    mcnk_shader.uniform ("wireframe_type", settings.wireframe_type);
+    mcnk_shader.uniform ("wireframe_radius", settings.wireframe_radius);
+    mcnk_shader.uniform ("wireframe_width", settings.wireframe_width);
+    mcnk_shader.uniform ("wireframe_color", settings.wireframe_color);
 
     mcnk_shader.uniform ("draw_fog", (int)draw_fog);
     mcnk_shader.uniform ("fog_color", math::vector_4d(skies->color_set[FOG_COLOR], 1));
@@ -1146,9 +947,15 @@ void World::draw ( math::matrix_4x4 const& model_view
     float size = (vertexCenter() - camera_pos).length();
     gl.pointSize(std::max(0.001f, 10.0f - (1.25f * size / CHUNKSIZE)));
 
-    for (math::vector_3d const* pos : _vertices_selected)
+    for (auto const& entry : _vertices_selected.entries())
     {
-      _sphere_render.draw(mvp, *pos, math::vector_4d(1.f, 0.f, 0.f, 1.f), 0.5f);
+      for (std::size_t i (0); i < entry.vertices.size(); ++i)
+      {
+        if (entry.vertices[i])
+        {
+          _sphere_render.draw(mvp, entry.chunk->mVertices[i], math::vector_4d(1.f, 0.f, 0.f, 1.f), 0.5f);
+        }
+      }
     }
 
     _sphere_render.draw(mvp, vertexCenter(), cursor_color, 2.f);
@@ -1281,7 +1088,7 @@ void World::draw ( math::matrix_4x4 const& model_view
         auto model = boost::get<selected_model_type>(selection);
         if (model->is_visible(frustum, culldistance, camera_pos, display))
         {
-          model->draw_box(model_view, projection, true);
+          model->draw_box(_debug_geometry, true);
         }
       }
     }
@@ -1344,8 +1151,7 @@ void World::draw ( math::matrix_4x4 const& model_view
         if (draw_hidden_models || !is_hidden)
         {
           wmo.draw( wmo_program
-                  , model_view
-                  , projection
+                  , _debug_geometry
                   , frustum
                   , culldistance
                   , camera_pos
@@ -1353,7 +1159,6 @@ void World::draw ( math::matrix_4x4 const& model_view
                   , draw_wmo_doodads
                   , draw_fog
                   , _liquid_render.get()
-                  , current_selection()
                   , animtime
                   , skies->hasSkies()
                   , display
@@ -1368,6 +1173,9 @@ void World::draw ( math::matrix_4x4 const& model_view
     }
   }
 
+  // bounding boxes of the models and WMOs, in one draw
+  _debug_render.flush (model_view, projection, _debug_geometry);
+
   // model particles
   if (draw_model_animations && !model_with_particles.empty())
   {
@@ -1433,13 +1241,13 @@ void World::draw ( math::matrix_4x4 const& model_view
                       , camera_pos
                       , camera_moved
                       , _liquid_render.get()
-                      , water_shader
-                      , animtime
                       , water_layer
                       , display
                       );
     }
 
+    _liquid_render->draw_queued(water_shader);
+
     gl.bindVertexArray(0);
     gl.bindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
   }
@@ -1581,6 +1389,8 @@ void World::clearHeight(math::vector_3d const& pos)
 
 void World::clearAllModelsOnADT(tile_index const& tile)
 {
+  reset_selection();
+
   _model_instance_storage.delete_instances_from_tile(tile);
   update_models_by_filename();
 }
@@ -1772,6 +1582,51 @@ void World::recalc_norms (MapChunk* chunk) const
                      );
 }
 
+void World::recalc_norms (noggit::chunk_vertex_masks<MapChunk> const& vertices) const
+{
+  auto const height
+    ( [this] (float x, float z) -> boost::optional<float>
+      {
+        math::vector_3d vec;
+        auto res (GetVertex (x, z, &vec));
+        return boost::make_optional (res, vec.y);
+      }
+    );
+
+  auto const& entries (vertices.entries());
+  noggit::parallel_for(entries.size(), [&] (std::size_t i)
+  {
+    entries[i].chunk->compute_normals (height, entries[i].vertices);
+  });
+
+  for (auto const& entry : entries)
+  {
+    entry.chunk->upload_normals (entry.vertices);
+  }
+}
+
+void World::recalc_norms (std::vector<MapChunk*> const& chunks) const
+{
+  auto const height
+    ( [this] (float x, float z) -> boost::optional<float>
+      {
+        math::vector_3d vec;
+        auto res (GetVertex (x, z, &vec));
+        return boost::make_optional (res, vec.y);
+      }
+    );
+
+  noggit::parallel_for(chunks.size(), [&] (std::size_t i)
+  {
+    chunks[i]->compute_normals (height);
+  });
+
+  for (MapChunk* chunk : chunks)
+  {
+    chunk->upload_normals();
+  }
+}
+
 bool World::paintTexture(math::vector_3d const& pos, Brush* brush, float strength, float pressure, scoped_blp_texture_reference texture)
 {
   return for_all_chunks_in_range
@@ -1900,41 +1755,132 @@ MapChunk * World::get_chunk_at(math::vector_3d const& pos)
   return nullptr;
 }
 
-void World::convert_alphamap(bool to_big_alpha)
+bool World::convert_alphamap(bool to_big_alpha, noggit::tile_pipeline_progress const& progress)
 {
   if (to_big_alpha == mapIndex.hasBigAlpha())
   {
-    return;
+    return true;
   }
 
+  std::vector<tile_index> tiles;
   for (size_t z = 0; z < 64; z++)
   {
     for (size_t x = 0; x < 64; x++)
     {
-      tile_index tile(x, z);
+      if (mapIndex.hasTile(tile_index(x, z)))
+      {
+        tiles.emplace_back(x, z);
+      }
+    }
+  }
 
-      bool unload = !mapIndex.tileLoaded(tile) && !mapIndex.tileAwaitingLoading(tile);
-      MapTile* mTile = mapIndex.loadTile(tile);
+  std::vector<tile_index> converted;
 
-      if (mTile)
+  // a map with both formats can't be read, tiles are loaded in the
+  // format of the wdt so it has to match the converted tiles meanwhile
+  auto const revert
+    ( [&]
       {
-        mTile->wait_until_loaded();
+        std::vector<tile_index> reverted;
+        mapIndex.convert_alphamap(to_big_alpha);
+        convert_tiles_alphamap(converted, !to_big_alpha, {}, reverted);
+        mapIndex.convert_alphamap(!to_big_alpha);
+      }
+    );
 
-        mTile->convert_alphamap(to_big_alpha);
-        mTile->saveTile(this);
-        mapIndex.markOnDisc (tile, true);
-        mapIndex.unsetChanged(tile);
+  bool completed;
+  try
+  {
+    completed = convert_tiles_alphamap(tiles, to_big_alpha, progress, converted);
+  }
+  catch (...)
+  {
+    revert();
+    throw;
+  }
 
-        if (unload)
-        {
-          mapIndex.unloadTile(tile);
-        }
-      }
-    }
+  if (!completed)
+  {
+    revert();
+    return false;
   }
 
   mapIndex.convert_alphamap(to_big_alpha);
   mapIndex.save();
+
+  return true;
+}
+
+bool World::convert_tiles_alphamap ( std::vector<tile_index> const& tiles
+                                   , bool to_big_alpha
+                                   , noggit::tile_pipeline_progress const& progress
+                                   , std::vector<tile_index>& converted
+                                   )
+{
+  // tiles loaded by the conversion are unloaded again once saved
+  std::vector<bool> unload (64 * 64, false);
+  std::vector<MapTile*> loaded (64 * 64, nullptr);
+  std::mutex loaded_mutex;
+
+  noggit::tile_pipeline_stages stages;
+
+  stages.start = [&] (tile_index const& tile)
+  {
+    bool const was_loaded = mapIndex.tileLoaded(tile) || mapIndex.tileAwaitingLoading(tile);
+    MapTile* mTile = mapIndex.loadTile(tile);
+
+    if (!mTile)
+    {
+      return false;
+    }
+
+    unload[tile.z * 64 + tile.x] = !was_loaded;
+
+    std::lock_guard<std::mutex> const lock (loaded_mutex);
+    loaded[tile.z * 64 + tile.x] = mTile;
+    return true;
+  };
+
+  // the tiles are parsed by the async loader, the workers wait for them,
+  // convert and write them
+  stages.work = [&] (tile_index const& tile)
+  {
+    MapTile* mTile;
+    {
+      std::lock_guard<std::mutex> const lock (loaded_mutex);
+      mTile = loaded[tile.z * 64 + tile.x];
+    }
+
+    mTile->wait_until_loaded();
+
+    mTile->convert_alphamap(to_big_alpha);
+
+    try
+    {
+      mTile->saveTile(this);
+    }
+    catch (...)
+    {
+      // not finished so not reverted, keep saving it in the map's format
+      mTile->convert_alphamap(!to_big_alpha);
+      throw;
+    }
+  };
+
+  stages.finish = [&] (tile_index const& tile)
+  {
+    converted.push_back(tile);
+
+    mapIndex.markOnDisc (tile, true);
+    mapIndex.unsetChanged(tile);
+
+    if (unload[tile.z * 64 + tile.x])
+    {
+      mapIndex.unloadTile(tile);
+    }
+  };
+
+  return noggit::run_tile_pipeline(tiles, stages, progress);
 }
 
 void World::saveMap (int, int)
@@ -1998,14 +1944,16 @@ ModelInstance* World::addM2 ( std::string const& filename
   model_instance.scale = scale;
   model_instance.dir = rotation;
 
-  if (_settings->value("model/random_rotation", false).toBool())
+  noggit::settings_snapshot const& settings (noggit::current_settings());
+
+  if (settings.model_random_rotation)
   {
     float min = paste_params->minRotation;
     float max = paste_params->maxRotation;
     model_instance.dir.y += math::degrees(misc::randfloat(min, max));
   }
 
-  if (_settings->value ("model/random_tilt", false).toBool ())
+  if (settings.model_random_tilt)
   {
     float min = paste_params->minTilt;
     float max = paste_params->maxTilt;
@@ -2013,7 +1961,7 @@ ModelInstance* World::addM2 ( std::string const& filename
     model_instance.dir.z += math::degrees(misc::randfloat(min, max));
   }
 
-  if (_settings->value ("model/random_size", false).toBool ())
+  if (settings.model_random_size)
   {
     float min = paste_params->minScale;
     float max = paste_params->maxScale;
@@ -2081,7 +2029,7 @@ void World::remove_models_if_needed(std::vector<uint32_t> const& uids)
   }
 
   // deselect the terrain when an adt is unloaded
-  if (_current_selection.size() == 1 && _current_selection.at(0).which() == eEntry_MapChunk)
+  if (_current_selection.size() == 1 && _current_selection.entries().front().which() == eEntry_MapChunk)
   {
     reset_selection();
   }
@@ -2095,15 +2043,76 @@ void World::reload_tile(tile_index const& tile)
   mapIndex.reloadTile(tile);
 }
 
-void World::updateTilesEntry(selection_type const& entry, model_update type)
+void World::transform_selected_models(std::function<bool (selection_type const&)> const& transform)
 {
-  if (entry.which() == eEntry_WMO)
+  auto const covered_tiles ([] (selection_type const& entry)
+  {
+    if (entry.which() == eEntry_Model)
+    {
+      ModelInstance* model = boost::get<selected_model_type>(entry);
+      model->model->wait_until_loaded();
+      auto const& extents (model->extents());
+      return std::make_pair(tile_index(extents[0]), tile_index(extents[1]));
+    }
+
+    WMOInstance* wmo = boost::get<selected_wmo_type>(entry);
+    return std::make_pair(tile_index(wmo->extents[0]), tile_index(wmo->extents[1]));
+  });
+
+  // the queue may still be reading the extents of these instances
+  _tile_update_queue.wait_for_all_update();
+
+  std::vector<selection_type> changed;
+  std::vector<std::pair<tile_index, tile_index>> old_tiles;
+
+  for (auto& entry : _current_selection.entries())
   {
-    updateTilesWMO (boost::get<selected_wmo_type> (entry), type);
+    if (entry.which() == eEntry_MapChunk)
+    {
+      continue;
+    }
+
+    auto tiles (covered_tiles(entry));
+
+    if (transform(entry))
+    {
+      changed.push_back(entry);
+      old_tiles.push_back(tiles);
+    }
+  }
+
+  noggit::parallel_for(changed.size(), [&] (std::size_t i)
+  {
+    if (changed[i].which() == eEntry_Model)
+    {
+      boost::get<selected_model_type>(changed[i])->recalcExtents();
+    }
+    else
+    {
+      boost::get<selected_wmo_type>(changed[i])->recalcExtents();
+    }
+  });
+
+  std::vector<noggit::instance_tiles_change> changes;
+
+  for (std::size_t i = 0; i < changed.size(); ++i)
+  {
+    auto const new_tiles (covered_tiles(changed[i]));
+
+    changes.push_back ( { changed[i].which() == eEntry_Model
+                          ? boost::get<selected_model_type>(changed[i])->uid
+                          : boost::get<selected_wmo_type>(changed[i])->mUniqueID
+                        , old_tiles[i].first
+                        , old_tiles[i].second
+                        , new_tiles.first
+                        , new_tiles.second
+                        }
+                      );
   }
-  else if (entry.which() == eEntry_Model)
+
+  if (!changes.empty())
   {
-    updateTilesModel (boost::get<selected_model_type> (entry), type);
+    _tile_update_queue.queue_update(std::move(changes));
   }
 }
 
@@ -2223,79 +2232,84 @@ void World::autoGenWaterTrans(const tile_index& pos, float factor)
 
 void World::fixAllGaps()
 {
-  std::vector<MapChunk*> chunks;
+  std::vector<MapTile*> map_tiles;
+  std::vector<noggit::stitched_tile> tiles;
+  std::map<MapTile*, std::size_t> tile_ids;
 
-  for (MapTile* tile : mapIndex.loaded_tiles())
-  {
-    MapTile* left = mapIndex.getTileLeft(tile);
-    MapTile* above = mapIndex.getTileAbove(tile);
-    bool tileChanged = false;
-
-    // fix the gaps with the adt at the left of the current one
-    if (left)
-    {
-      for (size_t ty = 0; ty < 16; ty++)
+  auto const add_tile
+    ( [&] (MapTile* tile, bool stitch)
       {
-        MapChunk* chunk = tile->getChunk(0, ty);
-        if (chunk->fixGapLeft(left->getChunk(15, ty)))
+        auto const inserted (tile_ids.emplace (tile, tiles.size()));
+        if (inserted.second)
         {
-          chunks.emplace_back(chunk);
-          tileChanged = true;
+          map_tiles.emplace_back (tile);
+          tiles.emplace_back();
+          tiles.back().stitch = stitch;
+          for (size_t ty = 0; ty < 16; ty++)
+          {
+            for (size_t tx = 0; tx < 16; tx++)
+            {
+              tiles.back().chunks[ty * 16 + tx] = tile->getChunk(tx, ty)->mVertices;
+            }
+          }
         }
+        return inserted.first->second;
       }
-    }
+    );
 
-    // fix the gaps with the adt above the current one
-    if (above)
+  for (MapTile* tile : mapIndex.loaded_tiles())
+  {
+    add_tile (tile, true);
+  }
+
+  // neighbours being loaded are waited for, but not stitched themselves
+  std::vector<std::pair<std::size_t, std::size_t>> lefts, aboves;
+  for (std::size_t i = 0, count = map_tiles.size(); i < count; ++i)
+  {
+    if (MapTile* left = mapIndex.getTileLeft(map_tiles[i]))
     {
-      for (size_t tx = 0; tx < 16; tx++)
-      {
-        MapChunk* chunk = tile->getChunk(tx, 0);
-        if (chunk->fixGapAbove(above->getChunk(tx, 15)))
-        {
-          chunks.emplace_back(chunk);
-          tileChanged = true;
-        }
-      }
+      lefts.emplace_back (i, add_tile (left, false));
     }
-
-    // fix gaps within the adt
-    for (size_t ty = 0; ty < 16; ty++)
+    if (MapTile* above = mapIndex.getTileAbove(map_tiles[i]))
     {
-      for (size_t tx = 0; tx < 16; tx++)
-      {
-        MapChunk* chunk = tile->getChunk(tx, ty);
-        bool changed = false;
+      aboves.emplace_back (i, add_tile (above, false));
+    }
+  }
+  for (auto const& left : lefts)
+  {
+    tiles[left.first].left = &tiles[left.second];
+  }
+  for (auto const& above : aboves)
+  {
+    tiles[above.first].above = &tiles[above.second];
+  }
 
-        // if the chunk isn't the first of the row
-        if (tx && chunk->fixGapLeft(tile->getChunk(tx - 1, ty)))
-        {
-          changed = true;
-        }
+  noggit::stitch_chunk_edges (tiles);
 
-        // if the chunk isn't the first of the column
-        if (ty && chunk->fixGapAbove(tile->getChunk(tx, ty - 1)))
-        {
-          changed = true;
-        }
+  std::vector<MapChunk*> chunks;
 
-        if (changed)
-        {
-          chunks.emplace_back(chunk);
-          tileChanged = true;
-        }
+  for (std::size_t i = 0; i < tiles.size(); ++i)
+  {
+    bool tileChanged = false;
+
+    for (size_t c = 0; c < 256; ++c)
+    {
+      if (tiles[i].changed[c])
+      {
+        MapChunk* chunk = map_tiles[i]->getChunk(c % 16, c / 16);
+        chunk->updateVerticesData();
+        chunks.emplace_back(chunk);
+        tileChanged = true;
       }
     }
+
     if (tileChanged)
     {
-      mapIndex.setChanged(tile);
+      mapIndex.setChanged(map_tiles[i]);
     }
   }
 
-  for (MapChunk* chunk : chunks)
-  {
-    recalc_norms (chunk);
-  }
+  recalc_norms (chunks);
 }
 
 bool World::isUnderMap(math::vector_3d const& pos)
@@ -2317,18 +2331,21 @@ bool World::isUnderMap(math::vector_3d const& pos)
 void World::selectVertices(math::vector_3d const& pos, float radius)
 {
   _vertex_center_updated = false;
-  _vertex_border_updated = false;
 
   for_all_chunks_in_range(pos, radius, [&](MapChunk* chunk){
-    _vertex_chunks.emplace(chunk);
-    _vertex_tiles.emplace(chunk->mt);
-    chunk->selectVertex(pos, radius, _vertices_selected);
+    _vertices_selected.add(chunk, chunk->selectVertex(pos, radius));
     return true;
   });
 }
 
 void World::delete_models(std::vector<selection_type> const& types)
 {
+  // the instances have to leave the selection before they are destroyed
+  if (_current_selection.remove(types))
+  {
+    update_selection_pivot();
+  }
+
   _model_instance_storage.delete_instances(types);
   need_model_updates = true;
 }
@@ -2338,12 +2355,9 @@ void World::selectVertices(math::vector_3d const& pos1, math::vector_3d const& p
   math::vector_3d pos_min = math::vector_3d(std::min(pos1.x,pos2.x),std::min(pos1.y,pos2.y),std::min(pos1.z,pos2.z));
   math::vector_3d pos_max = math::vector_3d(std::max(pos1.x,pos2.x),std::max(pos1.y,pos2.y),std::max(pos1.z,pos2.z));
   _vertex_center_updated = false;
-  _vertex_border_updated = false;
 
   for_all_chunks_between(pos_min, pos_max, [&](MapChunk* chunk){
-    _vertex_chunks.emplace(chunk);
-    _vertex_tiles.emplace(chunk->mt);
-    chunk->selectVertex(pos_min, pos_max, _vertices_selected);
+    _vertices_selected.add(chunk, chunk->selectVertex(pos_min, pos_max));
     return true;
   });
 }
@@ -2359,9 +2373,9 @@ void World::select_all_chunks_between(math::vector_3d const& pos1, math::vector_
   });
 }
 
-std::set<math::vector_3d*>* World::getSelectedVertices()
+noggit::chunk_vertex_masks<MapChunk> const& World::getSelectedVertices() const
 {
-  return &_vertices_selected;
+  return _vertices_selected;
 }
 
 template<typename Fun>
@@ -2391,20 +2405,17 @@ bool World::for_all_chunks_between (math::vector_3d const& pos1, math::vector_3d
 bool World::deselectVertices(math::vector_3d const& pos, float radius)
 {
   _vertex_center_updated = false;
-  _vertex_border_updated = false;
-  std::set<math::vector_3d*> inRange;
 
-  for (math::vector_3d* v : _vertices_selected)
+  // copied, removing the last vertex of a chunk drops its entry
+  auto const selected (_vertices_selected.entries());
+  for (auto const& entry : selected)
   {
-    if (misc::dist(*v, pos) <= radius)
+    noggit::vertex_mask in_range;
+    for (std::size_t i (0); i < in_range.size(); ++i)
     {
-      inRange.emplace(v);
+      in_range[i] = entry.vertices[i] && misc::dist(entry.chunk->mVertices[i], pos) <= radius;
     }
-  }
-
-  for (math::vector_3d* v : inRange)
-  {
-    _vertices_selected.erase(v);
+    _vertices_selected.remove(entry.chunk, in_range);
   }
 
   return _vertices_selected.empty();
@@ -2413,9 +2424,12 @@ bool World::deselectVertices(math::vector_3d const& pos, float radius)
 void World::moveVertices(float h)
 {
   _vertex_center_updated = false;
-  for (math::vector_3d* v : _vertices_selected)
+  for (auto const& entry : _vertices_selected.entries())
   {
-    v->y += h;
+    for (std::size_t i (0); i < entry.vertices.size(); ++i)
+    {
+      entry.chunk->mVertices[i].y += entry.vertices[i] ? h : 0.f;
+    }
   }
 
   updateVertexCenter();
@@ -2424,22 +2438,64 @@ void World::moveVertices(float h)
 
 void World::updateSelectedVertices()
 {
-  for (MapTile* tile : _vertex_tiles)
-  {
-    mapIndex.setChanged(tile);
-  }
+  std::vector<MapTile*> tiles;
+  // the normals reading a moved vertex, which includes the edges of
+  // neighbouring chunks without any selected vertex
+  noggit::chunk_vertex_masks<MapChunk> normals;
 
-  // fix only the border chunks to be more efficient
-  for (MapChunk* chunk : vertexBorderChunks())
+  for (auto const& entry : _vertices_selected.entries())
   {
-    chunk->fixVertices(_vertices_selected);
+    MapChunk* chunk (entry.chunk);
+    noggit::vertex_mask moved (entry.vertices);
+
+    // only the chunks at the selection's border have cells with unselected corners
+    if (!entry.vertices.all())
+    {
+      moved |= chunk->fixVertices(entry.vertices);
+    }
+
+    chunk->updateVerticesData(moved);
+    tiles.emplace_back(chunk->mt);
+
+    normals.add(chunk, noggit::normal_dependents(moved));
+    for (int dz (-1); dz <= 1; ++dz)
+    {
+      for (int dx (-1); dx <= 1; ++dx)
+      {
+        noggit::vertex_mask const dependents
+          ((dx || dz) ? noggit::neighbour_normal_dependents(moved, dx, dz) : noggit::vertex_mask());
+        if (dependents.none())
+        {
+          continue;
+        }
+
+        math::vector_3d const neighbour_center
+          ( chunk->xbase + CHUNKSIZE * (dx + 0.5f)
+          , 0.f
+          , chunk->zbase + CHUNKSIZE * (dz + 0.5f)
+          );
+        // there is no tile before the map's first one
+        MapChunk* neighbour ( neighbour_center.x < 0.f || neighbour_center.z < 0.f
+                            ? nullptr
+                            : get_chunk_at(neighbour_center)
+                            );
+        if (neighbour)
+        {
+          normals.add(neighbour, dependents);
+          tiles.emplace_back(neighbour->mt);
+        }
+      }
+    }
   }
 
-  for (MapChunk* chunk : _vertex_chunks)
+  std::sort(tiles.begin(), tiles.end());
+  tiles.erase(std::unique(tiles.begin(), tiles.end()), tiles.end());
+  for (MapTile* tile : tiles)
   {
-    chunk->updateVerticesData();
-    recalc_norms (chunk);
+    mapIndex.setChanged(tile);
   }
+
+  recalc_norms (normals);
 }
 
 void World::orientVertices ( math::vector_3d const& ref_pos
@@ -2447,39 +2503,61 @@ void World::orientVertices ( math::vector_3d const& ref_pos
                            , math::degrees vertex_orientation
                            )
 {
-  for (math::vector_3d* v : _vertices_selected)
+  for (auto const& entry : _vertices_selected.entries())
   {
-    v->y = misc::angledHeight(ref_pos, *v, vertex_angle, vertex_orientation);
+    for (std::size_t i (0); i < entry.vertices.size(); ++i)
+    {
+      if (entry.vertices[i])
+      {
+        math::vector_3d& v (entry.chunk->mVertices[i]);
+        v.y = misc::angledHeight(ref_pos, v, vertex_angle, vertex_orientation);
+      }
+    }
   }
   updateSelectedVertices();
 }
 
 void World::flattenVertices (float height)
 {
-  for (math::vector_3d* v : _vertices_selected)
+  for (auto const& entry : _vertices_selected.entries())
   {
-    v->y = height;
+    for (std::size_t i (0); i < entry.vertices.size(); ++i)
+    {
+      if (entry.vertices[i])
+      {
+        entry.chunk->mVertices[i].y = height;
+      }
+    }
   }
   updateSelectedVertices();
 }
 
 void World::clearVertexSelection()
 {
-  _vertex_border_updated = false;
   _vertex_center_updated = false;
   _vertices_selected.clear();
-  _vertex_chunks.clear();
-  _vertex_tiles.clear();
+}
+
+void World::unselect_vertices_of (MapTile* tile)
+{
+  _vertex_center_updated = false;
+  _vertices_selected.remove_chunks ([tile] (MapChunk* chunk) { return chunk->mt == tile; });
 }
 
 void World::updateVertexCenter()
 {
   _vertex_center_updated = true;
   _vertex_center = { 0,0,0 };
-  float f = 1.0f / _vertices_selected.size();
-  for (math::vector_3d* v : _vertices_selected)
+  float f = 1.0f / _vertices_selected.vertex_count();
+  for (auto const& entry : _vertices_selected.entries())
   {
-    _vertex_center += (*v) * f;
+    for (std::size_t i (0); i < entry.vertices.size(); ++i)
+    {
+      if (entry.vertices[i])
+      {
+        _vertex_center += entry.chunk->mVertices[i] * f;
+      }
+    }
   }
 }
 
@@ -2493,24 +2571,6 @@ math::vector_3d const& World::vertexCenter()
   return _vertex_center;
 }
 
-std::set<MapChunk*>& World::vertexBorderChunks()
-{
-  if (!_vertex_border_updated)
-  {
-    _vertex_border_updated = true;
-    _vertex_border_chunks.clear();
-
-    for (MapChunk* chunk : _vertex_chunks)
-    {
-      if (chunk->isBorderChunk(_vertices_selected))
-      {
-        _vertex_border_chunks.emplace(chunk);
-      }
-    }
-  }
-  return _vertex_border_chunks;
-}
-
 void World::update_models_by_filename()
 {
   _models_by_filename.clear();
@@ -12,8 +12,11 @@
 #include <noggit/WMO.h> // WMOManager
 #include <noggit/map_horizon.h>
 #include <noggit/map_index.hpp>
+#include <noggit/selection_set.hpp>
 #include <noggit/tile_index.hpp>
+#include <noggit/tile_pipeline.hpp>
 #include <noggit/tool_enums.hpp>
+#include <noggit/vertex_selection.hpp>
 #include <noggit/world_tile_update_queue.hpp>
 #include <noggit/world_model_instances_storage.hpp>
 #include <opengl/primitives.hpp>
@@ -23,6 +26,7 @@
 
 #include <QtCore/QSettings>
 
+#include <functional>
 #include <map>
 #include <string>
 #include <unordered_set>
@@ -142,9 +146,8 @@ public:
 
 private:
   // Information about the currently selected model / WMO / triangle.
-  std::vector<selection_type> _current_selection;
+  noggit::selection_set _current_selection;
   boost::optional<math::vector_3d> _multi_select_pivot;
-  int _selected_model_count = 0;
   void update_selection_pivot();
 public:
 
@@ -153,10 +156,10 @@ public:
   // Selection related methods.
   bool is_selected(selection_type selection) const;
   bool is_selected(std::uint32_t uid) const;
-  std::vector<selection_type> const& current_selection() const { return _current_selection; }
+  std::vector<selection_type> const& current_selection() const { return _current_selection.entries(); }
   boost::optional<selection_type> get_last_selected_model() const;
   bool has_selection() const { return !_current_selection.empty(); }
-  bool has_multiple_model_selected() const { return _selected_model_count > 1; }
+  bool has_multiple_model_selected() const { return _current_selection.instance_count() > 1; }
   void set_current_selection(selection_type entry);
   void add_to_selection(selection_type entry);
   void remove_from_selection(selection_type entry);
@@ -260,7 +263,11 @@ public:
 
   void reload_tile(tile_index const& tile);
 
-  void updateTilesEntry(selection_type const& entry, model_update type);
+  //! Calls transform for every selected model and WMO, which returns true
+  //! if it changed the instance. The extents of the changed instances are
+  //! then recalculated in parallel and their tiles updated in one queued
+  //! pass, instead of waiting for the update queue once per instance.
+  void transform_selected_models(std::function<bool (selection_type const&)> const& transform);
   void updateTilesWMO(WMOInstance* wmo, model_update type);
   void updateTilesModel(ModelInstance* m2, model_update type);
   void wait_for_all_tile_updates();
@@ -301,13 +308,16 @@ public:
 
   void fixAllGaps();
 
-  void convert_alphamap(bool to_big_alpha);
+  //! converts and saves every tile of the map, loading and saving several
+  //! tiles at once. When cancelled or if a tile fails, the tiles converted
+  //! so far are converted back and false is returned or the error rethrown.
+  bool convert_alphamap(bool to_big_alpha, noggit::tile_pipeline_progress const& progress = {});
 
   bool deselectVertices(math::vector_3d const& pos, float radius);
   void selectVertices(math::vector_3d const& pos, float radius);
   void delete_models(std::vector<selection_type> const& types);
   void selectVertices(math::vector_3d const& pos1, math::vector_3d const& pos2);
-  std::set<math::vector_3d*>* getSelectedVertices();
+  noggit::chunk_vertex_masks<MapChunk> const& getSelectedVertices() const;
 
   template<typename Fun>
   bool for_all_chunks_between ( math::vector_3d const& pos1,
@@ -339,25 +349,31 @@ public:
   void updateSelectedVertices();
   void updateVertexCenter();
   void clearVertexSelection();
+  //! drops the tile's chunks from the vertex selection before it is unloaded
+  void unselect_vertices_of (MapTile*);
 
   math::vector_3d const& vertexCenter();
 
   void recalc_norms (MapChunk*) const;
+  //! the chunks' normals are computed in parallel, then uploaded
+  void recalc_norms (std::vector<MapChunk*> const&) const;
+  //! only the normals of the given vertices, uploading their range
+  void recalc_norms (noggit::chunk_vertex_masks<MapChunk> const&) const;
 
   bool need_model_updates = false;
 
 private:
   void update_models_by_filename();
 
-  std::set<MapChunk*>& vertexBorderChunks();
+  bool convert_tiles_alphamap ( std::vector<tile_index> const& tiles
+                              , bool to_big_alpha
+                              , noggit::tile_pipeline_progress const& progress
+                              , std::vector<tile_index>& converted
+                              );
 
-  std::set<MapTile*> _vertex_tiles;
-  std::set<MapChunk*> _vertex_chunks;
-  std::set<MapChunk*> _vertex_border_chunks;
-  std::set<math::vector_3d*> _vertices_selected;
+  noggit::chunk_vertex_masks<MapChunk> _vertices_selected;
   math::vector_3d _vertex_center;
   bool _vertex_center_updated = false;
-  bool _vertex_border_updated = false;
 
   std::unique_ptr<noggit::map_horizon::render> _horizon_render;
 
@@ -378,6 +394,8 @@ private:
 
   noggit::cursor_render _cursor_render;
   opengl::primitives::sphere _sphere_render;
+  opengl::debug_geometry _debug_geometry;
+  opengl::primitives::debug_renderer _debug_render;
   opengl::primitives::square _square_render;
 
   boost::optional<liquid_render> _liquid_render = boost::none;
@@ -0,0 +1,157 @@
+// This file is part of Noggit3, licensed under GNU General Public License (version 3).
+
+#pragma once
+
+#include <math/interpolation.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Animation
+{
+  namespace Interpolation
+  {
+    //! \todo C++0x: Change namespace to "enum class Type : int16_t", remove typedef.
+    namespace Type
+    {
+      typedef int16_t Type_t;
+      enum
+      {
+        NONE,
+        LINEAR,
+        HERMITE
+      };
+    }
+  }
+
+  //! The keyframes of one animation of an M2Value.
+  template<class AnimatedType>
+  class track
+  {
+  public:
+    typedef uint32_t TimestampType;
+
+    std::vector<TimestampType> times;
+    std::vector<AnimatedType> data;
+
+    // for nonlinear interpolations:
+    std::vector<AnimatedType> in;
+    std::vector<AnimatedType> out;
+
+    //! to be called once the timestamps are filled in
+    void timestamps_changed()
+    {
+      _sorted = std::is_sorted (times.begin(), times.end());
+      _cursor = 0;
+    }
+
+    AnimatedType value (TimestampType time, Interpolation::Type::Type_t interpolation_type)
+    {
+      if (data.empty())
+      {
+        return AnimatedType();
+      }
+
+      AnimatedType result = data[0];
+
+      if (!times.empty())
+      {
+        TimestampType max_time = times.back();
+        if (max_time > 0)
+        {
+          time %= max_time;
+        }
+        else
+        {
+          time = TimestampType();
+        }
+
+        size_t const pos = keyframe (time);
+
+        if (pos == times.size() - 1 || interpolation_type == Interpolation::Type::NONE)
+        {
+          result = data[pos];
+        }
+        else
+        {
+          TimestampType t1 = times[pos];
+          TimestampType t2 = times[pos + 1];
+          const float percentage = (time - t1) / static_cast<float>(t2 - t1);
+
+          switch (interpolation_type)
+          {
+          case Interpolation::Type::LINEAR:
+          {
+            result = math::interpolation::linear (percentage, data[pos], data[pos + 1]);
+          }
+            break;
+
+          case Interpolation::Type::HERMITE:
+          {
+            result = math::interpolation::hermite (percentage, data[pos], data[pos + 1], in[pos], out[pos]);
+          }
+            break;
+          }
+        }
+      }
+
+      return result;
+    }
+
+  private:
+    //! First i with times[i] <= time < times[i + 1], 0 if there is none.
+    //! Time mostly advances by less than a keyframe between two calls, so
+    //! the interval of the last call and the one after it are tried first.
+    size_t keyframe (TimestampType time)
+    {
+      if (times.size() < 2)
+      {
+        return 0;
+      }
+
+      auto const contains
+      (
+        [&] (size_t i)
+        {
+          return time >= times[i] && time < times[i + 1];
+        }
+      );
+
+      // broken tracks: the first match is not the only one, keep scanning
+      if (!_sorted)
+      {
+        for (size_t i = 0; i < times.size() - 1; ++i)
+        {
+          if (contains (i))
+          {
+            return i;
+          }
+        }
+        return 0;
+      }
+
+      if (_cursor + 1 < times.size() && contains (_cursor))
+      {
+        return _cursor;
+      }
+      if (_cursor + 2 < times.size() && contains (_cursor + 1))
+      {
+        return ++_cursor;
+      }
+
+      auto const next (std::upper_bound (times.begin(), times.end(), time));
+
+      if (next == times.begin() || next == times.end())
+      {
+        return 0;
+      }
+
+      return _cursor = (next - times.begin()) - 1;
+    }
+
+    size_t _cursor = 0;
+    bool _sorted = true;
+  };
+}
@@ -11,6 +11,7 @@
 #include <noggit/WMO.h> // WMOManager::report()
 #include <noggit/errorHandling.h>
 #include <noggit/liquid_layer.hpp>
+#include <noggit/ui/SettingsPanel.h>
 #include <noggit/ui/main_window.hpp>
 #include <opengl/context.hpp>
 #include <util/exception_to_string.hpp>
@@ -45,7 +46,6 @@ public:
 
 private:
   void initPath(char *argv[]);
-  void loadMPQs();
 
   std::unique_ptr<noggit::ui::main_window> main_window;
 
@@ -77,94 +77,6 @@ void Noggit::initPath(char *argv[])
   }
 }
 
-void Noggit::loadMPQs()
-{
-  std::vector<std::string> archiveNames;
-  archiveNames.push_back("common.MPQ");
-  archiveNames.push_back("common-2.MPQ");
-  archiveNames.push_back("expansion.MPQ");
-  archiveNames.push_back("lichking.MPQ");
-  archiveNames.push_back("patch.MPQ");
-  archiveNames.push_back("patch-{number}.MPQ");
-  archiveNames.push_back("patch-{character}.MPQ");
-
-  //archiveNames.push_back( "{locale}/backup-{locale}.MPQ" );
-  //archiveNames.push_back( "{locale}/base-{locale}.MPQ" );
-  archiveNames.push_back("{locale}/locale-{locale}.MPQ");
-  //archiveNames.push_back( "{locale}/speech-{locale}.MPQ" );
-  archiveNames.push_back("{locale}/expansion-locale-{locale}.MPQ");
-  //archiveNames.push_back( "{locale}/expansion-speech-{locale}.MPQ" );
-  archiveNames.push_back("{locale}/lichking-locale-{locale}.MPQ");
-  //archiveNames.push_back( "{locale}/lichking-speech-{locale}.MPQ" );
-  archiveNames.push_back("{locale}/patch-{locale}.MPQ");
-  archiveNames.push_back("{locale}/patch-{locale}-{number}.MPQ");
-  archiveNames.push_back("{locale}/patch-{locale}-{character}.MPQ");
-
-  archiveNames.push_back("development.MPQ");
-
-  const char * locales[] = { "enGB", "enUS", "deDE", "koKR", "frFR", "zhCN", "zhTW", "esES", "esMX", "ruRU" };
-  const char * locale("****");
-
-  // Find locale, take first one.
-  for (int i(0); i < 10; ++i)
-  {
-    if (boost::filesystem::exists (wowpath / "Data" / locales[i] / "realmlist.wtf"))
-    {
-      locale = locales[i];
-      NOGGIT_LOG << "Locale: " << locale << std::endl;
-      break;
-    }
-  }
-  if (!strcmp(locale, "****"))
-  {
-    LogError << "Could not find locale directory. Be sure, that there is one containing the file \"realmlist.wtf\"." << std::endl;
-    //return -1;
-  }
-
-
-  //! \todo  This may be done faster. Maybe.
-  for (size_t i(0); i < archiveNames.size(); ++i)
-  {
-    std::string path((wowpath / "Data" / archiveNames[i]).string());
-    std::string::size_type location(std::string::npos);
-
-    do
-    {
-      location = path.find("{locale}");
-      if (location != std::string::npos)
-      {
-        path.replace(location, 8, locale);
-      }
-    } while (location != std::string::npos);
-
-    if (path.find("{number}") != std::string::npos)
-    {
-      location = path.find("{number}");
-      path.replace(location, 8, " ");
-      for (char j = '2'; j <= '9'; j++)
-      {
-        path.replace(location, 1, std::string(&j, 1));
-        if (boost::filesystem::exists(path))
-          MPQArchive::loadMPQ (&AsyncLoader::instance(), path, true);
-      }
-    }
-    else if (path.find("{character}") != std::string::npos)
-    {
-      location = path.find("{character}");
-      path.replace(location, 11, " ");
-      for (char c = 'a'; c <= 'z'; c++)
-      {
-        path.replace(location, 1, std::string(&c, 1));
-        if (boost::filesystem::exists(path))
-          MPQArchive::loadMPQ (&AsyncLoader::instance(), path, true);
-      }
-    }
-    else
-      if (boost::filesystem::exists(path))
-        MPQArchive::loadMPQ (&AsyncLoader::instance(), path, true);
-  }
-}
-
 namespace
 {
   bool is_valid_game_path (const QDir& path)
@@ -246,7 +158,10 @@ Noggit::Noggit(int argc, char *argv[])
   settings.setValue ("project/game_path", path.absolutePath());
   settings.setValue ("project/path", QString::fromStdString(project_path));
 
-  loadMPQs(); // listfiles are not available straight away! They are async! Do not rely on anything at this point!
+  // before anything is loaded, the loaders read the project path from it
+  noggit::ui::settings::publish_snapshot (settings);
+
+  MPQArchive::loadClientMPQs (&AsyncLoader::instance(), wowpath); // listfiles are not available straight away! They are async! Do not rely on anything at this point!
   OpenDBs();
 
   if (!QGLFormat::hasOpenGL())
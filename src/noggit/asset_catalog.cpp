@@ -0,0 +1,247 @@
+// This file is part of Noggit3, licensed under GNU General Public License (version 3).
+
+#include <noggit/asset_catalog.hpp>
+
+#include <algorithm>
+#include <cctype>
+
+namespace noggit
+{
+  namespace
+  {
+    bool ends_with (std::string const& string, std::string const& suffix)
+    {
+      return string.size() >= suffix.size()
+        && string.compare (string.size() - suffix.size(), suffix.size(), suffix) == 0;
+    }
+
+    //! whether the whole line matches ".*_[0-9]{3}\.wmo"
+    bool is_wmo_group (std::string const& line)
+    {
+      std::size_t const suffix_size (std::string ("_000.wmo").size());
+      if (line.size() < suffix_size || !ends_with (line, ".wmo"))
+      {
+        return false;
+      }
+
+      std::size_t const start (line.size() - suffix_size);
+      if ( line[start] != '_'
+        || !std::isdigit (static_cast<unsigned char> (line[start + 1]))
+        || !std::isdigit (static_cast<unsigned char> (line[start + 2]))
+        || !std::isdigit (static_cast<unsigned char> (line[start + 3]))
+         )
+      {
+        return false;
+      }
+
+      // '.' does not match line terminators
+      return line.find_first_of ("\r\n") >= start;
+    }
+
+    std::uint32_t trigram (char const* characters)
+    {
+      return std::uint32_t (static_cast<unsigned char> (characters[0])) << 16
+           | std::uint32_t (static_cast<unsigned char> (characters[1])) << 8
+           | std::uint32_t (static_cast<unsigned char> (characters[2]));
+    }
+
+    std::vector<std::uint32_t> trigrams (std::string const& string)
+    {
+      std::vector<std::uint32_t> result;
+      for (std::size_t i (0); i + 3 <= string.size(); ++i)
+      {
+        result.emplace_back (trigram (string.data() + i));
+      }
+      std::sort (result.begin(), result.end());
+      result.erase (std::unique (result.begin(), result.end()), result.end());
+      return result;
+    }
+
+    bool has_type (asset_type type, std::initializer_list<asset_type> types)
+    {
+      return std::find (types.begin(), types.end(), type) != types.end();
+    }
+  }
+
+  asset_type classify_asset (std::string const& filename)
+  {
+    if ( filename.find ("tileset") != std::string::npos
+      && filename.find (".blp") != std::string::npos
+       )
+    {
+      return asset_type::tileset;
+    }
+    if (ends_with (filename, ".m2"))
+    {
+      return asset_type::model;
+    }
+    if (ends_with (filename, ".wmo") && !is_wmo_group (filename))
+    {
+      return asset_type::wmo;
+    }
+    return asset_type::other;
+  }
+
+  boost::optional<std::string> imported_model_path (std::string const& line)
+  {
+    if (is_wmo_group (line))
+    {
+      return boost::none;
+    }
+
+    // the first match of "[^\.]+\.(m2|wmo)": a non empty run of anything
+    // but dots, followed by the extension
+    std::size_t run_start (0);
+    for ( std::size_t dot (line.find ('.'))
+        ; dot != std::string::npos
+        ; run_start = dot + 1, dot = line.find ('.', run_start)
+        )
+    {
+      if (dot == run_start)
+      {
+        continue;
+      }
+
+      for (std::string extension : {"m2", "wmo"})
+      {
+        if (line.compare (dot + 1, extension.size(), extension) == 0)
+        {
+          return line.substr (run_start, dot + 1 + extension.size() - run_start);
+        }
+      }
+    }
+
+    return boost::none;
+  }
+
+  void asset_catalog::add (std::string const& filename)
+  {
+    asset_type const type (classify_asset (filename));
+    if (type == asset_type::other)
+    {
+      return;
+    }
+
+    std::lock_guard<std::mutex> const lock (_mutex);
+
+    auto const suffix_pos (filename.find ("_s.blp"));
+    if (type == asset_type::tileset && suffix_pos != std::string::npos)
+    {
+      std::string specular (filename);
+      specular.erase (suffix_pos, std::string ("_s").size());
+      if (_specular_variants.emplace (std::move (specular)).second)
+      {
+        ++_revision;
+      }
+      return;
+    }
+
+    add_locked (filename, type);
+  }
+
+  void asset_catalog::add (std::vector<std::string> const& filenames)
+  {
+    for (auto const& filename : filenames)
+    {
+      add (filename);
+    }
+  }
+
+  void asset_catalog::add (std::string const& filename, asset_type type)
+  {
+    std::lock_guard<std::mutex> const lock (_mutex);
+    add_locked (filename, type);
+  }
+
+  void asset_catalog::add_locked (std::string const& filename, asset_type type)
+  {
+    if (!_filenames.emplace (filename).second)
+    {
+      return;
+    }
+
+    std::uint32_t const id (static_cast<std::uint32_t> (_entries.size()));
+    _entries.push_back ({filename, type});
+
+    for (std::uint32_t key : trigrams (filename))
+    {
+      _trigrams[key].emplace_back (id);
+    }
+
+    ++_revision;
+  }
+
+  std::vector<std::string> asset_catalog::matching
+    (std::string const& filter, std::initializer_list<asset_type> types) const
+  {
+    std::lock_guard<std::mutex> const lock (_mutex);
+
+    std::vector<std::string> result;
+    auto const match
+      ( [&] (entry const& candidate)
+        {
+          if ( has_type (candidate.type, types)
+            && candidate.filename.find (filter) != std::string::npos
+             )
+          {
+            result.emplace_back (candidate.filename);
+          }
+        }
+      );
+
+    if (filter.size() < 3)
+    {
+      for (auto const& candidate : _entries)
+      {
+        match (candidate);
+      }
+      return result;
+    }
+
+    // every match contains all of the filter's trigrams, so the shortest
+    // posting list is a superset of the result
+    std::vector<std::uint32_t> const* candidates (nullptr);
+    for (std::uint32_t key : trigrams (filter))
+    {
+      auto const it (_trigrams.find (key));
+      if (it == _trigrams.end())
+      {
+        return result;
+      }
+      if (!candidates || it->second.size() < candidates->size())
+      {
+        candidates = &it->second;
+      }
+    }
+
+    for (std::uint32_t id : *candidates)
+    {
+      match (_entries[id]);
+    }
+
+    return result;
+  }
+
+  bool asset_catalog::has_specular_variant (std::string const& tileset) const
+  {
+    std::lock_guard<std::mutex> const lock (_mutex);
+    return _specular_variants.count (tileset);
+  }
+
+  std::size_t asset_catalog::size() const
+  {
+    std::lock_guard<std::mutex> const lock (_mutex);
+    return _entries.size();
+  }
+
+  void asset_catalog::clear()
+  {
+    std::lock_guard<std::mutex> const lock (_mutex);
+
+    _entries.clear();
+    _filenames.clear();
+    _trigrams.clear();
+    _specular_variants.clear();
+    ++_revision;
+  }
+}
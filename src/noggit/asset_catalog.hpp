@@ -0,0 +1,80 @@
+// This file is part of Noggit3, licensed under GNU General Public License (version 3).
+
+#pragma once
+
+#include <boost/optional.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace noggit
+{
+  enum class asset_type : std::uint8_t
+  {
+    model,
+    wmo,
+    tileset,
+    other,
+  };
+
+  //! the type of a normalized filename: .m2 models, root .wmo files (no
+  //! _000.wmo groups) and .blp textures in a tileset folder
+  asset_type classify_asset (std::string const& filename);
+
+  //! The model named by a line of the import file: the first "name.m2" or
+  //! "name.wmo" in it, unless the line is a wmo group.
+  boost::optional<std::string> imported_model_path (std::string const& line);
+
+  //! Normalized asset filenames by type with a trigram index, so filtering by
+  //! substring only looks at the entries sharing the filter's rarest trigram.
+  //! Filled once and then extended incrementally, safe from any thread.
+  class asset_catalog
+  {
+  public:
+    //! ignores duplicates and files of no known type, records the tilesets'
+    //! specular variants (_s.blp) instead of listing them
+    void add (std::string const& filename);
+    void add (std::vector<std::string> const& filenames);
+    //! adds a file of a given type, e.g. a model found by imported_model_path()
+    void add (std::string const& filename, asset_type type);
+
+    //! the entries of the given types containing filter, in the order they
+    //! were added
+    std::vector<std::string> matching
+      (std::string const& filter, std::initializer_list<asset_type> types) const;
+
+    bool has_specular_variant (std::string const& tileset) const;
+    std::size_t size() const;
+    void clear();
+
+    //! incremented by every change, to know when a view is outdated
+    std::uint64_t revision() const
+    {
+      return _revision.load();
+    }
+
+  private:
+    struct entry
+    {
+      std::string filename;
+      asset_type type;
+    };
+
+    void add_locked (std::string const& filename, asset_type type);
+
+    mutable std::mutex _mutex;
+    std::vector<entry> _entries;
+    std::unordered_set<std::string> _filenames;
+    //! ids of the entries containing a trigram, ascending
+    std::unordered_map<std::uint32_t, std::vector<std::uint32_t>> _trigrams;
+    std::unordered_set<std::string> _specular_variants;
+    std::atomic<std::uint64_t> _revision = {0};
+  };
+}
@@ -0,0 +1,358 @@
+// This file is part of Noggit3, licensed under GNU General Public License (version 3).
+
+#include <noggit/blp_decoder.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+namespace noggit
+{
+  namespace
+  {
+    std::size_t const palette_size = 256 * 4;
+
+    BLPHeader read_header (char const* data, std::size_t size)
+    {
+      if (size < sizeof (BLPHeader))
+      {
+        throw std::runtime_error ("BLP: file is smaller than its header");
+      }
+
+      BLPHeader header;
+      std::memcpy (&header, data, sizeof (BLPHeader));
+
+      if (std::memcmp (&header.magix, "BLP2", 4) != 0)
+      {
+        throw std::runtime_error ("BLP: not a BLP2 file");
+      }
+      if (header.resx <= 0 || header.resy <= 0 || header.resx > 65536 || header.resy > 65536)
+      {
+        throw std::runtime_error ("BLP: invalid dimensions");
+      }
+
+      return header;
+    }
+
+    bool has_mip (BLPHeader const& header, int mip)
+    {
+      return mip >= 0 && mip < 16 && header.offsets[mip] > 0 && header.sizes[mip] > 0;
+    }
+
+    int mip_count (BLPHeader const& header)
+    {
+      int count = 0;
+      while (has_mip (header, count))
+      {
+        ++count;
+      }
+      return count;
+    }
+
+    //! expands a 565 colour to 8 bits per channel
+    void unpack_565 (std::uint16_t color, std::uint8_t* rgb)
+    {
+      std::uint8_t const r = (color >> 11) & 0x1f;
+      std::uint8_t const g = (color >> 5) & 0x3f;
+      std::uint8_t const b = color & 0x1f;
+      rgb[0] = (r << 3) | (r >> 2);
+      rgb[1] = (g << 2) | (g >> 4);
+      rgb[2] = (b << 3) | (b >> 2);
+    }
+
+    std::uint16_t read_u16 (std::uint8_t const* p)
+    {
+      return static_cast<std::uint16_t> (p[0] | (p[1] << 8));
+    }
+
+    std::uint32_t read_u32 (std::uint8_t const* p)
+    {
+      return p[0] | (p[1] << 8) | (p[2] << 16) | (static_cast<std::uint32_t> (p[3]) << 24);
+    }
+
+    //! colour part of a DXT block, alpha of the decoded pixels is left alone
+    //! unless the block uses the three colour mode with punch-through alpha
+    void decode_color_block ( std::uint8_t const* block
+                            , bool allow_three_colors
+                            , bool punch_through_alpha
+                            , std::uint8_t (&pixels)[16][4]
+                            )
+    {
+      std::uint16_t const c0 = read_u16 (block);
+      std::uint16_t const c1 = read_u16 (block + 2);
+      std::uint32_t const indices = read_u32 (block + 4);
+
+      std::uint8_t palette[4][4];
+      unpack_565 (c0, palette[0]);
+      unpack_565 (c1, palette[1]);
+      palette[0][3] = palette[1][3] = 255;
+
+      bool const three_colors = allow_three_colors && c0 <= c1;
+
+      for (int c = 0; c < 3; ++c)
+      {
+        if (three_colors)
+        {
+          palette[2][c] = static_cast<std::uint8_t> ((palette[0][c] + palette[1][c]) / 2);
+          palette[3][c] = 0;
+        }
+        else
+        {
+          palette[2][c] = static_cast<std::uint8_t> ((2 * palette[0][c] + palette[1][c]) / 3);
+          palette[3][c] = static_cast<std::uint8_t> ((palette[0][c] + 2 * palette[1][c]) / 3);
+        }
+      }
+      palette[2][3] = 255;
+      palette[3][3] = three_colors && punch_through_alpha ? 0 : 255;
+
+      for (int i = 0; i < 16; ++i)
+      {
+        std::uint8_t const* color = palette[(indices >> (2 * i)) & 3];
+        pixels[i][0] = color[0];
+        pixels[i][1] = color[1];
+        pixels[i][2] = color[2];
+        pixels[i][3] = color[3];
+      }
+    }
+
+    void decode_explicit_alpha_block (std::uint8_t const* block, std::uint8_t (&pixels)[16][4])
+    {
+      for (int i = 0; i < 16; ++i)
+      {
+        std::uint8_t const nibble = (block[i / 2] >> (4 * (i % 2))) & 0xf;
+        pixels[i][3] = static_cast<std::uint8_t> (nibble * 17);
+      }
+    }
+
+    void decode_interpolated_alpha_block (std::uint8_t const* block, std::uint8_t (&pixels)[16][4])
+    {
+      int const a0 = block[0];
+      int const a1 = block[1];
+
+      std::uint8_t alphas[8];
+      alphas[0] = static_cast<std::uint8_t> (a0);
+      alphas[1] = static_cast<std::uint8_t> (a1);
+      if (a0 > a1)
+      {
+        for (int k = 1; k < 7; ++k)
+        {
+          alphas[k + 1] = static_cast<std::uint8_t> (((7 - k) * a0 + k * a1) / 7);
+        }
+      }
+      else
+      {
+        for (int k = 1; k < 5; ++k)
+        {
+          alphas[k + 1] = static_cast<std::uint8_t> (((5 - k) * a0 + k * a1) / 5);
+        }
+        alphas[6] = 0;
+        alphas[7] = 255;
+      }
+
+      std::uint64_t indices = 0;
+      for (int i = 0; i < 6; ++i)
+      {
+        indices |= static_cast<std::uint64_t> (block[2 + i]) << (8 * i);
+      }
+
+      for (int i = 0; i < 16; ++i)
+      {
+        pixels[i][3] = alphas[(indices >> (3 * i)) & 7];
+      }
+    }
+
+    void decode_dxt ( BLPHeader const& header
+                    , std::uint8_t const* source
+                    , blp_image& image
+                    )
+    {
+      int const alpha_type = header.attr_2_alphatype & 3;
+      bool const dxt1 = alpha_type == 0;
+      std::size_t const block_size = dxt1 ? 8 : 16;
+      int const blocks_x = (image.width + 3) / 4;
+      int const blocks_y = (image.height + 3) / 4;
+
+      std::uint8_t pixels[16][4];
+
+      for (int by = 0; by < blocks_y; ++by)
+      {
+        for (int bx = 0; bx < blocks_x; ++bx)
+        {
+          std::uint8_t const* block = source + (by * blocks_x + bx) * block_size;
+
+          if (dxt1)
+          {
+            decode_color_block (block, true, header.attr_1_alphadepth != 0, pixels);
+          }
+          else
+          {
+            decode_color_block (block + 8, false, false, pixels);
+            if (alpha_type == 1)
+            {
+              decode_explicit_alpha_block (block, pixels);
+            }
+            else
+            {
+              decode_interpolated_alpha_block (block, pixels);
+            }
+          }
+
+          for (int y = 0; y < 4 && by * 4 + y < image.height; ++y)
+          {
+            for (int x = 0; x < 4 && bx * 4 + x < image.width; ++x)
+            {
+              std::size_t const pixel = (by * 4 + y) * static_cast<std::size_t> (image.width) + bx * 4 + x;
+              std::memcpy (&image.rgba[pixel * 4], pixels[y * 4 + x], 4);
+            }
+          }
+        }
+      }
+    }
+
+    void decode_paletted ( BLPHeader const& header
+                         , std::uint8_t const* palette
+                         , std::uint8_t const* source
+                         , blp_image& image
+                         )
+    {
+      std::size_t const pixel_count = static_cast<std::size_t> (image.width) * image.height;
+      std::uint8_t const* alpha = source + pixel_count;
+      int const alpha_bits = header.attr_1_alphadepth;
+
+      for (std::size_t i = 0; i < pixel_count; ++i)
+      {
+        std::uint8_t const* entry = palette + source[i] * 4;
+        std::uint8_t* pixel = &image.rgba[i * 4];
+        pixel[0] = entry[2];
+        pixel[1] = entry[1];
+        pixel[2] = entry[0];
+
+        switch (alpha_bits)
+        {
+        case 1:
+          pixel[3] = (alpha[i / 8] >> (i % 8)) & 1 ? 255 : 0;
+          break;
+        case 4:
+          pixel[3] = static_cast<std::uint8_t> (((alpha[i / 2] >> (4 * (i % 2))) & 0xf) * 17);
+          break;
+        case 8:
+          pixel[3] = alpha[i];
+          break;
+        default:
+          pixel[3] = 255;
+          break;
+        }
+      }
+    }
+
+    void decode_bgra (std::uint8_t const* source, blp_image& image)
+    {
+      std::size_t const pixel_count = static_cast<std::size_t> (image.width) * image.height;
+
+      for (std::size_t i = 0; i < pixel_count; ++i)
+      {
+        image.rgba[i * 4 + 0] = source[i * 4 + 2];
+        image.rgba[i * 4 + 1] = source[i * 4 + 1];
+        image.rgba[i * 4 + 2] = source[i * 4 + 0];
+        image.rgba[i * 4 + 3] = source[i * 4 + 3];
+      }
+    }
+  }
+
+  int blp_mip_count (char const* data, std::size_t size)
+  {
+    return mip_count (read_header (data, size));
+  }
+
+  int blp_mip_for_size (char const* data, std::size_t size, int width, int height)
+  {
+    BLPHeader const header (read_header (data, size));
+
+    int mip = 0;
+    while ( has_mip (header, mip + 1)
+         && std::max (1, header.resx >> (mip + 1)) >= width
+         && std::max (1, header.resy >> (mip + 1)) >= height
+          )
+    {
+      ++mip;
+    }
+    return mip;
+  }
+
+  blp_image decode_blp (char const* data, std::size_t size, int mip)
+  {
+    BLPHeader const header (read_header (data, size));
+
+    if (!has_mip (header, mip))
+    {
+      throw std::runtime_error ("BLP: mipmap " + std::to_string (mip) + " does not exist");
+    }
+
+    std::size_t const offset = static_cast<std::size_t> (header.offsets[mip]);
+    std::size_t const stored = static_cast<std::size_t> (header.sizes[mip]);
+    if (offset > size || stored > size - offset)
+    {
+      throw std::runtime_error ("BLP: mipmap " + std::to_string (mip) + " is truncated");
+    }
+
+    blp_image image;
+    image.width = std::max (1, header.resx >> mip);
+    image.height = std::max (1, header.resy >> mip);
+    image.rgba.resize (static_cast<std::size_t> (image.width) * image.height * 4);
+
+    std::size_t const pixel_count = static_cast<std::size_t> (image.width) * image.height;
+    std::size_t needed;
+
+    switch (header.attr_0_compression)
+    {
+    case 1:
+      if (sizeof (BLPHeader) + palette_size > size)
+      {
+        throw std::runtime_error ("BLP: palette is truncated");
+      }
+      needed = pixel_count + (pixel_count * header.attr_1_alphadepth + 7) / 8;
+      break;
+    case 2:
+      needed = static_cast<std::size_t> ((image.width + 3) / 4) * ((image.height + 3) / 4)
+             * ((header.attr_2_alphatype & 3) == 0 ? 8 : 16);
+      break;
+    case 3:
+      needed = pixel_count * 4;
+      break;
+    default:
+      throw std::runtime_error
+        ("BLP: unimplemented compression " + std::to_string (header.attr_0_compression));
+    }
+
+    std::uint8_t const* source = reinterpret_cast<std::uint8_t const*> (data + offset);
+
+    // blizzard gets the size of some small mipmaps wrong
+    std::vector<std::uint8_t> padded;
+    if (stored < needed)
+    {
+      padded.assign (needed, 0);
+      std::copy (source, source + stored, padded.begin());
+      source = padded.data();
+    }
+
+    switch (header.attr_0_compression)
+    {
+    case 1:
+      decode_paletted ( header
+                      , reinterpret_cast<std::uint8_t const*> (data + sizeof (BLPHeader))
+                      , source
+                      , image
+                      );
+      break;
+    case 2:
+      decode_dxt (header, source, image);
+      break;
+    case 3:
+      decode_bgra (source, image);
+      break;
+    }
+
+    return image;
+  }
+}
@@ -0,0 +1,49 @@
+// This file is part of Noggit3, licensed under GNU General Public License (version 3).
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+//! \todo Cross-platform syntax for packed structs.
+#pragma pack(push,1)
+struct BLPHeader
+{
+  int32_t magix;
+  int32_t version;
+  uint8_t attr_0_compression;
+  uint8_t attr_1_alphadepth;
+  uint8_t attr_2_alphatype;
+  uint8_t attr_3_mipmaplevels;
+  int32_t resx;
+  int32_t resy;
+  int32_t offsets[16];
+  int32_t sizes[16];
+};
+#pragma pack(pop)
+
+namespace noggit
+{
+  struct blp_image
+  {
+    int width = 0;
+    int height = 0;
+    //! four bytes per pixel in r, g, b, a order, rows from top to bottom
+    std::vector<std::uint8_t> rgba;
+  };
+
+  //! number of mipmap levels stored in the file
+  int blp_mip_count (char const* data, std::size_t size);
+
+  //! the smallest stored mipmap level that is at least width x height
+  int blp_mip_for_size (char const* data, std::size_t size, int width, int height);
+
+  //! Decodes one mipmap level of a BLP2 file on the CPU: paletted with 0, 1,
+  //! 4 or 8 bit alpha, DXT1/3/5 and uncompressed BGRA. DXT colours are
+  //! interpolated with integer arithmetic, so the result matches the usual
+  //! reference decoders rather than any particular GPU bit for bit. Mipmaps
+  //! shorter than their level needs are padded with zeros, like the GL path
+  //! does. Throws std::runtime_error for malformed files.
+  blp_image decode_blp (char const* data, std::size_t size, int mip = 0);
+}
@@ -0,0 +1,170 @@
+// This file is part of Noggit3, licensed under GNU General Public License (version 3).
+
+#include <noggit/blp_thumbnail.hpp>
+
+#include <noggit/Log.h>
+#include <noggit/MPQ.h>
+#include <noggit/blp_decoder.hpp>
+
+#include <QtCore/QDir>
+#include <QtCore/QRunnable>
+#include <QtCore/QSaveFile>
+#include <QtCore/QStandardPaths>
+
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+
+namespace noggit
+{
+  namespace
+  {
+    //! FNV-1a, only used to tell files apart, not for security
+    std::uint64_t content_hash (char const* data, std::size_t size)
+    {
+      std::uint64_t hash = 14695981039346656037ull;
+      for (std::size_t i = 0; i < size; ++i)
+      {
+        hash ^= static_cast<std::uint8_t> (data[i]);
+        hash *= 1099511628211ull;
+      }
+      return hash;
+    }
+
+    QString cache_directory()
+    {
+      return QStandardPaths::writableLocation (QStandardPaths::CacheLocation)
+        + "/blp_thumbnails";
+    }
+
+    QString cache_filename ( std::string const& normalized_filename
+                           , std::uint64_t hash
+                           , int width
+                           , int height
+                           )
+    {
+      return QString ("%1/%2_%3_%4x%5.png")
+        .arg (cache_directory())
+        .arg (content_hash (normalized_filename.data(), normalized_filename.size()), 16, 16, QChar ('0'))
+        .arg (hash, 16, 16, QChar ('0'))
+        .arg (width)
+        .arg (height);
+    }
+
+    void store (QString const& filename, QImage const& image)
+    {
+      if (!QDir().mkpath (cache_directory()))
+      {
+        return;
+      }
+
+      QSaveFile file (filename);
+      if ( !file.open (QIODevice::WriteOnly)
+        || !image.save (&file, "PNG")
+        || !file.commit()
+         )
+      {
+        LogDebug << "unable to write thumbnail cache file " << filename.toStdString() << std::endl;
+      }
+    }
+
+    class thumbnail_job : public QRunnable
+    {
+    public:
+      thumbnail_job (blp_thumbnail_loader* loader, std::string filename, int width, int height)
+        : _loader (loader)
+        , _filename (std::move (filename))
+        , _width (width)
+        , _height (height)
+      {}
+
+      virtual void run() override
+      {
+        QImage image;
+        try
+        {
+          image = blp_thumbnail (_filename, _width, _height);
+        }
+        catch (std::exception const& e)
+        {
+          LogError << "unable to create thumbnail of " << _filename << ": " << e.what() << std::endl;
+        }
+
+        emit _loader->loaded (QString::fromStdString (_filename), image);
+      }
+
+    private:
+      blp_thumbnail_loader* _loader;
+      std::string _filename;
+      int _width;
+      int _height;
+    };
+  }
+
+  QImage blp_thumbnail (std::string const& blp_filename, int width, int height)
+  {
+    std::string const filename (mpq::normalized_filename (blp_filename));
+
+    bool const exists (MPQFile::exists (filename));
+    if (!exists)
+    {
+      LogError << "file not found: '" << filename << "'" << std::endl;
+    }
+
+    MPQFile f (exists ? filename : "textures/shanecube.blp");
+    if (f.isEof())
+    {
+      throw std::runtime_error ("File " + filename + " does not exists");
+    }
+
+    std::uint64_t const hash (content_hash (f.getBuffer(), f.getSize()));
+    QString const cached (cache_filename (filename, hash, width, height));
+
+    {
+      QImage image (cached);
+      if (!image.isNull())
+      {
+        return image;
+      }
+    }
+
+    int const mip ( width == -1 || height == -1
+                  ? 0
+                  : blp_mip_for_size (f.getBuffer(), f.getSize(), width, height)
+                  );
+    blp_image const decoded (decode_blp (f.getBuffer(), f.getSize(), mip));
+
+    QImage image = QImage ( decoded.rgba.data()
+                          , decoded.width
+                          , decoded.height
+                          , decoded.width * 4
+                          , QImage::Format_RGBA8888
+                          ).convertToFormat (QImage::Format_RGB32);
+
+    if (width != -1 && height != -1 && (width != image.width() || height != image.height()))
+    {
+      image = image.scaled (width, height, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+    }
+
+    store (cached, image);
+
+    return image;
+  }
+
+  blp_thumbnail_loader::blp_thumbnail_loader (int width, int height, QObject* parent)
+    : QObject (parent)
+    , _width (width)
+    , _height (height)
+  {}
+
+  blp_thumbnail_loader::~blp_thumbnail_loader()
+  {
+    _pool.clear();
+    _pool.waitForDone();
+  }
+
+  void blp_thumbnail_loader::request (std::string const& blp_filename)
+  {
+    _pool.start (new thumbnail_job (this, blp_filename, _width, _height));
+  }
+}
@@ -0,0 +1,49 @@
+// This file is part of Noggit3, licensed under GNU General Public License (version 3).
+
+#pragma once
+
+#include <QtCore/QObject>
+#include <QtCore/QString>
+#include <QtCore/QThreadPool>
+#include <QtGui/QImage>
+
+#include <string>
+
+namespace noggit
+{
+  //! Decodes a BLP on the CPU and scales it to width x height (-1 keeps the
+  //! size of the file), dropping the alpha channel. Thumbnails are cached on
+  //! disk, keyed by the archive path and a hash of the file content, so a
+  //! later session only decodes the textures that changed. Falls back to
+  //! the placeholder texture for missing files and throws for broken ones.
+  //! Safe to call from any thread.
+  QImage blp_thumbnail ( std::string const& blp_filename
+                       , int width = -1
+                       , int height = -1
+                       );
+
+  //! Creates thumbnails of a fixed size on a pool of worker threads. The
+  //! loaded signal is emitted once per request from the worker thread, so
+  //! connect it with a receiver context to get it queued to that thread.
+  struct blp_thumbnail_loader : QObject
+  {
+  private:
+    Q_OBJECT
+
+  public:
+    blp_thumbnail_loader (int width, int height, QObject* parent = nullptr);
+    //! waits for the running requests, the queued ones are dropped
+    ~blp_thumbnail_loader();
+
+    void request (std::string const& blp_filename);
+
+  signals:
+    //! image is null if the file could not be decoded
+    void loaded (QString blp_filename, QImage image);
+
+  private:
+    int _width;
+    int _height;
+    QThreadPool _pool;
+  };
+}
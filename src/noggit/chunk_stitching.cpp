@@ -0,0 +1,234 @@
+// This file is part of Noggit3, licensed under GNU General Public License (version 3).
+
+#include <noggit/chunk_stitching.hpp>
+#include <noggit/parallel_for.hpp>
+
+#include <cstdint>
+#include <limits>
+
+namespace noggit
+{
+  namespace
+  {
+    // 9 outer and 8 inner vertices per row, see MapChunk::mVertices
+    std::size_t const row_stride = 17;
+    std::size_t const top_right = 8;
+    std::size_t const bottom_left = 136;
+    std::size_t const bottom_right = 144;
+
+    //! the first row, then the rest of the first column
+    std::size_t const edge_size = 17;
+    std::size_t edge_vertex (std::size_t i)
+    {
+      return i < 9 ? i : (i - 8) * row_stride;
+    }
+
+    struct chunk_ref
+    {
+      stitched_tile const* tile;
+      std::size_t index;
+
+      float height (std::size_t vertex) const
+      {
+        return tile->chunks[index][vertex].y;
+      }
+    };
+
+    //! Orders the fixes like stitching tile after tile would: per tile the
+    //! left tile's edge, the above tile's edge, then every chunk's left and
+    //! above edge in rows.
+    class stitch_order
+    {
+    public:
+      using time = std::uint64_t;
+      static time const never = std::numeric_limits<time>::max();
+
+      explicit stitch_order (std::vector<stitched_tile> const& tiles)
+        : _first (tiles.data())
+      {}
+
+      time left_fix (chunk_ref const& chunk) const
+      {
+        std::size_t const tx (chunk.index % 16);
+        std::size_t const ty (chunk.index / 16);
+
+        if (!chunk.tile->stitch)
+        {
+          return never;
+        }
+        if (tx > 0)
+        {
+          return tile_start (chunk.tile) + 32 + chunk.index * 2;
+        }
+        return chunk.tile->left ? tile_start (chunk.tile) + ty : never;
+      }
+
+      time above_fix (chunk_ref const& chunk) const
+      {
+        std::size_t const tx (chunk.index % 16);
+        std::size_t const ty (chunk.index / 16);
+
+        if (!chunk.tile->stitch)
+        {
+          return never;
+        }
+        if (ty > 0)
+        {
+          return tile_start (chunk.tile) + 32 + chunk.index * 2 + 1;
+        }
+        return chunk.tile->above ? tile_start (chunk.tile) + 16 + tx : never;
+      }
+
+    private:
+      time tile_start (stitched_tile const* tile) const
+      {
+        return static_cast<time> (tile - _first) * 1024;
+      }
+
+      stitched_tile const* _first;
+    };
+
+    chunk_ref left_of (chunk_ref const& chunk)
+    {
+      if (chunk.index % 16 > 0)
+      {
+        return {chunk.tile, chunk.index - 1};
+      }
+      return {chunk.tile->left, chunk.index + 15};
+    }
+
+    chunk_ref above_of (chunk_ref const& chunk)
+    {
+      if (chunk.index / 16 > 0)
+      {
+        return {chunk.tile, chunk.index - 16};
+      }
+      return {chunk.tile->above, chunk.index + 240};
+    }
+
+    //! The height of a vertex when a fix at the given time reads it. The
+    //! fixes only read the last row and column and only write the first
+    //! ones, so only the two corners they share are ever read after being
+    //! written, and those get the never written bottom right corner of the
+    //! chunk left of or above them.
+    float height_at ( stitch_order const& order
+                    , chunk_ref const& chunk
+                    , std::size_t vertex
+                    , stitch_order::time time
+                    )
+    {
+      if (vertex == top_right && order.above_fix (chunk) < time)
+      {
+        return above_of (chunk).height (bottom_right);
+      }
+      if (vertex == bottom_left && order.left_fix (chunk) < time)
+      {
+        return left_of (chunk).height (bottom_right);
+      }
+      return chunk.height (vertex);
+    }
+  }
+
+  void stitch_chunk_edges (std::vector<stitched_tile>& tiles, std::size_t threads)
+  {
+    stitch_order const order (tiles);
+    std::vector<std::array<float, edge_size>> edges (tiles.size() * 256);
+
+    // everything is read before anything is written, so chunks can be
+    // stitched in any order
+    parallel_for
+      ( edges.size()
+      , [&] (std::size_t i)
+        {
+          stitched_tile& tile (tiles[i / 256]);
+          chunk_ref const chunk {&tile, i % 256};
+
+          if (!tile.stitch)
+          {
+            return;
+          }
+
+          std::array<float, edge_size>& edge (edges[i]);
+          for (std::size_t e (0); e < edge_size; ++e)
+          {
+            edge[e] = chunk.height (edge_vertex (e));
+          }
+
+          bool changed (false);
+          auto const set
+            ( [&] (std::size_t e, float height)
+              {
+                if (edge[e] != height)
+                {
+                  edge[e] = height;
+                  changed = true;
+                }
+              }
+            );
+
+          auto const fix_left
+            ( [&] (stitch_order::time time)
+              {
+                chunk_ref const left (left_of (chunk));
+                for (std::size_t row (0); row < 9; ++row)
+                {
+                  set (row == 0 ? 0 : 8 + row, height_at (order, left, row * row_stride + 8, time));
+                }
+              }
+            );
+          auto const fix_above
+            ( [&] (stitch_order::time time)
+              {
+                chunk_ref const above (above_of (chunk));
+                for (std::size_t column (0); column < 9; ++column)
+                {
+                  set (column, height_at (order, above, bottom_left + column, time));
+                }
+              }
+            );
+
+          stitch_order::time const left_time (order.left_fix (chunk));
+          stitch_order::time const above_time (order.above_fix (chunk));
+
+          if (left_time < above_time)
+          {
+            fix_left (left_time);
+            if (above_time != stitch_order::never)
+            {
+              fix_above (above_time);
+            }
+          }
+          else if (above_time != stitch_order::never)
+          {
+            fix_above (above_time);
+            if (left_time != stitch_order::never)
+            {
+              fix_left (left_time);
+            }
+          }
+
+          tile.changed[chunk.index] = changed;
+        }
+      , threads
+      );
+
+    parallel_for
+      ( edges.size()
+      , [&] (std::size_t i)
+        {
+          stitched_tile& tile (tiles[i / 256]);
+
+          if (!tile.stitch || !tile.changed[i % 256])
+          {
+            return;
+          }
+
+          for (std::size_t e (0); e < edge_size; ++e)
+          {
+            tile.chunks[i % 256][edge_vertex (e)].y = edges[i][e];
+          }
+        }
+      , threads
+      );
+  }
+}
@@ -0,0 +1,34 @@
+// This file is part of Noggit3, licensed under GNU General Public License (version 3).
+
+#pragma once
+
+#include <math/vector_3d.hpp>
+
+#include <array>
+#include <cstddef>
+#include <vector>
+
+namespace noggit
+{
+  //! A tile as seen by stitch_chunk_edges(): the vertices of its chunks,
+  //! [ty * 16 + tx], laid out like MapChunk::mVertices.
+  struct stitched_tile
+  {
+    std::array<math::vector_3d*, 256> chunks;
+    //! the neighbouring tiles, in the same vector, null if not loaded
+    stitched_tile const* left = nullptr;
+    stitched_tile const* above = nullptr;
+    //! tiles only there as neighbours are read but not stitched
+    bool stitch = true;
+    //! set for every chunk whose heights changed
+    std::array<bool, 256> changed = {};
+  };
+
+  //! Copies the heights of the last column and row of every chunk onto the
+  //! first ones of the chunks right of and below it, all chunks in parallel.
+  //! The result is the one of stitching the tiles one after the other, in
+  //! order, each first along the tiles left of and above it and then chunk
+  //! by chunk in rows: where a chunk's corner is shared with a tile stitched
+  //! later, which height wins depends on that order.
+  void stitch_chunk_edges (std::vector<stitched_tile>& tiles, std::size_t threads = 0);
+}
@@ -2,6 +2,7 @@
 
 #include <noggit/cursor_render.hpp>
 
+#include <opengl/program_cache.hpp>
 #include <opengl/shader.hpp>
 
 namespace noggit
@@ -31,17 +32,18 @@ namespace noggit
     }
   }
 
+  namespace
+  {
+    opengl::registered_program const cursor_shaders
+      ({ {GL_VERTEX_SHADER, "cursor_vs", {}}, {GL_FRAGMENT_SHADER, "cursor_fs", {}} });
+  }
+
   void cursor_render::upload()
   {
     _vaos.upload();
     _vbos.upload();
 
-    _cursor_program.reset
-      ( new opengl::program
-          { { GL_VERTEX_SHADER,   opengl::shader::src_from_qrc("cursor_vs") }
-          , { GL_FRAGMENT_SHADER, opengl::shader::src_from_qrc("cursor_fs") }
-          }
-      );    
+    _cursor_program.reset (new opengl::program (cursor_shaders.sources()));
 
     opengl::scoped::use_program shader {*_cursor_program.get()};
 
@@ -167,7 +167,8 @@ liquid_layer::liquid_layer(MPQFile &f, std::size_t base_pos, math::vector_3d con
 }
 
 liquid_layer::liquid_layer(liquid_layer&& other)
-  : _liquid_id(other._liquid_id)
+  : _slot(std::move(other._slot))
+  , _liquid_id(other._liquid_id)
   , _liquid_vertex_format(other._liquid_vertex_format)
   , _minimum(other._minimum)
   , _maximum(other._maximum)
@@ -210,6 +211,7 @@ liquid_layer& liquid_layer::operator= (liquid_layer&& other)
   std::swap(_tex_coords, other._tex_coords);
   std::swap(pos, other.pos);
   std::swap(_indices_by_lod, other._indices_by_lod);
+  std::swap(_slot, other._slot);
 
   _need_buffer_update = true;
   other._need_buffer_update = true;
@@ -414,89 +416,43 @@ void liquid_layer::update_indices()
   _need_buffer_update = true;
 }
 
-void liquid_layer::upload()
+void liquid_layer::update_buffers(liquid_render& render)
 {
-  _index_buffer.upload();
-  _buffers.upload();
-  _vertex_array.upload();
-
-  _uploaded = true;
-}
+  std::vector<liquid_render::vertex> vertices;
+  vertices.reserve(_vertices.size());
 
-// todo: update only buffer that needs to be updated
-void liquid_layer::update_buffers()
-{
-  for (int i = 0; i < lod_count; ++i)
+  for (std::size_t i = 0; i < _vertices.size(); ++i)
   {
-    opengl::scoped::buffer_binder<GL_ELEMENT_ARRAY_BUFFER> const index_buffer (_index_buffer[i]);
-    gl.bufferData (GL_ELEMENT_ARRAY_BUFFER, _indices_by_lod[i].size() * sizeof (uint16_t), _indices_by_lod[i].data(), GL_STATIC_DRAW);
+    vertices.push_back({_vertices[i], _depth[i], _tex_coords[i]});
   }
 
-  gl.bufferData<GL_ARRAY_BUFFER>(_vertices_vbo, sizeof(*_vertices.data()) * _vertices.size(), _vertices.data(), GL_STATIC_DRAW);
-  gl.bufferData<GL_ARRAY_BUFFER>(_depth_vbo, sizeof(*_depth.data()) * _depth.size(), _depth.data(), GL_STATIC_DRAW);
-  gl.bufferData<GL_ARRAY_BUFFER>(_tex_coord_vbo, sizeof(*_tex_coords.data()) * _tex_coords.size(), _tex_coords.data(), GL_STATIC_DRAW);
+  render.update_slot(_slot, vertices, _indices_by_lod);
 
   _need_buffer_update = false;
-  _vao_need_update = true;
-}
-
-void liquid_layer::update_vao(opengl::scoped::vao_binder const& bound_vao, opengl::scoped::use_program& water_shader)
-{
-  water_shader.attrib(bound_vao, "position", _vertices_vbo, 3, GL_FLOAT, GL_FALSE, 0, 0);
-  water_shader.attrib(bound_vao, "depth", _depth_vbo, 1, GL_FLOAT, GL_FALSE, 0, 0);
-  water_shader.attrib(bound_vao, "tex_coord", _tex_coord_vbo, 2, GL_FLOAT, GL_FALSE, 0, 0);
-
-  _vao_need_update = false;
 }
 
 void liquid_layer::draw ( liquid_render& render
-                        , opengl::scoped::use_program& water_shader
                         , math::vector_3d const& camera
                         , bool camera_moved
-                        , int animtime
                         )
 {
-  bool lod_changed = false;
-
-  if (!_uploaded)
+  if (!_slot)
   {
-    upload();
-    lod_changed = true;
-    set_lod_level(get_lod_level(camera));
+    _slot = render.allocate_slot();
+    _need_buffer_update = true;
   }
 
   if (_need_buffer_update)
   {
-    update_buffers();
-  }
-
-  opengl::scoped::vao_binder const _ (_vao);
-
-  if (_vao_need_update)
-  {
-    update_vao(_, water_shader);
+    update_buffers(render);
     set_lod_level(get_lod_level(camera));
   }
-
-  if (camera_moved)
+  else if (camera_moved)
   {
-    int new_lod = get_lod_level(camera);
-
-    if (new_lod != _current_lod_level)
-    {
-      lod_changed = true;
-      set_lod_level(new_lod);
-    }
+    set_lod_level(get_lod_level(camera));
   }
 
-  render.prepare_draw (water_shader, _liquid_id, animtime);
-
-  if (lod_changed)
-  {
-    gl.bindBuffer(GL_ELEMENT_ARRAY_BUFFER, _index_buffer[_current_lod_level]);
-  }
-  
-  gl.drawElements (GL_TRIANGLES, _current_lod_indices_count, GL_UNSIGNED_SHORT, opengl::index_buffer_is_already_bound{});
+  render.queue_draw(_slot, _liquid_id, _current_lod_level, _current_lod_indices_count);
 }
 
 void liquid_layer::crop(MapChunk* chunk)
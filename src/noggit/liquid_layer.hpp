@@ -27,11 +27,10 @@ public:
 
   void save(util::sExtendableArray& adt, int base_pos, int& info_pos, int& current_pos) const;
 
+  //! queues the layer, drawn by liquid_render::draw_queued()
   void draw ( liquid_render& render
-            , opengl::scoped::use_program& water_shader
             , math::vector_3d const& camera
             , bool camera_moved
-            , int animtime
             );
   void update_indices();
   void changeLiquidID(int id);
@@ -71,18 +70,12 @@ private:
   int get_lod_level(math::vector_3d const& camera_pos) const;
   void set_lod_level(int lod_level);
 
-  static int const lod_count = 4;
+  static int const lod_count = liquid_render::lod_count;
 
   int _current_lod_level = -1;
   int _current_lod_indices_count = 0;
 
-  opengl::scoped::deferred_upload_buffers<lod_count> _index_buffer;
-  opengl::scoped::deferred_upload_buffers<3> _buffers;
-  GLuint const& _vertices_vbo = _buffers[0];
-  GLuint const& _depth_vbo = _buffers[1];
-  GLuint const& _tex_coord_vbo = _buffers[2];
-  opengl::scoped::deferred_upload_vertex_arrays<1> _vertex_array;
-  GLuint const& _vao = _vertex_array[0];
+  liquid_render::slot _slot;
 
   int _liquid_id;
   int _liquid_vertex_format;
@@ -95,12 +88,8 @@ private:
   std::map<int, std::vector<std::uint16_t>> _indices_by_lod;
 
   bool _need_buffer_update = true;
-  bool _vao_need_update = true;
-  bool _uploaded = false;
 
-  void upload();
-  void update_buffers();
-  void update_vao(opengl::scoped::vao_binder const& bound_vao, opengl::scoped::use_program& water_shader);
+  void update_buffers(liquid_render& render);
 
 private:
   math::vector_3d pos;
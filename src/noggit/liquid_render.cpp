@@ -1,76 +1,258 @@
 // This file is part of Noggit3, licensed under GNU General Public License (version 3).
 
 #include <noggit/DBC.h>
-#include <noggit/liquid_layer.hpp>
 #include <noggit/Log.h>
-#include <noggit/TextureManager.h> // TextureManager, Texture
-#include <noggit/World.h>
+#include <noggit/blp_decoder.hpp>
+#include <noggit/liquid_render.hpp>
 #include <opengl/context.hpp>
+#include <opengl/program_cache.hpp>
 #include <opengl/scoped.hpp>
 
-#include <boost/filesystem.hpp>
 #include <boost/format.hpp>
 
 #include <algorithm>
+#include <cstddef>
+#include <mutex>
+#include <stdexcept>
 #include <string>
+#include <utility>
 
+std::size_t const liquid_render::lod_count;
+std::size_t const liquid_render::vertices_per_layer;
+std::size_t const liquid_render::indices_per_layer;
+std::array<std::size_t, liquid_render::lod_count> const liquid_render::lod_index_offsets = {{0, 384, 480, 504}};
 
-void liquid_render::prepare_draw ( opengl::scoped::use_program& water_shader
-                                 , int liquid_id
-                                 , int animtime
-                                 )
+namespace
 {
-  std::size_t texture_index = 0;
-  bool need_texture_update = false;
+  std::size_t const slots_per_page = 1024;
 
-  if (!_current_liquid_id || liquid_id != _current_liquid_id)
+  opengl::registered_program const liquid_shaders
+    ({ {GL_VERTEX_SHADER, "liquid_vs", {}}, {GL_FRAGMENT_SHADER, "liquid_fs", {}} });
+}
+
+struct liquid_render::arena
+{
+  struct page
   {
-    _current_anim_time = animtime;
-    _current_liquid_id = liquid_id;
+    opengl::scoped::deferred_upload_buffers<2> buffers;
+    GLuint const& vertices_vbo = buffers[0];
+    GLuint const& indices_vbo = buffers[1];
+    opengl::scoped::deferred_upload_vertex_arrays<1> vertex_array;
+    GLuint const& vao = vertex_array[0];
+    bool vao_ready = false;
+  };
 
-    if (_textures_by_liquid_id[liquid_id].empty())
-    {
-      add_liquid_id(liquid_id);
-    }
+  struct batch
+  {
+    std::vector<GLsizei> counts;
+    std::vector<GLvoid const*> offsets;
+    std::vector<GLint> base_vertices;
+  };
+
+  std::vector<std::unique_ptr<page>> pages;
+
+  // layers may be destroyed by the loader threads
+  std::mutex slots_mutex;
+  std::vector<std::size_t> free_slots;
+  std::size_t slot_count = 0;
+
+  // kept across frames to reuse the allocations, keyed by liquid id and page
+  std::map<std::pair<int, std::size_t>, batch> batches;
+};
+
+liquid_render::slot::slot (std::shared_ptr<arena> const& owner, std::size_t index)
+  : _arena (owner)
+  , _index (index)
+{}
+
+liquid_render::slot::~slot()
+{
+  release();
+}
+
+liquid_render::slot::slot (slot&& other)
+  : _arena (std::move (other._arena))
+  , _index (other._index)
+{
+  other._arena.reset();
+}
+
+liquid_render::slot& liquid_render::slot::operator= (slot&& other)
+{
+  std::swap (_arena, other._arena);
+  std::swap (_index, other._index);
+  return *this;
+}
+
+void liquid_render::slot::release()
+{
+  if (auto owner = _arena.lock())
+  {
+    std::lock_guard<std::mutex> const lock (owner->slots_mutex);
+    owner->free_slots.push_back (_index);
+  }
+  _arena.reset();
+}
+
+liquid_render::liquid_render()
+  : program (liquid_shaders.sources())
+  , _arena (std::make_shared<arena>())
+{}
 
-    texture_index = get_texture_index(liquid_id, animtime);
-    need_texture_update = true;
-    
-    water_shader.uniform("type", _liquid_id_types[liquid_id]);
-    water_shader.uniform("param", _float_param_by_liquid_id[liquid_id]);
+liquid_render::slot liquid_render::allocate_slot()
+{
+  std::lock_guard<std::mutex> const lock (_arena->slots_mutex);
+
+  if (!_arena->free_slots.empty())
+  {
+    std::size_t const index (_arena->free_slots.back());
+    _arena->free_slots.pop_back();
+    return slot (_arena, index);
   }
-  else
+
+  return slot (_arena, _arena->slot_count++);
+}
+
+void liquid_render::update_slot ( slot const& s
+                                , std::vector<vertex> const& vertices
+                                , std::map<int, std::vector<std::uint16_t>> const& indices_by_lod
+                                )
+{
+  std::size_t const page_index (s._index / slots_per_page);
+  std::size_t const local (s._index % slots_per_page);
+
+  while (_arena->pages.size() <= page_index)
   {
-    texture_index = get_texture_index(liquid_id, animtime);
-    need_texture_update = texture_index != get_texture_index(liquid_id, animtime);
+    _arena->pages.emplace_back (new arena::page);
+
+    arena::page& page (*_arena->pages.back());
+    page.buffers.upload();
+    page.vertex_array.upload();
+
+    gl.bufferData<GL_ARRAY_BUFFER>
+      (page.vertices_vbo, slots_per_page * vertices_per_layer * sizeof (vertex), nullptr, GL_STATIC_DRAW);
+    gl.bufferData<GL_ELEMENT_ARRAY_BUFFER>
+      (page.indices_vbo, slots_per_page * indices_per_layer * sizeof (std::uint16_t), nullptr, GL_STATIC_DRAW);
   }
 
-  if (need_texture_update)
+  arena::page const& page (*_arena->pages[page_index]);
+
+  gl.bufferSubData<GL_ARRAY_BUFFER> ( page.vertices_vbo
+                                    , local * vertices_per_layer * sizeof (vertex)
+                                    , std::min (vertices.size(), vertices_per_layer) * sizeof (vertex)
+                                    , vertices.data()
+                                    );
+
+  std::array<std::uint16_t, indices_per_layer> indices;
+  indices.fill (0);
+
+  for (auto const& lod : indices_by_lod)
   {
-    auto const& textures = _textures_by_liquid_id[liquid_id];
-    water_shader.sampler
-    ("tex"
-      , GL_TEXTURE0
-      , textures[texture_index].get()
+    std::size_t const level (lod.first);
+    std::size_t const begin (lod_index_offsets[level]);
+    std::size_t const end (level + 1 < lod_count ? lod_index_offsets[level + 1] : indices_per_layer);
+    std::copy_n (lod.second.begin(), std::min (lod.second.size(), end - begin), indices.begin() + begin);
+  }
+
+  gl.bufferSubData<GL_ELEMENT_ARRAY_BUFFER> ( page.indices_vbo
+                                            , local * indices_per_layer * sizeof (std::uint16_t)
+                                            , sizeof (indices)
+                                            , indices.data()
+                                            );
+}
+
+void liquid_render::queue_draw (slot const& s, int liquid_id, int lod, int index_count)
+{
+  if (index_count <= 0)
+  {
+    return;
+  }
+
+  std::size_t const local (s._index % slots_per_page);
+  arena::batch& batch (_arena->batches[{liquid_id, s._index / slots_per_page}]);
+
+  batch.counts.push_back (index_count);
+  batch.offsets.push_back
+    ( reinterpret_cast<GLvoid const*>
+        ((local * indices_per_layer + lod_index_offsets[lod]) * sizeof (std::uint16_t))
     );
+  batch.base_vertices.push_back (static_cast<GLint> (local * vertices_per_layer));
+}
+
+void liquid_render::draw_queued (opengl::scoped::use_program& water_shader)
+{
+  for (auto& entry : _arena->batches)
+  {
+    arena::batch& batch (entry.second);
+
+    if (batch.counts.empty())
+    {
+      continue;
+    }
+
+    prepare_draw (water_shader, entry.first.first);
+
+    arena::page& page (*_arena->pages[entry.first.second]);
+    opengl::scoped::vao_binder const _ (page.vao);
+
+    if (!page.vao_ready)
+    {
+      water_shader.attrib (_, "position", page.vertices_vbo, 3, GL_FLOAT, GL_FALSE, sizeof (vertex), reinterpret_cast<GLvoid const*> (offsetof (vertex, position)));
+      water_shader.attrib (_, "depth", page.vertices_vbo, 1, GL_FLOAT, GL_FALSE, sizeof (vertex), reinterpret_cast<GLvoid const*> (offsetof (vertex, depth)));
+      water_shader.attrib (_, "tex_coord", page.vertices_vbo, 2, GL_FLOAT, GL_FALSE, sizeof (vertex), reinterpret_cast<GLvoid const*> (offsetof (vertex, tex_coord)));
+      // the element buffer binding is part of the vao state
+      gl.bindBuffer (GL_ELEMENT_ARRAY_BUFFER, page.indices_vbo);
+
+      page.vao_ready = true;
+    }
+
+    gl.multiDrawElementsBaseVertex ( GL_TRIANGLES
+                                   , batch.counts.data()
+                                   , GL_UNSIGNED_SHORT
+                                   , batch.offsets.data()
+                                   , static_cast<GLsizei> (batch.counts.size())
+                                   , batch.base_vertices.data()
+                                   );
+
+    batch.counts.clear();
+    batch.offsets.clear();
+    batch.base_vertices.clear();
   }
 }
 
+void liquid_render::prepare_draw (opengl::scoped::use_program& water_shader, int liquid_id)
+{
+  if (_current_liquid_id && liquid_id == _current_liquid_id)
+  {
+    return;
+  }
+
+  animation& anim (liquid_animation (liquid_id));
+
+  _current_liquid_id = liquid_id;
+
+  water_shader.uniform("type", _liquid_id_types[liquid_id]);
+  water_shader.uniform("param", _float_param_by_liquid_id[liquid_id]);
+  water_shader.uniform("frame_count", anim.frame_count);
+  water_shader.sampler("tex", GL_TEXTURE0, &anim.texture);
+}
+
 void liquid_render::force_texture_update()
 {
   _current_liquid_id.reset();
 }
 
-std::size_t liquid_render::get_texture_index(int liquid_id, int animtime) const
+liquid_render::animation& liquid_render::liquid_animation (int liquid_id)
 {
-  return static_cast<std::size_t> (animtime / 60) % _textures_by_liquid_id.at(liquid_id).size();
+  if (!_animation_by_liquid_id.count (liquid_id))
+  {
+    add_liquid_id (liquid_id);
+  }
+  return _animation_by_liquid_id.at (liquid_id);
 }
 
 void liquid_render::add_liquid_id(int liquid_id)
 {
-  auto& textures = _textures_by_liquid_id[liquid_id];
-  textures.clear();
-
   std::string filename;
 
   try
@@ -78,7 +260,7 @@ void liquid_render::add_liquid_id(int liquid_id)
     DBCFile::Record lLiquidTypeRow = gLiquidTypeDB.getByID(liquid_id);
 
     _liquid_id_types[liquid_id] = lLiquidTypeRow.getInt(LiquidTypeDB::Type);
-    _float_param_by_liquid_id[liquid_id] = 
+    _float_param_by_liquid_id[liquid_id] =
       math::vector_2d( lLiquidTypeRow.getFloat(LiquidTypeDB::AnimationX)
                      , lLiquidTypeRow.getFloat(LiquidTypeDB::AnimationY)
                      );
@@ -101,22 +283,94 @@ void liquid_render::add_liquid_id(int liquid_id)
     filename = "XTextures\\river\\lake_a.%d.blp";
   }
 
+  // frames by mipmap level, all frames share the size of the first one
+  std::vector<std::vector<noggit::blp_image>> frames;
+  int levels = 0;
+
+  auto const add_frame
+    ( [&] (std::string const& frame_filename)
+      {
+        MPQFile f (frame_filename);
+        int const mip_count (noggit::blp_mip_count (f.getBuffer(), f.getSize()));
+
+        std::vector<noggit::blp_image> mips;
+        for (int mip = 0; mip < (frames.empty() ? mip_count : std::min (mip_count, levels)); ++mip)
+        {
+          mips.emplace_back (noggit::decode_blp (f.getBuffer(), f.getSize(), mip));
+        }
+
+        if ( !frames.empty()
+          && ( mips[0].width != frames[0][0].width
+            || mips[0].height != frames[0][0].height
+             )
+           )
+        {
+          LogError << "liquid frame " << frame_filename << " does not match the size of the first frame" << std::endl;
+          return;
+        }
+
+        levels = frames.empty() ? mip_count : std::min (levels, mip_count);
+        frames.emplace_back (std::move (mips));
+      }
+    );
+
   for (int i = 1; i <= 30; ++i)
   {
-    try 
+    std::string const frame_filename
+      (mpq::normalized_filename (boost::str(boost::format(filename) % i)));
+
+    if (!MPQFile::exists (frame_filename))
+    {
+      break;
+    }
+
+    try
     {
-      textures.emplace_back(boost::str(boost::format(filename) % i));
+      add_frame (frame_filename);
     }
-    catch (...)
+    catch (std::exception const& e)
     {
-      break;
+      LogError << "unable to load liquid frame " << frame_filename << ": " << e.what() << std::endl;
     }
   }
 
   // make sure there's at least one texture
-  if (textures.empty())
+  if (frames.empty())
   {
-    textures.emplace_back ("textures/shanecube.blp");
+    add_frame ("textures/shanecube.blp");
   }
-}
 
+  animation& anim (_animation_by_liquid_id[liquid_id]);
+  anim.frame_count = static_cast<int> (frames.size());
+
+  opengl::texture::set_active_texture (0);
+  anim.texture.bind();
+
+  std::vector<std::uint8_t> pixels;
+
+  for (int level = 0; level < levels; ++level)
+  {
+    int const width (frames[0][level].width);
+    int const height (frames[0][level].height);
+
+    pixels.clear();
+    for (auto const& frame : frames)
+    {
+      pixels.insert (pixels.end(), frame[level].rgba.begin(), frame[level].rgba.end());
+    }
+
+    gl.texImage3D ( GL_TEXTURE_2D_ARRAY, level, GL_RGBA8
+                  , width, height, anim.frame_count
+                  , 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data()
+                  );
+  }
+
+  gl.texParameteri (GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAX_LEVEL, levels - 1);
+  gl.texParameteri (GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+  gl.texParameteri (GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+  gl.texParameteri (GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_REPEAT);
+  gl.texParameteri (GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_REPEAT);
+
+  // the texture unit now holds this liquid's texture
+  _current_liquid_id.reset();
+}
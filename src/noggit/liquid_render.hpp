@@ -2,23 +2,70 @@
 
 #pragma once
 
-
+#include <math/vector_2d.hpp>
+#include <math/vector_3d.hpp>
 #include <noggit/MPQ.h>
 #include <noggit/TextureManager.h>
 #include <opengl/shader.hpp>
+#include <opengl/texture.hpp>
+
+#include <boost/optional.hpp>
 
+#include <array>
+#include <cstdint>
+#include <map>
+#include <memory>
 #include <string>
 #include <vector>
-#include <memory>
 
 class liquid_render
 {
+private:
+  struct arena;
+
 public:
-  liquid_render() = default;
-  void prepare_draw ( opengl::scoped::use_program& water_shader
-                    , int liquid_id
-                    , int animtime
-                    );
+  struct vertex
+  {
+    math::vector_3d position;
+    float depth;
+    math::vector_2d tex_coord;
+  };
+
+  static std::size_t const lod_count = 4;
+  static std::size_t const vertices_per_layer = 9 * 9;
+  //! lod n draws at most (8 >> n)² quads of six indices each
+  static std::array<std::size_t, lod_count> const lod_index_offsets;
+  static std::size_t const indices_per_layer = 6 * (64 + 16 + 4 + 1);
+
+  //! Room for one liquid layer in the shared vertex and index buffers.
+  //! Releasing it only marks it as free, so it may outlive the renderer
+  //! and be destroyed without a current context.
+  class slot
+  {
+  public:
+    slot() = default;
+    ~slot();
+
+    slot (slot const&) = delete;
+    slot& operator= (slot const&) = delete;
+    slot (slot&&);
+    slot& operator= (slot&&);
+
+    explicit operator bool() const { return !_arena.expired(); }
+
+  private:
+    friend class liquid_render;
+
+    slot (std::shared_ptr<arena> const&, std::size_t index);
+    void release();
+
+    std::weak_ptr<arena> _arena;
+    std::size_t _index = 0;
+  };
+
+  liquid_render();
+
+  void prepare_draw (opengl::scoped::use_program& water_shader, int liquid_id);
 
   opengl::program const& shader_program() const
   {
@@ -26,20 +73,37 @@ public:
   }
 
   void force_texture_update();
-  std::size_t get_texture_index(int liquid_id, int animtime) const;
+
+  slot allocate_slot();
+  //! \note vertices must hold vertices_per_layer entries, missing lods are empty
+  void update_slot ( slot const&
+                   , std::vector<vertex> const& vertices
+                   , std::map<int, std::vector<std::uint16_t>> const& indices_by_lod
+                   );
+  //! remembers the layer for draw_queued(), indices of the lod are used
+  //! up to index_count
+  void queue_draw (slot const&, int liquid_id, int lod, int index_count);
+  //! draws everything queued since the last call with one multi-draw per
+  //! liquid type and buffer page
+  void draw_queued (opengl::scoped::use_program& water_shader);
 
 private:
+  struct animation
+  {
+    opengl::texture_array texture;
+    int frame_count = 0;
+  };
+
+  animation& liquid_animation (int liquid_id);
   void add_liquid_id(int liquid);
 
   boost::optional<int> _current_liquid_id;
-  int _current_anim_time = 0;
 
-  opengl::program program
-    { { GL_VERTEX_SHADER,   opengl::shader::src_from_qrc("liquid_vs") }
-    , { GL_FRAGMENT_SHADER, opengl::shader::src_from_qrc("liquid_fs") }
-    };
+  opengl::program program;
 
   std::map<int, int> _liquid_id_types;
   std::map<int, math::vector_2d> _float_param_by_liquid_id;
-  std::map<int, std::vector<scoped_blp_texture_reference>> _textures_by_liquid_id;
+  std::map<int, animation> _animation_by_liquid_id;
+
+  std::shared_ptr<arena> _arena;
 };
@@ -4,10 +4,19 @@
 
 #include <noggit/MPQ.h>
 #include <noggit/Log.h>
+#include <noggit/MapChunk.h>
+#include <noggit/MapTile.h>
+#include <noggit/Misc.h>
 #include <noggit/map_index.hpp>
 #include <noggit/World.h>
 #include <opengl/context.hpp>
+#include <opengl/program_cache.hpp>
+#include <util/sExtendableArray.hpp>
 
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
 #include <sstream>
 
 struct color
@@ -95,12 +104,39 @@ map_horizon::map_horizon(const std::string& basename, const MapIndex * const ind
   filename << "World\\Maps\\" << basename << "\\" << basename << ".wdl";
   _filename = filename.str();
 
-  if (!MPQFile::exists(_filename))
+  if (MPQFile::exists(_filename))
+  {
+    read_wdl();
+  }
+  else
   {
     LogError << "file \"World\\Maps\\" << basename << "\\" << basename << ".wdl\" does not exist." << std::endl;
-    return;
   }
 
+  _qt_minimap = QImage (16 * 64, 16 * 64, QImage::Format_ARGB32);
+  _qt_minimap.fill (Qt::transparent);
+
+  for (size_t y (0); y < 64; ++y)
+  {
+    for (size_t x (0); x < 64; ++x)
+    {
+      update_minimap_tile(x, y, index);
+    }
+  }
+
+  _thread = std::make_unique<std::thread>(&map_horizon::process_queue, this);
+}
+
+map_horizon::~map_horizon()
+{
+  _stop = true;
+  _state_changed.notify_all();
+
+  _thread->join();
+}
+
+void map_horizon::read_wdl()
+{
   MPQFile wdl_file (_filename);
 
   uint32_t fourcc;
@@ -123,10 +159,11 @@ map_horizon::map_horizon(const std::string& basename, const MapIndex * const ind
 
         break;
       }
-      // todo: handle those too ?
+      // kept as is to be written back on save
       case 'MWMO':
       case 'MWID':
       case 'MODF':
+        _object_chunks.insert(_object_chunks.end(), wdl_file.getPointer() - 8, wdl_file.getPointer() + size);
         wdl_file.seekRelative(size);
         break;
       case 'MAOF':
@@ -155,9 +192,20 @@ map_horizon::map_horizon(const std::string& basename, const MapIndex * const ind
 
             _tiles[y][x] = std::make_unique<map_horizon_tile>();
 
-            //! \todo There also is MAHO giving holes into this heightmap.
             wdl_file.read(_tiles[y][x]->height_17, 17 * 17 * sizeof(int16_t));
             wdl_file.read(_tiles[y][x]->height_16, 16 * 16 * sizeof(int16_t));
+
+            if (wdl_file.getPos() + 8 + sizeof(map_horizon_tile::holes) <= wdl_file.getSize())
+            {
+              wdl_file.read(&fourcc, 4);
+              wdl_file.read(&size, 4);
+
+              if (fourcc == 'MAHO' && size == sizeof(map_horizon_tile::holes))
+              {
+                _tiles[y][x]->has_holes = true;
+                wdl_file.read(_tiles[y][x]->holes, sizeof(map_horizon_tile::holes));
+              }
+            }
           }
         }
 
@@ -172,43 +220,291 @@ map_horizon::map_horizon(const std::string& basename, const MapIndex * const ind
   } while (!done && !wdl_file.isEof());
 
   wdl_file.close();
+}
 
-  _qt_minimap = QImage (16 * 64, 16 * 64, QImage::Format_ARGB32);
-  _qt_minimap.fill (Qt::transparent);
+void map_horizon::update_minimap_tile(size_t x, size_t y, const MapIndex* index)
+{
+  if (_tiles[y][x])
+  {
+    //! \todo There also is a second heightmap appended which has additional 16*16 pixels.
+    //! \todo There also is MAHO giving holes into this heightmap.
 
-  for (size_t y (0); y < 64; ++y)
+    for (size_t j (0); j < 16; ++j)
+    {
+      for (size_t i (0); i < 16; ++i)
+      {
+        //! \todo R and B are inverted here
+        _qt_minimap.setPixel(x * 16 + i, y * 16 + j, color_for_height(_tiles[y][x]->height_17[j][i]));
+      }
+    }
+  }
+  // the adt exist but there's no data in the wdl
+  else if (index->hasTile(tile_index(x, y)))
   {
-    for (size_t x (0); x < 64; ++x)
+    for (size_t j(0); j < 16; ++j)
     {
-      if (_tiles[y][x])
+      for (size_t i(0); i < 16; ++i)
       {
-        //! \todo There also is a second heightmap appended which has additional 16*16 pixels.
-        //! \todo There also is MAHO giving holes into this heightmap.
+        _qt_minimap.setPixel(x * 16 + i, y * 16 + j, color(200, 100, 25));
+      }
+    }
+  }
+}
+
+void map_horizon::queue_outdated_tiles(MapIndex& index)
+{
+  for (MapTile* tile : index.loaded_tiles())
+  {
+    if (tile->horizon_outdated.exchange(false))
+    {
+      queue_tile_update(tile);
+    }
+  }
+}
+
+void map_horizon::queue_tile_update(MapTile* tile)
+{
+  tile_update update;
+  update.x = tile->index.x;
+  update.y = tile->index.z;
+  update.heights.resize(129 * 129);
+
+  // the chunk borders are shared, the last row and column come from the last chunks
+  for (size_t cz (0); cz < 16; ++cz)
+  {
+    for (size_t cx (0); cx < 16; ++cx)
+    {
+      MapChunk* chunk = tile->getChunk(cx, cz);
 
-        for (size_t j (0); j < 16; ++j)
+      for (size_t j (0); j < 9; ++j)
+      {
+        for (size_t i (0); i < 9; ++i)
         {
-          for (size_t i (0); i < 16; ++i)
-          {
-            //! \todo R and B are inverted here
-            _qt_minimap.setPixel(x * 16 + i, y * 16 + j, color_for_height(_tiles[y][x]->height_17[j][i]));
-          }
+          update.heights[(cz * 8 + j) * 129 + cx * 8 + i] = chunk->mVertices[j * 17 + i].y;
         }
       }
-      // the adt exist but there's no data in the wdl
-      else if (index->hasTile(tile_index(x, y)))
-      {
-        for (size_t j(0); j < 16; ++j)
+    }
+  }
+
+  std::lock_guard<std::mutex> const lock (_mutex);
+
+  // the tile is edited every frame while a brush is used, only keep the latest heights
+  auto pending = std::find_if ( _update_queue.begin(), _update_queue.end()
+                              , [&] (tile_update const& queued)
+                                {
+                                  return queued.x == update.x && queued.y == update.y;
+                                }
+                              );
+
+  if (pending != _update_queue.end())
+  {
+    pending->heights = std::move(update.heights);
+  }
+  else
+  {
+    _update_queue.push_back(std::move(update));
+    _state_changed.notify_one();
+  }
+}
+
+void map_horizon::process_queue()
+{
+  while (!_stop.load())
+  {
+    tile_update update;
+
+    {
+      std::unique_lock<std::mutex> lock (_mutex);
+
+      _state_changed.wait
+      ( lock
+      , [&]
         {
-          for (size_t i(0); i < 16; ++i)
-          {
-            _qt_minimap.setPixel(x * 16 + i, y * 16 + j, color(200, 100, 25));
-          }
+          return _stop.load() || !_update_queue.empty();
         }
+      );
+
+      if (_stop.load())
+      {
+        return;
+      }
+
+      update = std::move(_update_queue.front());
+      _update_queue.pop_front();
+      _processing = true;
+    }
+
+    finished_tile_update finished;
+    finished.x = update.x;
+    finished.y = update.y;
+
+    auto const height
+    (
+      [&] (size_t row, size_t column)
+      {
+        float const h (std::round(update.heights[row * 129 + column]));
+        return static_cast<int16_t>
+          (std::max<float>(std::numeric_limits<int16_t>::min(), std::min<float>(std::numeric_limits<int16_t>::max(), h)));
+      }
+    );
+
+    // one outer value per chunk corner and the chunk centers in between
+    for (size_t j (0); j < 17; ++j)
+    {
+      for (size_t i (0); i < 17; ++i)
+      {
+        finished.tile.height_17[j][i] = height(j * 8, i * 8);
+      }
+    }
+    for (size_t j (0); j < 16; ++j)
+    {
+      for (size_t i (0); i < 16; ++i)
+      {
+        finished.tile.height_16[j][i] = height(j * 8 + 4, i * 8 + 4);
+        finished.pixels[j][i] = color_for_height(finished.tile.height_17[j][i]);
+      }
+    }
+
+    {
+      std::lock_guard<std::mutex> const lock (_mutex);
+      _finished_updates.push_back(std::move(finished));
+      _processing = false;
+      _state_changed.notify_all();
+    }
+  }
+}
+
+void map_horizon::wait_for_all_updates()
+{
+  std::unique_lock<std::mutex> lock (_mutex);
+
+  _state_changed.wait
+  ( lock
+  , [&]
+    {
+      return _update_queue.empty() && !_processing;
+    }
+  );
+}
+
+void map_horizon::apply_finished_updates()
+{
+  std::vector<finished_tile_update> finished;
+
+  {
+    std::lock_guard<std::mutex> const lock (_mutex);
+    std::swap(finished, _finished_updates);
+  }
+
+  for (finished_tile_update const& update : finished)
+  {
+    auto& tile (_tiles[update.y][update.x]);
+
+    if (!tile)
+    {
+      tile = std::make_unique<map_horizon_tile>();
+    }
+
+    // the holes are not regenerated, keep the ones read from the wdl
+    std::memcpy(tile->height_17, update.tile.height_17, sizeof(tile->height_17));
+    std::memcpy(tile->height_16, update.tile.height_16, sizeof(tile->height_16));
+
+    for (size_t j (0); j < 16; ++j)
+    {
+      for (size_t i (0); i < 16; ++i)
+      {
+        _qt_minimap.setPixel(update.x * 16 + i, update.y * 16 + j, update.pixels[j][i]);
       }
     }
+
+    _outdated_batches.emplace_back(update.x, update.y);
+    _wdl_changed = true;
   }
 }
 
+void map_horizon::save_wdl()
+{
+  wait_for_all_updates();
+  apply_finished_updates();
+
+  if (!_wdl_changed)
+  {
+    return;
+  }
+
+  util::sExtendableArray wdl_file;
+  int cur_pos = 0;
+
+  // MVER
+  wdl_file.Extend(8 + 0x4);
+  SetChunkHeader(wdl_file, cur_pos, 'MVER', 4);
+  *(wdl_file.GetPointer<int>(8)) = 18;
+  cur_pos += 8 + 0x4;
+
+  // MWMO, MWID, MODF
+  if (_object_chunks.empty())
+  {
+    for (int fourcc : {'MWMO', 'MWID', 'MODF'})
+    {
+      wdl_file.Extend(8);
+      SetChunkHeader(wdl_file, cur_pos, fourcc, 0);
+      cur_pos += 8;
+    }
+  }
+  else
+  {
+    wdl_file.Insert(cur_pos, _object_chunks.size(), _object_chunks.data());
+    cur_pos += _object_chunks.size();
+  }
+
+  // MAOF, the offsets get filled while writing the MARE
+  int const maof_pos = cur_pos;
+  wdl_file.Extend(8 + 64 * 64 * sizeof(uint32_t));
+  SetChunkHeader(wdl_file, cur_pos, 'MAOF', 64 * 64 * sizeof(uint32_t));
+  cur_pos += 8 + 64 * 64 * sizeof(uint32_t);
+
+  for (size_t y (0); y < 64; ++y)
+  {
+    for (size_t x (0); x < 64; ++x)
+    {
+      if (!_tiles[y][x])
+      {
+        continue;
+      }
+
+      wdl_file.GetPointer<uint32_t>(maof_pos + 8)[y * 64 + x] = cur_pos;
+
+      // MARE
+      wdl_file.Extend(8);
+      SetChunkHeader(wdl_file, cur_pos, 'MARE', 0x442);
+      cur_pos += 8;
+
+      wdl_file.Insert(cur_pos, sizeof(map_horizon_tile::height_17), reinterpret_cast<char*>(_tiles[y][x]->height_17));
+      cur_pos += sizeof(map_horizon_tile::height_17);
+      wdl_file.Insert(cur_pos, sizeof(map_horizon_tile::height_16), reinterpret_cast<char*>(_tiles[y][x]->height_16));
+      cur_pos += sizeof(map_horizon_tile::height_16);
+
+      // MAHO
+      if (_tiles[y][x]->has_holes)
+      {
+        wdl_file.Extend(8);
+        SetChunkHeader(wdl_file, cur_pos, 'MAHO', sizeof(map_horizon_tile::holes));
+        cur_pos += 8;
+
+        wdl_file.Insert(cur_pos, sizeof(map_horizon_tile::holes), reinterpret_cast<char*>(_tiles[y][x]->holes));
+        cur_pos += sizeof(map_horizon_tile::holes);
+      }
+    }
+  }
+
+  MPQFile f(_filename);
+  f.setBuffer(wdl_file.all_data());
+  f.SaveFile();
+  f.close();
+
+  _wdl_changed = false;
+}
+
 map_horizon::minimap::minimap(const map_horizon& horizon)
 {
   std::vector<uint32_t> texture_data(1024 * 1024);
@@ -243,6 +539,41 @@ map_horizon::minimap::minimap(const map_horizon& horizon)
 }
 
 map_horizon::render::render(const map_horizon& horizon)
+{
+  upload(horizon);
+}
+
+std::vector<math::vector_3d> map_horizon::render::tile_vertices(const map_horizon& horizon, size_t x, size_t y) const
+{
+  std::vector<math::vector_3d> vertices;
+  vertices.reserve(17 * 17 + 16 * 16);
+
+  for (size_t j (0); j < 17; ++j)
+  {
+    for (size_t i (0); i < 17; ++i)
+    {
+      vertices.emplace_back ( TILESIZE * (x + i / 16.0f)
+                            , horizon._tiles[y][x]->height_17[j][i]
+                            , TILESIZE * (y + j / 16.0f)
+                            );
+    }
+  }
+
+  for (size_t j (0); j < 16; ++j)
+  {
+    for (size_t i (0); i < 16; ++i)
+    {
+      vertices.emplace_back ( TILESIZE * (x + (i + 0.5f) / 16.0f)
+                            , horizon._tiles[y][x]->height_16[j][i]
+                            , TILESIZE * (y + (j + 0.5f) / 16.0f)
+                            );
+    }
+  }
+
+  return vertices;
+}
+
+void map_horizon::render::upload(const map_horizon& horizon)
 {
   std::vector<math::vector_3d> vertices;
 
@@ -251,37 +582,48 @@ map_horizon::render::render(const map_horizon& horizon)
     for (size_t x (0); x < 64; ++x)
     {
       if (!horizon._tiles[y][x])
-        continue;
-
-      _batches[y][x] = map_horizon_batch (vertices.size(), 17 * 17 + 16 * 16);
-
-      for (size_t j (0); j < 17; ++j)
       {
-        for (size_t i (0); i < 17; ++i)
-        {
-          vertices.emplace_back ( TILESIZE * (x + i / 16.0f)
-                                , horizon._tiles[y][x]->height_17[j][i]
-                                , TILESIZE * (y + j / 16.0f)
-                                );
-        }
+        _batches[y][x] = map_horizon_batch();
+        continue;
       }
 
-      for (size_t j (0); j < 16; ++j)
-      {
-        for (size_t i (0); i < 16; ++i)
-        {
-          vertices.emplace_back ( TILESIZE * (x + (i + 0.5f) / 16.0f)
-                                , horizon._tiles[y][x]->height_16[j][i]
-                                , TILESIZE * (y + (j + 0.5f) / 16.0f)
-                                );
-        }
-      }
+      std::vector<math::vector_3d> const tile (tile_vertices (horizon, x, y));
+
+      _batches[y][x] = map_horizon_batch (vertices.size(), tile.size());
+      vertices.insert (vertices.end(), tile.begin(), tile.end());
     }
   }
 
   gl.bufferData<GL_ARRAY_BUFFER, math::vector_3d> (_vertex_buffer, vertices, GL_STATIC_DRAW);
 }
 
+void map_horizon::render::update(map_horizon& horizon)
+{
+  std::vector<tile_index> tiles;
+  std::swap (tiles, horizon._outdated_batches);
+
+  for (tile_index const& tile : tiles)
+  {
+    // a new tile doesn't fit in the buffer, rebuild it once for all of them
+    if (_batches[tile.z][tile.x].vertex_count == 0)
+    {
+      upload (horizon);
+      return;
+    }
+  }
+
+  for (tile_index const& tile : tiles)
+  {
+    std::vector<math::vector_3d> const vertices (tile_vertices (horizon, tile.x, tile.z));
+
+    gl.bufferSubData<GL_ARRAY_BUFFER> ( _vertex_buffer
+                                      , _batches[tile.z][tile.x].vertex_start * sizeof (math::vector_3d)
+                                      , vertices.size() * sizeof (math::vector_3d)
+                                      , vertices.data()
+                                      );
+  }
+}
+
 static inline uint32_t outer_index(const map_horizon_batch &batch, int y, int x)
 {
   return batch.vertex_start + y * 17 + x;
@@ -292,6 +634,12 @@ static inline uint32_t inner_index(const map_horizon_batch &batch, int y, int x)
   return batch.vertex_start + 17 * 17 + y * 16 + x;
 };
 
+namespace
+{
+  opengl::registered_program const horizon_shaders
+    ({ {GL_VERTEX_SHADER, "horizon_vs", {}}, {GL_FRAGMENT_SHADER, "horizon_fs", {}} });
+}
+
 void map_horizon::render::draw( math::matrix_4x4 const& model_view
                               , math::matrix_4x4 const& projection
                               , MapIndex *index
@@ -356,12 +704,7 @@ void map_horizon::render::draw( math::matrix_4x4 const& model_view
 
   if (!_map_horizon_program)
   {
-    _map_horizon_program.reset
-      ( new opengl::program
-          { { GL_VERTEX_SHADER,   opengl::shader::src_from_qrc("horizon_vs") }
-          , { GL_FRAGMENT_SHADER, opengl::shader::src_from_qrc("horizon_fs") }
-          }
-      );
+    _map_horizon_program.reset (new opengl::program (horizon_shaders.sources()));
   
     _vaos.upload();
   }
@@ -4,6 +4,7 @@
 
 #include <math/frustum.hpp>
 
+#include <noggit/tile_index.hpp>
 #include <noggit/tool_enums.hpp>
 
 #include <opengl/texture.hpp>
@@ -12,9 +13,17 @@
 
 #include <QtGui/QImage>
 
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <list>
 #include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 class MapIndex;
+class MapTile;
 
 namespace noggit
 {
@@ -23,6 +32,10 @@ struct map_horizon_tile
 {
     int16_t height_17[17][17];
     int16_t height_16[16][16];
+
+    //! MAHO, only written back when the wdl had it for this tile
+    bool has_holes = false;
+    uint16_t holes[16] = {};
 };
 
 struct map_horizon_batch
@@ -58,6 +71,10 @@ public:
              , display_mode display
              );
 
+    //! upload the tiles regenerated since the last call, only touching
+    //! their part of the vertex buffer unless a tile got added
+    void update(map_horizon& horizon);
+
     map_horizon_batch _batches[64][64];
 
     opengl::scoped::deferred_upload_vertex_arrays<1> _vaos;
@@ -66,6 +83,10 @@ public:
     GLuint const& _index_buffer = _buffers[0];
     GLuint const& _vertex_buffer = _buffers[1];
     std::unique_ptr<opengl::program> _map_horizon_program;
+
+  private:
+    void upload(const map_horizon& horizon);
+    std::vector<math::vector_3d> tile_vertices(const map_horizon& horizon, size_t x, size_t y) const;
   };
 
   class minimap : public opengl::texture
@@ -75,13 +96,64 @@ public:
   };
 
   map_horizon(const std::string& basename, const MapIndex * const index);
+  ~map_horizon();
+
+  map_horizon(map_horizon const&) = delete;
+  map_horizon& operator= (map_horizon const&) = delete;
+
+  //! queue every loaded tile whose heights changed since the last call
+  void queue_outdated_tiles(MapIndex& index);
+  //! samples the tile heights, the downsampling itself is done by the worker thread
+  void queue_tile_update(MapTile* tile);
+  //! move the tiles done by the worker into the heightmap and the minimap
+  void apply_finished_updates();
+  void wait_for_all_updates();
+
+  //! wait for pending updates and write the wdl if anything changed
+  void save_wdl();
 
   QImage _qt_minimap;
 
 private:
+  struct tile_update
+  {
+    size_t x;
+    size_t y;
+    //! outer vertices of all the chunks, 129 * 129
+    std::vector<float> heights;
+  };
+
+  struct finished_tile_update
+  {
+    size_t x;
+    size_t y;
+    map_horizon_tile tile;
+    uint32_t pixels[16][16];
+  };
+
+  void read_wdl();
+  void update_minimap_tile(size_t x, size_t y, const MapIndex* index);
+  void process_queue();
+
   std::string _filename;
 
   std::unique_ptr<map_horizon_tile> _tiles[64][64];
+
+  //! MWMO, MWID and MODF as read from the wdl, written back untouched
+  std::vector<char> _object_chunks;
+  bool _wdl_changed = false;
+
+  //! tiles applied to _tiles but not yet uploaded by render::update
+  std::vector<tile_index> _outdated_batches;
+
+  std::atomic<bool> _stop = {false};
+  std::mutex _mutex;
+  std::condition_variable _state_changed;
+  std::list<tile_update> _update_queue;
+  bool _processing = false;
+  std::vector<finished_tile_update> _finished_updates;
+
+  std::unique_ptr<std::thread> _thread;
 };
 
 }
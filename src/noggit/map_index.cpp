@@ -102,6 +102,8 @@ MapIndex::MapIndex (const std::string &pBasename, int map_id, World* world)
 				mTiles[j][i].flags |= 1;
 				changed = true;
 			}
+
+      update_tile_status (tile_index (i, j));
 		}
 	}
 
@@ -144,11 +146,20 @@ void MapIndex::saveall (World* world)
 
   saveMaxUID();
 
+  for (tile_index const& tile : _parked_tiles.tiles())
+  {
+    save_parked_tile(tile);
+  }
+
   for (MapTile* tile : loaded_tiles())
   {
     tile->saveTile(world);
     tile->changed = false;
+    update_tile_status (tile->index);
   }
+
+  world->horizon.queue_outdated_tiles(*this);
+  world->horizon.save_wdl();
 }
 
 void MapIndex::save()
@@ -261,6 +272,7 @@ void MapIndex::update_model_tile(const tile_index& tile, model_update type, uint
   MapTile* adt = loadTile(tile);
   adt->wait_until_loaded();
   adt->changed = true;
+  update_tile_status (tile);
 
   if (type == model_update::add)
   {
@@ -272,6 +284,20 @@ void MapIndex::update_model_tile(const tile_index& tile, model_update type, uint
   }
 }
 
+void MapIndex::update_model_tile(const tile_index& tile, std::vector<uint32_t> const& removed, std::vector<uint32_t> const& added)
+{
+  if (!hasTile(tile))
+  {
+    return;
+  }
+
+  MapTile* adt = loadTile(tile);
+  adt->wait_until_loaded();
+  adt->changed = true;
+  update_tile_status (tile);
+  adt->update_models(removed, added);
+}
+
 void MapIndex::setChanged(const tile_index& tile)
 {
   MapTile* mTile = loadTile(tile);
@@ -279,6 +305,7 @@ void MapIndex::setChanged(const tile_index& tile)
   if (!!mTile)
   {
     mTile->changed = true;
+    update_tile_status (tile);
   }
 }
 
@@ -293,12 +320,13 @@ void MapIndex::unsetChanged(const tile_index& tile)
   if (hasTile(tile))
   {
     mTiles[tile.z][tile.x].tile->changed = false;
+    update_tile_status (tile);
   }
 }
 
 bool MapIndex::has_unsaved_changes(const tile_index& tile) const
 {
-  return (tileLoaded(tile) ? getTile(tile)->changed.load() : false);
+  return (tileLoaded(tile) ? getTile(tile)->changed.load() : _parked_tiles.contains(tile));
 }
 
 void MapIndex::setFlag(bool to, math::vector_3d const& pos, uint32_t flag)
@@ -331,7 +359,9 @@ MapTile* MapIndex::loadTile(const tile_index& tile, bool reloading)
   std::stringstream filename;
   filename << "World\\Maps\\" << basename << "\\" << basename << "_" << tile.x << "_" << tile.z << ".adt";
 
-  if (!MPQFile::exists(filename.str()))
+  boost::optional<std::vector<char>> parked (_parked_tiles.unpark(tile));
+
+  if (!parked && !MPQFile::exists(filename.str()))
   {
     LogError << "The requested tile \"" << filename.str() << "\" does not exist! Oo" << std::endl;
     return nullptr;
@@ -341,6 +371,11 @@ MapTile* MapIndex::loadTile(const tile_index& tile, bool reloading)
 
   MapTile* adt = mTiles[tile.z][tile.x].tile.get();
 
+  if (parked)
+  {
+    adt->load_from(std::move(*parked));
+  }
+
   AsyncLoader::instance().queue_for_load(adt);
 
   return adt;
@@ -352,6 +387,7 @@ void MapIndex::reloadTile(const tile_index& tile)
   {
     mTiles[tile.z][tile.x].tile.reset();
     loadTile(tile, true);
+    update_tile_status (tile);
   }
 }
 
@@ -363,11 +399,15 @@ void MapIndex::unloadTiles(const tile_index& tile)
     {
       if (tile.dist(adt->index) > _unload_dist)
       {
-        //Only unload adts not marked to save
+        // adts marked to save keep their changes in memory
         if (!adt->changed.load())
         {
           unloadTile(adt->index);
         }
+        else
+        {
+          park_tile(adt->index);
+        }
       }
     }
 
@@ -380,16 +420,72 @@ void MapIndex::unloadTile(const tile_index& tile)
   // unloads a tile with givn cords
   if (tileLoaded(tile))
   {
+    _world->unselect_vertices_of (mTiles[tile.z][tile.x].tile.get());
     mTiles[tile.z][tile.x].tile = nullptr;
+    update_tile_status (tile);
     NOGGIT_LOG << "Unload Tile " << tile.x << "-" << tile.z << std::endl;
   }
 }
 
+void MapIndex::park_tile(const tile_index& tile)
+{
+  if (!tileLoaded(tile))
+  {
+    return;
+  }
+
+  // pending model updates have to be part of the parked data
+  _world->wait_for_all_tile_updates();
+
+  MapTile* adt = mTiles[tile.z][tile.x].tile.get();
+
+  if (adt->horizon_outdated.exchange(false))
+  {
+    _world->horizon.queue_tile_update(adt);
+  }
+
+  // the alphamaps are big in memory whatever the map uses, parking with
+  // old ones would quantize them
+  _parked_tiles.park(tile, adt->write_adt(_world, true));
+  _world->unselect_vertices_of (adt);
+  mTiles[tile.z][tile.x].tile = nullptr;
+  update_tile_status (tile);
+  NOGGIT_LOG << "Park Tile " << tile.x << "-" << tile.z << " (" << _parked_tiles.memory_usage() / 1024 << " KiB parked)" << std::endl;
+}
+
+void MapIndex::save_parked_tile(const tile_index& tile)
+{
+  if (mBigAlpha)
+  {
+    // the parked data already is the ADT to save
+    std::stringstream filename;
+    filename << "World\\Maps\\" << basename << "\\" << basename << "_" << tile.x << "_" << tile.z << ".adt";
+
+    NOGGIT_LOG << "Saving parked ADT \"" << filename.str() << "\"." << std::endl;
+
+    MPQFile f(filename.str());
+    f.setBuffer(*_parked_tiles.unpark(tile));
+    f.SaveFile();
+  }
+  else
+  {
+    // the alphamaps have to be converted to the map's format, which takes
+    // loading the tile, one at a time to keep the memory used bounded
+    loadTile(tile)->wait_until_loaded();
+    _world->wait_for_all_tile_updates();
+    mTiles[tile.z][tile.x].tile->saveTile(_world);
+    unloadTile(tile);
+  }
+
+  update_tile_status(tile);
+}
+
 void MapIndex::markOnDisc(const tile_index& tile, bool mto)
 {
   if(tile.is_valid())
   {
     mTiles[tile.z][tile.x].onDisc = mto;
+    update_tile_status (tile);
   }
 }
 
@@ -401,6 +497,16 @@ bool MapIndex::isTileExternal(const tile_index& tile) const
 
 void MapIndex::saveTile(const tile_index& tile, World* world)
 {
+  if (_parked_tiles.contains(tile))
+  {
+    saveMaxUID();
+    save_parked_tile(tile);
+
+    world->horizon.queue_outdated_tiles(*this);
+    world->horizon.save_wdl();
+    return;
+  }
+
   world->wait_for_all_tile_updates();
 
 	// save given tile
@@ -408,6 +514,9 @@ void MapIndex::saveTile(const tile_index& tile, World* world)
 	{
     saveMaxUID();
 		mTiles[tile.z][tile.x].tile->saveTile(world);
+
+    world->horizon.queue_outdated_tiles(*this);
+    world->horizon.save_wdl();
 	}
 }
 
@@ -422,14 +531,57 @@ void MapIndex::saveChanged (World* world)
 
   saveMaxUID();
 
+  for (tile_index const& tile : _parked_tiles.tiles())
+  {
+    save_parked_tile(tile);
+  }
+
   for (MapTile* tile : loaded_tiles())
   {
     if (tile->changed.load())
     {
       tile->saveTile(world);
       tile->changed = false;
+      update_tile_status (tile->index);
+    }
+  }
+
+  world->horizon.queue_outdated_tiles(*this);
+  world->horizon.save_wdl();
+}
+
+void MapIndex::tile_finished_loading (MapTile const& tile)
+{
+  _tile_status.set ( tile.index
+                   , tile.changed.load() ? noggit::tile_status::changed : noggit::tile_status::loaded
+                   );
+}
+
+void MapIndex::update_tile_status (tile_index const& tile)
+{
+  noggit::tile_status status (noggit::tile_status::none);
+
+  if (hasTile (tile))
+  {
+    if (tileLoaded (tile))
+    {
+      status = has_unsaved_changes (tile) ? noggit::tile_status::changed : noggit::tile_status::loaded;
+    }
+    else if (_parked_tiles.contains (tile))
+    {
+      status = noggit::tile_status::changed;
+    }
+    else if (isTileExternal (tile))
+    {
+      status = noggit::tile_status::external;
+    }
+    else
+    {
+      status = noggit::tile_status::unloaded;
     }
   }
+
+  _tile_status.set (tile, status);
 }
 
 bool MapIndex::hasAGlobalWMO()
@@ -6,7 +6,9 @@
 #include <noggit/MapHeaders.h>
 #include <noggit/MapTile.h>
 #include <noggit/Misc.h>
+#include <noggit/parked_tiles.hpp>
 #include <noggit/tile_index.hpp>
+#include <noggit/tile_status_layer.hpp>
 
 #include <boost/range/iterator_range.hpp>
 
@@ -145,6 +147,7 @@ public:
   MapTile *loadTile(const tile_index& tile, bool reloading = false);
 
   void update_model_tile(const tile_index& tile, model_update type, uint32_t uid);
+  void update_model_tile(const tile_index& tile, std::vector<uint32_t> const& removed, std::vector<uint32_t> const& added);
 
   void setChanged(const tile_index& tile);
   void setChanged(MapTile* tile);
@@ -182,6 +185,12 @@ public:
 
   bool sort_models_by_size_class() const { return _sort_models_by_size_class; }
 
+  //! what the minimap shows of each tile, kept up to date when tiles are
+  //! loaded, unloaded, changed or saved
+  noggit::tile_status_layer const& tile_status() const { return _tile_status; }
+  //! called by the tiles once they finished loading
+  void tile_finished_loading (MapTile const&);
+
   uint32_t newGUID();
 
   uid_fix_status fixUIDs (World*, bool);
@@ -203,6 +212,13 @@ public:
 private:
 	uint32_t getHighestGUIDFromFile(const std::string& pFilename) const;
 
+  void update_tile_status (tile_index const& tile);
+
+  //! unloads a tile with unsaved changes, keeping them in _parked_tiles
+  void park_tile (tile_index const& tile);
+  //! writes a parked tile's changes to disk and stops keeping them
+  void save_parked_tile (tile_index const& tile);
+
   bool _uid_fix_all_in_progress = false;
 
   const std::string basename;
@@ -234,6 +250,11 @@ private:
   // Holding all MapTiles there can be in a World.
   MapTileEntry mTiles[64][64];
 
+  noggit::tile_status_layer _tile_status;
+
+  //! modified tiles out of view, loaded again from there by loadTile()
+  noggit::parked_tiles _parked_tiles;
+
   //! \todo REMOVE!
   World* _world;
 
@@ -37,25 +37,32 @@ namespace noggit
     {
       std::string const normalized (_normalize (filename));
 
+      // counting and inserting in one go: with several threads creating
+      // references to the same file, e.g. the chunks of a tile built in
+      // parallel, a later caller must never see the count before the element
+      T* obj;
       {
         boost::mutex::scoped_lock const lock(_mutex);
 
-        if ([&] { return _counts[normalized]++; }())
+        if (_counts[normalized]++)
         {
           return &_elements.at (normalized);
         }
+
+        auto const inserted ( _elements.emplace ( std::piecewise_construct
+                                                , std::forward_as_tuple (normalized)
+                                                , std::forward_as_tuple (normalized, args...)
+                                                )
+                            );
+        obj = &inserted.first->second;
+
+        // still there from an erase() waiting for the loader, which now
+        // keeps it
+        if (!inserted.second && static_cast<AsyncObject*> (obj)->finishedLoading())
+        {
+          return obj;
+        }
       }
-        
-
-      T* const obj ( [&]
-                     {
-                       boost::mutex::scoped_lock const lock(_mutex);
-                       return &_elements.emplace ( std::piecewise_construct
-                                                 , std::forward_as_tuple (normalized)
-                                                 , std::forward_as_tuple (normalized, args...)
-                                                 ).first->second;
-                     }()
-                   );
 
       AsyncLoader::instance().queue_for_load(static_cast<AsyncObject*>(obj));
 
@@ -85,8 +92,13 @@ namespace noggit
 
         {
           boost::mutex::scoped_lock lock(_mutex);
-          _elements.erase (normalized);
-          _counts.erase (normalized);
+          // it may have been referenced again while waiting for the loader
+          auto const count (_counts.find (normalized));
+          if (count != _counts.end() && count->second == 0)
+          {
+            _elements.erase (normalized);
+            _counts.erase (count);
+          }
         }
       }
     }
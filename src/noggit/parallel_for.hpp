@@ -0,0 +1,73 @@
+// This file is part of Noggit3, licensed under GNU General Public License (version 3).
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace noggit
+{
+  //! Calls fun(i) for every i in [0, count) on up to max_threads threads,
+  //! the calling thread included (0 uses one per core). Indices are handed
+  //! out one at a time, so the order of the calls is unspecified. The first
+  //! exception thrown stops handing out indices and is rethrown once every
+  //! thread is done.
+  template<typename Fun>
+    void parallel_for (std::size_t count, Fun&& fun, std::size_t max_threads = 0)
+  {
+    if (max_threads == 0)
+    {
+      max_threads = std::max (1u, std::thread::hardware_concurrency());
+    }
+    std::size_t const thread_count (std::min (max_threads, count));
+
+    std::atomic<std::size_t> next (0);
+    std::atomic<bool> failed (false);
+    std::exception_ptr error;
+    std::mutex error_mutex;
+
+    auto const worker
+      ( [&]
+        {
+          for (std::size_t i; !failed && (i = next++) < count;)
+          {
+            try
+            {
+              fun (i);
+            }
+            catch (...)
+            {
+              std::lock_guard<std::mutex> const lock (error_mutex);
+              if (!error)
+              {
+                error = std::current_exception();
+              }
+              failed = true;
+            }
+          }
+        }
+      );
+
+    std::vector<std::thread> threads;
+    for (std::size_t i = 1; i < thread_count; ++i)
+    {
+      threads.emplace_back (worker);
+    }
+    worker();
+
+    for (auto& thread : threads)
+    {
+      thread.join();
+    }
+
+    if (error)
+    {
+      std::rethrow_exception (error);
+    }
+  }
+}
@@ -0,0 +1,70 @@
+// This file is part of Noggit3, licensed under GNU General Public License (version 3).
+
+#include <noggit/parked_tiles.hpp>
+
+#include <stdexcept>
+
+namespace noggit
+{
+  namespace
+  {
+    std::pair<std::size_t, std::size_t> key (tile_index const& tile)
+    {
+      return {tile.z, tile.x};
+    }
+  }
+
+  void parked_tiles::park (tile_index const& tile, std::vector<char> const& adt)
+  {
+    // ADTs are mostly repeated chunk headers, zeroed alphamaps and smooth
+    // heights, the fastest level already gets most of it
+    _tiles[key (tile)] = qCompress ( reinterpret_cast<uchar const*> (adt.data())
+                                   , static_cast<int> (adt.size())
+                                   , 1
+                                   );
+  }
+
+  boost::optional<std::vector<char>> parked_tiles::unpark (tile_index const& tile)
+  {
+    auto const it (_tiles.find (key (tile)));
+    if (it == _tiles.end())
+    {
+      return boost::none;
+    }
+
+    QByteArray const adt (qUncompress (it->second));
+    _tiles.erase (it);
+
+    if (adt.isEmpty())
+    {
+      throw std::runtime_error ("parked tile data is corrupted");
+    }
+
+    return std::vector<char> (adt.begin(), adt.end());
+  }
+
+  bool parked_tiles::contains (tile_index const& tile) const
+  {
+    return _tiles.count (key (tile));
+  }
+
+  std::vector<tile_index> parked_tiles::tiles() const
+  {
+    std::vector<tile_index> tiles;
+    for (auto const& tile : _tiles)
+    {
+      tiles.emplace_back (tile.first.second, tile.first.first);
+    }
+    return tiles;
+  }
+
+  std::size_t parked_tiles::memory_usage() const
+  {
+    std::size_t size (0);
+    for (auto const& tile : _tiles)
+    {
+      size += tile.second.size();
+    }
+    return size;
+  }
+}
@@ -0,0 +1,39 @@
+// This file is part of Noggit3, licensed under GNU General Public License (version 3).
+
+#pragma once
+
+#include <noggit/tile_index.hpp>
+
+#include <QtCore/QByteArray>
+
+#include <boost/optional.hpp>
+
+#include <cstddef>
+#include <map>
+#include <utility>
+#include <vector>
+
+namespace noggit
+{
+  //! Modified tiles unloaded to bound the memory used by long editing
+  //! sessions: the ADT they would have been saved as, compressed, until
+  //! they are loaded again or saved.
+  class parked_tiles
+  {
+  public:
+    //! replaces what was parked for that tile
+    void park (tile_index const&, std::vector<char> const& adt);
+    //! removes the tile, none if it wasn't parked
+    boost::optional<std::vector<char>> unpark (tile_index const&);
+
+    bool contains (tile_index const&) const;
+    std::vector<tile_index> tiles() const;
+    bool empty() const { return _tiles.empty(); }
+
+    //! compressed size of all parked tiles, in bytes
+    std::size_t memory_usage() const;
+
+  private:
+    std::map<std::pair<std::size_t, std::size_t>, QByteArray> _tiles;
+  };
+}
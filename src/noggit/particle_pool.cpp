@@ -0,0 +1,251 @@
+// This file is part of Noggit3, licensed under GNU General Public License (version 3).
+
+#include <noggit/particle_pool.hpp>
+
+#include <math/simd.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+namespace noggit
+{
+  namespace
+  {
+    std::size_t padded (std::size_t count)
+    {
+      return (count + 3) & ~std::size_t (3);
+    }
+  }
+
+  particle_pool::particle_pool (std::size_t capacity)
+    : _capacity (capacity)
+  {}
+
+  void particle_pool::reserve (std::size_t count)
+  {
+    if (count <= _life.size())
+    {
+      return;
+    }
+
+    std::size_t const storage
+      (std::min (padded (_capacity), padded (std::max (count, _life.size() * 2))));
+
+    for ( std::vector<float>* array
+        : { &_pos_x, &_pos_y, &_pos_z
+          , &_speed_x, &_speed_y, &_speed_z
+          , &_down_x, &_down_y, &_down_z
+          , &_dir_x, &_dir_y, &_dir_z
+          , &_life, &_maxlife, &_particle_size
+          , &_color_r, &_color_g, &_color_b, &_color_a
+          , &_speed_scale
+          }
+        )
+    {
+      array->resize (storage, 0.f);
+    }
+
+    _origin.resize (storage);
+    _corners.resize (storage);
+    _tile.resize (storage);
+  }
+
+  bool particle_pool::push_back (Particle const& particle)
+  {
+    if (_size >= _capacity)
+    {
+      return false;
+    }
+
+    reserve (_size + 1);
+
+    std::size_t const i (_size++);
+    _pos_x[i] = particle.pos.x;
+    _pos_y[i] = particle.pos.y;
+    _pos_z[i] = particle.pos.z;
+    _speed_x[i] = particle.speed.x;
+    _speed_y[i] = particle.speed.y;
+    _speed_z[i] = particle.speed.z;
+    _down_x[i] = particle.down.x;
+    _down_y[i] = particle.down.y;
+    _down_z[i] = particle.down.z;
+    _dir_x[i] = particle.dir.x;
+    _dir_y[i] = particle.dir.y;
+    _dir_z[i] = particle.dir.z;
+    _life[i] = particle.life;
+    _maxlife[i] = particle.maxlife;
+    _particle_size[i] = particle.size;
+    _color_r[i] = particle.color.x;
+    _color_g[i] = particle.color.y;
+    _color_b[i] = particle.color.z;
+    _color_a[i] = particle.color.w;
+    _origin[i] = particle.origin;
+    std::copy (particle.corners, particle.corners + 4, _corners[i].begin());
+    _tile[i] = particle.tile;
+
+    return true;
+  }
+
+  void particle_pool::move (std::size_t from, std::size_t to)
+  {
+    _pos_x[to] = _pos_x[from];
+    _pos_y[to] = _pos_y[from];
+    _pos_z[to] = _pos_z[from];
+    _speed_x[to] = _speed_x[from];
+    _speed_y[to] = _speed_y[from];
+    _speed_z[to] = _speed_z[from];
+    _down_x[to] = _down_x[from];
+    _down_y[to] = _down_y[from];
+    _down_z[to] = _down_z[from];
+    _dir_x[to] = _dir_x[from];
+    _dir_y[to] = _dir_y[from];
+    _dir_z[to] = _dir_z[from];
+    _life[to] = _life[from];
+    _maxlife[to] = _maxlife[from];
+    _particle_size[to] = _particle_size[from];
+    _color_r[to] = _color_r[from];
+    _color_g[to] = _color_g[from];
+    _color_b[to] = _color_b[from];
+    _color_a[to] = _color_a[from];
+    _origin[to] = _origin[from];
+    _corners[to] = _corners[from];
+    _tile[to] = _tile[from];
+  }
+
+  void particle_pool::update (float dt, particle_update_parameters const& parameters)
+  {
+    if (_size == 0)
+    {
+      return;
+    }
+
+    bool const slows_down (parameters.slowdown > 0);
+    if (slows_down)
+    {
+      for (std::size_t i (0); i < _size; ++i)
+      {
+        _speed_scale[i] = expf (-1.0f * parameters.slowdown * _life[i]);
+      }
+    }
+
+    float const mid (parameters.mid);
+    float const after_mid (1.0f - mid);
+    auto const& sizes (parameters.sizes);
+    auto const& colors (parameters.colors);
+
+    // the operations mirror vector_3d and interpolation::linear one to one
+    // so both paths give the same results as the old per-particle code
+#ifdef NOGGIT_MATH_SSE
+    __m128 const v_dt (_mm_set1_ps (dt));
+    __m128 const v_gravity (_mm_set1_ps (parameters.gravity));
+    __m128 const v_deacceleration (_mm_set1_ps (parameters.deacceleration));
+    __m128 const v_one (_mm_set1_ps (1.0f));
+    __m128 const v_mid (_mm_set1_ps (mid));
+    __m128 const v_after_mid (_mm_set1_ps (after_mid));
+
+    auto const ramp
+    (
+      [&] (__m128 before, __m128 t, float a, float b, float c)
+      {
+        __m128 const start (_mm_or_ps ( _mm_and_ps (before, _mm_set1_ps (a))
+                                      , _mm_andnot_ps (before, _mm_set1_ps (b))
+                                      )
+                           );
+        __m128 const end (_mm_or_ps ( _mm_and_ps (before, _mm_set1_ps (b))
+                                    , _mm_andnot_ps (before, _mm_set1_ps (c))
+                                    )
+                         );
+        return _mm_add_ps ( _mm_mul_ps (start, _mm_sub_ps (v_one, t))
+                          , _mm_mul_ps (end, t)
+                          );
+      }
+    );
+
+    auto const integrate
+    (
+      [&] (float* pos, float* speed, float const* down, float const* dir, __m128 scale)
+      {
+        __m128 const accel (_mm_sub_ps ( _mm_mul_ps (_mm_mul_ps (_mm_loadu_ps (down), v_gravity), v_dt)
+                                       , _mm_mul_ps (_mm_mul_ps (_mm_loadu_ps (dir), v_deacceleration), v_dt)
+                                       )
+                           );
+        __m128 const new_speed (_mm_add_ps (_mm_loadu_ps (speed), accel));
+        _mm_storeu_ps (speed, new_speed);
+        _mm_storeu_ps (pos, _mm_add_ps (_mm_loadu_ps (pos), _mm_mul_ps (_mm_mul_ps (new_speed, scale), v_dt)));
+      }
+    );
+
+    // the storage is padded, the lanes past _size are computed and ignored
+    for (std::size_t i (0); i < _size; i += 4)
+    {
+      __m128 const scale (slows_down ? _mm_loadu_ps (&_speed_scale[i]) : v_one);
+
+      integrate (&_pos_x[i], &_speed_x[i], &_down_x[i], &_dir_x[i], scale);
+      integrate (&_pos_y[i], &_speed_y[i], &_down_y[i], &_dir_y[i], scale);
+      integrate (&_pos_z[i], &_speed_z[i], &_down_z[i], &_dir_z[i], scale);
+
+      __m128 const life (_mm_add_ps (_mm_loadu_ps (&_life[i]), v_dt));
+      _mm_storeu_ps (&_life[i], life);
+
+      __m128 const rlife (_mm_div_ps (life, _mm_loadu_ps (&_maxlife[i])));
+      __m128 const before (_mm_cmple_ps (rlife, v_mid));
+      __m128 const t (_mm_or_ps ( _mm_and_ps (before, _mm_div_ps (rlife, v_mid))
+                                , _mm_andnot_ps (before, _mm_div_ps (_mm_sub_ps (rlife, v_mid), v_after_mid))
+                                )
+                     );
+
+      _mm_storeu_ps (&_particle_size[i], ramp (before, t, sizes[0], sizes[1], sizes[2]));
+      _mm_storeu_ps (&_color_r[i], ramp (before, t, colors[0].x, colors[1].x, colors[2].x));
+      _mm_storeu_ps (&_color_g[i], ramp (before, t, colors[0].y, colors[1].y, colors[2].y));
+      _mm_storeu_ps (&_color_b[i], ramp (before, t, colors[0].z, colors[1].z, colors[2].z));
+      _mm_storeu_ps (&_color_a[i], ramp (before, t, colors[0].w, colors[1].w, colors[2].w));
+    }
+#else
+    auto const ramp
+    (
+      [&] (bool before, float t, float a, float b, float c)
+      {
+        return before ? a * (1.0f - t) + b * t : b * (1.0f - t) + c * t;
+      }
+    );
+
+    for (std::size_t i (0); i < _size; ++i)
+    {
+      float const scale (slows_down ? _speed_scale[i] : 1.0f);
+
+      _speed_x[i] += _down_x[i] * parameters.gravity * dt - _dir_x[i] * parameters.deacceleration * dt;
+      _speed_y[i] += _down_y[i] * parameters.gravity * dt - _dir_y[i] * parameters.deacceleration * dt;
+      _speed_z[i] += _down_z[i] * parameters.gravity * dt - _dir_z[i] * parameters.deacceleration * dt;
+
+      _pos_x[i] += _speed_x[i] * scale * dt;
+      _pos_y[i] += _speed_y[i] * scale * dt;
+      _pos_z[i] += _speed_z[i] * scale * dt;
+
+      _life[i] += dt;
+
+      float const rlife (_life[i] / _maxlife[i]);
+      bool const before (rlife <= mid);
+      float const t (before ? rlife / mid : (rlife - mid) / after_mid);
+
+      _particle_size[i] = ramp (before, t, sizes[0], sizes[1], sizes[2]);
+      _color_r[i] = ramp (before, t, colors[0].x, colors[1].x, colors[2].x);
+      _color_g[i] = ramp (before, t, colors[0].y, colors[1].y, colors[2].y);
+      _color_b[i] = ramp (before, t, colors[0].z, colors[1].z, colors[2].z);
+      _color_a[i] = ramp (before, t, colors[0].w, colors[1].w, colors[2].w);
+    }
+#endif
+
+    // kill off old particles
+    for (std::size_t i (0); i < _size;)
+    {
+      if (_life[i] / _maxlife[i] >= 1.0f)
+      {
+        move (--_size, i);
+      }
+      else
+      {
+        ++i;
+      }
+    }
+  }
+}
@@ -0,0 +1,96 @@
+// This file is part of Noggit3, licensed under GNU General Public License (version 3).
+
+#pragma once
+
+#include <math/vector_3d.hpp>
+#include <math/vector_4d.hpp>
+
+#include <array>
+#include <cstddef>
+#include <vector>
+
+//! a particle as created by an emitter, before it is moved into a pool
+struct Particle {
+  math::vector_3d pos, speed, down, origin, dir;
+  math::vector_3d  corners[4];
+  //math::vector_3d tpos;
+  float size, life, maxlife;
+  unsigned int tile;
+  math::vector_4d color;
+};
+
+namespace noggit
+{
+  //! values shared by all particles of a system for one update
+  struct particle_update_parameters
+  {
+    float gravity;
+    float deacceleration;
+    float slowdown;
+    //! relative life at which size and colour reach their middle value
+    float mid;
+    std::array<float, 3> sizes;
+    std::array<math::vector_4d, 3> colors;
+  };
+
+  //! Structure-of-arrays storage for the live particles of a system. The
+  //! hot fields get one array per component so update() can work on four
+  //! particles at once; dead particles are swap-removed, so the order of
+  //! the particles is not stable. Storage grows on demand but never holds
+  //! more than capacity() particles.
+  class particle_pool
+  {
+  public:
+    explicit particle_pool (std::size_t capacity);
+
+    std::size_t size() const { return _size; }
+    std::size_t capacity() const { return _capacity; }
+    std::size_t available() const { return _capacity - _size; }
+    bool empty() const { return _size == 0; }
+
+    //! returns false and drops the particle if the pool is full
+    bool push_back (Particle const& particle);
+    void clear() { _size = 0; }
+
+    //! integrates velocity and position, ramps size and colour over the
+    //! relative life and removes the particles that reached its end
+    void update (float dt, particle_update_parameters const& parameters);
+
+    math::vector_3d position (std::size_t i) const
+    {
+      return {_pos_x[i], _pos_y[i], _pos_z[i]};
+    }
+    math::vector_4d color (std::size_t i) const
+    {
+      return {_color_r[i], _color_g[i], _color_b[i], _color_a[i]};
+    }
+    float size (std::size_t i) const { return _particle_size[i]; }
+    float life (std::size_t i) const { return _life[i]; }
+    math::vector_3d const& origin (std::size_t i) const { return _origin[i]; }
+    std::array<math::vector_3d, 4> const& corners (std::size_t i) const { return _corners[i]; }
+    unsigned int tile (std::size_t i) const { return _tile[i]; }
+
+  private:
+    void reserve (std::size_t count);
+    void move (std::size_t from, std::size_t to);
+
+    std::size_t _capacity;
+    std::size_t _size = 0;
+
+    // hot, touched by update(). Padded to a multiple of four.
+    std::vector<float> _pos_x, _pos_y, _pos_z;
+    std::vector<float> _speed_x, _speed_y, _speed_z;
+    std::vector<float> _down_x, _down_y, _down_z;
+    std::vector<float> _dir_x, _dir_y, _dir_z;
+    std::vector<float> _life, _maxlife;
+    std::vector<float> _particle_size;
+    std::vector<float> _color_r, _color_g, _color_b, _color_a;
+    //! per-particle speed factor, only filled when slowing down
+    std::vector<float> _speed_scale;
+
+    // cold, only read when drawing
+    std::vector<math::vector_3d> _origin;
+    std::vector<std::array<math::vector_3d, 4>> _corners;
+    std::vector<unsigned int> _tile;
+  };
+}
@@ -0,0 +1,93 @@
+// This file is part of Noggit3, licensed under GNU General Public License (version 3).
+
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace noggit
+{
+  //! Double-ended queue over one contiguous allocation, indexed from the
+  //! front. Only grows when pushing into a full buffer, so a steady state
+  //! of pushing to the front and trimming the back does not allocate.
+  template<typename T>
+    class ring_buffer
+  {
+  public:
+    std::size_t size() const { return _size; }
+    bool empty() const { return _size == 0; }
+
+    T& operator[] (std::size_t i)
+    {
+      assert (i < _size);
+      return _data[(_head + i) % _data.size()];
+    }
+    T const& operator[] (std::size_t i) const
+    {
+      assert (i < _size);
+      return _data[(_head + i) % _data.size()];
+    }
+
+    T& front() { return (*this)[0]; }
+    T const& front() const { return (*this)[0]; }
+    T& back() { return (*this)[_size - 1]; }
+    T const& back() const { return (*this)[_size - 1]; }
+
+    void push_front (T value)
+    {
+      if (_size == _data.size())
+      {
+        grow();
+      }
+
+      _head = (_head + _data.size() - 1) % _data.size();
+      _data[_head] = std::move (value);
+      ++_size;
+    }
+
+    void push_back (T value)
+    {
+      if (_size == _data.size())
+      {
+        grow();
+      }
+
+      _data[(_head + _size) % _data.size()] = std::move (value);
+      ++_size;
+    }
+
+    //! drops everything after the first count elements
+    void truncate (std::size_t count)
+    {
+      if (count < _size)
+      {
+        _size = count;
+      }
+    }
+
+    void clear()
+    {
+      _head = 0;
+      _size = 0;
+    }
+
+  private:
+    void grow()
+    {
+      std::vector<T> data (std::max<std::size_t> (8, _data.size() * 2));
+      for (std::size_t i (0); i < _size; ++i)
+      {
+        data[i] = std::move ((*this)[i]);
+      }
+      _data = std::move (data);
+      _head = 0;
+    }
+
+    std::vector<T> _data;
+    std::size_t _head = 0;
+    std::size_t _size = 0;
+  };
+}
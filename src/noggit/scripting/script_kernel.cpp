@@ -0,0 +1,293 @@
+// This file is part of Noggit3, licensed under GNU General Public License (version 3).
+#include <noggit/scripting/script_kernel.hpp>
+#include <noggit/scripting/script_exception.hpp>
+#include <noggit/scripting/script_math.hpp>
+#include <noggit/scripting/script_random.hpp>
+#include <noggit/scripting/script_vert.hpp>
+
+#include <noggit/MapChunk.h>
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <thread>
+
+namespace noggit
+{
+  namespace scripting
+  {
+    kernel_parameters read_kernel_parameters(sol::table const& table)
+    {
+      kernel_parameters params;
+      table.for_each([&](sol::object const& key, sol::object const& value)
+      {
+        if (key.get_type() != sol::type::string)
+        {
+          throw script_exception(
+            "selection::run_kernel",
+            "kernel parameter names must be strings");
+        }
+
+        std::string name = key.as<std::string>();
+        switch (value.get_type())
+        {
+          case sol::type::number:
+            params.emplace_back(name, value.as<double>());
+            break;
+          case sol::type::boolean:
+            params.emplace_back(name, value.as<bool>());
+            break;
+          case sol::type::string:
+            params.emplace_back(name, value.as<std::string>());
+            break;
+          default:
+            throw script_exception(
+              "selection::run_kernel",
+              "kernel parameter '" + name + "' must be a number, boolean or string");
+        }
+      });
+      return params;
+    }
+
+    kernel_chunk::kernel_chunk(MapChunk* chunk, std::vector<int> const& indices)
+      : _chunk(chunk)
+      , _indices(indices)
+    {
+    }
+
+    int kernel_chunk::vertex(std::string const& caller, int index) const
+    {
+      if (index < 0 || index >= static_cast<int>(_indices.size()))
+      {
+        throw script_exception(
+          caller,
+          "vertex index out of range: " + std::to_string(index));
+      }
+      return _indices[index];
+    }
+
+    void kernel_chunk::check_layer(std::string const& caller, int layer) const
+    {
+      if (layer < 0 || layer > 3)
+      {
+        throw script_exception(
+          caller,
+          "invalid texture layer: " + std::to_string(layer));
+      }
+    }
+
+    int kernel_chunk::count()
+    {
+      return static_cast<int>(_indices.size());
+    }
+
+    float kernel_chunk::get_x(int index)
+    {
+      return _chunk->mVertices[vertex("kernel_chunk::get_x", index)].x;
+    }
+
+    float kernel_chunk::get_z(int index)
+    {
+      return _chunk->mVertices[vertex("kernel_chunk::get_z", index)].z;
+    }
+
+    float kernel_chunk::get_height(int index)
+    {
+      return _chunk->mVertices[vertex("kernel_chunk::get_height", index)].y;
+    }
+
+    void kernel_chunk::set_height(int index, float height)
+    {
+      _chunk->mVertices[vertex("kernel_chunk::set_height", index)].y = height;
+      _heights_changed = true;
+    }
+
+    math::vector_3d kernel_chunk::get_color(int index)
+    {
+      int const vert = vertex("kernel_chunk::get_color", index);
+      return _chunk->hasColors() ? _chunk->mccv[vert] : math::vector_3d(1.f, 1.f, 1.f);
+    }
+
+    void kernel_chunk::set_color(int index, float r, float g, float b)
+    {
+      int const vert = vertex("kernel_chunk::set_color", index);
+      _chunk->maybe_create_mccv();
+      _chunk->mccv[vert] = math::vector_3d(r, g, b);
+      _colors_changed = true;
+    }
+
+    float kernel_chunk::get_alpha(int index, int layer)
+    {
+      check_layer("kernel_chunk::get_alpha", layer);
+      return get_vert_alpha(_chunk, vertex("kernel_chunk::get_alpha", index), layer);
+    }
+
+    void kernel_chunk::set_alpha(int index, int layer, float alpha)
+    {
+      check_layer("kernel_chunk::set_alpha", layer);
+      set_vert_alpha(_chunk, vertex("kernel_chunk::set_alpha", index), layer, alpha);
+      _textures_changed = true;
+    }
+
+    namespace
+    {
+      void register_kernel_state(sol::state& lua)
+      {
+        lua.open_libraries(sol::lib::base, sol::lib::table, sol::lib::string);
+        register_math_functions(lua);
+
+        lua.new_usertype<random>("random"
+          , "integer", &random::integer
+          , "real", &random::real
+          );
+
+        lua.new_usertype<kernel_chunk>("kernel_chunk"
+          , "count", &kernel_chunk::count
+          , "get_x", &kernel_chunk::get_x
+          , "get_z", &kernel_chunk::get_z
+          , "get_height", &kernel_chunk::get_height
+          , "set_height", &kernel_chunk::set_height
+          , "get_color", &kernel_chunk::get_color
+          , "set_color", &kernel_chunk::set_color
+          , "get_alpha", &kernel_chunk::get_alpha
+          , "set_alpha", &kernel_chunk::set_alpha
+          );
+      }
+
+      sol::table create_params_table(sol::state& lua, kernel_parameters const& params)
+      {
+        sol::table table = lua.create_table();
+        for (auto const& param : params)
+        {
+          std::visit([&](auto const& value) { table[param.first] = value; }, param.second);
+        }
+        return table;
+      }
+
+      std::string chunk_seed(std::string const& seed, MapChunk* chunk)
+      {
+        return seed
+          + ":" + std::to_string(static_cast<int>(chunk->xbase))
+          + ":" + std::to_string(static_cast<int>(chunk->zbase));
+      }
+    }
+
+    void run_kernel ( std::string const& caller
+                    , std::string const& source
+                    , kernel_parameters const& params
+                    , std::size_t job_count
+                    , kernel_runner const& run_job
+                    , std::size_t max_threads
+                    )
+    {
+      if (job_count == 0)
+      {
+        return;
+      }
+
+      std::atomic<std::size_t> next_job(0);
+      std::atomic<bool> failed(false);
+      std::mutex error_mutex;
+      std::string error;
+
+      auto const fail([&](std::string const& message)
+      {
+        std::lock_guard<std::mutex> const lock(error_mutex);
+        if (!failed.exchange(true))
+        {
+          error = message;
+        }
+      });
+
+      auto const worker([&]
+      {
+        try
+        {
+          sol::state lua;
+          register_kernel_state(lua);
+
+          sol::load_result kernel = lua.load(source, "kernel");
+          if (!kernel.valid())
+          {
+            sol::error err = kernel;
+            fail(err.what());
+            return;
+          }
+          sol::protected_function fun = kernel;
+
+          for (std::size_t i; !failed && (i = next_job++) < job_count;)
+          {
+            // globals the kernel sets, and changes to params, stay in here
+            sol::environment env(lua, sol::create, lua.globals());
+            env["params"] = create_params_table(lua, params);
+            sol::set_environment(env, fun);
+
+            sol::protected_function_result result = run_job(i, env, fun);
+            if (!result.valid())
+            {
+              sol::error err = result;
+              fail(err.what());
+            }
+          }
+        }
+        catch (std::exception const& e)
+        {
+          fail(e.what());
+        }
+      });
+
+      if (max_threads == 0)
+      {
+        max_threads = std::max(1u, std::thread::hardware_concurrency());
+      }
+      std::size_t const thread_count(std::min(max_threads, job_count));
+
+      std::vector<std::thread> threads;
+      for (std::size_t i = 1; i < thread_count; ++i)
+      {
+        threads.emplace_back(worker);
+      }
+      worker();
+
+      for (auto& thread : threads)
+      {
+        thread.join();
+      }
+
+      if (failed)
+      {
+        throw script_exception(caller, error);
+      }
+    }
+
+    void run_chunk_kernel ( std::string const& caller
+                          , std::string const& source
+                          , std::string const& seed
+                          , kernel_parameters const& params
+                          , std::vector<kernel_job>& jobs
+                          )
+    {
+      run_kernel(caller, source, params, jobs.size()
+        , [&](std::size_t i, sol::environment& env, sol::protected_function const& kernel)
+          {
+            kernel_job& job = jobs[i];
+            kernel_chunk chunk(job.chunk, job.indices);
+            random rand(nullptr, chunk_seed(seed, job.chunk));
+
+            env["chunk"] = &chunk;
+            env["rand"] = &rand;
+            sol::protected_function_result result = kernel();
+            env["chunk"] = sol::lua_nil;
+            env["rand"] = sol::lua_nil;
+
+            // keep partial changes so they still get uploaded
+            job.heights_changed = chunk.heights_changed();
+            job.colors_changed = chunk.colors_changed();
+            job.textures_changed = chunk.textures_changed();
+
+            return result;
+          }
+        );
+    }
+  } // namespace scripting
+} // namespace noggit
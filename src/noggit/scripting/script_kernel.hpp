@@ -0,0 +1,99 @@
+// This file is part of Noggit3, licensed under GNU General Public License (version 3).
+#pragma once
+
+#include <math/vector_3d.hpp>
+
+#include <sol/sol.hpp>
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <utility>
+#include <variant>
+#include <vector>
+
+class MapChunk;
+
+namespace noggit
+{
+  namespace scripting
+  {
+    //! plain values copied out of a script table so they can be handed
+    //! to the lua states of the kernel workers
+    using kernel_parameter = std::variant<double, bool, std::string>;
+    using kernel_parameters = std::vector<std::pair<std::string, kernel_parameter>>;
+
+    kernel_parameters read_kernel_parameters(sol::table const& table);
+
+    //! one chunk as seen by a chunk kernel: only the vertices inside the
+    //! selection, addressed 0..count()-1. Everything here only touches the
+    //! chunk it wraps, so kernels for different chunks may run concurrently.
+    class kernel_chunk
+    {
+    public:
+      kernel_chunk(MapChunk* chunk, std::vector<int> const& indices);
+
+      int count();
+      float get_x(int index);
+      float get_z(int index);
+      float get_height(int index);
+      void set_height(int index, float height);
+      math::vector_3d get_color(int index);
+      void set_color(int index, float r, float g, float b);
+      float get_alpha(int index, int layer);
+      void set_alpha(int index, int layer, float alpha);
+
+      bool heights_changed() const { return _heights_changed; }
+      bool colors_changed() const { return _colors_changed; }
+      bool textures_changed() const { return _textures_changed; }
+
+    private:
+      int vertex(std::string const& caller, int index) const;
+      void check_layer(std::string const& caller, int layer) const;
+
+      MapChunk* _chunk;
+      std::vector<int> const& _indices;
+      bool _heights_changed = false;
+      bool _colors_changed = false;
+      bool _textures_changed = false;
+    };
+
+    struct kernel_job
+    {
+      MapChunk* chunk;
+      std::vector<int> indices;
+
+      bool heights_changed = false;
+      bool colors_changed = false;
+      bool textures_changed = false;
+    };
+
+    //! Runs the lua source job_count times on up to max_threads worker
+    //! threads (0 uses one per core), each with its own lua state that only
+    //! knows math, random and kernel_chunk. Every job gets a fresh
+    //! environment falling back to those globals and its own 'params'
+    //! table, so nothing a kernel stores is seen by the next job of the same
+    //! worker. run_job sets the remaining globals of job i in env and calls
+    //! kernel. Throws the first error raised by any job.
+    using kernel_runner = std::function<sol::protected_function_result
+      (std::size_t job, sol::environment& env, sol::protected_function const& kernel)>;
+
+    void run_kernel ( std::string const& caller
+                    , std::string const& source
+                    , kernel_parameters const& params
+                    , std::size_t job_count
+                    , kernel_runner const& run_job
+                    , std::size_t max_threads = 0
+                    );
+
+    //! run_kernel() once per chunk, with the globals 'chunk' and 'rand' set
+    //! for every job, 'rand' being seeded from seed and the chunk position
+    //! so the result does not depend on scheduling.
+    void run_chunk_kernel ( std::string const& caller
+                          , std::string const& source
+                          , std::string const& seed
+                          , kernel_parameters const& params
+                          , std::vector<kernel_job>& jobs
+                          );
+  } // namespace scripting
+} // namespace noggit
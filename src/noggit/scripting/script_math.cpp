@@ -61,34 +61,39 @@ namespace noggit
 
     void register_math(script_context * state)
     {
-      state->set_function("round",round);
-      state->set_function("pow",pow);
-      state->set_function("log10",log10);
-      state->set_function("log",log);
-      state->set_function("ceil",ceil);
-      state->set_function("floor",floor);
-      state->set_function("exp",exp);
-      state->set_function("cbrt",cbrt);
-      state->set_function("acosh",acosh);
-      state->set_function("asinh",asinh);
-      state->set_function("atanh",atanh);
-      state->set_function("cosh",cosh);
-      state->set_function("sinh",sinh);
-      state->set_function("tanh",tanh);
-      state->set_function("acos",acos);
-      state->set_function("asin",asin);
-      state->set_function("atan",atan);
-      state->set_function("cos",cos);
-      state->set_function("sin",sin);
-      state->set_function("tan",tan);
-      state->set_function("sqrt",sqrt);
-      state->set_function("abs",abs);
-      state->set_function("lerp",lerp);
-      state->set_function("dist_2d",dist_2d);
-      state->set_function("dist_2d_compare",dist_2d_compare);
-      state->set_function("rotate_2d",rotate_2d);
+      register_math_functions(*state);
+    }
+
+    void register_math_functions(sol::state_view state)
+    {
+      state.set_function("round",round);
+      state.set_function("pow",pow);
+      state.set_function("log10",log10);
+      state.set_function("log",log);
+      state.set_function("ceil",ceil);
+      state.set_function("floor",floor);
+      state.set_function("exp",exp);
+      state.set_function("cbrt",cbrt);
+      state.set_function("acosh",acosh);
+      state.set_function("asinh",asinh);
+      state.set_function("atanh",atanh);
+      state.set_function("cosh",cosh);
+      state.set_function("sinh",sinh);
+      state.set_function("tanh",tanh);
+      state.set_function("acos",acos);
+      state.set_function("asin",asin);
+      state.set_function("atan",atan);
+      state.set_function("cos",cos);
+      state.set_function("sin",sin);
+      state.set_function("tan",tan);
+      state.set_function("sqrt",sqrt);
+      state.set_function("abs",abs);
+      state.set_function("lerp",lerp);
+      state.set_function("dist_2d",dist_2d);
+      state.set_function("dist_2d_compare",dist_2d_compare);
+      state.set_function("rotate_2d",rotate_2d);
 
-      state->new_usertype<math::vector_3d>("vector_3d"
+      state.new_usertype<math::vector_3d>("vector_3d"
         , "x", &math::vector_3d::x
         , "y", &math::vector_3d::y
         , "z", &math::vector_3d::z
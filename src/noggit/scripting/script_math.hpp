@@ -3,6 +3,8 @@
 
 #include <math/vector_3d.hpp>
 
+#include <sol/sol.hpp>
+
 #include <memory>
 #include <string>
 
@@ -40,5 +42,7 @@ namespace noggit
     math::vector_3d rotate_2d(math::vector_3d const& point, math::vector_3d const& origin, float angleDeg);
 
     void register_math(script_context * state);
+    //! math functions and vector_3d only, for states without a script_context
+    void register_math_functions(sol::state_view state);
   } // namespace scripting
 } // namespace noggit
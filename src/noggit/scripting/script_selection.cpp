@@ -114,16 +114,19 @@ namespace noggit
 
     sol::as_table_t<std::vector<chunk>> selection::chunks()
     {
+      _objects_handed_out = true;
       return sol::as_table(chunks_raw());
     }
 
     sol::as_table_t<std::vector<vert>> selection::verts()
     {
+      _objects_handed_out = true;
       return sol::as_table(verts_raw());
     }
 
     sol::as_table_t<std::vector<tex>> selection::textures()
     {
+      _objects_handed_out = true;
       return sol::as_table(textures_raw());
     }
 
@@ -132,11 +135,272 @@ namespace noggit
       return sol::as_table(models_raw());
     }
 
+    void selection::collect_vertices()
+    {
+      if (_vertices_collected)
+      {
+        return;
+      }
+
+      _world->select_all_chunks_between(_min, _max, _chunks);
+      _chunk_changes.assign(_chunks.size(), 0);
+
+      for (std::size_t c = 0; c < _chunks.size(); ++c)
+      {
+        for (int i = 0; i < mapbufsize; ++i)
+        {
+          auto& v = _chunks[c]->mVertices[i];
+          if (v.x >= _min.x && v.x <= _max.x &&
+            v.z >= _min.z && v.z <= _max.z)
+          {
+            _vertices.push_back({c, i});
+          }
+        }
+      }
+
+      _vertices_collected = true;
+    }
+
+    std::vector<float> selection::read_table( std::string const& caller
+                                            , sol::table const& table
+                                            , std::size_t expected_size
+                                            )
+    {
+      std::size_t const size = table.size();
+      if (size != expected_size)
+      {
+        throw script_exception(
+          caller,
+          std::string("expected ")
+          + std::to_string(expected_size)
+          + " values, got "
+          + std::to_string(size));
+      }
+
+      std::vector<float> values(size);
+      for (std::size_t i = 0; i < size; ++i)
+      {
+        values[i] = table.get<float>(i + 1);
+      }
+      return values;
+    }
+
+    template<typename Fun>
+      void selection::modify_heights(Fun&& fun)
+    {
+      collect_vertices();
+      for (std::size_t i = 0; i < _vertices.size(); ++i)
+      {
+        auto const& v = _vertices[i];
+        fun(_chunks[v.chunk]->mVertices[v.index], i);
+        _chunk_changes[v.chunk] |= heightmap_changed;
+      }
+    }
+
+    sol::as_table_t<std::vector<float>> selection::get_heights()
+    {
+      collect_vertices();
+      std::vector<float> heights(_vertices.size());
+      for (std::size_t i = 0; i < _vertices.size(); ++i)
+      {
+        heights[i] = _chunks[_vertices[i].chunk]->mVertices[_vertices[i].index].y;
+      }
+      return sol::as_table(std::move(heights));
+    }
+
+    void selection::set_heights(sol::table const& heights)
+    {
+      collect_vertices();
+      auto const values = read_table("selection::set_heights", heights, _vertices.size());
+      modify_heights([&](math::vector_3d& v, std::size_t i) { v.y = values[i]; });
+    }
+
+    void selection::add_heights(sol::table const& offsets)
+    {
+      collect_vertices();
+      auto const values = read_table("selection::add_heights", offsets, _vertices.size());
+      modify_heights([&](math::vector_3d& v, std::size_t i) { v.y += values[i]; });
+    }
+
+    void selection::set_heights_from_noise(std::shared_ptr<noisemap> const& noise, float amplitude)
+    {
+      modify_heights([&](math::vector_3d& v, std::size_t)
+      {
+        math::vector_3d pos = v;
+        v.y = noise->get(pos) * amplitude;
+      });
+    }
+
+    void selection::add_heights_from_noise(std::shared_ptr<noisemap> const& noise, float amplitude)
+    {
+      modify_heights([&](math::vector_3d& v, std::size_t)
+      {
+        math::vector_3d pos = v;
+        v.y += noise->get(pos) * amplitude;
+      });
+    }
+
+    void selection::run_kernel(std::string const& source, std::string const& seed)
+    {
+      run_kernel_impl(source, seed, {});
+    }
+
+    void selection::run_kernel_with_params( std::string const& source
+                                          , std::string const& seed
+                                          , sol::table const& params
+                                          )
+    {
+      run_kernel_impl(source, seed, read_kernel_parameters(params));
+    }
+
+    void selection::run_kernel_impl( std::string const& source
+                                   , std::string const& seed
+                                   , kernel_parameters const& params
+                                   )
+    {
+      collect_vertices();
+
+      std::vector<kernel_job> jobs(_chunks.size());
+      for (std::size_t c = 0; c < _chunks.size(); ++c)
+      {
+        jobs[c].chunk = _chunks[c];
+      }
+      for (auto const& v : _vertices)
+      {
+        jobs[v.chunk].indices.push_back(v.index);
+      }
+
+      // chunks a failing kernel already touched still need to be applied
+      auto const mark_changes([&]
+      {
+        for (std::size_t c = 0; c < jobs.size(); ++c)
+        {
+          _chunk_changes[c] |= (jobs[c].heights_changed ? heightmap_changed : 0)
+                             | (jobs[c].colors_changed ? vertex_color_changed : 0)
+                             | (jobs[c].textures_changed ? textures_changed : 0);
+        }
+      });
+
+      try
+      {
+        run_chunk_kernel("selection::run_kernel", source, seed, params, jobs);
+      }
+      catch (...)
+      {
+        mark_changes();
+        throw;
+      }
+      mark_changes();
+    }
+
+    sol::as_table_t<std::vector<float>> selection::get_colors()
+    {
+      collect_vertices();
+      std::vector<float> colors;
+      colors.reserve(_vertices.size() * 3);
+      for (auto const& v : _vertices)
+      {
+        MapChunk* chunk = _chunks[v.chunk];
+        math::vector_3d const color = chunk->hasColors()
+          ? chunk->mccv[v.index]
+          : math::vector_3d(1, 1, 1);
+        colors.push_back(color.x);
+        colors.push_back(color.y);
+        colors.push_back(color.z);
+      }
+      return sol::as_table(std::move(colors));
+    }
+
+    void selection::set_colors(sol::table const& colors)
+    {
+      collect_vertices();
+      auto const values = read_table("selection::set_colors", colors, _vertices.size() * 3);
+      for (std::size_t i = 0; i < _vertices.size(); ++i)
+      {
+        auto const& v = _vertices[i];
+        MapChunk* chunk = _chunks[v.chunk];
+        if (!(_chunk_changes[v.chunk] & vertex_color_changed))
+        {
+          chunk->maybe_create_mccv();
+          _chunk_changes[v.chunk] |= vertex_color_changed;
+        }
+        chunk->mccv[v.index] = math::vector_3d(values[i * 3], values[i * 3 + 1], values[i * 3 + 2]);
+      }
+    }
+
+    sol::as_table_t<std::vector<float>> selection::get_alphas(int layer)
+    {
+      if (layer < 0 || layer > 3)
+      {
+        throw script_exception(
+          "selection::get_alphas",
+          std::string("invalid texture layer: ")
+          + std::to_string(layer));
+      }
+      collect_vertices();
+      std::vector<float> alphas(_vertices.size());
+      for (std::size_t i = 0; i < _vertices.size(); ++i)
+      {
+        alphas[i] = get_vert_alpha(_chunks[_vertices[i].chunk], _vertices[i].index, layer);
+      }
+      return sol::as_table(std::move(alphas));
+    }
+
+    void selection::set_alphas(int layer, sol::table const& alphas)
+    {
+      if (layer < 0 || layer > 3)
+      {
+        throw script_exception(
+          "selection::set_alphas",
+          std::string("invalid texture layer: ")
+          + std::to_string(layer));
+      }
+      collect_vertices();
+      auto const values = read_table("selection::set_alphas", alphas, _vertices.size());
+      for (std::size_t i = 0; i < _vertices.size(); ++i)
+      {
+        auto const& v = _vertices[i];
+        set_vert_alpha(_chunks[v.chunk], v.index, layer, values[i]);
+        _chunk_changes[v.chunk] |= textures_changed;
+      }
+    }
+
     void selection::apply()
     {
-      for (auto& chnk : chunks_raw())
+      // objects handed out to the script may have changed anything,
+      // so fall back to applying everything
+      if (_objects_handed_out || !_vertices_collected)
       {
-        chnk.apply_all();
+        for (auto& chnk : chunks_raw())
+        {
+          chnk.apply_all();
+        }
+        std::fill(_chunk_changes.begin(), _chunk_changes.end(), 0);
+        return;
+      }
+
+      for (std::size_t c = 0; c < _chunks.size(); ++c)
+      {
+        int const changes = _chunk_changes[c];
+        if (!changes)
+        {
+          continue;
+        }
+
+        chunk chnk(state(), _chunks[c]);
+        if (changes & heightmap_changed)
+        {
+          chnk.apply_heightmap();
+        }
+        if (changes & textures_changed)
+        {
+          chnk.apply_textures();
+        }
+        if (changes & vertex_color_changed)
+        {
+          chnk.apply_vertex_color();
+        }
+        _chunk_changes[c] = 0;
       }
     }
 
@@ -153,6 +417,19 @@ namespace noggit
         , "models", &selection::models
         , "chunks", &selection::chunks
         , "make_noise", &selection::make_noise
+        , "get_heights", &selection::get_heights
+        , "set_heights", &selection::set_heights
+        , "add_heights", &selection::add_heights
+        , "get_colors", &selection::get_colors
+        , "set_colors", &selection::set_colors
+        , "get_alphas", &selection::get_alphas
+        , "set_alphas", &selection::set_alphas
+        , "set_heights_from_noise", &selection::set_heights_from_noise
+        , "add_heights_from_noise", &selection::add_heights_from_noise
+        , "run_kernel", sol::overload(
+            &selection::run_kernel
+          , &selection::run_kernel_with_params
+          )
         );
 
       state->set_function("select_origin", [state](
@@ -4,6 +4,7 @@
 #include <noggit/scripting/script_object.hpp>
 #include <noggit/scripting/script_model.hpp>
 #include <noggit/scripting/script_chunk.hpp>
+#include <noggit/scripting/script_kernel.hpp>
 
 #include <math/vector_3d.hpp>
 
@@ -54,9 +55,60 @@ namespace noggit
       sol::as_table_t<std::vector<tex>> textures();
       sol::as_table_t<std::vector<model>> models();
 
+      // bulk accessors: flat arrays in the same order as verts(), colors
+      // as consecutive r, g, b triplets. Chunks changed through these are
+      // remembered and only those are applied by apply().
+      sol::as_table_t<std::vector<float>> get_heights();
+      void set_heights(sol::table const& heights);
+      void add_heights(sol::table const& offsets);
+      sol::as_table_t<std::vector<float>> get_colors();
+      void set_colors(sol::table const& colors);
+      sol::as_table_t<std::vector<float>> get_alphas(int layer);
+      void set_alphas(int layer, sol::table const& alphas);
+      void set_heights_from_noise(std::shared_ptr<noisemap> const& noise, float amplitude);
+      void add_heights_from_noise(std::shared_ptr<noisemap> const& noise, float amplitude);
+
+      // runs a lua kernel for every chunk in parallel, see run_chunk_kernel
+      void run_kernel(std::string const& source, std::string const& seed);
+      void run_kernel_with_params( std::string const& source
+                                 , std::string const& seed
+                                 , sol::table const& params
+                                 );
+
       void apply();
     
     private:
+      enum chunk_changes
+      {
+        heightmap_changed = 0x1,
+        vertex_color_changed = 0x2,
+        textures_changed = 0x4,
+      };
+
+      struct selected_vertex
+      {
+        std::size_t chunk;
+        int index;
+      };
+
+      void collect_vertices();
+      std::vector<float> read_table ( std::string const& caller
+                                    , sol::table const& table
+                                    , std::size_t expected_size
+                                    );
+      void run_kernel_impl( std::string const& source
+                          , std::string const& seed
+                          , kernel_parameters const& params
+                          );
+      template<typename Fun>
+        void modify_heights(Fun&& /* (math::vector_3d&, std::size_t) -> void */);
+
+      bool _vertices_collected = false;
+      bool _objects_handed_out = false;
+      std::vector<MapChunk*> _chunks;
+      std::vector<selected_vertex> _vertices;
+      std::vector<int> _chunk_changes;
+
       World* _world;
       math::vector_3d _center;
       math::vector_3d _min;
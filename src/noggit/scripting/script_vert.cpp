@@ -82,23 +82,16 @@ namespace noggit
       return _chunk->mVertices[_index];
     }
 
-    void vert::set_alpha(int index, float alpha)
+    void set_vert_alpha(MapChunk* chunk, int vert_index, int layer, float alpha)
     {
-      if(index<0||index>3)
-      {
-        throw script_exception(
-            "vert::set_alpha",
-            std::string("invalid texture layer: ")
-          + std::to_string(index));
-      }
-      if (index == 0)
+      if (layer == 0)
       {
         return;
       }
-      auto& ts = _chunk->texture_set;
+      auto& ts = chunk->texture_set;
       ts->create_temporary_alphamaps_if_needed();
 
-      auto tex_indices = texture_index[_index];
+      auto const& tex_indices = texture_index[vert_index];
 
       for ( auto iter = std::begin(tex_indices.indices)
           ; iter != std::end(tex_indices.indices)
@@ -107,26 +100,19 @@ namespace noggit
       {
         if (*iter == -1)
           break;
-        ts->tmp_edit_values.get()[index][*iter] = alpha;
+        ts->tmp_edit_values.get()[layer][*iter] = alpha;
       }
     }
 
-    float vert::get_alpha(int index)
+    float get_vert_alpha(MapChunk* chunk, int vert_index, int layer)
     {
-      if(index<0||index>3)
-      {
-        throw script_exception(
-          "vert::get_alpha",
-          std::string("invalid texture layer: ")
-          + std::to_string(index));
-      }
-      if (index == 0)
+      if (layer == 0)
       {
         return 1;
       }
-      auto& ts = _chunk->texture_set;
+      auto& ts = chunk->texture_set;
       ts->create_temporary_alphamaps_if_needed();
-      auto tex_indices = texture_index[_index];
+      auto const& tex_indices = texture_index[vert_index];
 
       float sum = 0;
       int ctr = 0;
@@ -137,12 +123,36 @@ namespace noggit
       {
         if (*iter == -1)
           break;
-        sum += ts->tmp_edit_values.get()[index][*iter];
+        sum += ts->tmp_edit_values.get()[layer][*iter];
         ++ctr;
       }
       return sum / float(ctr);
     }
 
+    void vert::set_alpha(int index, float alpha)
+    {
+      if(index<0||index>3)
+      {
+        throw script_exception(
+            "vert::set_alpha",
+            std::string("invalid texture layer: ")
+          + std::to_string(index));
+      }
+      set_vert_alpha(_chunk, _index, index, alpha);
+    }
+
+    float vert::get_alpha(int index)
+    {
+      if(index<0||index>3)
+      {
+        throw script_exception(
+          "vert::get_alpha",
+          std::string("invalid texture layer: ")
+          + std::to_string(index));
+      }
+      return get_vert_alpha(_chunk, _index, index);
+    }
+
     bool vert::is_water_aligned()
     {
       return (_index % VERTS_PER_TWO_ROWS) > VERTS_ON_ODD_ROWS;
@@ -37,6 +37,11 @@ namespace noggit
       int _index;
     };
 
+    // alpha of a texture layer around a vertex, shared by vert and the
+    // bulk accessors of selection. layer is expected to be within 0-3.
+    float get_vert_alpha(MapChunk* chunk, int vert_index, int layer);
+    void set_vert_alpha(MapChunk* chunk, int vert_index, int layer, float alpha);
+
     void register_vert(script_context * state);
   } // namespace scripting
 } // namespace noggit
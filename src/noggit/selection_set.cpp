@@ -0,0 +1,137 @@
+// This file is part of Noggit3, licensed under GNU General Public License (version 3).
+
+#include <noggit/ModelInstance.h>
+#include <noggit/WMOInstance.h>
+#include <noggit/selection_set.hpp>
+
+#include <algorithm>
+
+namespace noggit
+{
+  namespace
+  {
+    struct instance_entry
+    {
+      std::uint32_t uid;
+      selection_flag* flag;
+    };
+
+    //! uid and flag of a model or WMO entry, nullptr flag for chunks
+    instance_entry instance_of (selection_type const& entry)
+    {
+      switch (entry.which())
+      {
+      case eEntry_Model:
+        {
+          auto const model (boost::get<selected_model_type> (entry));
+          return {model->uid, &model->selected};
+        }
+      case eEntry_WMO:
+        {
+          auto const wmo (boost::get<selected_wmo_type> (entry));
+          return {wmo->mUniqueID, &wmo->selected};
+        }
+      default:
+        return {0, nullptr};
+      }
+    }
+
+    bool has_uid (selection_type const& entry, std::uint32_t uid)
+    {
+      instance_entry const instance (instance_of (entry));
+      return instance.flag && instance.uid == uid;
+    }
+  }
+
+  bool selection_set::add (selection_type const& entry)
+  {
+    instance_entry const instance (instance_of (entry));
+
+    if (instance.flag)
+    {
+      if (!_uids.emplace (instance.uid).second)
+      {
+        return false;
+      }
+      instance.flag->_selected = true;
+    }
+
+    _entries.push_back (entry);
+    return true;
+  }
+
+  bool selection_set::remove (selection_type const& entry)
+  {
+    instance_entry const instance (instance_of (entry));
+
+    if (instance.flag)
+    {
+      return remove (instance.uid);
+    }
+
+    auto const it (std::find (_entries.begin(), _entries.end(), entry));
+    if (it == _entries.end())
+    {
+      return false;
+    }
+
+    _entries.erase (it);
+    return true;
+  }
+
+  bool selection_set::remove (std::uint32_t uid)
+  {
+    if (!_uids.erase (uid))
+    {
+      return false;
+    }
+
+    auto const it ( std::find_if ( _entries.begin(), _entries.end()
+                                 , [uid] (selection_type const& entry)
+                                   {
+                                     return has_uid (entry, uid);
+                                   }
+                                 )
+                  );
+
+    instance_of (*it).flag->_selected = false;
+    _entries.erase (it);
+    return true;
+  }
+
+  bool selection_set::remove (std::vector<selection_type> const& entries)
+  {
+    bool removed (false);
+    for (selection_type const& entry : entries)
+    {
+      removed = remove (entry) || removed;
+    }
+    return removed;
+  }
+
+  void selection_set::clear()
+  {
+    for (selection_type const& entry : _entries)
+    {
+      if (selection_flag* flag = instance_of (entry).flag)
+      {
+        flag->_selected = false;
+      }
+    }
+
+    _entries.clear();
+    _uids.clear();
+  }
+
+  bool selection_set::contains (selection_type const& entry) const
+  {
+    instance_entry const instance (instance_of (entry));
+
+    if (instance.flag)
+    {
+      return contains (instance.uid);
+    }
+
+    return std::find (_entries.begin(), _entries.end(), entry) != _entries.end();
+  }
+}
@@ -0,0 +1,69 @@
+// This file is part of Noggit3, licensed under GNU General Public License (version 3).
+
+#pragma once
+
+#include <noggit/Selection.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_set>
+#include <vector>
+
+namespace noggit
+{
+  //! Set on model and WMO instances while they are part of the selection,
+  //! so that the renderers don't have to look them up. It belongs to the
+  //! object, not to its value: copies start unselected and assignments
+  //! keep the state of the target.
+  class selection_flag
+  {
+  public:
+    selection_flag() = default;
+    selection_flag (selection_flag const&) {}
+    selection_flag& operator= (selection_flag const&) { return *this; }
+
+    operator bool() const { return _selected; }
+
+  private:
+    friend class selection_set;
+
+    bool _selected = false;
+  };
+
+  //! The current selection: the entries in the order they were selected,
+  //! which the pivot and the last selected model rely on, plus the uids of
+  //! the selected models and WMOs for constant time membership tests.
+  //! Instances must leave the selection before they are destroyed.
+  class selection_set
+  {
+  public:
+    selection_set() = default;
+
+    selection_set (selection_set const&) = delete;
+    selection_set& operator= (selection_set const&) = delete;
+
+    //! false if the model or WMO was already selected
+    bool add (selection_type const&);
+    //! false if the entry was not selected
+    bool remove (selection_type const&);
+    //! removes the model or WMO with that uid, false if there is none
+    bool remove (std::uint32_t uid);
+    //! removes the entries that are selected, e.g. instances about to be
+    //! deleted, false if none was
+    bool remove (std::vector<selection_type> const&);
+    void clear();
+
+    bool contains (selection_type const&) const;
+    bool contains (std::uint32_t uid) const { return _uids.count (uid); }
+
+    std::vector<selection_type> const& entries() const { return _entries; }
+    bool empty() const { return _entries.empty(); }
+    std::size_t size() const { return _entries.size(); }
+    //! number of selected models and WMOs
+    std::size_t instance_count() const { return _uids.size(); }
+
+  private:
+    std::vector<selection_type> _entries;
+    std::unordered_set<std::uint32_t> _uids;
+  };
+}
@@ -0,0 +1,113 @@
+// This file is part of Noggit3, licensed under GNU General Public License (version 3).
+
+#include <noggit/settings_snapshot.hpp>
+
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace noggit
+{
+  namespace
+  {
+    struct settings_registry
+    {
+      settings_registry()
+      {
+        published.emplace_back (new settings_snapshot);
+        current = published.back().get();
+      }
+
+      std::atomic<settings_snapshot const*> current;
+
+      std::mutex mutex;
+      // settings are saved a handful of times per session, keeping every
+      // snapshot alive is what allows readers to go without any locking
+      std::vector<std::unique_ptr<settings_snapshot const>> published;
+      std::map<std::size_t, std::function<void (settings_snapshot const&)>> subscribers;
+      std::size_t next_subscriber_id = 1;
+    };
+
+    settings_registry& registry()
+    {
+      static settings_registry instance;
+      return instance;
+    }
+  }
+
+  settings_snapshot const& current_settings()
+  {
+    return *registry().current.load (std::memory_order_acquire);
+  }
+
+  void publish_settings (settings_snapshot snapshot)
+  {
+    settings_registry& reg (registry());
+    std::vector<std::function<void (settings_snapshot const&)>> subscribers;
+    settings_snapshot const* published;
+
+    {
+      std::lock_guard<std::mutex> const lock (reg.mutex);
+
+      snapshot.generation = reg.published.back()->generation + 1;
+      reg.published.emplace_back (new settings_snapshot (std::move (snapshot)));
+      published = reg.published.back().get();
+      reg.current.store (published, std::memory_order_release);
+
+      for (auto const& subscriber : reg.subscribers)
+      {
+        subscribers.push_back (subscriber.second);
+      }
+    }
+
+    // outside of the lock so callbacks may (un)subscribe
+    for (auto const& subscriber : subscribers)
+    {
+      subscriber (*published);
+    }
+  }
+
+  settings_subscription::settings_subscription (std::function<void (settings_snapshot const&)> callback)
+  {
+    settings_registry& reg (registry());
+    std::lock_guard<std::mutex> const lock (reg.mutex);
+
+    _id = reg.next_subscriber_id++;
+    reg.subscribers.emplace (_id, std::move (callback));
+  }
+
+  settings_subscription::~settings_subscription()
+  {
+    unsubscribe();
+  }
+
+  settings_subscription::settings_subscription (settings_subscription&& other)
+    : _id (other._id)
+  {
+    other._id = 0;
+  }
+
+  settings_subscription& settings_subscription::operator= (settings_subscription&& other)
+  {
+    unsubscribe();
+    std::swap (_id, other._id);
+    return *this;
+  }
+
+  void settings_subscription::unsubscribe()
+  {
+    if (_id == 0)
+    {
+      return;
+    }
+
+    settings_registry& reg (registry());
+    std::lock_guard<std::mutex> const lock (reg.mutex);
+
+    reg.subscribers.erase (_id);
+    _id = 0;
+  }
+}
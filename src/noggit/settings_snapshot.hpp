@@ -0,0 +1,65 @@
+// This file is part of Noggit3, licensed under GNU General Public License (version 3).
+
+#pragma once
+
+#include <math/vector_4d.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+
+namespace noggit
+{
+  //! The settings read by the renderer, the loader threads and per-object
+  //! editing operations. Filled from QSettings by ui::settings::publish_snapshot()
+  //! whenever they are saved, so hot paths never touch QSettings.
+  struct settings_snapshot
+  {
+    std::string project_path;
+
+    float far_z = 2048.f;
+    bool tablet_enabled = false;
+    bool additional_file_loading_log = false;
+
+    int wireframe_type = 0;
+    float wireframe_radius = 1.5f;
+    float wireframe_width = 1.f;
+    math::vector_4d wireframe_color = {0.f, 0.f, 0.f, 1.f};
+
+    bool model_random_rotation = false;
+    bool model_random_tilt = false;
+    bool model_random_size = false;
+
+    //! incremented by every publish, 0 for the defaults
+    std::uint64_t generation = 0;
+  };
+
+  //! The last published snapshot. Lock free and safe from any thread.
+  //! Published snapshots are never freed, so the reference stays valid,
+  //! but it is only current until the next publish.
+  settings_snapshot const& current_settings();
+
+  //! replaces the current snapshot and notifies the subscribers, in the
+  //! calling thread
+  void publish_settings (settings_snapshot snapshot);
+
+  //! Calls the callback after every publish until it is destroyed.
+  class settings_subscription
+  {
+  public:
+    settings_subscription() = default;
+    explicit settings_subscription (std::function<void (settings_snapshot const&)>);
+    ~settings_subscription();
+
+    settings_subscription (settings_subscription const&) = delete;
+    settings_subscription& operator= (settings_subscription const&) = delete;
+    settings_subscription (settings_subscription&&);
+    settings_subscription& operator= (settings_subscription&&);
+
+  private:
+    void unsubscribe();
+
+    std::size_t _id = 0;
+  };
+}
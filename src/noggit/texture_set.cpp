@@ -82,8 +82,7 @@ int TextureSet::addTexture (scoped_blp_texture_reference texture)
     }
   }
 
-  _need_amap_update = true;
-  _need_lod_texture_map_update = true;
+  require_update();
 
   return texLevel;
 }
@@ -157,8 +156,7 @@ void TextureSet::swap_layers(int layer_1, int layer_2)
       alphamaps[a2]->setAlpha(alpha);
     }
 
-    _need_amap_update = true;
-    _need_lod_texture_map_update = true;
+    require_update();
   }
 }
 
@@ -185,8 +183,7 @@ void TextureSet::eraseTextures()
   _lod_texture_map.resize(8 * 8);
   memset(_lod_texture_map.data(), 0, 64 * sizeof(std::uint8_t));
 
-  _need_amap_update = true;
-  _need_lod_texture_map_update = true;
+  require_update();
 
   tmp_edit_values = boost::none;
 }
@@ -232,8 +229,7 @@ void TextureSet::eraseTexture(size_t id)
     tmp_edit_values.get()[nTextures].fill(0.f);
   }
 
-  _need_amap_update = true;
-  _need_lod_texture_map_update = true;
+  require_update();
 }
 
 bool TextureSet::canPaintTexture(scoped_blp_texture_reference const& texture)
@@ -341,8 +337,7 @@ bool TextureSet::eraseUnusedTextures()
       }
     }
 
-    _need_amap_update = true;
-    _need_lod_texture_map_update = true;
+    require_update();
     return true;
   }
 
@@ -521,8 +516,7 @@ bool TextureSet::paintTexture(float xbase, float zbase, float x, float z, Brush*
   // cleanup
   eraseUnusedTextures();
 
-  _need_amap_update = true;
-  _need_lod_texture_map_update = true;
+  require_update();
 
   return true;
 }
@@ -609,8 +603,7 @@ bool TextureSet::replace_texture( float xbase
 
   if (changed)
   {
-    _need_amap_update = true;
-    _need_lod_texture_map_update = true;
+    require_update();
   }
 
   return changed;
@@ -624,6 +617,7 @@ unsigned int TextureSet::flag(size_t id)
 void TextureSet::setEffect(size_t id, int value)
 {
   _layers_info[id].effectID = value;
+  _saved_alphamaps = boost::none;
 }
 
 unsigned int TextureSet::effect(size_t id)
@@ -665,6 +659,7 @@ void TextureSet::change_texture_flag(scoped_blp_texture_reference const& tex, st
         _layers_info[i].flags &= ~FLAG_GLOW;
       }
 
+      _saved_alphamaps = boost::none;
       break;
     }
   }
@@ -672,10 +667,15 @@ void TextureSet::change_texture_flag(scoped_blp_texture_reference const& tex, st
 
 std::vector<std::vector<uint8_t>> TextureSet::save_alpha(bool big_alphamap)
 {
-  std::vector<std::vector<uint8_t>> amaps;
-
   apply_alpha_changes();
 
+  if (_saved_alphamaps && _saved_big_alphamap == big_alphamap)
+  {
+    return _saved_alphamaps.get();
+  }
+
+  std::vector<std::vector<uint8_t>> amaps;
+
   if (nTextures > 1)
   {
     if (big_alphamap)
@@ -725,9 +725,17 @@ std::vector<std::vector<uint8_t>> TextureSet::save_alpha(bool big_alphamap)
     }
   }
 
+  _saved_alphamaps = amaps;
+  _saved_big_alphamap = big_alphamap;
+
   return amaps;
 }
 
+bool TextureSet::changed_since_save(bool big_alphamap) const
+{
+  return tmp_edit_values || !_saved_alphamaps || _saved_big_alphamap != big_alphamap;
+}
+
 scoped_blp_texture_reference TextureSet::texture(size_t id)
 {
   return textures[id];
@@ -780,6 +788,8 @@ void TextureSet::convertToBigAlpha()
   {
     alphamaps[k]->setAlpha(tab + 4096 * k);
   }
+
+  require_update();
 }
 
 // dest = tab [4096 * (nTextures - 1)]
@@ -840,7 +850,7 @@ void TextureSet::convertToOldAlpha()
     alphamaps[k]->setAlpha(tab + k * 4096);
   }
 
-  _need_amap_update = true;
+  require_update();
 }
 
 void TextureSet::merge_layers(size_t id1, size_t id2)
@@ -866,8 +876,7 @@ void TextureSet::merge_layers(size_t id1, size_t id2)
   }
 
   eraseTexture(id2);
-  _need_amap_update = true;
-  _need_lod_texture_map_update = true;
+  require_update();
 }
 
 bool TextureSet::removeDuplicate()
@@ -1056,14 +1065,20 @@ bool TextureSet::apply_alpha_changes()
     alphamaps[alpha_layer]->setAlpha(values.data());
   }
 
-  _need_amap_update = true;
-  _need_lod_texture_map_update = true;
+  require_update();
 
   tmp_edit_values = boost::none;
 
   return true;
 }
 
+void TextureSet::require_update()
+{
+  _need_amap_update = true;
+  _need_lod_texture_map_update = true;
+  _saved_alphamaps = boost::none;
+}
+
 void TextureSet::create_temporary_alphamaps_if_needed()
 {
   if (tmp_edit_values || nTextures < 2)
@@ -61,7 +61,10 @@ public:
   bool is_animated(std::size_t id) const;
   void change_texture_flag(scoped_blp_texture_reference const& tex, std::size_t flag, bool add);
 
+  //! the result is kept until the next change to the alphamaps or layers
   std::vector<std::vector<uint8_t>> save_alpha(bool big_alphamap);
+  //! whether anything written to MCLY/MCAL changed since the last save_alpha()
+  bool changed_since_save(bool big_alphamap) const;
 
   void convertToBigAlpha();
   void convertToOldAlpha();
@@ -89,6 +92,7 @@ private:
   void alphas_to_old_alpha(uint8_t* dest);
 
   void update_lod_texture_map();
+  void require_update();
 
   std::vector<scoped_blp_texture_reference> textures;
   std::array<boost::optional<Alphamap>, 3> alphamaps;
@@ -98,6 +102,9 @@ private:
   std::vector<uint8_t> _lod_texture_map;
   bool _need_lod_texture_map_update = false;
 
+  boost::optional<std::vector<std::vector<uint8_t>>> _saved_alphamaps;
+  bool _saved_big_alphamap = false;
+
   ENTRY_MCLY _layers_info[4];
 
   bool _do_not_convert_alphamaps;
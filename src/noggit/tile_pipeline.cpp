@@ -0,0 +1,193 @@
+// This file is part of Noggit3, licensed under GNU General Public License (version 3).
+
+#include <noggit/tile_pipeline.hpp>
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
+
+namespace noggit
+{
+  bool run_tile_pipeline ( std::vector<tile_index> const& tiles
+                         , tile_pipeline_stages const& stages
+                         , tile_pipeline_progress const& progress
+                         , std::size_t threads
+                         , std::size_t max_in_flight
+                         )
+  {
+    if (threads == 0)
+    {
+      threads = std::max (1u, std::thread::hardware_concurrency());
+    }
+    if (max_in_flight == 0)
+    {
+      max_in_flight = 2 * threads;
+    }
+
+    std::mutex mutex;
+    std::condition_variable work_queued;
+    std::condition_variable work_done;
+    std::deque<std::size_t> queued;
+    // index and whether the work succeeded
+    std::deque<std::pair<std::size_t, bool>> worked;
+    bool stop (false);
+    std::exception_ptr error;
+
+    auto const worker
+      ( [&]
+        {
+          std::unique_lock<std::mutex> lock (mutex);
+
+          while (true)
+          {
+            work_queued.wait (lock, [&] { return stop || !queued.empty(); });
+            if (queued.empty())
+            {
+              return;
+            }
+
+            std::size_t const index (queued.front());
+            queued.pop_front();
+
+            lock.unlock();
+            bool succeeded (true);
+            try
+            {
+              stages.work (tiles[index]);
+            }
+            catch (...)
+            {
+              succeeded = false;
+              lock.lock();
+              if (!error)
+              {
+                error = std::current_exception();
+              }
+              lock.unlock();
+            }
+            lock.lock();
+
+            worked.emplace_back (index, succeeded);
+            work_done.notify_one();
+          }
+        }
+      );
+
+    std::vector<std::thread> pool;
+    for (std::size_t i (0); i < std::min (threads, tiles.size()); ++i)
+    {
+      pool.emplace_back (worker);
+    }
+
+    auto const shutdown
+      ( [&]
+        {
+          {
+            std::lock_guard<std::mutex> const lock (mutex);
+            stop = true;
+          }
+          work_queued.notify_all();
+
+          for (auto& thread : pool)
+          {
+            thread.join();
+          }
+        }
+      );
+
+    std::size_t next (0);
+    std::size_t in_flight (0);
+    std::size_t done (0);
+    bool cancelled (false);
+
+    auto const report
+      ( [&]
+        {
+          ++done;
+          if (progress && !progress (done, tiles.size()))
+          {
+            cancelled = true;
+          }
+        }
+      );
+
+    try
+    {
+      while (true)
+      {
+        while (!cancelled && in_flight < max_in_flight && next < tiles.size())
+        {
+          {
+            std::lock_guard<std::mutex> const lock (mutex);
+            if (error)
+            {
+              break;
+            }
+          }
+
+          std::size_t const index (next++);
+
+          if (stages.start (tiles[index]))
+          {
+            {
+              std::lock_guard<std::mutex> const lock (mutex);
+              queued.push_back (index);
+            }
+            work_queued.notify_one();
+            ++in_flight;
+          }
+          else
+          {
+            report();
+          }
+        }
+
+        if (in_flight == 0)
+        {
+          break;
+        }
+
+        std::deque<std::pair<std::size_t, bool>> finished;
+        {
+          std::unique_lock<std::mutex> lock (mutex);
+          work_done.wait (lock, [&] { return !worked.empty(); });
+          std::swap (finished, worked);
+        }
+
+        for (auto const& tile : finished)
+        {
+          --in_flight;
+
+          if (tile.second)
+          {
+            stages.finish (tiles[tile.first]);
+          }
+
+          report();
+        }
+      }
+    }
+    catch (...)
+    {
+      // the workers may still be using tiles the caller is about to free
+      {
+        std::unique_lock<std::mutex> lock (mutex);
+        queued.clear();
+      }
+      shutdown();
+      throw;
+    }
+
+    shutdown();
+
+    if (error)
+    {
+      std::rethrow_exception (error);
+    }
+
+    return !cancelled || next == tiles.size();
+  }
+}
@@ -0,0 +1,43 @@
+// This file is part of Noggit3, licensed under GNU General Public License (version 3).
+
+#pragma once
+
+#include <noggit/tile_index.hpp>
+
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+namespace noggit
+{
+  //! The stages of a batch operation over many tiles, e.g. converting a
+  //! whole map. start and finish run on the calling thread, so they may
+  //! touch the map index or the world, work runs on the worker threads.
+  struct tile_pipeline_stages
+  {
+    //! e.g. queue the tile for loading, false skips it
+    std::function<bool (tile_index const&)> start;
+    //! e.g. wait for the tile to be loaded, convert and save it
+    std::function<void (tile_index const&)> work;
+    //! e.g. unload the tile again
+    std::function<void (tile_index const&)> finish;
+  };
+
+  //! Called on the calling thread whenever a tile is finished or skipped,
+  //! returning false cancels the remaining tiles.
+  using tile_pipeline_progress = std::function<bool (std::size_t done, std::size_t total)>;
+
+  //! Runs the stages for every tile, in order, while keeping at most
+  //! max_in_flight tiles between start and finish to bound the memory
+  //! used (0 uses twice the thread count, which in turn defaults to one
+  //! per core). Cancelling and exceptions stop starting tiles, the ones
+  //! already started are finished before returning or rethrowing the
+  //! first exception. Tiles whose work threw are not finished.
+  //! \returns false if cancelled
+  bool run_tile_pipeline ( std::vector<tile_index> const& tiles
+                         , tile_pipeline_stages const& stages
+                         , tile_pipeline_progress const& progress = {}
+                         , std::size_t threads = 0
+                         , std::size_t max_in_flight = 0
+                         );
+}
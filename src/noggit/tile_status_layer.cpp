@@ -0,0 +1,156 @@
+// This file is part of Noggit3, licensed under GNU General Public License (version 3).
+
+#include <noggit/tile_status_layer.hpp>
+
+#include <QtGui/QPainter>
+
+#include <algorithm>
+
+namespace noggit
+{
+  tile_status_layer::tile_status_layer()
+  {
+    _status.fill (tile_status::none);
+  }
+
+  void tile_status_layer::set (tile_index const& tile, tile_status status)
+  {
+    if (!tile.is_valid())
+    {
+      return;
+    }
+
+    std::size_t const index (tile.z * 64 + tile.x);
+
+    std::lock_guard<std::mutex> const lock (_mutex);
+
+    if (_status[index] != status)
+    {
+      _status[index] = status;
+      _dirty.push_back (index);
+      ++_revision;
+    }
+  }
+
+  tile_status tile_status_layer::get (tile_index const& tile) const
+  {
+    std::lock_guard<std::mutex> const lock (_mutex);
+    return tile.is_valid() ? _status[tile.z * 64 + tile.x] : tile_status::none;
+  }
+
+  std::uint64_t tile_status_layer::revision() const
+  {
+    std::lock_guard<std::mutex> const lock (_mutex);
+    return _revision;
+  }
+
+  QImage const& tile_status_layer::image (int tile_size) const
+  {
+    std::array<tile_status, 64 * 64> status;
+    std::vector<std::size_t> dirty;
+
+    {
+      std::lock_guard<std::mutex> const lock (_mutex);
+      status = _status;
+      std::swap (dirty, _dirty);
+    }
+
+    if (tile_size <= 0)
+    {
+      _image = QImage();
+      _image_tile_size = 0;
+      return _image;
+    }
+
+    bool const full_redraw (tile_size != _image_tile_size);
+
+    if (!full_redraw && dirty.empty())
+    {
+      return _image;
+    }
+
+    if (full_redraw)
+    {
+      // the outlines are drawn one pixel past the last tile
+      _image = QImage (64 * tile_size + 1, 64 * tile_size + 1, QImage::Format_ARGB32_Premultiplied);
+      _image.fill (Qt::transparent);
+      _image_tile_size = tile_size;
+    }
+
+    QPainter painter (&_image);
+    painter.setRenderHint (QPainter::Antialiasing);
+    painter.setBrush (QColor (255, 255, 255, 30));
+
+    if (full_redraw)
+    {
+      for (int x (0); x < 64; ++x)
+      {
+        for (int z (0); z < 64; ++z)
+        {
+          draw_tile (painter, x, z, tile_size, status[z * 64 + x]);
+        }
+      }
+
+      return _image;
+    }
+
+    std::sort (dirty.begin(), dirty.end());
+    dirty.erase (std::unique (dirty.begin(), dirty.end()), dirty.end());
+
+    // outlines are shared with and antialiased into the neighbours, so the
+    // area around a tile is cleared and every tile touching it is redrawn
+    // in the order of a full redraw
+    int const reach (1 + 2 / tile_size);
+
+    for (std::size_t index : dirty)
+    {
+      int const tile_x (index % 64);
+      int const tile_z (index / 64);
+
+      QRect const area (tile_x * tile_size - 1, tile_z * tile_size - 1, tile_size + 3, tile_size + 3);
+
+      painter.setClipRect (area);
+      painter.setCompositionMode (QPainter::CompositionMode_Source);
+      painter.fillRect (area, Qt::transparent);
+      painter.setCompositionMode (QPainter::CompositionMode_SourceOver);
+
+      for (int x (std::max (0, tile_x - reach)); x <= std::min (63, tile_x + reach); ++x)
+      {
+        for (int z (std::max (0, tile_z - reach)); z <= std::min (63, tile_z + reach); ++z)
+        {
+          draw_tile (painter, x, z, tile_size, status[z * 64 + x]);
+        }
+      }
+    }
+
+    return _image;
+  }
+
+  void tile_status_layer::draw_tile (QPainter& painter, int x, int z, int tile_size, tile_status status) const
+  {
+    switch (status)
+    {
+    case tile_status::none:
+      painter.setPen (QColor::fromRgbF (1.0f, 1.0f, 1.0f, 0.05f));
+      break;
+    case tile_status::unloaded:
+      painter.setPen (QColor::fromRgbF (0.8f, 0.8f, 0.8f, 0.4f));
+      break;
+    case tile_status::external:
+      painter.setPen (QColor::fromRgbF (1.0f, 0.7f, 0.5f, 0.6f));
+      break;
+    case tile_status::loaded:
+    case tile_status::changed:
+      painter.setPen (QColor::fromRgbF (0.f, 0.f, 0.f, 0.6f));
+      break;
+    }
+
+    painter.drawRect (QRect (tile_size * x, tile_size * z, tile_size, tile_size));
+
+    if (status == tile_status::changed)
+    {
+      painter.setPen (QColor::fromRgbF (1.0f, 1.0f, 0.0f, 1.f));
+      painter.drawRect (QRect (tile_size * x + 1, tile_size * z + 1, tile_size - 2, tile_size - 2));
+    }
+  }
+}
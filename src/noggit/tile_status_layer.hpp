@@ -0,0 +1,57 @@
+// This file is part of Noggit3, licensed under GNU General Public License (version 3).
+
+#pragma once
+
+#include <noggit/tile_index.hpp>
+
+#include <QtGui/QImage>
+
+#include <array>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+class QPainter;
+
+namespace noggit
+{
+  enum class tile_status : std::uint8_t
+  {
+    none,      // not part of the map
+    unloaded,
+    external,  // not loaded, but the file is in the project folder
+    loaded,
+    changed,   // loaded, with unsaved changes
+  };
+
+  //! The tile grid drawn over the minimap. The map index reports status
+  //! changes from whatever thread they happen on, and the image is only
+  //! redrawn around the tiles that changed since it was last requested,
+  //! so showing it costs one blit.
+  class tile_status_layer
+  {
+  public:
+    tile_status_layer();
+
+    //! no-op if the tile already has that status
+    void set (tile_index const&, tile_status);
+    tile_status get (tile_index const&) const;
+
+    //! incremented by every status change
+    std::uint64_t revision() const;
+
+    //! 64 x 64 tiles of tile_size pixels. Only call from one thread.
+    QImage const& image (int tile_size) const;
+
+  private:
+    void draw_tile (QPainter&, int x, int z, int tile_size, tile_status) const;
+
+    mutable std::mutex _mutex;
+    std::array<tile_status, 64 * 64> _status;
+    mutable std::vector<std::size_t> _dirty;
+    std::uint64_t _revision = 0;
+
+    mutable QImage _image;
+    mutable int _image_tile_size = 0;
+  };
+}
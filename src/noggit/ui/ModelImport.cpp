@@ -9,11 +9,13 @@
 #include <noggit/ui/ObjectEditor.h>
 
 #include <fstream>
-#include <regex>
 #include <string>
 
 #include <QtWidgets/QFormLayout>
 
+#include <boost/algorithm/string/predicate.hpp>
+#include <boost/filesystem.hpp>
+
 namespace noggit
 {
   namespace ui
@@ -48,16 +50,33 @@ namespace noggit
               );
     }
 
-    void model_import::buildModelList()
+    void model_import::reload_import_file()
     {
-      _list->clear();
-
       QSettings settings;
+      std::string const import_file
+        (settings.value ("project/import_file", "import.txt").toString().toStdString());
+
+      boost::system::error_code time_error, size_error;
+      std::time_t const write_time (boost::filesystem::last_write_time (import_file, time_error));
+      std::uintmax_t const size (boost::filesystem::file_size (import_file, size_error));
+
+      // the time only has a resolution of seconds, appending to the file
+      // from the object editor would go unnoticed without the size
+      if ( import_file == _import_file
+        && !time_error && !size_error
+        && write_time == _import_file_time
+        && size == _import_file_size
+         )
+      {
+        return;
+      }
 
-      std::ifstream fileReader (settings.value ("project/import_file", "import.txt").toString().toStdString());
-      std::string const filter
-        (mpq::normalized_filename (_textBox->text().toStdString()));
+      _import_file = import_file;
+      _import_file_time = time_error ? 0 : write_time;
+      _import_file_size = size_error ? 0 : size;
+      _models.clear();
 
+      std::ifstream fileReader (import_file);
       std::string line;
       while (std::getline (fileReader, line))
       {
@@ -66,20 +85,30 @@ namespace noggit
           continue;
         }
 
-        std::string path (mpq::normalized_filename (line));
-
-        if (!filter.empty() && path.find (filter) == std::string::npos)
+        auto const path (imported_model_path (mpq::normalized_filename (line)));
+        if (path)
         {
-          continue;
+          _models.add ( *path
+                      , boost::ends_with (*path, ".m2") ? asset_type::model : asset_type::wmo
+                      );
         }
+      }
+    }
 
-        std::regex regex("[^\\.]+\\.(m2|wmo)"), wmo_group(".*_[0-9]{3}\\.wmo");
-        std::smatch match;
+    void model_import::buildModelList()
+    {
+      reload_import_file();
 
-        if (std::regex_search(path, match, regex) && !regex_match(path, wmo_group))
-        {
-          _list->addItem (QString::fromStdString (match.str(0)));
-        }
+      _list->clear();
+
+      std::string const filter
+        (mpq::normalized_filename (_textBox->text().toStdString()));
+
+      for ( auto const& path
+          : _models.matching (filter, {asset_type::model, asset_type::wmo})
+          )
+      {
+        _list->addItem (QString::fromStdString (path));
       }
 
       _list->setMinimumWidth(_list->sizeHintForColumn(0));
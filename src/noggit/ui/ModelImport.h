@@ -2,10 +2,16 @@
 
 #pragma once
 
+#include <noggit/asset_catalog.hpp>
+
 #include <QtWidgets/QLineEdit>
 #include <QtWidgets/QListWidget>
 #include <QtWidgets/QWidget>
 
+#include <cstdint>
+#include <ctime>
+#include <string>
+
 class MapView;
 
 namespace noggit
@@ -20,6 +26,14 @@ namespace noggit
       QListWidget* _list;
       QLineEdit* _textBox;
 
+      //! the import file's models, only read again when it changed
+      asset_catalog _models;
+      std::string _import_file;
+      std::time_t _import_file_time = 0;
+      std::uintmax_t _import_file_size = 0;
+
+      void reload_import_file();
+
     public:
       model_import (noggit::ui::object_editor* object_editor);
       void buildModelList();
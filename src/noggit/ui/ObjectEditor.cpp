@@ -9,6 +9,7 @@
 #include <noggit/ui/ModelImport.h>
 #include <noggit/ui/ObjectEditor.h>
 #include <noggit/ui/RotationEditor.h>
+#include <noggit/ui/SettingsPanel.h>
 #include <noggit/ui/checkbox.hpp>
 #include <util/qt/overload.hpp>
 
@@ -226,18 +227,21 @@ namespace noggit
       {
         _settings->setValue ("model/random_rotation", s);
         _settings->sync();
+        settings::publish_snapshot (*_settings);
       });
 
       connect (tilt_group, &QGroupBox::toggled, [&] (int s)
       {
         _settings->setValue ("model/random_tilt", s);
         _settings->sync();
+        settings::publish_snapshot (*_settings);
       });
 
       connect (scale_group, &QGroupBox::toggled, [&] (int s)
       {
         _settings->setValue ("model/random_size", s);
         _settings->sync();
+        settings::publish_snapshot (*_settings);
       });
 
       rotRangeStart->setValue(paste_params->minRotation);
@@ -3,6 +3,7 @@
 #include <noggit/ui/SettingsPanel.h>
 
 #include <noggit/TextureManager.h>
+#include <noggit/settings_snapshot.hpp>
 #include <util/qt/overload.hpp>
 
 
@@ -16,6 +17,7 @@
 
 
 #include <algorithm>
+#include <utility>
 
 namespace util
 {
@@ -284,6 +286,31 @@ namespace noggit
       _settings->setValue ("wireframe/color", _wireframe_color->color());      
 
 	  _settings->sync();
+
+      publish_snapshot (*_settings);
+    }
+
+    void settings::publish_snapshot (QSettings const& settings)
+    {
+      settings_snapshot snapshot;
+
+      snapshot.project_path = settings.value ("project/path").toString().toStdString();
+
+      snapshot.far_z = settings.value ("farZ", 2048.f).toFloat();
+      snapshot.tablet_enabled = settings.value ("tablet/enabled", false).toBool();
+      snapshot.additional_file_loading_log = settings.value ("additional_file_loading_log", false).toBool();
+
+      snapshot.wireframe_type = settings.value ("wireframe/type", 0).toInt();
+      snapshot.wireframe_radius = settings.value ("wireframe/radius", 1.5f).toFloat();
+      snapshot.wireframe_width = settings.value ("wireframe/width", 1.f).toFloat();
+      QColor const c (settings.value ("wireframe/color").value<QColor>());
+      snapshot.wireframe_color = math::vector_4d (c.redF(), c.greenF(), c.blueF(), c.alphaF());
+
+      snapshot.model_random_rotation = settings.value ("model/random_rotation", false).toBool();
+      snapshot.model_random_tilt = settings.value ("model/random_tilt", false).toBool();
+      snapshot.model_random_size = settings.value ("model/random_size", false).toBool();
+
+      publish_settings (std::move (snapshot));
     }
   }
 }
@@ -78,6 +78,9 @@ namespace noggit
       settings(QWidget* parent = nullptr);
       void discard_changes();
       void save_changes();
+
+      //! reads the values of noggit::settings_snapshot and publishes them
+      static void publish_snapshot (QSettings const& settings);
     };
   }
 }
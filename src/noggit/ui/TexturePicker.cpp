@@ -131,7 +131,7 @@ namespace noggit
     {
       if (set_changed)
       {
-        _chunk->mt->changed = true;
+        _chunk->mt->set_changed();
       }
 
       _textures.clear();
@@ -5,6 +5,7 @@
 #include <algorithm>
 #include <list>
 #include <map>
+#include <memory>
 #include <sstream>
 #include <string>
 #include <vector>
@@ -13,49 +14,58 @@
 #include <noggit/Misc.h>
 #include <noggit/MPQ.h>
 #include <noggit/TextureManager.h> // TextureManager, Texture
+#include <noggit/blp_thumbnail.hpp>
 #include <noggit/ui/TextureList.hpp>
 
-#include <unordered_set>
+#include <unordered_map>
 
-#include <QtCore/QSettings>
 #include <QtCore/QSortFilterProxyModel>
 #include <QtGui/QStandardItemModel>
 #include <QtWidgets/QCheckBox>
 #include <QtWidgets/QComboBox>
 #include <QtWidgets/QVBoxLayout>
 
-#include <boost/filesystem.hpp>
-#include <boost/filesystem/path.hpp>
-#include <boost/range/iterator_range.hpp>
-
 namespace noggit
 {
   namespace ui
   {
     struct model_item : QStandardItem
     {
-      model_item (QString const& display_role)
+      model_item (QString const& display_role, blp_thumbnail_loader* thumbnail_loader)
         : QStandardItem (display_role)
+        , _thumbnail_loader (thumbnail_loader)
       {}
 
+      std::string filename() const
+      {
+        return data (Qt::DisplayRole).toString().prepend ("tileset/").toStdString();
+      }
+
       virtual QVariant data (int role) const
       {
         if (role == Qt::DecorationRole)
         {
-          if (!_rendered)
+          if (!_requested)
           {
             //! \note The one time Qt is const correct and we don't want that.
             auto that (const_cast<model_item*> (this));
-            that->_rendered = true;
-            that->_pixmap = render_blp_to_pixmap (data (Qt::DisplayRole).toString().prepend ("tileset/").toStdString(), 256, 256);
+            that->_requested = true;
+            _thumbnail_loader->request (filename());
           }
-          return QIcon(_pixmap);
+          return _pixmap.isNull() ? QVariant() : QIcon (_pixmap);
         }
 
         return QStandardItem::data (role);
       }
 
-      bool _rendered = false;
+      void set_thumbnail (QImage const& image)
+      {
+        _pixmap = QPixmap::fromImage (image);
+        emitDataChanged();
+      }
+
+      blp_thumbnail_loader* _thumbnail_loader;
+      bool _requested = false;
       QPixmap _pixmap;
     };
 
@@ -66,81 +76,42 @@ namespace noggit
       setWindowIcon (QIcon (":/icon"));
       setMinimumHeight(490);
 
-      while (!MPQArchive::allFinishedLoading())
-      {
-        MPQArchive::allFinishLoading();
-      }
-
-      std::vector<std::string> tilesets;
-      std::unordered_set<std::string> tilesets_with_specular_variant;
-
-      for (auto const& entry : gListfile)
-      {
-        if ( entry.find ("tileset") != std::string::npos
-          && entry.find (".blp") != std::string::npos
-           )
-        {
-          auto suffix_pos (entry.find ("_s.blp"));
-          if (suffix_pos == std::string::npos)
-          {
-            tilesets.emplace_back (entry);
-          }
-          else
-          {
-            std::string specular (entry);
-            specular.erase (suffix_pos, strlen ("_s"));
-            tilesets_with_specular_variant.emplace (specular);
-          }
-        }
-      }
-
-      {
-        QSettings settings;
-        auto const prefix
-          (boost::filesystem::path (settings.value("project/path").toString().toStdString()));
-        auto const prefix_size (prefix.string().length());
-
-        if (boost::filesystem::exists (prefix))
-        {
-          for ( auto const& entry_abs
-              : boost::make_iterator_range
-                  (boost::filesystem::recursive_directory_iterator (prefix), {})
-              )
-          {
-            auto entry ( mpq::normalized_filename
-                          (entry_abs.path().string().substr (prefix_size))
-                       );
-
-            if ( entry.find ("tileset") != std::string::npos
-              && entry.find (".blp") != std::string::npos
-               )
-            {
-              auto suffix_pos (entry.find ("_s.blp"));
-              if (suffix_pos == std::string::npos)
-              {
-                tilesets.emplace_back (entry);
-              }
-              else
-              {
-                std::string specular (entry);
-                specular.erase (suffix_pos, strlen ("_s"));
-                tilesets_with_specular_variant.emplace (specular);
-              }
-            }
-          }
-        }
-      }
+      mpq::wait_for_assets();
+      std::vector<std::string> const tilesets
+        (mpq::assets().matching ("", {asset_type::tileset}));
 
 
       auto model (new QStandardItemModel);
       constexpr int const has_specular_role = Qt::UserRole;
 
+      // thumbnails are decoded on worker threads the first time the view
+      // asks for an item's icon
+      auto thumbnail_loader (new blp_thumbnail_loader (256, 256, this));
+      auto items (std::make_shared<std::unordered_multimap<std::string, model_item*>>());
+      connect ( thumbnail_loader, &blp_thumbnail_loader::loaded
+              , this
+              , [=] (QString filename, QImage image)
+                {
+                  if (image.isNull())
+                  {
+                    return;
+                  }
+
+                  auto const range (items->equal_range (filename.toStdString()));
+                  for (auto it (range.first); it != range.second; ++it)
+                  {
+                    it->second->set_thumbnail (image);
+                  }
+                }
+              );
+
       for (auto const& texture : tilesets)
       {
         auto item ( new model_item
-                      (QString::fromStdString (texture).remove ("tileset/"))
+                      (QString::fromStdString (texture).remove ("tileset/"), thumbnail_loader)
                   );
-        item->setData ( tilesets_with_specular_variant.count (texture) ? "true" : "false"
+        items->emplace (item->filename(), item);
+        item->setData ( mpq::assets().has_specular_variant (texture) ? "true" : "false"
                       , has_specular_role
                       );
         model->appendRow (item);
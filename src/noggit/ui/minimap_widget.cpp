@@ -29,7 +29,6 @@ namespace noggit
       return QSize (700, 700);
     }
 
-    //! \todo Only redraw stuff as told in event.
     void minimap_widget::paintEvent (QPaintEvent*)
     {
       //! \note Only take multiples of 1.0 pixels per tile.
@@ -51,59 +50,7 @@ namespace noggit
 
         if (draw_boundaries())
         {
-          //! \todo Draw non-existing tiles aswell?
-          painter.setBrush (QColor (255, 255, 255, 30));
-          for (size_t i (0); i < 64; ++i)
-          {
-            for (size_t j (0); j < 64; ++j)
-            {
-              tile_index const tile (i, j);
-              bool changed = false;
-
-              if (world()->mapIndex.hasTile (tile))
-              {
-                if (world()->mapIndex.tileLoaded (tile))
-                {
-                  if (world()->mapIndex.has_unsaved_changes(tile))
-                  {
-                    changed = true;
-                  }
-
-                  painter.setPen(QColor::fromRgbF(0.f, 0.f, 0.f, 0.6f));
-                }
-                else if (world()->mapIndex.isTileExternal(tile))
-                {
-                  painter.setPen(QColor::fromRgbF(1.0f, 0.7f, 0.5f, 0.6f));
-                }
-                else
-                {
-                  painter.setPen (QColor::fromRgbF (0.8f, 0.8f, 0.8f, 0.4f));
-                }
-              }
-              else
-              {
-                painter.setPen (QColor::fromRgbF (1.0f, 1.0f, 1.0f, 0.05f));
-              }
-
-              painter.drawRect ( QRect ( tile_size * i
-                                       , tile_size * j
-                                       , tile_size
-                                       , tile_size
-                                       )
-                               );
-
-              if (changed)
-              {
-                painter.setPen(QColor::fromRgbF(1.0f, 1.0f, 0.0f, 1.f));
-                painter.drawRect ( QRect ( tile_size * i + 1
-                                         , tile_size * j + 1
-                                         , tile_size - 2
-                                         , tile_size - 2
-                                         )
-                                 );
-              }
-            }
-          }
+          painter.drawImage (QPoint (0, 0), world()->mapIndex.tile_status().image (tile_size));
         }
 
         if (draw_skies() && world()->skies)
@@ -0,0 +1,140 @@
+// This file is part of Noggit3, licensed under GNU General Public License (version 3).
+
+#include <noggit/upload_scheduler.hpp>
+
+#include <utility>
+
+namespace noggit
+{
+  struct upload_scheduler::job_state
+  {
+    std::mutex mutex;
+    std::function<void()> upload;
+    std::size_t bytes;
+    //! cleared once the job ran or was cancelled
+    bool pending = true;
+  };
+
+  upload_scheduler::ticket::ticket (std::shared_ptr<job_state> state)
+    : _state (std::move (state))
+  {}
+
+  upload_scheduler::ticket::~ticket()
+  {
+    cancel();
+  }
+
+  upload_scheduler::ticket& upload_scheduler::ticket::operator= (ticket&& other)
+  {
+    cancel();
+    _state = std::move (other._state);
+    return *this;
+  }
+
+  bool upload_scheduler::ticket::pending() const
+  {
+    if (!_state)
+    {
+      return false;
+    }
+
+    std::lock_guard<std::mutex> const lock (_state->mutex);
+    return _state->pending;
+  }
+
+  void upload_scheduler::ticket::cancel()
+  {
+    if (!_state)
+    {
+      return;
+    }
+
+    {
+      std::lock_guard<std::mutex> const lock (_state->mutex);
+      _state->pending = false;
+      // release what the job captured now, the queue may hold it a while
+      _state->upload = nullptr;
+    }
+    _state.reset();
+  }
+
+  upload_scheduler::upload_scheduler (std::size_t bytes_per_frame)
+    : _bytes_per_frame (bytes_per_frame)
+  {}
+
+  upload_scheduler::ticket upload_scheduler::enqueue (std::size_t bytes, std::function<void()> upload)
+  {
+    auto state (std::make_shared<job_state>());
+    state->upload = std::move (upload);
+    state->bytes = bytes;
+
+    std::lock_guard<std::mutex> const lock (_mutex);
+    _queue.push_back (state);
+    _queued_bytes += bytes;
+
+    return ticket (std::move (state));
+  }
+
+  upload_scheduler::frame_stats upload_scheduler::run_frame()
+  {
+    frame_stats stats;
+
+    while (true)
+    {
+      std::shared_ptr<job_state> state;
+
+      {
+        std::lock_guard<std::mutex> const lock (_mutex);
+
+        if (_queue.empty())
+        {
+          stats.queue_depth = 0;
+          stats.queued_bytes = _queued_bytes = 0;
+          break;
+        }
+
+        state = _queue.front();
+
+        {
+          std::lock_guard<std::mutex> const state_lock (state->mutex);
+          if (!state->pending)
+          {
+            _queue.pop_front();
+            _queued_bytes -= state->bytes;
+            continue;
+          }
+        }
+
+        // the first job of a frame always runs
+        if (stats.uploads > 0 && stats.uploaded_bytes + state->bytes > _bytes_per_frame)
+        {
+          stats.queue_depth = _queue.size();
+          stats.queued_bytes = _queued_bytes;
+          break;
+        }
+
+        _queue.pop_front();
+        _queued_bytes -= state->bytes;
+      }
+
+      std::lock_guard<std::mutex> const lock (state->mutex);
+
+      // cancelled since it was taken from the queue
+      if (!state->pending)
+      {
+        continue;
+      }
+
+      std::function<void()> const upload (std::move (state->upload));
+      state->pending = false;
+
+      ++stats.uploads;
+      stats.uploaded_bytes += state->bytes;
+
+      upload();
+    }
+
+    _last_frame = stats;
+    return stats;
+  }
+}
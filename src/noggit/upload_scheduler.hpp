@@ -0,0 +1,86 @@
+// This file is part of Noggit3, licensed under GNU General Public License (version 3).
+
+#pragma once
+
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+
+namespace noggit
+{
+  //! Spreads GPU uploads over several frames. Loader threads enqueue jobs
+  //! that only copy already decoded data to the GPU, the render thread
+  //! runs them once per frame until the byte budget of that frame is used
+  //! up. At least one job runs per frame so that jobs bigger than the
+  //! budget still make progress. Objects keep drawing with whatever they
+  //! had before, usually an empty texture, until their job ran.
+  class upload_scheduler
+  {
+  private:
+    struct job_state;
+
+  public:
+    static upload_scheduler& instance()
+    {
+      static upload_scheduler scheduler (4 << 20);
+      return scheduler;
+    }
+
+    struct frame_stats
+    {
+      std::size_t uploads = 0;
+      std::size_t uploaded_bytes = 0;
+      //! jobs and bytes still waiting after the frame
+      std::size_t queue_depth = 0;
+      std::size_t queued_bytes = 0;
+    };
+
+    //! Owned by the object the upload is for. Destroying it cancels the
+    //! job, waiting for it if it is running right now.
+    class ticket
+    {
+    public:
+      ticket() = default;
+      ~ticket();
+
+      ticket (ticket const&) = delete;
+      ticket& operator= (ticket const&) = delete;
+      ticket (ticket&&) = default;
+      ticket& operator= (ticket&&);
+
+      bool pending() const;
+
+    private:
+      friend class upload_scheduler;
+      ticket (std::shared_ptr<job_state>);
+
+      void cancel();
+
+      std::shared_ptr<job_state> _state;
+    };
+
+    explicit upload_scheduler (std::size_t bytes_per_frame);
+
+    //! thread safe, upload is called on the render thread with its
+    //! context current
+    ticket enqueue (std::size_t bytes, std::function<void()> upload);
+
+    //! call once per frame on the render thread
+    frame_stats run_frame();
+
+    frame_stats const& last_frame() const { return _last_frame; }
+    std::size_t bytes_per_frame() const { return _bytes_per_frame; }
+    void bytes_per_frame (std::size_t bytes) { _bytes_per_frame = bytes; }
+
+  private:
+    std::size_t _bytes_per_frame;
+
+    std::mutex _mutex;
+    std::deque<std::shared_ptr<job_state>> _queue;
+    std::size_t _queued_bytes = 0;
+
+    frame_stats _last_frame;
+  };
+}
@@ -0,0 +1,180 @@
+// This file is part of Noggit3, licensed under GNU General Public License (version 3).
+
+#include <noggit/vertex_selection.hpp>
+
+#include <array>
+
+namespace noggit
+{
+  namespace
+  {
+    // 9 outer vertices and 8 cell centers per row, see MapChunk::mVertices
+    std::size_t outer (int row, int column)
+    {
+      return row * 17 + column;
+    }
+    std::size_t center (int row, int column)
+    {
+      return row * 17 + 9 + column;
+    }
+
+    std::array<std::size_t, 4> corners (int row, int column)
+    {
+      return { outer (row, column), outer (row, column + 1)
+             , outer (row + 1, column), outer (row + 1, column + 1)
+             };
+    }
+  }
+
+  std::pair<std::size_t, std::size_t> vertex_range (vertex_mask const& vertices)
+  {
+    if (vertices.none())
+    {
+      return {0, 0};
+    }
+
+    std::size_t first (0);
+    while (!vertices[first])
+    {
+      ++first;
+    }
+    std::size_t last (vertices.size());
+    while (!vertices[last - 1])
+    {
+      --last;
+    }
+    return {first, last};
+  }
+
+  vertex_mask normal_dependents (vertex_mask const& changed)
+  {
+    vertex_mask dependents (changed);
+
+    for (int row (0); row < 8; ++row)
+    {
+      for (int column (0); column < 8; ++column)
+      {
+        auto const cell_corners (corners (row, column));
+
+        if (changed[center (row, column)])
+        {
+          for (std::size_t corner : cell_corners)
+          {
+            dependents.set (corner);
+          }
+        }
+        for (std::size_t corner : cell_corners)
+        {
+          if (changed[corner])
+          {
+            dependents.set (center (row, column));
+          }
+        }
+      }
+    }
+
+    return dependents;
+  }
+
+  vertex_mask neighbour_normal_dependents (vertex_mask const& changed, int dx, int dz)
+  {
+    vertex_mask dependents;
+
+    for (int row (0); row < 8; ++row)
+    {
+      for (int column (0); column < 8; ++column)
+      {
+        if (!changed[center (row, column)])
+        {
+          continue;
+        }
+
+        // the cell's corners in the neighbour's coordinates
+        for (int corner_row (row - 8 * dz); corner_row <= row + 1 - 8 * dz; ++corner_row)
+        {
+          for (int corner_column (column - 8 * dx); corner_column <= column + 1 - 8 * dx; ++corner_column)
+          {
+            if ( corner_row >= 0 && corner_row <= 8
+              && corner_column >= 0 && corner_column <= 8
+               )
+            {
+              dependents.set (outer (corner_row, corner_column));
+            }
+          }
+        }
+      }
+    }
+
+    // edge vertices are shared with the neighbour and the height lookup may
+    // return either chunk's copy for the centers of the neighbour's cells
+    for (int row (0); row <= 8; ++row)
+    {
+      for (int column (0); column <= 8; ++column)
+      {
+        if (!changed[outer (row, column)])
+        {
+          continue;
+        }
+
+        int const shared_row (row - 8 * dz);
+        int const shared_column (column - 8 * dx);
+        for (int cell_row (shared_row - 1); cell_row <= shared_row; ++cell_row)
+        {
+          for (int cell_column (shared_column - 1); cell_column <= shared_column; ++cell_column)
+          {
+            if ( cell_row >= 0 && cell_row < 8
+              && cell_column >= 0 && cell_column < 8
+               )
+            {
+              dependents.set (center (cell_row, cell_column));
+            }
+          }
+        }
+      }
+    }
+
+    return dependents;
+  }
+
+  vertex_mask fix_cell_centers (math::vector_3d* vertices, vertex_mask const& selected)
+  {
+    vertex_mask fixed;
+
+    for (int row (0); row < 8; ++row)
+    {
+      for (int column (0); column < 8; ++column)
+      {
+        std::size_t not_selected (0);
+        int count (0);
+        float h (0.f);
+
+        for (std::size_t corner : corners (row, column))
+        {
+          if (selected[corner])
+          {
+            ++count;
+          }
+          else
+          {
+            not_selected = corner;
+          }
+          h += vertices[corner].y;
+        }
+
+        std::size_t const mid_vertex (center (row, column));
+        if (count == 2)
+        {
+          vertices[mid_vertex].y = h * 0.25f;
+          fixed.set (mid_vertex);
+        }
+        else if (count == 3)
+        {
+          vertices[mid_vertex].y = (h - vertices[not_selected].y) / 3.0f;
+          fixed.set (mid_vertex);
+        }
+      }
+    }
+
+    return fixed;
+  }
+}
@@ -0,0 +1,142 @@
+// This file is part of Noggit3, licensed under GNU General Public License (version 3).
+
+#pragma once
+
+#include <math/vector_3d.hpp>
+
+#include <algorithm>
+#include <bitset>
+#include <cstddef>
+#include <functional>
+#include <utility>
+#include <vector>
+
+namespace noggit
+{
+  //! One bit per vertex of a chunk, laid out like MapChunk::mVertices: 17
+  //! rows alternating between 9 outer vertices and 8 cell centers.
+  using vertex_mask = std::bitset<145>;
+
+  //! the first and one past the last vertex of the mask, e.g. the part of a
+  //! buffer to upload. {0, 0} when the mask is empty.
+  std::pair<std::size_t, std::size_t> vertex_range (vertex_mask const&);
+
+  //! The vertices whose normal depends on the height of a changed vertex.
+  //! Normals sample the terrain half a unit away diagonally, which is the
+  //! cells' centers around an outer vertex and the corners of the cell of
+  //! a center.
+  vertex_mask normal_dependents (vertex_mask const& changed);
+  //! the same for the outer vertices of the chunk dx, dz chunks away, as
+  //! the normals along its edge sample the centers of this chunk's cells
+  vertex_mask neighbour_normal_dependents (vertex_mask const& changed, int dx, int dz);
+
+  //! Sets the center of every cell with two or three selected corners to
+  //! the average height of its corners, so the border of a moved selection
+  //! doesn't tear. Returns the centers that were set.
+  vertex_mask fix_cell_centers (math::vector_3d* vertices, vertex_mask const& selected);
+
+  //! A vertex mask per chunk, kept in a vector sorted by chunk. Chunks
+  //! without vertices are not stored.
+  template<typename Chunk>
+    class chunk_vertex_masks
+  {
+  public:
+    struct entry
+    {
+      Chunk* chunk;
+      vertex_mask vertices;
+    };
+
+    //! adds the vertices to the chunk's, false if they all were there already
+    bool add (Chunk* chunk, vertex_mask const& vertices)
+    {
+      if (vertices.none())
+      {
+        return false;
+      }
+
+      auto const it (find (chunk));
+      if (it == _entries.end() || it->chunk != chunk)
+      {
+        _entries.insert (it, entry {chunk, vertices});
+        return true;
+      }
+
+      bool const added ((vertices & ~it->vertices).any());
+      it->vertices |= vertices;
+      return added;
+    }
+
+    //! removes the vertices from the chunk's, false if none of them was there
+    bool remove (Chunk* chunk, vertex_mask const& vertices)
+    {
+      auto const it (find (chunk));
+      if (it == _entries.end() || it->chunk != chunk || (it->vertices & vertices).none())
+      {
+        return false;
+      }
+
+      it->vertices &= ~vertices;
+      if (it->vertices.none())
+      {
+        _entries.erase (it);
+      }
+      return true;
+    }
+
+    //! drops the chunks for which the predicate returns true
+    template<typename Predicate>
+      void remove_chunks (Predicate&& predicate)
+    {
+      _entries.erase ( std::remove_if ( _entries.begin(), _entries.end()
+                                      , [&] (entry const& e) { return predicate (e.chunk); }
+                                      )
+                     , _entries.end()
+                     );
+    }
+
+    vertex_mask vertices (Chunk* chunk) const
+    {
+      auto const it (std::lower_bound (_entries.begin(), _entries.end(), chunk, less));
+      return it == _entries.end() || it->chunk != chunk ? vertex_mask() : it->vertices;
+    }
+
+    std::vector<entry> const& entries() const
+    {
+      return _entries;
+    }
+
+    bool empty() const
+    {
+      return _entries.empty();
+    }
+
+    std::size_t vertex_count() const
+    {
+      std::size_t count (0);
+      for (auto const& entry : _entries)
+      {
+        count += entry.vertices.count();
+      }
+      return count;
+    }
+
+    void clear()
+    {
+      _entries.clear();
+    }
+
+  private:
+    static bool less (entry const& lhs, Chunk* rhs)
+    {
+      return std::less<Chunk*>() (lhs.chunk, rhs);
+    }
+
+    typename std::vector<entry>::iterator find (Chunk* chunk)
+    {
+      return std::lower_bound (_entries.begin(), _entries.end(), chunk, less);
+    }
+
+    std::vector<entry> _entries;
+  };
+}
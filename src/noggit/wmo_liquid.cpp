@@ -257,7 +257,7 @@ void wmo_liquid::draw ( math::matrix_4x4 const& transform
   opengl::scoped::vao_binder const _ (_vao);
 
   render.force_texture_update();
-  render.prepare_draw (water_shader, _liquid_id, animtime);
+  render.prepare_draw (water_shader, _liquid_id);
 
   gl.drawElements (GL_TRIANGLES, indices.size(), GL_UNSIGNED_SHORT, opengl::index_buffer_is_already_bound{});
 }
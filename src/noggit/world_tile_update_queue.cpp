@@ -7,6 +7,8 @@
 #include <noggit/WMOInstance.h>
 #include <noggit/World.h>
 
+#include <map>
+#include <utility>
 
 namespace noggit
 {
@@ -84,6 +86,51 @@ namespace noggit
     model_update update_type;
   };
 
+  struct tiles_change_update : public instance_update
+  {
+    tiles_change_update(std::vector<instance_tiles_change> changes)
+      : changes(std::move(changes))
+    {
+
+    }
+
+    virtual void apply(World* const world) override
+    {
+      // removed and added uids per tile, in the order of the changes, so the
+      // tiles end up with the same uid order as with one remove and one add
+      // per instance
+      std::map< std::pair<int, int>
+              , std::pair<std::vector<std::uint32_t>, std::vector<std::uint32_t>>
+              > tiles;
+
+      for (auto const& change : changes)
+      {
+        for (int z = change.old_start.z; z <= change.old_end.z; ++z)
+        {
+          for (int x = change.old_start.x; x <= change.old_end.x; ++x)
+          {
+            tiles[{x, z}].first.push_back(change.uid);
+          }
+        }
+        for (int z = change.new_start.z; z <= change.new_end.z; ++z)
+        {
+          for (int x = change.new_start.x; x <= change.new_end.x; ++x)
+          {
+            tiles[{x, z}].second.push_back(change.uid);
+          }
+        }
+      }
+
+      for (auto const& tile : tiles)
+      {
+        world->mapIndex.update_model_tile
+          (tile_index(tile.first.first, tile.first.second), tile.second.first, tile.second.second);
+      }
+    }
+
+    std::vector<instance_tiles_change> changes;
+  };
+
   world_tile_update_queue::world_tile_update_queue(World* world)
     : _world(world)
   {
@@ -140,6 +187,14 @@ namespace noggit
     _state_changed.notify_one();
   }
 
+  void world_tile_update_queue::queue_update(std::vector<instance_tiles_change> changes)
+  {
+    std::lock_guard<std::mutex> const lock (_mutex);
+
+    _update_queue.emplace(new tiles_change_update(std::move(changes)));
+    _state_changed.notify_one();
+  }
+
   void world_tile_update_queue::process_queue()
   {
     instance_update* update;
@@ -3,13 +3,16 @@
 #pragma once
 
 #include <noggit/map_enums.hpp>
+#include <noggit/tile_index.hpp>
 
 #include <atomic>
 #include <condition_variable>
+#include <cstdint>
 #include <memory>
 #include <mutex>
 #include <queue>
 #include <thread>
+#include <vector>
 
 class ModelInstance;
 class WMOInstance;
@@ -19,6 +22,16 @@ namespace noggit
 {
   struct instance_update;
 
+  //! the tiles covered by an instance before and after being transformed
+  struct instance_tiles_change
+  {
+    std::uint32_t uid;
+    tile_index old_start;
+    tile_index old_end;
+    tile_index new_start;
+    tile_index new_end;
+  };
+
   class world_tile_update_queue
   {
   public:
@@ -35,6 +48,8 @@ namespace noggit
 
     void queue_update(ModelInstance* instance, model_update type);
     void queue_update(WMOInstance* instance, model_update type);
+    //! applied as one pass over the tiles, without waiting for it
+    void queue_update(std::vector<instance_tiles_change> changes);
 
   private:
     void process_queue();
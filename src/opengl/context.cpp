@@ -31,6 +31,10 @@ namespace opengl
     {
       static constexpr char const* const name = "GL_ARB_vertex_program";
     };
+    template<> struct extension_traits<QOpenGLExtension_ARB_get_program_binary>
+    {
+      static constexpr char const* const name = "GL_ARB_get_program_binary";
+    };
 
     struct verify_context_and_check_for_gl_errors
     {
@@ -215,6 +219,11 @@ namespace opengl
     verify_context_and_check_for_gl_errors const _ (_current_context, BOOST_CURRENT_FUNCTION);
     return _current_context->functions()->glClear (target);
   }
+  void context::finish()
+  {
+    verify_context_and_check_for_gl_errors const _ (_current_context, BOOST_CURRENT_FUNCTION);
+    return _current_context->functions()->glFinish();
+  }
   void context::clearColor (GLfloat r, GLfloat g, GLfloat b, GLfloat a)
   {
     verify_context_and_check_for_gl_errors const _ (_current_context, BOOST_CURRENT_FUNCTION);
@@ -295,6 +304,11 @@ namespace opengl
     verify_context_and_check_for_gl_errors const _ (_current_context, BOOST_CURRENT_FUNCTION);
     return _current_context->functions()->glTexImage2D (target, level, internal_format, width, height, border, format, type, data);
   }
+  void context::texImage3D (GLenum target, GLint level, GLint internal_format, GLsizei width, GLsizei height, GLsizei depth, GLint border, GLenum format, GLenum type, GLvoid const* data)
+  {
+    verify_context_and_check_for_gl_errors const _ (_current_context, BOOST_CURRENT_FUNCTION);
+    return _3_3_core_func->glTexImage3D (target, level, internal_format, width, height, depth, border, format, type, data);
+  }
   void context::compressedTexImage2D (GLenum target, GLint level, GLenum internalformat, GLsizei width, GLsizei height, GLint border, GLsizei imageSize, GLvoid const* data)
   {
     verify_context_and_check_for_gl_errors const _ (_current_context, BOOST_CURRENT_FUNCTION);
@@ -367,6 +381,11 @@ namespace opengl
     verify_context_and_check_for_gl_errors const _ (_current_context, BOOST_CURRENT_FUNCTION);
     return _current_context->functions()->glBufferData (target, size, data, usage);
   }
+  void context::bufferSubData (GLenum target, GLintptr offset, GLsizeiptr size, GLvoid const* data)
+  {
+    verify_context_and_check_for_gl_errors const _ (_current_context, BOOST_CURRENT_FUNCTION);
+    return _current_context->functions()->glBufferSubData (target, offset, size, data);
+  }
   GLvoid* context::mapBuffer (GLenum target, GLenum access)
   {
     verify_context_and_check_for_gl_errors const _ (_current_context, BOOST_CURRENT_FUNCTION);
@@ -388,11 +407,21 @@ namespace opengl
     verify_context_and_check_for_gl_errors const _ (_current_context, BOOST_CURRENT_FUNCTION);
     return _3_3_core_func->glDrawElementsInstanced (mode, count, type, reinterpret_cast<void*> (indices_offset), instancecount);
   }
+  void context::drawArrays (GLenum mode, GLint first, GLsizei count)
+  {
+    verify_context_and_check_for_gl_errors const _ (_current_context, BOOST_CURRENT_FUNCTION);
+    return _3_3_core_func->glDrawArrays (mode, first, count);
+  }
   void context::drawRangeElements (GLenum mode, GLuint start, GLuint end, GLsizei count, GLenum type, index_buffer_is_already_bound, std::intptr_t indices_offset)
   {
     verify_context_and_check_for_gl_errors const _ (_current_context, BOOST_CURRENT_FUNCTION);
     return _3_3_core_func->glDrawRangeElements (mode, start, end, count, type, reinterpret_cast<void*> (indices_offset));
   }
+  void context::multiDrawElementsBaseVertex (GLenum mode, GLsizei const* count, GLenum type, GLvoid const** indices, GLsizei drawcount, GLint const* basevertex)
+  {
+    verify_context_and_check_for_gl_errors const _ (_current_context, BOOST_CURRENT_FUNCTION);
+    return _3_3_core_func->glMultiDrawElementsBaseVertex (mode, count, type, indices, drawcount, basevertex);
+  }
 
   void context::drawElements (GLenum mode, GLsizei count, GLenum type, GLuint index_buffer, std::intptr_t indices_offset)
   {
@@ -630,6 +659,38 @@ namespace opengl
     return std::string(log.data());
   }
 
+  bool context::has_extension (char const* name)
+  {
+    verify_context_and_check_for_gl_errors const _ (_current_context, BOOST_CURRENT_FUNCTION);
+    return _current_context->hasExtension (name);
+  }
+  void context::programParameteri (GLuint program, GLenum pname, GLint value)
+  {
+    verify_context_and_check_for_gl_errors const _ (_current_context, BOOST_CURRENT_FUNCTION);
+    return _.extension_functions<QOpenGLExtension_ARB_get_program_binary>()->glProgramParameteri (program, pname, value);
+  }
+  std::vector<char> context::get_program_binary (GLuint program, GLenum* binary_format)
+  {
+    std::vector<char> binary (get_program (program, GL_PROGRAM_BINARY_LENGTH));
+
+    verify_context_and_check_for_gl_errors const _ (_current_context, BOOST_CURRENT_FUNCTION);
+    GLsizei length (0);
+    _.extension_functions<QOpenGLExtension_ARB_get_program_binary>()->glGetProgramBinary
+      (program, binary.size(), &length, binary_format, binary.data());
+    binary.resize (length);
+
+    return binary;
+  }
+  bool context::program_binary (GLuint program, GLenum binary_format, std::vector<char> const& binary)
+  {
+    {
+      verify_context_and_check_for_gl_errors const _ (_current_context, BOOST_CURRENT_FUNCTION);
+      _.extension_functions<QOpenGLExtension_ARB_get_program_binary>()->glProgramBinary
+        (program, binary_format, binary.data(), binary.size());
+    }
+    return get_program (program, GL_LINK_STATUS) == GL_TRUE;
+  }
+
   GLint context::getAttribLocation (GLuint program, GLchar const* name)
   {
     verify_context_and_check_for_gl_errors const _ (_current_context, BOOST_CURRENT_FUNCTION);
@@ -792,4 +853,13 @@ namespace opengl
   template void context::bufferData<GL_ELEMENT_ARRAY_BUFFER, std::uint8_t>(GLuint buffer, std::vector<std::uint8_t> const& data, GLenum usage);
   template void context::bufferData<GL_ELEMENT_ARRAY_BUFFER, std::uint16_t>(GLuint buffer, std::vector<std::uint16_t> const& data, GLenum usage);
   template void context::bufferData<GL_ELEMENT_ARRAY_BUFFER, std::uint32_t>(GLuint buffer, std::vector<std::uint32_t> const& data, GLenum usage);
+
+  template<GLenum target>
+    void context::bufferSubData (GLuint buffer, GLintptr offset, GLsizeiptr size, GLvoid const* data)
+  {
+    scoped::buffer_binder<target> const _ (buffer);
+    return bufferSubData (target, offset, size, data);
+  }
+  template void context::bufferSubData<GL_ARRAY_BUFFER> (GLuint buffer, GLintptr offset, GLsizeiptr size, GLvoid const* data);
+  template void context::bufferSubData<GL_ELEMENT_ARRAY_BUFFER> (GLuint buffer, GLintptr offset, GLsizeiptr size, GLvoid const* data);
 }
@@ -59,6 +59,7 @@ namespace opengl
     void blendFunc (GLenum, GLenum);
 
     void clear (GLenum);
+    void finish();
     void clearColor (GLfloat, GLfloat, GLfloat, GLfloat);
 
     void readBuffer (GLenum);
@@ -79,6 +80,7 @@ namespace opengl
     void deleteTextures (GLuint, GLuint*);
     void bindTexture (GLenum target, GLuint);
     void texImage2D (GLenum target, GLint level, GLint internal_format, GLsizei width, GLsizei height, GLint border, GLenum format, GLenum type, GLvoid const* data);
+    void texImage3D (GLenum target, GLint level, GLint internal_format, GLsizei width, GLsizei height, GLsizei depth, GLint border, GLenum format, GLenum type, GLvoid const* data);
     void compressedTexImage2D (GLenum target, GLint level, GLenum internalformat, GLsizei width, GLsizei height, GLint border, GLsizei imageSize, GLvoid const* data);
     void generateMipmap (GLenum);
     void activeTexture (GLenum);
@@ -96,6 +98,7 @@ namespace opengl
     void deleteBuffers (GLuint, GLuint*);
     void bindBuffer (GLenum, GLuint);
     void bufferData (GLenum target, GLsizeiptr size, GLvoid const* data, GLenum usage);
+    void bufferSubData (GLenum target, GLintptr offset, GLsizeiptr size, GLvoid const* data);
     GLvoid* mapBuffer (GLenum target, GLenum access);
     GLboolean unmapBuffer (GLenum);
 
@@ -110,6 +113,7 @@ namespace opengl
     // \note Not all combinations are implemented for sake of implementer's time.
     // \todo Take index information via some object that encapsulates the mess.
 
+    void drawArrays (GLenum mode, GLint first, GLsizei count);
     void drawElements (GLenum mode, GLsizei count, GLenum type, GLuint index_buffer,           std::intptr_t indices_offset = 0);
     void drawElements (GLenum mode, GLsizei count, GLenum type, index_buffer_is_already_bound, std::intptr_t indices_offset = 0);
     template<typename T>
@@ -119,6 +123,7 @@ namespace opengl
     template<typename T>
       void drawElementsInstanced (GLenum mode, GLsizei count, GLsizei instancecount, std::vector<T> const& indices,            std::intptr_t indices_offset = 0);
     void drawRangeElements (GLenum mode, GLuint start, GLuint end, GLsizei count, GLenum type, index_buffer_is_already_bound, std::intptr_t indices_offset = 0);
+    void multiDrawElementsBaseVertex (GLenum mode, GLsizei const* count, GLenum type, GLvoid const** indices, GLsizei drawcount, GLint const* basevertex);
 
     void genPrograms (GLsizei programs, GLuint*);
     void deletePrograms (GLsizei programs, GLuint*);
@@ -150,6 +155,12 @@ namespace opengl
     GLint get_program (GLuint program, GLenum pname);
     std::string get_program_info_log(GLuint program);
 
+    bool has_extension (char const* name);
+    void programParameteri (GLuint program, GLenum pname, GLint value);
+    std::vector<char> get_program_binary (GLuint program, GLenum* binary_format);
+    //! false if the driver rejected the binary, the program is not linked then
+    bool program_binary (GLuint program, GLenum binary_format, std::vector<char> const& binary);
+
     GLint getAttribLocation (GLuint program, GLchar const* name);
     void vertexAttribPointer (GLuint index, GLint size, GLenum type, GLboolean normalized, GLsizei stride, GLvoid const* pointer);
     void vertexAttribDivisor (GLuint index, GLuint divisor);
@@ -185,6 +196,8 @@ namespace opengl
       void bufferData (GLuint buffer, GLsizeiptr size, GLvoid const* data, GLenum usage);
     template<GLenum target, typename T>
       void bufferData(GLuint buffer, std::vector<T> const& data, GLenum usage);
+    template<GLenum target>
+      void bufferSubData (GLuint buffer, GLintptr offset, GLsizeiptr size, GLvoid const* data);
   };
 }
 
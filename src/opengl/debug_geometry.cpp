@@ -0,0 +1,43 @@
+// This file is part of Noggit3, licensed under GNU General Public License (version 3).
+
+#include <opengl/debug_geometry.hpp>
+
+#include <math/bounding_box.hpp>
+
+#include <array>
+#include <cstdint>
+#include <utility>
+
+namespace opengl
+{
+  void debug_geometry::add_line ( math::vector_3d const& from
+                                , math::vector_3d const& to
+                                , math::vector_4d const& color
+                                )
+  {
+    _vertices.push_back ({from, color});
+    _vertices.push_back ({to, color});
+  }
+
+  void debug_geometry::add_box ( math::vector_3d const& min_point
+                               , math::vector_3d const& max_point
+                               , math::vector_4d const& color
+                               , math::matrix_4x4 const& transform
+                               )
+  {
+    // indices into math::box_points()
+    static std::array<std::pair<std::uint8_t, std::uint8_t>, vertices_per_box / 2> const edges
+      {{ {5, 7}, {7, 3}, {3, 2}, {2, 0}, {0, 1}, {1, 3}
+       , {1, 5}, {5, 4}, {4, 0}, {4, 6}, {6, 2}, {6, 7}
+      }};
+
+    std::vector<math::vector_3d> const points
+      (transform * math::box_points (min_point, max_point));
+
+    _vertices.reserve (_vertices.size() + vertices_per_box);
+    for (auto const& edge : edges)
+    {
+      add_line (points[edge.first], points[edge.second], color);
+    }
+  }
+}
@@ -0,0 +1,48 @@
+// This file is part of Noggit3, licensed under GNU General Public License (version 3).
+
+#pragma once
+
+#include <math/matrix_4x4.hpp>
+#include <math/vector_3d.hpp>
+#include <math/vector_4d.hpp>
+
+#include <cstddef>
+#include <vector>
+
+namespace opengl
+{
+  //! Lines collected over a frame for bounding boxes and other helpers,
+  //! drawn at once by primitives::debug_renderer instead of one draw call
+  //! (and formerly one program) per box.
+  class debug_geometry
+  {
+  public:
+    struct vertex
+    {
+      math::vector_3d position;
+      math::vector_4d color;
+    };
+
+    static constexpr std::size_t const vertices_per_box = 24;
+
+    void add_line ( math::vector_3d const& from
+                  , math::vector_3d const& to
+                  , math::vector_4d const& color
+                  );
+    //! the twelve edges of the box, with its corners multiplied by transform
+    void add_box ( math::vector_3d const& min_point
+                 , math::vector_3d const& max_point
+                 , math::vector_4d const& color
+                 , math::matrix_4x4 const& transform = math::matrix_4x4::unit
+                 );
+
+    //! pairs of vertices, as drawn with GL_LINES
+    std::vector<vertex> const& vertices() const { return _vertices; }
+    bool empty() const { return _vertices.empty(); }
+    //! keeps the memory for the next frame
+    void clear() { _vertices.clear(); }
+
+  private:
+    std::vector<vertex> _vertices;
+  };
+}
@@ -1,6 +1,5 @@
 // This file is part of Noggit3, licensed under GNU General Public License (version 3).
 
-#include <math/bounding_box.hpp>
 #include <math/matrix_4x4.hpp>
 #include <math/vector_4d.hpp>
 #include <noggit/Misc.h>
@@ -9,28 +8,68 @@
 #include <opengl/scoped.hpp>
 #include <opengl/types.hpp>
 
-#include <array>
+#include <cstddef>
 
 namespace opengl
 {
   namespace primitives
   {
-    wire_box::wire_box ( math::vector_3d const& min_point
-                       , math::vector_3d const& max_point
-                       )
-      : _program { { GL_VERTEX_SHADER
+    void debug_renderer::flush ( math::matrix_4x4 const& model_view
+                               , math::matrix_4x4 const& projection
+                               , debug_geometry& geometry
+                               )
+    {
+      if (geometry.empty())
+      {
+        return;
+      }
+
+      if (!_buffers_are_setup)
+      {
+        setup_buffers();
+      }
+
+      // orphans the previous frame's storage instead of waiting for it
+      gl.bufferData<GL_ARRAY_BUFFER, debug_geometry::vertex>
+        (_vertices_vbo, geometry.vertices(), GL_STREAM_DRAW);
+
+      opengl::scoped::use_program debug_shader {*_program.get()};
+
+      debug_shader.uniform("model_view", model_view);
+      debug_shader.uniform("projection", projection);
+
+      opengl::scoped::bool_setter<GL_BLEND, GL_TRUE> const blend;
+      gl.blendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+      opengl::scoped::bool_setter<GL_LINE_SMOOTH, GL_TRUE> const line_smooth;
+      gl.hint(GL_LINE_SMOOTH_HINT, GL_NICEST);
+
+      opengl::scoped::vao_binder const _(_vao[0]);
+      gl.drawArrays (GL_LINES, 0, geometry.vertices().size());
+
+      geometry.clear();
+    }
+
+    void debug_renderer::setup_buffers()
+    {
+      _vao.upload();
+      _buffers.upload();
+
+      _program.reset(new opengl::program({{ GL_VERTEX_SHADER
                    , R"code(
 #version 330 core
 
-in vec4 position;
+in vec3 position;
+in vec4 color;
 
 uniform mat4 model_view;
 uniform mat4 projection;
-uniform mat4 transform;
+
+out vec4 f_color;
 
 void main()
 {
-  gl_Position = projection * model_view * transform * position;
+  gl_Position = projection * model_view * vec4(position, 1.);
+  f_color = color;
 }
 )code"
                    }
@@ -38,64 +77,34 @@ void main()
                    , R"code(
 #version 330 core
 
-uniform vec4 color;
+in vec4 f_color;
 
 out vec4 out_color;
 
 void main()
 {
-  out_color = color;
+  out_color = f_color;
 }
 )code"
                    }
-                 }
-    {
-      std::vector<math::vector_3d> positions (math::box_points (min_point, max_point));
-      
-      static std::array<std::uint8_t, 16> const indices
-        {{5, 7, 3, 2, 0, 1, 3, 1, 5, 4, 0, 4, 6, 2, 6, 7}};
+                     }));
 
-      _vao.upload();
+      opengl::scoped::use_program shader (*_program.get());
 
       {
-        scoped::buffer_binder<GL_ARRAY_BUFFER> const buffer (_positions);
-        gl.bufferData ( GL_ARRAY_BUFFER
-                      , positions.size() * sizeof (*positions.data())
-                      , positions.data()
-                      , GL_STATIC_DRAW
-                      );
-      }
+        opengl::scoped::vao_binder const _ (_vao[0]);
 
-      {
-        scoped::buffer_binder<GL_ELEMENT_ARRAY_BUFFER> const buffer (_indices);
-        gl.bufferData ( GL_ELEMENT_ARRAY_BUFFER
-                      , indices.size() * sizeof (*indices.data())
-                      , indices.data()
-                      , GL_STATIC_DRAW
+        shader.attrib ( _, "position", _vertices_vbo, 3, GL_FLOAT, GL_FALSE
+                      , sizeof (debug_geometry::vertex)
+                      , reinterpret_cast<GLvoid const*> (offsetof (debug_geometry::vertex, position))
+                      );
+        shader.attrib ( _, "color", _vertices_vbo, 4, GL_FLOAT, GL_FALSE
+                      , sizeof (debug_geometry::vertex)
+                      , reinterpret_cast<GLvoid const*> (offsetof (debug_geometry::vertex, color))
                       );
       }
-    }
-
-    void wire_box::draw ( math::matrix_4x4 const& model_view
-                        , math::matrix_4x4 const& projection
-                        , math::matrix_4x4 const& transform
-                        , math::vector_4d const& color
-                        ) const
-    {
-      opengl::scoped::use_program wire_box_shader {_program};
-
-      wire_box_shader.uniform("model_view", model_view);
-      wire_box_shader.uniform("projection", projection);
-      wire_box_shader.uniform("transform", transform);
-      wire_box_shader.uniform("color", color);
 
-      opengl::scoped::bool_setter<GL_LINE_SMOOTH, GL_TRUE> const line_smooth;
-      gl.hint(GL_LINE_SMOOTH_HINT, GL_NICEST);
-      
-      opengl::scoped::vao_binder const _(_vao[0]);
-      wire_box_shader.attrib(_, "position", _positions, 3, GL_FLOAT, GL_FALSE, 0, 0);
-
-      gl.drawElements (GL_LINE_STRIP, 16, GL_UNSIGNED_BYTE, _indices);
+      _buffers_are_setup = true;
     }
   
 
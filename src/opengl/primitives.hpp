@@ -2,6 +2,7 @@
 
 #pragma once
 
+#include <opengl/debug_geometry.hpp>
 #include <opengl/scoped.hpp>
 #include <opengl/shader.hpp>
 
@@ -17,25 +18,26 @@ namespace opengl
 {
   namespace primitives
   {
-    class wire_box
+    //! Draws the lines of a debug_geometry in a single call, streaming them
+    //! into one buffer. The program and the buffer are created on first use
+    //! and reused every frame.
+    class debug_renderer
     {
     public:
-      wire_box ( math::vector_3d const& min_point
-               , math::vector_3d const& max_point
-               );
+      //! draws then clears the geometry
+      void flush ( math::matrix_4x4 const& model_view
+                 , math::matrix_4x4 const& projection
+                 , debug_geometry& geometry
+                 );
+    private:
+      bool _buffers_are_setup = false;
 
-      void draw ( math::matrix_4x4 const& model_view
-                , math::matrix_4x4 const& projection
-                , math::matrix_4x4 const& transform
-                , math::vector_4d const& color
-                ) const;
+      void setup_buffers();
 
-    private:
       scoped::deferred_upload_vertex_arrays<1> _vao;
-      scoped::buffers<2> _buffers;
-      GLuint const& _positions = _buffers[0];
-      GLuint const& _indices = _buffers[1];
-      opengl::program _program;
+      scoped::deferred_upload_buffers<1> _buffers;
+      GLuint const& _vertices_vbo = _buffers[0];
+      std::unique_ptr<opengl::program> _program;
     };
 
     class sphere
@@ -0,0 +1,234 @@
+// This file is part of Noggit3, licensed under GNU General Public License (version 3).
+
+#include <opengl/program_cache.hpp>
+
+#include <noggit/Log.h>
+#include <noggit/parallel_for.hpp>
+#include <opengl/context.hpp>
+#include <opengl/shader_template.hpp>
+
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QSaveFile>
+#include <QtCore/QStandardPaths>
+
+#include <cstdint>
+#include <cstring>
+#include <utility>
+
+namespace opengl
+{
+  namespace
+  {
+    std::uint32_t const binary_magic = 0x4250474e; // "NGPB"
+
+    struct binary_header
+    {
+      std::uint32_t magic;
+      GLenum format;
+    };
+
+    QString cache_directory()
+    {
+      return QStandardPaths::writableLocation (QStandardPaths::CacheLocation)
+        + "/program_binaries";
+    }
+
+    QString cache_filename (std::string const& key)
+    {
+      return cache_directory() + "/" + QString::fromStdString (key) + ".bin";
+    }
+
+    std::vector<char> read_file (std::string const& key)
+    {
+      QFile file (cache_filename (key));
+      if (!file.open (QIODevice::ReadOnly))
+      {
+        return {};
+      }
+
+      QByteArray const data (file.readAll());
+      return std::vector<char> (data.begin(), data.end());
+    }
+
+    //! registered_programs are constructed during static initialization
+    std::vector<registered_program const*>& registered_programs()
+    {
+      static std::vector<registered_program const*> programs;
+      return programs;
+    }
+  }
+
+  registered_program::registered_program (std::vector<shader_variant> shaders)
+    : _shaders (std::move (shaders))
+  {
+    registered_programs().emplace_back (this);
+  }
+
+  std::vector<shader_source> registered_program::sources() const
+  {
+    std::vector<shader_source> sources;
+    for (auto const& variant : _shaders)
+    {
+      sources.push_back ({variant.type, shader::src_from_qrc (variant.alias, variant.defines)});
+    }
+    return sources;
+  }
+
+  program_cache& program_cache::instance()
+  {
+    static program_cache cache;
+    return cache;
+  }
+
+  bool program_cache::enabled()
+  {
+    if (!_enabled)
+    {
+      GLint formats (0);
+      if (gl.has_extension ("GL_ARB_get_program_binary"))
+      {
+        gl.getIntegerv (GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+      }
+      _enabled = formats > 0;
+    }
+
+    return *_enabled;
+  }
+
+  std::string const& program_cache::driver()
+  {
+    if (!_driver)
+    {
+      _driver = std::string();
+      for (GLenum name : {GL_VENDOR, GL_RENDERER, GL_VERSION})
+      {
+        *_driver += reinterpret_cast<char const*> (gl.getString (name));
+        *_driver += '\n';
+      }
+    }
+
+    return *_driver;
+  }
+
+  std::string program_cache::key (std::vector<shader_source> const& sources)
+  {
+    std::string const& driver_string (driver());
+    std::uint64_t hash (hash_bytes (driver_string.data(), driver_string.size()));
+
+    for (auto const& source : sources)
+    {
+      std::uint32_t const type (source.type);
+      hash = hash_bytes (&type, sizeof (type), hash);
+      hash = hash_bytes (source.source.data(), source.source.size(), hash);
+    }
+
+    return QString ("%1").arg (hash, 16, 16, QChar ('0')).toStdString();
+  }
+
+  void program_cache::warm_up()
+  {
+    if (!enabled())
+    {
+      return;
+    }
+
+    // the driver string needs the context, query it before the workers do
+    driver();
+
+    std::vector<registered_program const*> const& programs (registered_programs());
+
+    noggit::parallel_for
+      ( programs.size()
+      , [&] (std::size_t i)
+        {
+          std::string program_key (key (programs[i]->sources()));
+          std::vector<char> binary (read_file (program_key));
+
+          if (!binary.empty())
+          {
+            std::lock_guard<std::mutex> const lock (_mutex);
+            _warmed_up.emplace (std::move (program_key), std::move (binary));
+          }
+        }
+      );
+  }
+
+  bool program_cache::load (GLuint program, std::vector<shader_source> const& sources)
+  {
+    if (!enabled())
+    {
+      return false;
+    }
+
+    std::string const program_key (key (sources));
+    std::vector<char> file;
+
+    {
+      std::lock_guard<std::mutex> const lock (_mutex);
+      auto const it (_warmed_up.find (program_key));
+      if (it != _warmed_up.end())
+      {
+        file = std::move (it->second);
+        _warmed_up.erase (it);
+      }
+    }
+
+    if (file.empty())
+    {
+      file = read_file (program_key);
+    }
+
+    binary_header header;
+    if (file.size() <= sizeof (header))
+    {
+      return false;
+    }
+
+    std::memcpy (&header, file.data(), sizeof (header));
+    std::vector<char> const binary (file.begin() + sizeof (header), file.end());
+
+    if (header.magic == binary_magic && gl.program_binary (program, header.format, binary))
+    {
+      return true;
+    }
+
+    LogDebug << "discarding stale program binary " << program_key << std::endl;
+    QFile::remove (cache_filename (program_key));
+    return false;
+  }
+
+  void program_cache::link (GLuint program, std::vector<shader_source> const& sources)
+  {
+    bool const store (enabled());
+
+    if (store)
+    {
+      gl.programParameteri (program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    }
+
+    gl.link_program (program);
+
+    if (!store || !QDir().mkpath (cache_directory()))
+    {
+      return;
+    }
+
+    binary_header header {binary_magic, 0};
+    std::vector<char> const binary (gl.get_program_binary (program, &header.format));
+    if (binary.empty())
+    {
+      return;
+    }
+
+    QSaveFile file (cache_filename (key (sources)));
+    if ( !file.open (QIODevice::WriteOnly)
+      || file.write (reinterpret_cast<char const*> (&header), sizeof (header)) != static_cast<qint64> (sizeof (header))
+      || file.write (binary.data(), binary.size()) != static_cast<qint64> (binary.size())
+      || !file.commit()
+       )
+    {
+      LogDebug << "unable to write program binary cache file " << file.fileName().toStdString() << std::endl;
+    }
+  }
+}
@@ -0,0 +1,76 @@
+// This file is part of Noggit3, licensed under GNU General Public License (version 3).
+
+#pragma once
+
+#include <opengl/shader.hpp>
+
+#include <boost/optional.hpp>
+
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace opengl
+{
+  //! A shader of a program, as passed to shader::src_from_qrc()
+  struct shader_variant
+  {
+    GLenum type;
+    std::string alias;
+    std::vector<std::string> defines;
+  };
+
+  //! The qrc shaders of a program. Constructing one registers it for
+  //! program_cache::warm_up(), so renderers define theirs at namespace
+  //! scope next to the code creating the program from sources().
+  class registered_program
+  {
+  public:
+    registered_program (std::vector<shader_variant>);
+
+    registered_program (registered_program const&) = delete;
+    registered_program& operator= (registered_program const&) = delete;
+
+    //! the expanded sources, as passed to program's constructor
+    std::vector<shader_source> sources() const;
+
+  private:
+    std::vector<shader_variant> _shaders;
+  };
+
+  //! Linked program binaries kept on disk, keyed by a hash of the
+  //! preprocessed sources, which include the defines, and of the driver
+  //! string, so unchanged programs skip compiling and linking in later
+  //! sessions. Disabled if the driver has no binary formats. Except for
+  //! warm_up()'s workers, everything happens on the thread owning the
+  //! current context.
+  class program_cache
+  {
+  public:
+    static program_cache& instance();
+
+    //! Expands the sources of every registered_program and reads their
+    //! cached binaries into memory on worker threads, so creating the
+    //! programs later only hands the binaries to the driver.
+    void warm_up();
+
+    //! true if a cached binary was accepted, the program is linked then
+    bool load (GLuint program, std::vector<shader_source> const&);
+    //! links the program with the shaders attached and stores its binary
+    void link (GLuint program, std::vector<shader_source> const&);
+
+  private:
+    program_cache() = default;
+
+    bool enabled();
+    std::string const& driver();
+    std::string key (std::vector<shader_source> const&);
+
+    boost::optional<bool> _enabled;
+    boost::optional<std::string> _driver;
+
+    std::mutex _mutex;
+    std::unordered_map<std::string, std::vector<char>> _warmed_up;
+  };
+}
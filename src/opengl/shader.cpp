@@ -5,8 +5,10 @@
 #include <math/vector_3d.hpp>
 #include <math/vector_4d.hpp>
 #include <opengl/context.hpp>
+#include <opengl/program_cache.hpp>
 #include <opengl/scoped.hpp>
 #include <opengl/shader.hpp>
+#include <opengl/shader_template.hpp>
 #include <opengl/texture.hpp>
 
 #include <boost/filesystem/string_file.hpp>
@@ -16,8 +18,9 @@
 
 #include <stdexcept>
 #include <list>
-#include <regex>
-#include <sstream>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
 
 namespace opengl
 {
@@ -55,38 +58,38 @@ namespace opengl
 
   std::string shader::src_from_qrc(std::string const& shader_alias, std::vector<std::string> const& defines)
   {
-    std::string src(src_from_qrc(shader_alias));
+    static std::mutex mutex;
+    static std::unordered_map<std::string, shader_template> templates;
 
-    if (defines.empty())
     {
-      return src;
-    }
-
-    std::stringstream ss;
-
-    ss << "\n";
-    for (auto const& def : defines)
-    {
-      ss << "#define " << def << "\n";
+      std::lock_guard<std::mutex> const lock (mutex);
+      auto const it (templates.find (shader_alias));
+      if (it != templates.end())
+      {
+        return it->second.expand (defines);
+      }
     }
 
-    std::regex regex("#version[ \t]+[0-9]+.*");
-    std::smatch match;
+    shader_template tmpl (shader_alias, src_from_qrc (shader_alias));
+    std::string src (tmpl.expand (defines));
 
-    if (!std::regex_search(src, match, regex))
-    {
-      throw std::logic_error("shader " + shader_alias + " has no #version directive");
-    }
-
-    // #version is always the first thing in the shader, insert defines after it
-    src.insert(match.length() + match.position(), ss.str());
+    std::lock_guard<std::mutex> const lock (mutex);
+    templates.emplace (shader_alias, std::move (tmpl));
 
     return src;
   }
 
-  program::program (std::initializer_list<shader> shaders)
+  program::program (std::initializer_list<shader_source> sources)
+    : program (std::vector<shader_source> (sources))
+  {}
+  program::program (std::vector<shader_source> const& source_list)
     : _handle (gl.createProgram())
   {
+    if (program_cache::instance().load (*_handle, source_list))
+    {
+      return;
+    }
+
     struct scoped_attach
     {
       scoped_attach (GLuint program, GLuint shader)
@@ -103,14 +106,16 @@ namespace opengl
       GLuint _shader;
     };
 
+    std::list<shader> shaders;
     std::list<scoped_attach> attachments;
 
-    for (shader const& s : shaders)
+    for (shader_source const& source : source_list)
     {
-      attachments.emplace_back (*_handle, s._handle);
+      shaders.emplace_back (source.type, source.source);
+      attachments.emplace_back (*_handle, shaders.back()._handle);
     }
 
-    gl.link_program (*_handle);
+    program_cache::instance().link (*_handle, source_list);
 #ifdef  VALIDATE_OPENGL_PROGRAMS
     gl.validate_program(*_handle);
 #endif
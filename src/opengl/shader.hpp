@@ -27,12 +27,19 @@ namespace opengl
   // The caller guarantees that the array buffer is already bound.
   struct array_buffer_is_already_bound{};
 
+  struct shader_source
+  {
+    GLenum type;
+    std::string source;
+  };
+
   struct shader
   {
     shader(GLenum type, std::string const& source);
     ~shader();
 
     static std::string src_from_qrc(std::string const& shader_alias);
+    //! \note thread safe, the files are only read and split once
     static std::string src_from_qrc(std::string const& shader_alias, std::vector<std::string> const& defines);
 
     shader (shader const&) = delete;
@@ -48,7 +55,9 @@ namespace opengl
 
   struct program
   {
-    program (std::initializer_list<shader>);
+    //! uses a cached binary of the program if there is one, see program_cache
+    program (std::initializer_list<shader_source>);
+    program (std::vector<shader_source> const&);
     ~program();
 
     program (program const&) = delete;
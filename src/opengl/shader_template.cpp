@@ -0,0 +1,87 @@
+// This file is part of Noggit3, licensed under GNU General Public License (version 3).
+
+#include <opengl/shader_template.hpp>
+
+#include <algorithm>
+#include <cctype>
+#include <stdexcept>
+
+namespace opengl
+{
+  namespace
+  {
+    std::size_t version_directive_end (std::string const& source)
+    {
+      for ( std::size_t pos (source.find ("#version"))
+          ; pos != std::string::npos
+          ; pos = source.find ("#version", pos + 1)
+          )
+      {
+        std::size_t number (pos + 8);
+        if (number == source.size() || (source[number] != ' ' && source[number] != '\t'))
+        {
+          continue;
+        }
+        number = source.find_first_not_of (" \t", number);
+        if (number == std::string::npos || !std::isdigit (static_cast<unsigned char> (source[number])))
+        {
+          continue;
+        }
+
+        return std::min (source.find_first_of ("\r\n", number), source.size());
+      }
+
+      return std::string::npos;
+    }
+  }
+
+  shader_template::shader_template (std::string const& name, std::string const& source)
+  {
+    std::size_t const split (version_directive_end (source));
+
+    if (split == std::string::npos)
+    {
+      throw std::logic_error ("shader " + name + " has no #version directive");
+    }
+
+    _head = source.substr (0, split);
+    _tail = source.substr (split);
+  }
+
+  std::string shader_template::expand (std::vector<std::string> const& defines) const
+  {
+    std::size_t size (_head.size() + _tail.size() + 1);
+    for (auto const& define : defines)
+    {
+      size += define.size() + 9;
+    }
+
+    std::string source;
+    source.reserve (size);
+    source += _head;
+
+    if (!defines.empty())
+    {
+      source += "\n";
+      for (auto const& define : defines)
+      {
+        source += "#define " + define + "\n";
+      }
+    }
+
+    source += _tail;
+    return source;
+  }
+
+  std::uint64_t hash_bytes (void const* data, std::size_t size, std::uint64_t seed)
+  {
+    unsigned char const* bytes (static_cast<unsigned char const*> (data));
+    std::uint64_t hash (seed);
+    for (std::size_t i = 0; i < size; ++i)
+    {
+      hash ^= bytes[i];
+      hash *= 1099511628211ull;
+    }
+    return hash;
+  }
+}
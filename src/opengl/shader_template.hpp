@@ -0,0 +1,36 @@
+// This file is part of Noggit3, licensed under GNU General Public License (version 3).
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace opengl
+{
+  //! A shader source split once after its #version directive, so every
+  //! define set is expanded by concatenating the parts instead of
+  //! searching the source again for each variant.
+  class shader_template
+  {
+  public:
+    //! throws std::logic_error if the source has no #version directive
+    shader_template (std::string const& name, std::string const& source);
+
+    //! the source with a "#define <define>" line per define inserted
+    //! after #version, or the unchanged source if there are none
+    std::string expand (std::vector<std::string> const& defines) const;
+
+  private:
+    //! up to the end of the #version line, excluding the line break
+    std::string _head;
+    std::string _tail;
+  };
+
+  //! FNV-1a, stable across sessions to key on-disk caches, not for security
+  std::uint64_t hash_bytes ( void const* data
+                           , std::size_t size
+                           , std::uint64_t seed = 14695981039346656037ull
+                           );
+}
@@ -26,4 +26,15 @@ namespace opengl
 
     internal_type _id;
   };
+
+  //! a GL_TEXTURE_2D_ARRAY, e.g. all frames of an animation
+  class texture_array : public texture
+  {
+  public:
+    texture_array() = default;
+    texture_array (texture_array&&) = default;
+    texture_array& operator= (texture_array&&) = default;
+
+    virtual void bind() override;
+  };
 }
@@ -0,0 +1,106 @@
+// This file is part of Noggit3, licensed under GNU General Public License (version 3).
+
+//! Micro-benchmark for DBCFile::getByID() on synthetic tables: compares the
+//! id index against a linear scan of a column holding the same ids.
+//!
+//! usage: noggit-dbc.benchmark [record count] [lookups]
+
+#include <noggit/DBCFile.h>
+
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+  using clock_type = std::chrono::steady_clock;
+
+  volatile unsigned int sink;
+
+  //! two columns holding the same id, the second is only reachable by scanning
+  std::vector<char> synthetic_dbc (std::vector<std::uint32_t> const& ids)
+  {
+    std::vector<std::uint32_t> records;
+    for (std::uint32_t id : ids)
+    {
+      records.push_back (id);
+      records.push_back (id);
+    }
+
+    std::uint32_t const header[] = {static_cast<std::uint32_t> (ids.size()), 2, 8, 1};
+
+    std::vector<char> buffer (4 + sizeof (header) + records.size() * 4 + 1, '\0');
+    std::memcpy (buffer.data(), "WDBC", 4);
+    std::memcpy (buffer.data() + 4, header, sizeof (header));
+    std::memcpy (buffer.data() + 4 + sizeof (header), records.data(), records.size() * 4);
+    return buffer;
+  }
+
+  void run (std::string const& name, std::vector<std::uint32_t> const& ids, std::size_t lookups)
+  {
+    std::vector<char> const buffer (synthetic_dbc (ids));
+
+    auto const open_start (clock_type::now());
+    DBCFile dbc (name);
+    dbc.open (buffer.data(), buffer.size());
+    double const open_ms (std::chrono::duration<double, std::milli> (clock_type::now() - open_start).count());
+
+    std::mt19937 engine (42);
+    std::uniform_int_distribution<std::size_t> pick (0, ids.size() - 1);
+    std::vector<std::uint32_t> queries;
+    for (std::size_t i (0); i < lookups; ++i)
+    {
+      queries.push_back (ids[pick (engine)]);
+    }
+
+    auto const measure
+    (
+      [&] (std::size_t field)
+      {
+        auto const start (clock_type::now());
+        for (std::uint32_t id : queries)
+        {
+          sink = dbc.getByID (id, field).getUInt (0);
+        }
+        return std::chrono::duration<double, std::milli> (clock_type::now() - start).count();
+      }
+    );
+
+    double const indexed_ms (measure (0));
+    double const scanned_ms (measure (1));
+
+    std::cout << std::fixed << std::setprecision (3)
+              << name << " (" << ids.size() << " records, " << lookups << " lookups)"
+              << ": open " << open_ms << " ms"
+              << " / indexed " << indexed_ms << " ms"
+              << " / scanned " << scanned_ms << " ms"
+              << " / speedup " << scanned_ms / indexed_ms << "x" << std::endl;
+  }
+}
+
+int main (int argc, char* argv[])
+{
+  std::size_t const record_count (argc > 1 ? std::stoul (argv[1]) : 5000);
+  std::size_t const lookups (argc > 2 ? std::stoul (argv[2]) : 100000);
+
+  std::vector<std::uint32_t> dense;
+  std::vector<std::uint32_t> sparse;
+  std::mt19937 engine (1337);
+
+  for (std::uint32_t i (0); i < record_count; ++i)
+  {
+    // like AreaTable: mostly increasing ids with a few holes
+    dense.push_back (1 + i + i / 7);
+    sparse.push_back (engine());
+  }
+
+  run ("dense ids", dense, lookups);
+  run ("sparse ids", sparse, lookups);
+
+  return 0;
+}
@@ -0,0 +1,406 @@
+// This file is part of Noggit3, licensed under GNU General Public License (version 3).
+
+//! Headless benchmark: opens a map from a local client directory and replays
+//! a scripted camera path through MapIndex::enterTile() and World::draw(),
+//! then reports tile load latency, frame time distribution and peak RSS.
+//!
+//! usage: noggit-map_path.benchmark <game path> <map id> <path file>
+//!                                  [frames per segment] [width] [height]
+//!
+//! The path file holds one waypoint per line: "x y z yaw pitch", in world
+//! coordinates and degrees. Empty lines and lines starting with '#' are
+//! ignored. The camera is linearly interpolated between waypoints.
+//!
+//! Run with "-platform offscreen" (or QT_QPA_PLATFORM=offscreen) and e.g.
+//! LIBGL_ALWAYS_SOFTWARE=1 on machines without a display or GPU.
+
+#include <math/projection.hpp>
+#include <noggit/AsyncLoader.h>
+#include <noggit/DBC.h>
+#include <noggit/Log.h>
+#include <noggit/MPQ.h>
+#include <noggit/World.h>
+#include <noggit/camera.hpp>
+#include <opengl/context.hpp>
+
+#include <boost/filesystem.hpp>
+
+#include <QtGui/QOffscreenSurface>
+#include <QtGui/QOpenGLContext>
+#include <QtGui/QOpenGLFramebufferObject>
+#include <QtWidgets/QApplication>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#ifdef _WIN32
+  #include <windows.h>
+  #include <psapi.h>
+#else
+  #include <sys/resource.h>
+#endif
+
+namespace
+{
+  using clock_type = std::chrono::steady_clock;
+
+  struct waypoint
+  {
+    math::vector_3d position;
+    float yaw;
+    float pitch;
+  };
+
+  std::vector<waypoint> read_path (std::string const& filename)
+  {
+    std::ifstream file (filename);
+
+    if (!file)
+    {
+      throw std::runtime_error ("unable to open path file " + filename);
+    }
+
+    std::vector<waypoint> path;
+    std::string line;
+
+    while (std::getline (file, line))
+    {
+      if (line.empty() || line[0] == '#')
+      {
+        continue;
+      }
+
+      std::istringstream stream (line);
+      waypoint point;
+
+      if (stream >> point.position.x >> point.position.y >> point.position.z >> point.yaw >> point.pitch)
+      {
+        path.push_back (point);
+      }
+    }
+
+    if (path.size() < 2)
+    {
+      throw std::runtime_error ("the camera path needs at least two waypoints");
+    }
+
+    return path;
+  }
+
+  std::uint64_t peak_rss_bytes()
+  {
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo (GetCurrentProcess(), &counters, sizeof (counters)))
+    {
+      return counters.PeakWorkingSetSize;
+    }
+    return 0;
+#else
+    rusage usage;
+    if (getrusage (RUSAGE_SELF, &usage) != 0)
+    {
+      return 0;
+    }
+  #ifdef __APPLE__
+    return static_cast<std::uint64_t> (usage.ru_maxrss);
+  #else
+    return static_cast<std::uint64_t> (usage.ru_maxrss) * 1024;
+  #endif
+#endif
+  }
+
+  void report (std::string const& name, std::vector<double> values)
+  {
+    std::cout << name << " (" << values.size() << " samples)";
+
+    if (values.empty())
+    {
+      std::cout << ": -" << std::endl;
+      return;
+    }
+
+    std::sort (values.begin(), values.end());
+
+    auto const percentile
+    (
+      [&] (double p)
+      {
+        std::size_t const index (static_cast<std::size_t> (p * (values.size() - 1) + 0.5));
+        return values[std::min (index, values.size() - 1)];
+      }
+    );
+
+    double sum (0.);
+    for (double v : values)
+    {
+      sum += v;
+    }
+
+    std::cout << std::fixed << std::setprecision (3)
+              << ": min " << values.front()
+              << " / p50 " << percentile (0.5)
+              << " / p90 " << percentile (0.9)
+              << " / p99 " << percentile (0.99)
+              << " / max " << values.back()
+              << " / mean " << sum / values.size()
+              << " ms" << std::endl;
+  }
+
+  std::string map_name (int map_id)
+  {
+    for (DBCFile::Iterator it = gMapDB.begin(); it != gMapDB.end(); ++it)
+    {
+      if (it->getInt (MapDB::MapID) == map_id)
+      {
+        return it->getString (MapDB::InternalName);
+      }
+    }
+
+    throw std::runtime_error ("map " + std::to_string (map_id) + " not found in Map.dbc");
+  }
+
+  //! tiles enterTile() may start loading around the given tile
+  std::vector<tile_index> tiles_around (tile_index const& center)
+  {
+    std::vector<tile_index> tiles;
+
+    for (int z = static_cast<int> (center.z) - 1; z <= static_cast<int> (center.z) + 1; ++z)
+    {
+      for (int x = static_cast<int> (center.x) - 1; x <= static_cast<int> (center.x) + 1; ++x)
+      {
+        if (x >= 0 && z >= 0 && x < 64 && z < 64)
+        {
+          tiles.emplace_back (x, z);
+        }
+      }
+    }
+
+    return tiles;
+  }
+
+  int run (int argc, char* argv[])
+  {
+    if (argc < 4)
+    {
+      std::cerr << "usage: " << argv[0]
+                << " <game path> <map id> <path file> [frames per segment] [width] [height]"
+                << std::endl;
+      return 1;
+    }
+
+    boost::filesystem::path const game_path (argv[1]);
+    int const map_id (std::stoi (argv[2]));
+    std::vector<waypoint> const path (read_path (argv[3]));
+    int const frames_per_segment (argc > 4 ? std::max (1, std::stoi (argv[4])) : 60);
+    int const width (argc > 5 ? std::stoi (argv[5]) : 1280);
+    int const height (argc > 6 ? std::stoi (argv[6]) : 720);
+
+    boost::filesystem::current_path (game_path);
+
+    MPQArchive::loadClientMPQs (&AsyncLoader::instance(), game_path);
+    OpenDBs();
+
+    QSurfaceFormat format;
+    format.setRenderableType (QSurfaceFormat::OpenGL);
+    format.setVersion (3, 3);
+    format.setProfile (QSurfaceFormat::CoreProfile);
+    QSurfaceFormat::setDefaultFormat (format);
+
+    QOpenGLContext context;
+    if (!context.create())
+    {
+      throw std::runtime_error ("unable to create an OpenGL 3.3 core context");
+    }
+
+    QOffscreenSurface surface;
+    surface.create();
+    context.makeCurrent (&surface);
+
+    opengl::context::scoped_setter const _ (::gl, &context);
+
+    std::cout << "GL: " << gl.getString (GL_RENDERER) << " / " << gl.getString (GL_VERSION) << std::endl;
+
+    QOpenGLFramebufferObject framebuffer (width, height, QOpenGLFramebufferObject::Depth);
+    framebuffer.bind();
+
+    std::vector<double> tile_load_times;
+    std::vector<double> frame_times;
+    std::map<std::pair<std::size_t, std::size_t>, clock_type::time_point> tiles_loading;
+
+    auto const elapsed_ms
+    (
+      [] (clock_type::time_point since)
+      {
+        return std::chrono::duration<double, std::milli> (clock_type::now() - since).count();
+      }
+    );
+
+    {
+      World world (map_name (map_id), map_id);
+      std::map<int, misc::random_color> area_id_colors;
+
+      auto const poll_loading_tiles
+      (
+        [&]
+        {
+          for (auto it (tiles_loading.begin()); it != tiles_loading.end();)
+          {
+            tile_index const tile (it->first.first, it->first.second);
+
+            if (world.mapIndex.tileLoaded (tile))
+            {
+              tile_load_times.push_back (elapsed_ms (it->second));
+              it = tiles_loading.erase (it);
+            }
+            else if (!world.mapIndex.tileAwaitingLoading (tile))
+            {
+              it = tiles_loading.erase (it);
+            }
+            else
+            {
+              ++it;
+            }
+          }
+        }
+      );
+
+      std::size_t const frame_count ((path.size() - 1) * frames_per_segment + 1);
+
+      for (std::size_t frame (0); frame < frame_count; ++frame)
+      {
+        std::size_t const segment (std::min (frame / frames_per_segment, path.size() - 2));
+        float const t ((frame - segment * frames_per_segment) / static_cast<float> (frames_per_segment));
+        waypoint const& from (path[segment]);
+        waypoint const& to (path[segment + 1]);
+
+        noggit::camera camera ( from.position + (to.position - from.position) * t
+                              , math::degrees (from.yaw + (to.yaw - from.yaw) * t)
+                              , math::degrees (from.pitch + (to.pitch - from.pitch) * t)
+                              );
+
+        tile_index const camera_tile (camera.position);
+        std::vector<tile_index> unloaded_neighbours;
+
+        for (tile_index const& tile : tiles_around (camera_tile))
+        {
+          if (!world.mapIndex.tileLoaded (tile) && !world.mapIndex.tileAwaitingLoading (tile))
+          {
+            unloaded_neighbours.push_back (tile);
+          }
+        }
+
+        auto const frame_start (clock_type::now());
+
+        world.mapIndex.enterTile (camera_tile);
+        world.mapIndex.unloadTiles (camera_tile);
+
+        for (tile_index const& tile : unloaded_neighbours)
+        {
+          if (world.mapIndex.tileLoaded (tile) || world.mapIndex.tileAwaitingLoading (tile))
+          {
+            tiles_loading.emplace (std::make_pair (tile.x, tile.z), frame_start);
+          }
+        }
+
+        gl.viewport (0, 0, width, height);
+        gl.clearColor (0.f, 0.f, 0.f, 1.f);
+        gl.clear (GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+        world.draw ( camera.look_at_matrix().transposed()
+                   , math::perspective (camera.fov(), width / static_cast<float> (height), 1.f, 2048.f).transposed()
+                   , camera.position
+                   , math::vector_4d (1.f, 1.f, 1.f, 1.f)
+                   , static_cast<int> (cursor_mode::none)
+                   , 0.f
+                   , false
+                   , false
+                   , 0.f
+                   , math::vector_3d()
+                   , 0.f
+                   , 0.f
+                   , false
+                   , false
+                   , false
+                   , false
+                   , false
+                   , editing_mode::ground
+                   , camera.position
+                   , true
+                   , false
+                   , false
+                   , false
+                   , true
+                   , true
+                   , true
+                   , true
+                   , true
+                   , true
+                   , false
+                   , false
+                   , false
+                   , area_id_colors
+                   , false
+                   , eTerrainType_Flat
+                   , -1
+                   , display_mode::in_3D
+                   );
+
+        gl.finish();
+
+        frame_times.push_back (elapsed_ms (frame_start));
+        world.time += 1.f;
+        world.animtime += 1000.f / 60.f;
+
+        poll_loading_tiles();
+      }
+
+      for (auto& tile : tiles_loading)
+      {
+        if (MapTile* adt = world.mapIndex.getTile (tile_index (tile.first.first, tile.first.second)))
+        {
+          adt->wait_until_loaded();
+        }
+      }
+      poll_loading_tiles();
+
+      std::cout << "frames: " << frame_count << std::endl;
+      report ("tile load latency", tile_load_times);
+      report ("frame time", frame_times);
+    }
+
+    framebuffer.release();
+
+    std::cout << "peak RSS: " << peak_rss_bytes() / (1024 * 1024) << " MiB" << std::endl;
+
+    return 0;
+  }
+}
+
+int main (int argc, char* argv[])
+{
+  InitLogging();
+
+  QApplication qapp (argc, argv);
+  qapp.setApplicationName ("Noggit");
+  qapp.setOrganizationName ("Noggit");
+
+  try
+  {
+    return run (argc, argv);
+  }
+  catch (std::exception const& e)
+  {
+    std::cerr << "error: " << e.what() << std::endl;
+    return 1;
+  }
+}
@@ -0,0 +1,178 @@
+// This file is part of Noggit3, licensed under GNU General Public License (version 3).
+
+//! Micro-benchmark for the vectorised math paths: compares matrix products
+//! and batched frustum culling against their scalar counterparts.
+//!
+//! usage: noggit-math.benchmark [iterations]
+
+#include <math/bounding_box.hpp>
+#include <math/frustum.hpp>
+#include <math/matrix_4x4.hpp>
+#include <math/projection.hpp>
+#include <math/simd.hpp>
+
+#include <array>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+  using clock_type = std::chrono::steady_clock;
+
+  //! keeps the optimizer from dropping the measured work
+  volatile float sink;
+
+  template<typename Fun>
+    double measure_ms (std::size_t iterations, Fun&& fun)
+  {
+    auto const start (clock_type::now());
+    for (std::size_t i (0); i < iterations; ++i)
+    {
+      fun();
+    }
+    return std::chrono::duration<double, std::milli> (clock_type::now() - start).count();
+  }
+
+  void report (std::string const& name, double scalar_ms, double vectorised_ms)
+  {
+    std::cout << std::fixed << std::setprecision (3)
+              << name << ": scalar " << scalar_ms << " ms"
+              << " / vectorised " << vectorised_ms << " ms"
+              << " / speedup " << scalar_ms / vectorised_ms << "x" << std::endl;
+  }
+
+  math::matrix_4x4 scalar_product (math::matrix_4x4 const& lhs, math::matrix_4x4 const& rhs)
+  {
+    math::matrix_4x4 result (math::matrix_4x4::uninitialized);
+    for (std::size_t j (0); j < 4; ++j)
+    {
+      for (std::size_t i (0); i < 4; ++i)
+      {
+        result (j, i, lhs (j, 0) * rhs (0, i) + lhs (j, 1) * rhs (1, i) + lhs (j, 2) * rhs (2, i) + lhs (j, 3) * rhs (3, i));
+      }
+    }
+    return result;
+  }
+}
+
+int main (int argc, char* argv[])
+{
+  std::size_t const iterations (argc > 1 ? std::stoul (argv[1]) : 200);
+
+#ifdef NOGGIT_MATH_SSE
+  std::cout << "vectorised paths: SSE2" << std::endl;
+#else
+  std::cout << "vectorised paths: none, scalar fallback" << std::endl;
+#endif
+
+  std::mt19937 engine (42);
+  std::uniform_real_distribution<float> value (-100.f, 100.f);
+
+  {
+    std::vector<math::matrix_4x4> matrices;
+    for (std::size_t n (0); n < 4096; ++n)
+    {
+      math::matrix_4x4 mat (math::matrix_4x4::uninitialized);
+      for (std::size_t i (0); i < 16; ++i)
+      {
+        mat._data[i] = value (engine);
+      }
+      matrices.push_back (mat);
+    }
+
+    auto const chain
+    (
+      [&] (auto&& product)
+      {
+        math::matrix_4x4 result (math::matrix_4x4::unit);
+        for (auto const& mat : matrices)
+        {
+          result = product (result, mat);
+          result = result * 1e-3f;
+        }
+        sink = result (0, 0);
+      }
+    );
+
+    report ( "matrix_4x4 * matrix_4x4 (x4096)"
+           , measure_ms (iterations, [&] { chain (scalar_product); })
+           , measure_ms (iterations, [&] { chain ([] (math::matrix_4x4 const& l, math::matrix_4x4 const& r) { return l * r; }); })
+           );
+  }
+
+  math::frustum const frustum
+    (math::perspective (math::degrees (60.f), 16.f / 9.f, 1.f, 2000.f).transposed());
+
+  std::uniform_real_distribution<float> position (-2500.f, 2500.f);
+  std::uniform_real_distribution<float> size (1.f, 40.f);
+
+  {
+    // about the chunks of 3x3 tiles
+    std::vector<std::array<math::vector_3d, 2>> boxes;
+    std::vector<std::vector<math::vector_3d>> corners;
+    for (std::size_t n (0); n < 9 * 256; ++n)
+    {
+      math::vector_3d const min (position (engine), position (engine), position (engine));
+      math::vector_3d const max (min + math::vector_3d (size (engine), size (engine), size (engine)));
+      boxes.push_back ({min, max});
+      corners.push_back (math::box_points (min, max));
+    }
+    std::unique_ptr<bool[]> results (new bool[boxes.size()]);
+
+    report ( "frustum vs aabb (x2304)"
+           , measure_ms ( iterations
+                        , [&]
+                          {
+                            for (std::size_t i (0); i < corners.size(); ++i)
+                            {
+                              results[i] = frustum.intersects (corners[i]);
+                            }
+                            sink = results[0];
+                          }
+                        )
+           , measure_ms ( iterations
+                        , [&]
+                          {
+                            frustum.intersects (boxes.data(), boxes.size(), results.get());
+                            sink = results[0];
+                          }
+                        )
+           );
+  }
+
+  {
+    std::vector<math::vector_4d> spheres;
+    for (std::size_t n (0); n < 10000; ++n)
+    {
+      spheres.emplace_back (position (engine), position (engine), position (engine), size (engine));
+    }
+    std::unique_ptr<bool[]> results (new bool[spheres.size()]);
+
+    report ( "frustum vs sphere (x10000)"
+           , measure_ms ( iterations
+                        , [&]
+                          {
+                            for (std::size_t i (0); i < spheres.size(); ++i)
+                            {
+                              results[i] = frustum.intersectsSphere (spheres[i].xyz(), spheres[i].w);
+                            }
+                            sink = results[0];
+                          }
+                        )
+           , measure_ms ( iterations
+                        , [&]
+                          {
+                            frustum.intersects_spheres (spheres.data(), spheres.size(), results.get());
+                            sink = results[0];
+                          }
+                        )
+           );
+  }
+
+  return 0;
+}
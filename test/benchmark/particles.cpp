@@ -0,0 +1,215 @@
+// This file is part of Noggit3, licensed under GNU General Public License (version 3).
+
+//! Headless benchmark for the particle simulation: runs a number of emitters
+//! in a steady state of spawning and dying particles, once on the per-node
+//! std::list the systems used before and once on noggit::particle_pool.
+//! No GL context or game client is needed.
+//!
+//! usage: noggit-particles.benchmark [systems] [particles per second] [frames]
+
+#include <math/interpolation.hpp>
+#include <math/simd.hpp>
+#include <noggit/particle_pool.hpp>
+
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <list>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+  using clock_type = std::chrono::steady_clock;
+
+  volatile float sink;
+
+  float const frame_time (1.f / 60.f);
+
+  noggit::particle_update_parameters const parameters
+    { 2.f, 0.5f, 0.25f, 0.5f
+    , {{0.5f, 2.f, 0.25f}}
+    , {{ math::vector_4d (1.f, 0.5f, 0.f, 0.f)
+       , math::vector_4d (0.8f, 0.8f, 0.2f, 1.f)
+       , math::vector_4d (0.1f, 0.1f, 0.1f, 0.f)
+      }}
+    };
+
+  template<class T>
+  T lifeRamp(float life, float mid, const T &a, const T &b, const T &c)
+  {
+    if (life <= mid) return math::interpolation::linear(life / mid, a, b);
+    else return math::interpolation::linear((life - mid) / (1.0f - mid), b, c);
+  }
+
+  //! stand-in for the emitters, which need a model to sample bones from
+  class spawner
+  {
+  public:
+    explicit spawner (unsigned int seed) : _engine (seed) {}
+
+    Particle operator()()
+    {
+      Particle p;
+      p.pos = {_value (_engine), _value (_engine), _value (_engine)};
+      p.speed = {_value (_engine), std::abs (_value (_engine)), _value (_engine)};
+      p.down = {0.f, -1.f, 0.f};
+      p.dir = math::vector_3d (p.speed).normalize();
+      p.origin = p.pos;
+      p.size = 0.f;
+      p.life = 0.f;
+      p.maxlife = _life (_engine);
+      p.tile = 0;
+      return p;
+    }
+
+  private:
+    std::mt19937 _engine;
+    std::uniform_real_distribution<float> _value {-1.f, 1.f};
+    std::uniform_real_distribution<float> _life {1.f, 3.f};
+  };
+
+  struct list_system
+  {
+    explicit list_system (unsigned int seed) : spawn (seed) {}
+
+    std::list<Particle> particles;
+    spawner spawn;
+    float rem = 0.f;
+
+    void update (float rate)
+    {
+      float const count (frame_time * rate + rem);
+      int const tospawn (static_cast<int> (count));
+      rem = count - tospawn;
+      for (int i (0); i < tospawn; ++i)
+      {
+        particles.push_back (spawn());
+      }
+
+      float mspeed = 1.0f;
+      for (auto it = particles.begin(); it != particles.end();)
+      {
+        Particle &p = *it;
+        p.speed += p.down * parameters.gravity * frame_time - p.dir * parameters.deacceleration * frame_time;
+        mspeed = expf(-1.0f * parameters.slowdown * p.life);
+        p.pos += p.speed * mspeed * frame_time;
+
+        p.life += frame_time;
+        float rlife = p.life / p.maxlife;
+        p.size = lifeRamp<float>(rlife, parameters.mid, parameters.sizes[0], parameters.sizes[1], parameters.sizes[2]);
+        p.color = lifeRamp<math::vector_4d>(rlife, parameters.mid, parameters.colors[0], parameters.colors[1], parameters.colors[2]);
+
+        if (rlife >= 1.0f)
+        {
+          it = particles.erase (it);
+        }
+        else
+        {
+          ++it;
+        }
+      }
+    }
+
+    float checksum() const
+    {
+      float sum (0.f);
+      for (Particle const& p : particles)
+      {
+        sum += p.pos.y + p.size;
+      }
+      return sum;
+    }
+  };
+
+  struct pool_system
+  {
+    explicit pool_system (unsigned int seed) : spawn (seed) {}
+
+    noggit::particle_pool particles {10000};
+    spawner spawn;
+    float rem = 0.f;
+
+    void update (float rate)
+    {
+      float const count (frame_time * rate + rem);
+      int const tospawn (static_cast<int> (count));
+      rem = count - tospawn;
+      for (int i (0); i < tospawn; ++i)
+      {
+        particles.push_back (spawn());
+      }
+
+      particles.update (frame_time, parameters);
+    }
+
+    float checksum() const
+    {
+      float sum (0.f);
+      for (std::size_t i (0); i < particles.size(); ++i)
+      {
+        sum += particles.position (i).y + particles.size (i);
+      }
+      return sum;
+    }
+  };
+
+  template<typename System>
+    double run (std::size_t system_count, float rate, std::size_t frames, std::size_t& live)
+  {
+    std::vector<System> systems;
+    for (std::size_t i (0); i < system_count; ++i)
+    {
+      systems.emplace_back (static_cast<unsigned int> (i));
+    }
+
+    auto const start (clock_type::now());
+    for (std::size_t frame (0); frame < frames; ++frame)
+    {
+      for (System& system : systems)
+      {
+        system.update (rate);
+      }
+    }
+    double const elapsed (std::chrono::duration<double, std::milli> (clock_type::now() - start).count());
+
+    live = 0;
+    float sum (0.f);
+    for (System const& system : systems)
+    {
+      live += system.particles.size();
+      sum += system.checksum();
+    }
+    sink = sum;
+
+    return elapsed / frames;
+  }
+}
+
+int main (int argc, char* argv[])
+{
+  std::size_t const systems (argc > 1 ? std::stoul (argv[1]) : 200);
+  float const rate (argc > 2 ? std::stof (argv[2]) : 500.f);
+  std::size_t const frames (argc > 3 ? std::stoul (argv[3]) : 600);
+
+#ifdef NOGGIT_MATH_SSE
+  std::cout << "vectorised paths: SSE2" << std::endl;
+#else
+  std::cout << "vectorised paths: none, scalar fallback" << std::endl;
+#endif
+
+  std::size_t list_live, pool_live;
+  double const list_ms (run<list_system> (systems, rate, frames, list_live));
+  double const pool_ms (run<pool_system> (systems, rate, frames, pool_live));
+
+  std::cout << std::fixed << std::setprecision (3)
+            << systems << " systems, " << frames << " frames"
+            << ", live particles: list " << list_live << " / pool " << pool_live << std::endl
+            << "frame time: list " << list_ms << " ms"
+            << " / pool " << pool_ms << " ms"
+            << " / speedup " << list_ms / pool_ms << "x" << std::endl;
+
+  return 0;
+}
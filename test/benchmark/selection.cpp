@@ -0,0 +1,126 @@
+// This file is part of Noggit3, licensed under GNU General Public License (version 3).
+
+//! Headless benchmark for the selection checks done while drawing: selects
+//! a number of model instances, then times a simulated draw pass asking
+//! every instance whether it is selected, once with the linear search the
+//! world did before, once with noggit::selection_set::contains() and once
+//! with the per instance flag the renderers read.
+//! No GL context or game client is needed, the model never loads.
+//!
+//! usage: noggit-selection.benchmark [instances] [passes]
+
+#include <noggit/Log.h>
+#include <noggit/ModelInstance.h>
+#include <noggit/selection_set.hpp>
+
+#include <boost/variant/get.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace
+{
+  using clock_type = std::chrono::steady_clock;
+
+  volatile std::size_t sink;
+
+  //! what World::is_selected() did before the selection was hashed
+  bool linear_is_selected (std::vector<selection_type> const& selection, std::uint32_t uid)
+  {
+    return std::find_if ( selection.begin(), selection.end()
+                        , [uid] (selection_type const& entry)
+                          {
+                            return entry.which() == eEntry_Model
+                              && boost::get<selected_model_type> (entry)->uid == uid;
+                          }
+                        ) != selection.end();
+  }
+
+  template<typename IsSelected>
+    double run (std::vector<ModelInstance> const& instances, std::size_t passes, IsSelected is_selected)
+  {
+    std::size_t selected (0);
+
+    auto const start (clock_type::now());
+    for (std::size_t pass (0); pass < passes; ++pass)
+    {
+      for (ModelInstance const& instance : instances)
+      {
+        selected += is_selected (instance);
+      }
+    }
+    double const elapsed (std::chrono::duration<double, std::milli> (clock_type::now() - start).count());
+
+    sink = selected;
+
+    return elapsed / passes;
+  }
+}
+
+int main (int argc, char* argv[])
+{
+  InitLogging();
+
+  std::size_t const count (argc > 1 ? std::stoul (argv[1]) : 10000);
+  std::size_t const passes (argc > 2 ? std::stoul (argv[2]) : 20);
+
+  std::vector<ModelInstance> instances;
+  {
+    ModelInstance const prototype ("world/generic/benchmark/selection.m2");
+    instances.reserve (count * 2);
+    for (std::size_t i (0); i < count * 2; ++i)
+    {
+      instances.push_back (prototype);
+      instances.back().uid = static_cast<std::uint32_t> (i);
+    }
+  }
+
+  // every other instance, so half of the checks miss
+  noggit::selection_set selection;
+  auto const select_start (clock_type::now());
+  for (std::size_t i (0); i < instances.size(); i += 2)
+  {
+    selection.add (&instances[i]);
+  }
+  double const select_time
+    (std::chrono::duration<double, std::milli> (clock_type::now() - select_start).count());
+
+  std::cout << std::fixed << std::setprecision (4)
+            << instances.size() << " instances, " << selection.size() << " selected in "
+            << select_time << " ms\n"
+            << "per draw pass:\n";
+
+  std::cout << "  linear search   "
+            << run ( instances, passes
+                   , [&] (ModelInstance const& instance)
+                     {
+                       return linear_is_selected (selection.entries(), instance.uid);
+                     }
+                   )
+            << " ms\n";
+  std::cout << "  hashed uid      "
+            << run ( instances, passes
+                   , [&] (ModelInstance const& instance)
+                     {
+                       return selection.contains (instance.uid);
+                     }
+                   )
+            << " ms\n";
+  std::cout << "  instance flag   "
+            << run ( instances, passes
+                   , [] (ModelInstance const& instance)
+                     {
+                       return static_cast<bool> (instance.selected);
+                     }
+                   )
+            << " ms\n";
+
+  selection.clear();
+
+  return 0;
+}
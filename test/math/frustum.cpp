@@ -0,0 +1,154 @@
+#include <boost/test/unit_test.hpp>
+
+#include <math/bounding_box.hpp>
+#include <math/frustum.hpp>
+#include <math/projection.hpp>
+
+#include <boost/optional.hpp>
+
+#include <array>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace math
+{
+  namespace
+  {
+    //! camera in the origin looking down -z, as World::draw builds it
+    frustum test_frustum()
+    {
+      return frustum (perspective (degrees (60.f), 16.f / 9.f, 1.f, 1000.f).transposed());
+    }
+
+    //! the old corner based test, only trusted when growing or shrinking
+    //! the box a little does not change the result
+    boost::optional<bool> reference_box (frustum const& frust, vector_3d const& min, vector_3d const& max)
+    {
+      vector_3d const epsilon (0.01f, 0.01f, 0.01f);
+
+      bool const grown (frust.intersects (box_points (min - epsilon, max + epsilon)));
+      bool const shrunk (frust.intersects (box_points (min + epsilon, max - epsilon)));
+
+      if (grown != shrunk)
+      {
+        return boost::none;
+      }
+      return grown;
+    }
+  }
+
+  BOOST_AUTO_TEST_CASE (frustum_boxes)
+  {
+    frustum const frust (test_frustum());
+
+    std::array<vector_3d, 2> const boxes[] =
+      { {vector_3d (-1.f, -1.f, -11.f), vector_3d (1.f, 1.f, -9.f)}       // in front
+      , {vector_3d (-1.f, -1.f, 9.f), vector_3d (1.f, 1.f, 11.f)}         // behind
+      , {vector_3d (-1.f, -1.f, -2000.f), vector_3d (1.f, 1.f, -1500.f)}  // too far
+      , {vector_3d (500.f, -1.f, -11.f), vector_3d (501.f, 1.f, -9.f)}    // right
+      , {vector_3d (-100.f, -100.f, -500.f), vector_3d (100.f, 100.f, 500.f)} // around the camera
+      };
+
+    bool results[5];
+    frust.intersects (boxes, 5, results);
+
+    BOOST_CHECK (results[0]);
+    BOOST_CHECK (!results[1]);
+    BOOST_CHECK (!results[2]);
+    BOOST_CHECK (!results[3]);
+    BOOST_CHECK (results[4]);
+
+    BOOST_CHECK (frust.intersects (boxes[0][0], boxes[0][1]));
+    BOOST_CHECK (!frust.intersects (boxes[1][0], boxes[1][1]));
+  }
+
+  BOOST_AUTO_TEST_CASE (frustum_boxes_match_corner_test)
+  {
+    frustum const frust (test_frustum());
+
+    std::mt19937 engine (42);
+    std::uniform_real_distribution<float> position (-1200.f, 1200.f);
+    std::uniform_real_distribution<float> size (0.1f, 200.f);
+
+    std::vector<std::array<vector_3d, 2>> boxes;
+    for (std::size_t i (0); i < 10000; ++i)
+    {
+      vector_3d const min (position (engine), position (engine), position (engine));
+      boxes.push_back ({min, min + vector_3d (size (engine), size (engine), size (engine))});
+    }
+
+    std::unique_ptr<bool[]> results (new bool[boxes.size()]);
+    frust.intersects (boxes.data(), boxes.size(), results.get());
+
+    std::size_t visible (0);
+    for (std::size_t i (0); i < boxes.size(); ++i)
+    {
+      if (auto const expected = reference_box (frust, boxes[i][0], boxes[i][1]))
+      {
+        BOOST_CHECK_EQUAL (results[i], *expected);
+      }
+      visible += results[i];
+    }
+
+    // make sure both sides actually got tested
+    BOOST_CHECK_GT (visible, 0u);
+    BOOST_CHECK_LT (visible, boxes.size());
+  }
+
+  BOOST_AUTO_TEST_CASE (frustum_spheres)
+  {
+    frustum const frust (test_frustum());
+
+    vector_4d const spheres[] =
+      { {0.f, 0.f, -10.f, 1.f}     // in front
+      , {0.f, 0.f, 10.f, 1.f}      // behind
+      , {0.f, 0.f, 10.f, 20.f}     // behind, but around the camera
+      , {0.f, 0.f, -2000.f, 10.f}  // too far
+      , {0.f, 0.f, -2000.f, 1500.f} // too far but reaching back
+      };
+
+    bool results[5];
+    frust.intersects_spheres (spheres, 5, results);
+
+    BOOST_CHECK (results[0]);
+    BOOST_CHECK (!results[1]);
+    BOOST_CHECK (results[2]);
+    BOOST_CHECK (!results[3]);
+    BOOST_CHECK (results[4]);
+  }
+
+  BOOST_AUTO_TEST_CASE (frustum_spheres_match_bounds)
+  {
+    frustum const frust (test_frustum());
+
+    std::mt19937 engine (1337);
+    std::uniform_real_distribution<float> position (-1200.f, 1200.f);
+    std::uniform_real_distribution<float> radius (0.1f, 100.f);
+
+    std::vector<vector_4d> spheres;
+    for (std::size_t i (0); i < 10000; ++i)
+    {
+      spheres.emplace_back (position (engine), position (engine), position (engine), radius (engine));
+    }
+
+    std::unique_ptr<bool[]> results (new bool[spheres.size()]);
+    frust.intersects_spheres (spheres.data(), spheres.size(), results.get());
+
+    for (std::size_t i (0); i < spheres.size(); ++i)
+    {
+      vector_3d const center (spheres[i].xyz());
+      vector_3d const extent (spheres[i].w, spheres[i].w, spheres[i].w);
+
+      // a sphere is visible if its center is, and hidden if its bounding box is
+      if (frust.contains (center))
+      {
+        BOOST_CHECK (results[i]);
+      }
+      if (reference_box (frust, center - extent, center + extent) == false)
+      {
+        BOOST_CHECK (!results[i]);
+      }
+    }
+  }
+}
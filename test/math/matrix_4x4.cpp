@@ -2,6 +2,9 @@
 
 #include <math/matrix_4x4.hpp>
 
+#include <random>
+#include <vector>
+
 namespace math
 {
   BOOST_AUTO_TEST_CASE (translation)
@@ -29,4 +32,64 @@ namespace math
     BOOST_CHECK_EQUAL (matrix_4x4 (matrix_4x4::rotation_xyz, {degrees (0.f), degrees (90.f), degrees (0.f)}) * vector_3d (1.f, 0.f, 0.f), vector_3d (0.f, 0.f, -1.f));
     BOOST_CHECK_EQUAL (matrix_4x4 (matrix_4x4::rotation_xyz, {degrees (0.f), degrees (0.f), degrees (90.f)}) * vector_3d (1.f, 0.f, 0.f), vector_3d (0.f, -1.f, 0.f));
   }
+
+  namespace
+  {
+    matrix_4x4 random_matrix (std::mt19937& engine)
+    {
+      std::uniform_real_distribution<float> value (-100.f, 100.f);
+
+      matrix_4x4 mat (matrix_4x4::uninitialized);
+      for (std::size_t i (0); i < 16; ++i)
+      {
+        mat._data[i] = value (engine);
+      }
+      return mat;
+    }
+  }
+
+  //! the vectorised products against the plain row times column definition
+  BOOST_AUTO_TEST_CASE (products_match_scalar)
+  {
+    std::mt19937 engine (4711);
+    std::uniform_real_distribution<float> value (-100.f, 100.f);
+
+    for (std::size_t n (0); n < 1000; ++n)
+    {
+      matrix_4x4 const lhs (random_matrix (engine));
+      matrix_4x4 const rhs (random_matrix (engine));
+      matrix_4x4 const product (lhs * rhs);
+
+      for (std::size_t j (0); j < 4; ++j)
+      {
+        for (std::size_t i (0); i < 4; ++i)
+        {
+          float const expected ( lhs (j, 0) * rhs (0, i) + lhs (j, 1) * rhs (1, i)
+                               + lhs (j, 2) * rhs (2, i) + lhs (j, 3) * rhs (3, i)
+                               );
+          BOOST_CHECK_SMALL (product (j, i) - expected, 1e-2f);
+        }
+      }
+
+      vector_4d const v4 (value (engine), value (engine), value (engine), value (engine));
+      vector_4d const product_4 (lhs * v4);
+      vector_3d const v3 (v4.xyz());
+      vector_3d const product_3 (lhs * v3);
+      std::vector<vector_3d> const products (lhs * std::vector<vector_3d> {v3, v3});
+
+      for (std::size_t j (0); j < 4; ++j)
+      {
+        float const expected_4 (lhs (j, 0) * v4.x + lhs (j, 1) * v4.y + lhs (j, 2) * v4.z + lhs (j, 3) * v4.w);
+        BOOST_CHECK_SMALL (product_4[j] - expected_4, 1e-2f);
+
+        if (j < 3)
+        {
+          float const expected_3 (lhs (j, 0) * v3.x + lhs (j, 1) * v3.y + lhs (j, 2) * v3.z + lhs (j, 3));
+          BOOST_CHECK_SMALL (product_3[j] - expected_3, 1e-2f);
+          BOOST_CHECK_EQUAL (products[0][j], product_3[j]);
+          BOOST_CHECK_EQUAL (products[1][j], product_3[j]);
+        }
+      }
+    }
+  }
 }
@@ -0,0 +1,181 @@
+#include <boost/test/unit_test.hpp>
+
+#include <math/ray.hpp>
+#include <math/triangle_bvh.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace math
+{
+  namespace
+  {
+    struct triangle_soup
+    {
+      std::vector<vector_3d> vertices;
+      std::vector<std::uint32_t> indices;
+    };
+
+    //! small triangles scattered in a box plus a few large ones crossing
+    //! it, sharing vertices like a model would
+    triangle_soup random_soup (std::mt19937& engine, std::size_t count)
+    {
+      std::uniform_real_distribution<float> position (-50.f, 50.f);
+      std::uniform_real_distribution<float> offset (-4.f, 4.f);
+
+      triangle_soup soup;
+      for (std::size_t i (0); i < count; ++i)
+      {
+        vector_3d const center (position (engine), position (engine), position (engine));
+        float const scale (i % 50 == 0 ? 10.f : 1.f);
+        for (int corner (0); corner < 3; ++corner)
+        {
+          soup.vertices.emplace_back
+            (center + vector_3d (offset (engine), offset (engine), offset (engine)) * scale);
+        }
+      }
+
+      std::uniform_int_distribution<std::uint32_t> vertex (0, soup.vertices.size() - 1);
+      for (std::size_t i (0); i < count; ++i)
+      {
+        soup.indices.push_back (3 * i);
+        soup.indices.push_back (3 * i + 1);
+        // every tenth triangle borrows a vertex of another one
+        soup.indices.push_back (i % 10 == 0 ? vertex (engine) : 3 * i + 2);
+      }
+      // duplicated triangles have to be reported twice
+      soup.indices.insert (soup.indices.end(), soup.indices.begin(), soup.indices.begin() + 30);
+
+      return soup;
+    }
+
+    std::vector<float> brute_force (triangle_soup const& soup, ray const& ray)
+    {
+      std::vector<float> distances;
+      for (std::size_t i (0); i < soup.indices.size(); i += 3)
+      {
+        if ( auto distance = ray.intersect_triangle ( soup.vertices[soup.indices[i]]
+                                                    , soup.vertices[soup.indices[i + 1]]
+                                                    , soup.vertices[soup.indices[i + 2]]
+                                                    )
+           )
+        {
+          distances.push_back (*distance);
+        }
+      }
+      std::sort (distances.begin(), distances.end());
+      return distances;
+    }
+
+    std::vector<float> hits (triangle_bvh const& bvh, ray const& ray)
+    {
+      std::vector<float> distances;
+      bvh.intersect (ray, distances);
+      std::sort (distances.begin(), distances.end());
+      return distances;
+    }
+
+    //! rays from outside and inside the soup, aimed at random vertices so
+    //! that many of them hit something, plus axis aligned ones
+    std::vector<ray> random_rays (std::mt19937& engine, triangle_soup const& soup, std::size_t count)
+    {
+      std::uniform_real_distribution<float> position (-80.f, 80.f);
+      std::uniform_real_distribution<float> jitter (-0.5f, 0.5f);
+      std::uniform_int_distribution<std::size_t> vertex (0, soup.vertices.size() - 1);
+
+      std::vector<ray> rays;
+      for (std::size_t i (0); i < count; ++i)
+      {
+        vector_3d const origin (position (engine), position (engine), position (engine));
+        vector_3d const target
+          (soup.vertices[vertex (engine)] + vector_3d (jitter (engine), jitter (engine), jitter (engine)));
+
+        if (i % 8 == 0)
+        {
+          rays.emplace_back (origin, vector_3d (0.f, i % 16 == 0 ? -1.f : 1.f, 0.f));
+        }
+        else
+        {
+          rays.emplace_back (origin, target - origin);
+        }
+      }
+      return rays;
+    }
+  }
+
+  BOOST_AUTO_TEST_CASE (triangle_bvh_matches_brute_force)
+  {
+    std::mt19937 engine (42);
+
+    for (std::size_t count : {0u, 1u, 3u, 17u, 1000u})
+    {
+      triangle_soup const soup (random_soup (engine, std::max<std::size_t> (count, 10)));
+      triangle_soup const used { soup.vertices
+                               , std::vector<std::uint32_t> (soup.indices.begin(), soup.indices.begin() + 3 * count)
+                               };
+      triangle_bvh const bvh (used.vertices, used.indices);
+
+      BOOST_CHECK_EQUAL (bvh.triangle_count(), count);
+
+      std::size_t hit_rays (0);
+      for (ray const& ray : random_rays (engine, used, 2000))
+      {
+        std::vector<float> const expected (brute_force (used, ray));
+        BOOST_REQUIRE (hits (bvh, ray) == expected);
+        hit_rays += !expected.empty();
+      }
+
+      if (count >= 17)
+      {
+        BOOST_CHECK_GT (hit_rays, 100u);
+      }
+    }
+  }
+
+  BOOST_AUTO_TEST_CASE (triangle_bvh_reports_duplicates)
+  {
+    std::mt19937 engine (7);
+    triangle_soup const soup (random_soup (engine, 200));
+    triangle_bvh const bvh (soup.vertices, soup.indices);
+
+    vector_3d const center ( ( soup.vertices[soup.indices[0]]
+                             + soup.vertices[soup.indices[1]]
+                             + soup.vertices[soup.indices[2]]
+                             ) * (1.f / 3.f)
+                           );
+    ray const ray (center + vector_3d (0.f, 100.f, 0.f), vector_3d (0.f, -1.f, 0.f));
+
+    std::vector<float> const distances (hits (bvh, ray));
+    BOOST_CHECK (distances == brute_force (soup, ray));
+    BOOST_CHECK_GE (std::count_if ( distances.begin(), distances.end()
+                                  , [&] (float d) { return std::abs (ray.position (d).x - center.x) < 1e-3f; }
+                                  )
+                   , 2
+                   );
+  }
+
+  BOOST_AUTO_TEST_CASE (triangle_bvh_refit_follows_moved_vertices)
+  {
+    std::mt19937 engine (1337);
+    triangle_soup soup (random_soup (engine, 500));
+    triangle_bvh bvh (soup.vertices, soup.indices);
+
+    // an animation moves the vertices far from where the tree was built
+    std::uniform_real_distribution<float> move (-30.f, 30.f);
+    vector_3d const shift (60.f, 0.f, 0.f);
+    for (std::size_t i (0); i < soup.vertices.size(); ++i)
+    {
+      soup.vertices[i] = soup.vertices[i] * 0.5f
+        + (i % 3 == 0 ? shift : vector_3d (move (engine), move (engine), move (engine)));
+    }
+    bvh.refit (soup.vertices);
+
+    for (ray const& ray : random_rays (engine, soup, 2000))
+    {
+      BOOST_REQUIRE (hits (bvh, ray) == brute_force (soup, ray));
+    }
+  }
+}
@@ -0,0 +1,145 @@
+#include <boost/test/unit_test.hpp>
+
+#include <math/vector_3d.hpp>
+#include <noggit/animation_track.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <random>
+#include <vector>
+
+namespace
+{
+  //! the linear scan M2Value::getValue used before the tracks got a cursor
+  template<typename T>
+    T reference_value (Animation::track<T> const& track, uint32_t time, Animation::Interpolation::Type::Type_t type)
+  {
+    if (track.data.empty())
+    {
+      return T();
+    }
+
+    T result = track.data[0];
+
+    if (!track.times.empty())
+    {
+      uint32_t max_time = track.times.back();
+      time = max_time > 0 ? time % max_time : 0;
+
+      size_t pos = 0;
+      for (size_t i = 0; i < track.times.size() - 1; ++i)
+      {
+        if (time >= track.times[i] && time < track.times[i + 1])
+        {
+          pos = i;
+          break;
+        }
+      }
+
+      if (pos == track.times.size() - 1 || type == Animation::Interpolation::Type::NONE)
+      {
+        result = track.data[pos];
+      }
+      else
+      {
+        uint32_t t1 = track.times[pos];
+        uint32_t t2 = track.times[pos + 1];
+        const float percentage = (time - t1) / static_cast<float>(t2 - t1);
+
+        if (type == Animation::Interpolation::Type::LINEAR)
+        {
+          result = math::interpolation::linear (percentage, track.data[pos], track.data[pos + 1]);
+        }
+        else
+        {
+          result = math::interpolation::hermite (percentage, track.data[pos], track.data[pos + 1], track.in[pos], track.out[pos]);
+        }
+      }
+    }
+
+    return result;
+  }
+
+  //! bitwise, broken tracks interpolate between equal timestamps into NaNs
+  template<typename T>
+    bool same (T const& lhs, T const& rhs)
+  {
+    return !std::memcmp (&lhs, &rhs, sizeof (T));
+  }
+
+  template<typename T, typename Random>
+    Animation::track<T> random_track (std::mt19937& engine, Random&& random_value, bool sorted)
+  {
+    std::uniform_int_distribution<size_t> count (0, 24);
+    std::uniform_int_distribution<uint32_t> timestamp (0, 5000);
+
+    Animation::track<T> track;
+
+    size_t const keys (count (engine));
+    for (size_t i (0); i < keys; ++i)
+    {
+      // small ranges so duplicated timestamps happen too
+      track.times.push_back (timestamp (engine) / (i % 3 ? 1 : 250) * (i % 3 ? 1 : 250));
+      track.data.push_back (random_value());
+      track.in.push_back (random_value());
+      track.out.push_back (random_value());
+    }
+
+    if (sorted)
+    {
+      std::sort (track.times.begin(), track.times.end());
+    }
+
+    track.timestamps_changed();
+    return track;
+  }
+
+  template<typename T, typename Random>
+    void compare_random_tracks (Random&& random_value)
+  {
+    std::mt19937 engine (0x6d32);
+    std::uniform_int_distribution<uint32_t> any_time (0, 20000);
+    std::uniform_int_distribution<uint32_t> step (0, 40);
+
+    for (size_t n (0); n < 2000; ++n)
+    {
+      auto track (random_track<T> (engine, random_value, n % 5 != 0));
+
+      for ( auto type : { Animation::Interpolation::Type::NONE
+                        , Animation::Interpolation::Type::LINEAR
+                        , Animation::Interpolation::Type::HERMITE
+                        }
+          )
+      {
+        // monotonic time like a running animation, then random jumps
+        uint32_t time (0);
+        for (size_t i (0); i < 300; ++i)
+        {
+          time += step (engine);
+          BOOST_REQUIRE (same (track.value (time, type), reference_value (track, time, type)));
+        }
+        for (size_t i (0); i < 100; ++i)
+        {
+          uint32_t const random_time (any_time (engine));
+          BOOST_REQUIRE (same (track.value (random_time, type), reference_value (track, random_time, type)));
+        }
+      }
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE (float_tracks_match_linear_scan)
+{
+  std::mt19937 engine (42);
+  std::uniform_real_distribution<float> value (-10.f, 10.f);
+
+  compare_random_tracks<float> ([&] { return value (engine); });
+}
+
+BOOST_AUTO_TEST_CASE (vector_tracks_match_linear_scan)
+{
+  std::mt19937 engine (43);
+  std::uniform_real_distribution<float> value (-10.f, 10.f);
+
+  compare_random_tracks<math::vector_3d> ([&] { return math::vector_3d (value (engine), value (engine), value (engine)); });
+}
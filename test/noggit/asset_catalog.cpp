@@ -0,0 +1,143 @@
+#include <boost/test/unit_test.hpp>
+
+#include <noggit/asset_catalog.hpp>
+
+#include <algorithm>
+#include <random>
+#include <regex>
+#include <string>
+#include <vector>
+
+BOOST_AUTO_TEST_CASE (imported_model_path_matches_the_regex_it_replaces)
+{
+  std::regex const regex ("[^\\.]+\\.(m2|wmo)"), wmo_group (".*_[0-9]{3}\\.wmo");
+
+  std::vector<std::string> lines
+    { "", ".", ".m2", "a.m2", "world/a.m2", "world/a.mdx", "a..m2", "a.b.wmo"
+    , "world/wmo/a_000.wmo", "world/wmo/a_00.wmo", "world/wmo/a_000.wmo.m2"
+    , "x.wmox", "x.m", "a\r_000.wmo", "a.m2\r", "1.2.3.m2 and b.wmo"
+    };
+
+  std::mt19937 random (1);
+  std::string const alphabet ("ab_0./mw2o\r");
+  for (int i (0); i < 20000; ++i)
+  {
+    std::string line (random() % 16, ' ');
+    for (char& c : line)
+    {
+      c = alphabet[random() % alphabet.size()];
+    }
+    if (random() % 2)
+    {
+      line += random() % 2 ? ".wmo" : "_123.wmo";
+    }
+    lines.emplace_back (line);
+  }
+
+  for (auto const& line : lines)
+  {
+    std::smatch match;
+    bool const expected ( std::regex_search (line, match, regex)
+                       && !std::regex_match (line, wmo_group)
+                        );
+
+    auto const path (noggit::imported_model_path (line));
+    BOOST_REQUIRE_EQUAL (!!path, expected);
+    if (expected)
+    {
+      BOOST_CHECK_EQUAL (*path, match.str (0));
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE (assets_are_classified_by_type)
+{
+  BOOST_CHECK (noggit::classify_asset ("world/a/b.m2") == noggit::asset_type::model);
+  BOOST_CHECK (noggit::classify_asset ("world/wmo/b.wmo") == noggit::asset_type::wmo);
+  BOOST_CHECK (noggit::classify_asset ("world/wmo/b_012.wmo") == noggit::asset_type::other);
+  BOOST_CHECK (noggit::classify_asset ("tileset/grass/a.blp") == noggit::asset_type::tileset);
+  BOOST_CHECK (noggit::classify_asset ("textures/a.blp") == noggit::asset_type::other);
+  BOOST_CHECK (noggit::classify_asset ("world/a/b.mdx") == noggit::asset_type::other);
+
+  noggit::asset_catalog catalog;
+  catalog.add ( { "tileset/a.blp", "tileset/a_s.blp", "tileset/b.blp"
+                , "world/a.m2", "world/a.m2", "world/a.skin"
+                }
+              );
+
+  BOOST_CHECK_EQUAL (catalog.size(), 3);
+  BOOST_CHECK (catalog.has_specular_variant ("tileset/a.blp"));
+  BOOST_CHECK (!catalog.has_specular_variant ("tileset/b.blp"));
+  BOOST_CHECK ( catalog.matching ("", {noggit::asset_type::tileset})
+             == (std::vector<std::string> {"tileset/a.blp", "tileset/b.blp"})
+              );
+}
+
+BOOST_AUTO_TEST_CASE (matching_equals_a_substring_search)
+{
+  std::mt19937 random (2);
+  std::string const alphabet ("abcdef/_");
+  std::vector<std::string> extensions {".m2", ".wmo", "_001.wmo", ".blp"};
+
+  noggit::asset_catalog catalog;
+  std::vector<std::string> added;
+  for (int i (0); i < 5000; ++i)
+  {
+    std::string name ((random() % 2 ? "tileset/" : "world/") + std::string (random() % 10, ' '));
+    for (std::size_t c (name.find (' ')); c < name.size(); ++c)
+    {
+      name[c] = alphabet[random() % alphabet.size()];
+    }
+    name += extensions[random() % extensions.size()];
+
+    catalog.add (name);
+    added.emplace_back (name);
+  }
+
+  std::vector<std::string> filters {"", "a", "ab", "abc", "set/", ".m2", "zzz", "d_c"};
+  for (int i (0); i < 200; ++i)
+  {
+    filters.emplace_back (added[random() % added.size()].substr (random() % 8, 1 + random() % 6));
+  }
+
+  for (auto const& filter : filters)
+  {
+    std::vector<std::string> expected;
+    for (auto const& name : added)
+    {
+      auto const type (noggit::classify_asset (name));
+      if ( (type == noggit::asset_type::model || type == noggit::asset_type::wmo)
+        && name.find (filter) != std::string::npos
+        && std::find (expected.begin(), expected.end(), name) == expected.end()
+         )
+      {
+        expected.emplace_back (name);
+      }
+    }
+
+    auto const result
+      (catalog.matching (filter, {noggit::asset_type::model, noggit::asset_type::wmo}));
+    BOOST_CHECK_EQUAL_COLLECTIONS (result.begin(), result.end(), expected.begin(), expected.end());
+  }
+}
+
+BOOST_AUTO_TEST_CASE (adding_updates_the_revision)
+{
+  noggit::asset_catalog catalog;
+  auto const initial (catalog.revision());
+
+  catalog.add ("world/maps/a.m2");
+  BOOST_CHECK_GT (catalog.revision(), initial);
+
+  auto const after_add (catalog.revision());
+  catalog.add ("world/maps/a.m2");
+  catalog.add ("world/maps/a.adt");
+  BOOST_CHECK_EQUAL (catalog.revision(), after_add);
+
+  BOOST_CHECK_EQUAL (catalog.matching ("maps/a", {noggit::asset_type::model}).size(), 1);
+
+  catalog.clear();
+  BOOST_CHECK_EQUAL (catalog.size(), 0);
+  BOOST_CHECK (catalog.matching ("maps/a", {noggit::asset_type::model}).empty());
+  BOOST_CHECK_GT (catalog.revision(), after_add);
+}
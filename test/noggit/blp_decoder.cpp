@@ -0,0 +1,229 @@
+#include <boost/test/unit_test.hpp>
+
+#include <noggit/blp_decoder.hpp>
+
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+namespace
+{
+  using bytes = std::vector<std::uint8_t>;
+
+  //! a BLP2 file with the given mipmaps stored back to back after the palette
+  std::vector<char> synthetic_blp ( int compression
+                                  , int alpha_depth
+                                  , int alpha_type
+                                  , int width
+                                  , int height
+                                  , std::vector<bytes> const& mips
+                                  , bytes const& palette = bytes (256 * 4, 0)
+                                  )
+  {
+    BLPHeader header;
+    std::memset (&header, 0, sizeof (header));
+    std::memcpy (&header.magix, "BLP2", 4);
+    header.version = 1;
+    header.attr_0_compression = static_cast<std::uint8_t> (compression);
+    header.attr_1_alphadepth = static_cast<std::uint8_t> (alpha_depth);
+    header.attr_2_alphatype = static_cast<std::uint8_t> (alpha_type);
+    header.attr_3_mipmaplevels = mips.size() > 1;
+    header.resx = width;
+    header.resy = height;
+
+    std::vector<char> file (sizeof (header) + palette.size());
+    std::memcpy (file.data() + sizeof (header), palette.data(), palette.size());
+
+    for (std::size_t i = 0; i < mips.size(); ++i)
+    {
+      header.offsets[i] = static_cast<std::int32_t> (file.size());
+      header.sizes[i] = static_cast<std::int32_t> (mips[i].size());
+      file.insert (file.end(), mips[i].begin(), mips[i].end());
+    }
+
+    std::memcpy (file.data(), &header, sizeof (header));
+    return file;
+  }
+
+  noggit::blp_image decode (std::vector<char> const& file, int mip = 0)
+  {
+    return noggit::decode_blp (file.data(), file.size(), mip);
+  }
+}
+
+BOOST_AUTO_TEST_CASE (paletted_without_alpha)
+{
+  bytes palette (256 * 4, 0);
+  // stored as b, g, r, a
+  palette[4 * 1 + 0] = 0x30; palette[4 * 1 + 1] = 0x20; palette[4 * 1 + 2] = 0x10; palette[4 * 1 + 3] = 0x00;
+  palette[4 * 2 + 0] = 0xcc; palette[4 * 2 + 1] = 0xbb; palette[4 * 2 + 2] = 0xaa; palette[4 * 2 + 3] = 0x00;
+
+  auto const image (decode (synthetic_blp (1, 0, 0, 2, 1, {{1, 2}}, palette)));
+
+  BOOST_REQUIRE_EQUAL (image.width, 2);
+  BOOST_REQUIRE_EQUAL (image.height, 1);
+  bytes const expected {0x10, 0x20, 0x30, 0xff, 0xaa, 0xbb, 0xcc, 0xff};
+  BOOST_CHECK_EQUAL_COLLECTIONS (image.rgba.begin(), image.rgba.end(), expected.begin(), expected.end());
+}
+
+BOOST_AUTO_TEST_CASE (paletted_alpha_depths)
+{
+  bytes palette (256 * 4, 0xff);
+
+  // 1 bit, lowest bit first
+  {
+    auto const image (decode (synthetic_blp (1, 1, 0, 4, 1, {{0, 0, 0, 0, 0x5}}, palette)));
+    BOOST_CHECK_EQUAL (image.rgba[3], 0xff);
+    BOOST_CHECK_EQUAL (image.rgba[7], 0x00);
+    BOOST_CHECK_EQUAL (image.rgba[11], 0xff);
+    BOOST_CHECK_EQUAL (image.rgba[15], 0x00);
+  }
+  // 4 bit, low nibble first
+  {
+    auto const image (decode (synthetic_blp (1, 4, 0, 2, 1, {{0, 0, 0xf1}}, palette)));
+    BOOST_CHECK_EQUAL (image.rgba[3], 0x11);
+    BOOST_CHECK_EQUAL (image.rgba[7], 0xff);
+  }
+  // 8 bit
+  {
+    auto const image (decode (synthetic_blp (1, 8, 0, 2, 1, {{0, 0, 0x42, 0x99}}, palette)));
+    BOOST_CHECK_EQUAL (image.rgba[3], 0x42);
+    BOOST_CHECK_EQUAL (image.rgba[7], 0x99);
+  }
+}
+
+BOOST_AUTO_TEST_CASE (dxt1_four_colors)
+{
+  // c0 = pure red, c1 = pure blue, c0 > c1 selects the four colour mode
+  // indices: row 0 = 0 1 2 3, the other rows use colour 0
+  bytes const block {0x00, 0xf8, 0x1f, 0x00, 0xe4, 0x00, 0x00, 0x00};
+  auto const image (decode (synthetic_blp (2, 0, 0, 4, 4, {block})));
+
+  BOOST_REQUIRE_EQUAL (image.rgba.size(), 4u * 4u * 4u);
+  bytes const row0 { 0xff, 0x00, 0x00, 0xff
+                   , 0x00, 0x00, 0xff, 0xff
+                   , 0xaa, 0x00, 0x55, 0xff
+                   , 0x55, 0x00, 0xaa, 0xff
+                   };
+  BOOST_CHECK_EQUAL_COLLECTIONS (image.rgba.begin(), image.rgba.begin() + 16, row0.begin(), row0.end());
+  for (std::size_t i = 16; i < image.rgba.size(); i += 4)
+  {
+    BOOST_CHECK_EQUAL (image.rgba[i], 0xff);
+    BOOST_CHECK_EQUAL (image.rgba[i + 2], 0x00);
+  }
+}
+
+BOOST_AUTO_TEST_CASE (dxt1_punch_through_alpha)
+{
+  // c0 <= c1 selects three colours plus transparent black
+  bytes const block {0x1f, 0x00, 0x00, 0xf8, 0xe4, 0x00, 0x00, 0x00};
+
+  auto const with_alpha (decode (synthetic_blp (2, 1, 0, 4, 4, {block})));
+  bytes const row0 { 0x00, 0x00, 0xff, 0xff
+                   , 0xff, 0x00, 0x00, 0xff
+                   , 0x7f, 0x00, 0x7f, 0xff
+                   , 0x00, 0x00, 0x00, 0x00
+                   };
+  BOOST_CHECK_EQUAL_COLLECTIONS (with_alpha.rgba.begin(), with_alpha.rgba.begin() + 16, row0.begin(), row0.end());
+
+  auto const without_alpha (decode (synthetic_blp (2, 0, 0, 4, 4, {block})));
+  BOOST_CHECK_EQUAL (without_alpha.rgba[15], 0xff);
+}
+
+BOOST_AUTO_TEST_CASE (dxt3_explicit_alpha)
+{
+  bytes block { 0x10, 0x32, 0x54, 0x76, 0x98, 0xba, 0xdc, 0xfe
+              , 0xe0, 0x07, 0xe0, 0x07, 0x00, 0x00, 0x00, 0x00
+              };
+  auto const image (decode (synthetic_blp (2, 8, 1, 4, 4, {block})));
+
+  for (int i = 0; i < 16; ++i)
+  {
+    BOOST_CHECK_EQUAL (image.rgba[i * 4 + 0], 0x00);
+    BOOST_CHECK_EQUAL (image.rgba[i * 4 + 1], 0xff);
+    BOOST_CHECK_EQUAL (image.rgba[i * 4 + 2], 0x00);
+    BOOST_CHECK_EQUAL (image.rgba[i * 4 + 3], i * 17);
+  }
+}
+
+BOOST_AUTO_TEST_CASE (dxt5_interpolated_alpha)
+{
+  // a0 = 255 > a1 = 0: eight alphas. Pixel i uses index i % 8.
+  std::uint64_t indices = 0;
+  for (int i = 0; i < 16; ++i)
+  {
+    indices |= static_cast<std::uint64_t> (i % 8) << (3 * i);
+  }
+
+  bytes block {0xff, 0x00};
+  for (int i = 0; i < 6; ++i)
+  {
+    block.push_back (static_cast<std::uint8_t> (indices >> (8 * i)));
+  }
+  block.insert (block.end(), {0xff, 0xff, 0xff, 0xff, 0x00, 0x00, 0x00, 0x00});
+
+  auto const image (decode (synthetic_blp (2, 8, 7, 4, 4, {block})));
+
+  std::uint8_t const expected[8] = {255, 0, 218, 182, 145, 109, 72, 36};
+  for (int i = 0; i < 16; ++i)
+  {
+    BOOST_CHECK_EQUAL (image.rgba[i * 4 + 0], 0xff);
+    BOOST_CHECK_EQUAL (image.rgba[i * 4 + 3], expected[i % 8]);
+  }
+}
+
+BOOST_AUTO_TEST_CASE (uncompressed_bgra)
+{
+  auto const image (decode (synthetic_blp (3, 8, 0, 1, 1, {{0x01, 0x02, 0x03, 0x04}})));
+  bytes const expected {0x03, 0x02, 0x01, 0x04};
+  BOOST_CHECK_EQUAL_COLLECTIONS (image.rgba.begin(), image.rgba.end(), expected.begin(), expected.end());
+}
+
+BOOST_AUTO_TEST_CASE (partial_blocks_and_mipmaps)
+{
+  bytes const red {0x00, 0xf8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
+  bytes const blue {0x1f, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
+  auto const file (synthetic_blp (2, 0, 0, 6, 2, {bytes (16, 0), red, blue}));
+
+  BOOST_CHECK_EQUAL (noggit::blp_mip_count (file.data(), file.size()), 3);
+  BOOST_CHECK_EQUAL (noggit::blp_mip_for_size (file.data(), file.size(), 3, 1), 1);
+  BOOST_CHECK_EQUAL (noggit::blp_mip_for_size (file.data(), file.size(), 1, 1), 2);
+  BOOST_CHECK_EQUAL (noggit::blp_mip_for_size (file.data(), file.size(), 6, 2), 0);
+
+  auto const mip1 (decode (file, 1));
+  BOOST_REQUIRE_EQUAL (mip1.width, 3);
+  BOOST_REQUIRE_EQUAL (mip1.height, 1);
+  bytes const expected { 0xff, 0x00, 0x00, 0xff, 0xff, 0x00, 0x00, 0xff, 0xff, 0x00, 0x00, 0xff };
+  BOOST_CHECK_EQUAL_COLLECTIONS (mip1.rgba.begin(), mip1.rgba.end(), expected.begin(), expected.end());
+
+  auto const mip2 (decode (file, 2));
+  BOOST_CHECK_EQUAL (mip2.width, 1);
+  BOOST_CHECK_EQUAL (mip2.rgba[2], 0xff);
+}
+
+BOOST_AUTO_TEST_CASE (short_mipmaps_are_padded)
+{
+  // a 4x4 DXT1 level needs 8 bytes, only the colours are stored
+  auto const image (decode (synthetic_blp (2, 0, 0, 4, 4, {{0x00, 0xf8, 0x00, 0x00}})));
+  for (std::size_t i = 0; i < image.rgba.size(); i += 4)
+  {
+    BOOST_CHECK_EQUAL (image.rgba[i], 0xff);
+  }
+}
+
+BOOST_AUTO_TEST_CASE (malformed_files_throw)
+{
+  auto file (synthetic_blp (2, 0, 0, 4, 4, {bytes (8, 0)}));
+
+  BOOST_CHECK_THROW (noggit::decode_blp (file.data(), 10, 0), std::runtime_error);
+  BOOST_CHECK_THROW (noggit::decode_blp (file.data(), file.size() - 1, 0), std::runtime_error);
+  BOOST_CHECK_THROW (noggit::decode_blp (file.data(), file.size(), 1), std::runtime_error);
+
+  auto wrong_magic (file);
+  wrong_magic[3] = '1';
+  BOOST_CHECK_THROW (noggit::decode_blp (wrong_magic.data(), wrong_magic.size(), 0), std::runtime_error);
+
+  auto unknown_compression (synthetic_blp (4, 0, 0, 1, 1, {bytes (4, 0)}));
+  BOOST_CHECK_THROW (noggit::decode_blp (unknown_compression.data(), unknown_compression.size(), 0), std::runtime_error);
+}
@@ -0,0 +1,204 @@
+#include <boost/test/unit_test.hpp>
+
+#include <noggit/chunk_stitching.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <numeric>
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace
+{
+  using chunk_vertices = std::array<math::vector_3d, 145>;
+
+  //! MapChunk::fixGapLeft()
+  bool fix_gap_left (math::vector_3d* chunk, math::vector_3d const* left)
+  {
+    bool changed = false;
+    for (size_t i = 0; i <= 136; i += 17)
+    {
+      float h = left[i + 8].y;
+      if (chunk[i].y != h)
+      {
+        chunk[i].y = h;
+        changed = true;
+      }
+    }
+    return changed;
+  }
+
+  //! MapChunk::fixGapAbove()
+  bool fix_gap_above (math::vector_3d* chunk, math::vector_3d const* above)
+  {
+    bool changed = false;
+    for (size_t i = 0; i < 9; i++)
+    {
+      float h = above[i + 136].y;
+      if (chunk[i].y != h)
+      {
+        chunk[i].y = h;
+        changed = true;
+      }
+    }
+    return changed;
+  }
+
+  //! World::fixAllGaps() as it was before stitching in parallel
+  void serial_stitch (std::vector<noggit::stitched_tile>& tiles)
+  {
+    for (auto& tile : tiles)
+    {
+      if (!tile.stitch)
+      {
+        continue;
+      }
+
+      if (tile.left)
+      {
+        for (size_t ty = 0; ty < 16; ty++)
+        {
+          tile.changed[ty * 16] |= fix_gap_left (tile.chunks[ty * 16], tile.left->chunks[ty * 16 + 15]);
+        }
+      }
+      if (tile.above)
+      {
+        for (size_t tx = 0; tx < 16; tx++)
+        {
+          tile.changed[tx] |= fix_gap_above (tile.chunks[tx], tile.above->chunks[240 + tx]);
+        }
+      }
+      for (size_t ty = 0; ty < 16; ty++)
+      {
+        for (size_t tx = 0; tx < 16; tx++)
+        {
+          math::vector_3d* chunk (tile.chunks[ty * 16 + tx]);
+          if (tx && fix_gap_left (chunk, tile.chunks[ty * 16 + tx - 1]))
+          {
+            tile.changed[ty * 16 + tx] = true;
+          }
+          if (ty && fix_gap_above (chunk, tile.chunks[(ty - 1) * 16 + tx]))
+          {
+            tile.changed[ty * 16 + tx] = true;
+          }
+        }
+      }
+    }
+  }
+
+  //! A random set of loaded tiles on a small grid, in a random order,
+  //! some of them only loaded as neighbours. Heights come from a few
+  //! values so that many fixes change nothing.
+  struct random_map
+  {
+    random_map (unsigned seed)
+    {
+      std::mt19937 engine (seed);
+      std::bernoulli_distribution loaded (0.7);
+      std::bernoulli_distribution stitched (0.8);
+      std::uniform_int_distribution<int> height (0, 3);
+
+      std::vector<std::pair<int, int>> positions;
+      for (int z (0); z < 4; ++z)
+      {
+        for (int x (0); x < 4; ++x)
+        {
+          if (loaded (engine))
+          {
+            positions.emplace_back (x, z);
+          }
+        }
+      }
+      std::shuffle (positions.begin(), positions.end(), engine);
+
+      vertices.resize (positions.size() * 256);
+      for (auto& chunk : vertices)
+      {
+        for (auto& vertex : chunk)
+        {
+          vertex.y = height (engine) * 0.25f;
+        }
+      }
+
+      tiles.resize (positions.size());
+      std::map<std::pair<int, int>, noggit::stitched_tile*> by_position;
+      for (std::size_t i (0); i < positions.size(); ++i)
+      {
+        for (std::size_t c (0); c < 256; ++c)
+        {
+          tiles[i].chunks[c] = vertices[i * 256 + c].data();
+        }
+        tiles[i].stitch = stitched (engine);
+        by_position[positions[i]] = &tiles[i];
+      }
+      for (std::size_t i (0); i < positions.size(); ++i)
+      {
+        auto const left (by_position.find ({positions[i].first - 1, positions[i].second}));
+        auto const above (by_position.find ({positions[i].first, positions[i].second - 1}));
+        tiles[i].left = left == by_position.end() ? nullptr : left->second;
+        tiles[i].above = above == by_position.end() ? nullptr : above->second;
+      }
+    }
+
+    random_map (random_map const&) = delete;
+
+    std::vector<chunk_vertices> vertices;
+    std::vector<noggit::stitched_tile> tiles;
+  };
+}
+
+BOOST_AUTO_TEST_CASE (stitching_in_parallel_matches_serial_stitching)
+{
+  for (unsigned seed (0); seed < 20; ++seed)
+  {
+    random_map serial (seed);
+    random_map parallel (seed);
+
+    serial_stitch (serial.tiles);
+    noggit::stitch_chunk_edges (parallel.tiles, seed % 2 ? 4 : 0);
+
+    BOOST_REQUIRE_EQUAL (serial.tiles.size(), parallel.tiles.size());
+    BOOST_CHECK ( std::memcmp ( serial.vertices.data(), parallel.vertices.data()
+                              , serial.vertices.size() * sizeof (chunk_vertices)
+                              ) == 0
+                );
+    for (std::size_t i (0); i < serial.tiles.size(); ++i)
+    {
+      BOOST_CHECK (serial.tiles[i].changed == parallel.tiles[i].changed);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE (stitched_edges_are_closed)
+{
+  random_map map (1234);
+  for (auto& tile : map.tiles)
+  {
+    tile.stitch = true;
+  }
+
+  noggit::stitch_chunk_edges (map.tiles);
+
+  for (auto const& tile : map.tiles)
+  {
+    for (std::size_t c (0); c < 256; ++c)
+    {
+      math::vector_3d const* chunk (tile.chunks[c]);
+      math::vector_3d const* left
+        (c % 16 ? tile.chunks[c - 1] : tile.left ? tile.left->chunks[c + 15] : nullptr);
+      math::vector_3d const* above
+        (c / 16 ? tile.chunks[c - 16] : tile.above ? tile.above->chunks[c + 240] : nullptr);
+
+      for (std::size_t row (1); row < 9 && left; ++row)
+      {
+        BOOST_CHECK_EQUAL (chunk[row * 17].y, left[row * 17 + 8].y);
+      }
+      for (std::size_t column (1); column < 9 && above; ++column)
+      {
+        BOOST_CHECK_EQUAL (chunk[column].y, above[136 + column].y);
+      }
+    }
+  }
+}
@@ -0,0 +1,115 @@
+#include <boost/test/unit_test.hpp>
+
+#include <noggit/DBCFile.h>
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace
+{
+  //! a WDBC with the given ids, a second column holding id * 2 and a third
+  //! pointing to the string "name <id>"
+  std::vector<char> synthetic_dbc (std::vector<std::uint32_t> const& ids)
+  {
+    std::vector<std::uint32_t> records;
+    std::string strings (1, '\0');
+
+    for (std::uint32_t id : ids)
+    {
+      records.push_back (id);
+      records.push_back (id * 2);
+      records.push_back (static_cast<std::uint32_t> (strings.size()));
+      strings += "name " + std::to_string (id) + '\0';
+    }
+
+    std::uint32_t const header[] = { static_cast<std::uint32_t> (ids.size()), 3, 12
+                                   , static_cast<std::uint32_t> (strings.size())
+                                   };
+
+    std::vector<char> buffer (4 + sizeof (header) + records.size() * 4 + strings.size());
+    std::memcpy (buffer.data(), "WDBC", 4);
+    std::memcpy (buffer.data() + 4, header, sizeof (header));
+    std::memcpy (buffer.data() + 4 + sizeof (header), records.data(), records.size() * 4);
+    std::memcpy (buffer.data() + 4 + sizeof (header) + records.size() * 4, strings.data(), strings.size());
+    return buffer;
+  }
+
+  DBCFile open_synthetic (std::vector<std::uint32_t> const& ids)
+  {
+    DBCFile dbc ("synthetic.dbc");
+    std::vector<char> const buffer (synthetic_dbc (ids));
+    dbc.open (buffer.data(), buffer.size());
+    return dbc;
+  }
+
+  void check_lookups (DBCFile& dbc, std::vector<std::uint32_t> const& ids)
+  {
+    for (std::uint32_t id : ids)
+    {
+      DBCFile::Record const record (dbc.getByID (id));
+      BOOST_CHECK_EQUAL (record.getUInt (0), id);
+      BOOST_CHECK_EQUAL (record.getUInt (1), id * 2);
+      BOOST_CHECK_EQUAL (record.getStringView (2), "name " + std::to_string (id));
+
+      // lookups on another field still scan
+      BOOST_CHECK_EQUAL (dbc.getByID (id * 2, 1).getUInt (0), id);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE (dense_ids)
+{
+  std::vector<std::uint32_t> ids;
+  for (std::uint32_t id (100); id < 1100; id += 3)
+  {
+    ids.push_back (id);
+  }
+
+  DBCFile dbc (open_synthetic (ids));
+  BOOST_REQUIRE_EQUAL (dbc.getRecordCount(), ids.size());
+  check_lookups (dbc, ids);
+
+  BOOST_CHECK_THROW (dbc.getByID (0), DBCFile::NotFound);
+  BOOST_CHECK_THROW (dbc.getByID (99), DBCFile::NotFound);
+  BOOST_CHECK_THROW (dbc.getByID (101), DBCFile::NotFound);
+  BOOST_CHECK_THROW (dbc.getByID (1100), DBCFile::NotFound);
+  BOOST_CHECK_THROW (dbc.getByID (0xFFFFFFFF), DBCFile::NotFound);
+}
+
+BOOST_AUTO_TEST_CASE (sparse_ids)
+{
+  std::vector<std::uint32_t> const ids {7, 100000, 42, 0xFFFFFFF0, 3000000};
+
+  DBCFile dbc (open_synthetic (ids));
+  check_lookups (dbc, ids);
+
+  BOOST_CHECK_THROW (dbc.getByID (8), DBCFile::NotFound);
+  BOOST_CHECK_THROW (dbc.getByID (0xFFFFFFFF), DBCFile::NotFound);
+}
+
+BOOST_AUTO_TEST_CASE (duplicated_ids_resolve_to_first_record)
+{
+  std::vector<std::uint32_t> const dense {5, 6, 5};
+  std::vector<std::uint32_t> const sparse {5, 100000, 5};
+
+  for (auto const& ids : {dense, sparse})
+  {
+    DBCFile dbc (open_synthetic (ids));
+    BOOST_CHECK_EQUAL (dbc.getByID (5).getStringView (2), "name 5");
+    BOOST_CHECK_EQUAL (dbc.getByID (5).getString (2), (*dbc.begin()).getString (2));
+  }
+}
+
+BOOST_AUTO_TEST_CASE (empty_and_invalid)
+{
+  DBCFile dbc (open_synthetic ({}));
+  BOOST_CHECK_EQUAL (dbc.getRecordCount(), 0u);
+  BOOST_CHECK_THROW (dbc.getByID (1), DBCFile::NotFound);
+
+  std::vector<char> truncated (synthetic_dbc ({1, 2, 3}));
+  truncated.resize (truncated.size() - 8);
+  DBCFile broken ("broken.dbc");
+  BOOST_CHECK_THROW (broken.open (truncated.data(), truncated.size()), std::runtime_error);
+}
@@ -0,0 +1,57 @@
+#include <boost/test/unit_test.hpp>
+
+#include <noggit/parallel_for.hpp>
+
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+BOOST_AUTO_TEST_CASE (every_index_is_visited_once)
+{
+  for (std::size_t threads : {0u, 1u, 3u, 64u})
+  {
+    std::vector<std::atomic<int>> visits (1000);
+    for (auto& v : visits)
+    {
+      v = 0;
+    }
+
+    noggit::parallel_for (visits.size(), [&] (std::size_t i) { ++visits[i]; }, threads);
+
+    for (auto const& v : visits)
+    {
+      BOOST_CHECK_EQUAL (v.load(), 1);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE (empty_ranges_call_nothing)
+{
+  bool called (false);
+  noggit::parallel_for (0, [&] (std::size_t) { called = true; });
+  BOOST_CHECK (!called);
+}
+
+BOOST_AUTO_TEST_CASE (exceptions_reach_the_caller)
+{
+  std::atomic<int> calls (0);
+
+  BOOST_CHECK_THROW
+    ( noggit::parallel_for
+        ( 10000
+        , [&] (std::size_t i)
+          {
+            ++calls;
+            if (i == 10)
+            {
+              throw std::runtime_error ("chunk 10 is broken");
+            }
+          }
+        , 4
+        )
+    , std::runtime_error
+    );
+
+  // the remaining indices are not handed out anymore
+  BOOST_CHECK_LT (calls.load(), 10000);
+}
@@ -0,0 +1,90 @@
+#include <boost/test/unit_test.hpp>
+
+#include <noggit/parked_tiles.hpp>
+
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <vector>
+
+namespace
+{
+  //! something shaped like an ADT: chunk headers, smooth heights, mostly
+  //! empty alphamaps and a few random bytes
+  std::vector<char> fake_adt (unsigned seed)
+  {
+    std::mt19937 engine (seed);
+    std::uniform_int_distribution<int> byte (0, 255);
+    std::vector<char> adt;
+
+    for (int chunk (0); chunk < 256; ++chunk)
+    {
+      char const header[] = "KNCM";
+      adt.insert (adt.end(), header, header + 4);
+
+      for (int vertex (0); vertex < 145; ++vertex)
+      {
+        float const height (100.f + chunk * 0.5f + vertex * 0.01f);
+        char bytes[sizeof (float)];
+        std::memcpy (bytes, &height, sizeof (float));
+        adt.insert (adt.end(), bytes, bytes + sizeof (float));
+      }
+
+      adt.insert (adt.end(), 2048, 0);
+
+      for (int i (0); i < 64; ++i)
+      {
+        adt.push_back (static_cast<char> (byte (engine)));
+      }
+    }
+
+    return adt;
+  }
+}
+
+BOOST_AUTO_TEST_CASE (parked_tiles_round_trip_losslessly)
+{
+  noggit::parked_tiles parked;
+  std::vector<char> const first (fake_adt (1));
+  std::vector<char> const second (fake_adt (2));
+
+  parked.park ({10, 20}, first);
+  parked.park ({20, 10}, second);
+
+  BOOST_CHECK (parked.contains ({10, 20}));
+  BOOST_CHECK (parked.contains ({20, 10}));
+  BOOST_CHECK (!parked.contains ({10, 10}));
+  BOOST_CHECK_EQUAL (parked.tiles().size(), 2u);
+  BOOST_CHECK_LT (parked.memory_usage(), (first.size() + second.size()) / 2);
+
+  auto const unparked (parked.unpark ({10, 20}));
+  BOOST_REQUIRE (unparked);
+  BOOST_CHECK (*unparked == first);
+
+  // unparking removes the tile
+  BOOST_CHECK (!parked.contains ({10, 20}));
+  BOOST_CHECK (!parked.unpark ({10, 20}));
+
+  BOOST_CHECK (*parked.unpark ({20, 10}) == second);
+  BOOST_CHECK (parked.empty());
+  BOOST_CHECK_EQUAL (parked.memory_usage(), 0u);
+}
+
+BOOST_AUTO_TEST_CASE (parking_again_replaces_the_tile)
+{
+  noggit::parked_tiles parked;
+
+  parked.park ({1, 2}, fake_adt (1));
+  parked.park ({1, 2}, fake_adt (3));
+
+  BOOST_CHECK_EQUAL (parked.tiles().size(), 1u);
+  BOOST_CHECK (*parked.unpark ({1, 2}) == fake_adt (3));
+}
+
+BOOST_AUTO_TEST_CASE (tiny_tiles_survive)
+{
+  noggit::parked_tiles parked;
+
+  parked.park ({0, 0}, std::vector<char> {'x'});
+  BOOST_CHECK (*parked.unpark ({0, 0}) == std::vector<char> {'x'});
+}
@@ -0,0 +1,153 @@
+#include <boost/test/unit_test.hpp>
+
+#include <math/interpolation.hpp>
+#include <noggit/particle_pool.hpp>
+
+#include <cstring>
+#include <list>
+#include <random>
+#include <vector>
+
+namespace
+{
+  template<class T>
+  T lifeRamp(float life, float mid, const T &a, const T &b, const T &c)
+  {
+    if (life <= mid) return math::interpolation::linear(life / mid, a, b);
+    else return math::interpolation::linear((life - mid) / (1.0f - mid), b, c);
+  }
+
+  //! the per-particle loop ParticleSystem::update used on a std::list
+  void reference_update (std::list<Particle>& particles, float dt, noggit::particle_update_parameters const& parameters)
+  {
+    float mspeed = 1.0f;
+
+    for (auto it = particles.begin(); it != particles.end();)
+    {
+      Particle &p = *it;
+      p.speed += p.down * parameters.gravity * dt - p.dir * parameters.deacceleration * dt;
+
+      if (parameters.slowdown > 0)
+      {
+        mspeed = expf(-1.0f * parameters.slowdown * p.life);
+      }
+      p.pos += p.speed * mspeed * dt;
+
+      p.life += dt;
+      float rlife = p.life / p.maxlife;
+      p.size = lifeRamp<float>(rlife, parameters.mid, parameters.sizes[0], parameters.sizes[1], parameters.sizes[2]);
+      p.color = lifeRamp<math::vector_4d>(rlife, parameters.mid, parameters.colors[0], parameters.colors[1], parameters.colors[2]);
+
+      if (rlife >= 1.0f)
+      {
+        it = particles.erase (it);
+      }
+      else
+      {
+        ++it;
+      }
+    }
+  }
+
+  template<typename T>
+    bool same (T const& lhs, T const& rhs)
+  {
+    return std::memcmp (&lhs, &rhs, sizeof (T)) == 0;
+  }
+
+  noggit::particle_update_parameters parameters (float slowdown)
+  {
+    return { 9.81f, 0.35f, slowdown, 0.4f
+           , {{0.5f, 2.f, 0.25f}}
+           , {{ math::vector_4d (1.f, 0.5f, 0.f, 0.f)
+              , math::vector_4d (0.8f, 0.8f, 0.2f, 1.f)
+              , math::vector_4d (0.1f, 0.1f, 0.1f, 0.f)
+             }}
+           };
+  }
+
+  //! origin.x holds a unique id to find the particle after swap-removes
+  Particle random_particle (std::mt19937& engine, float id)
+  {
+    std::uniform_real_distribution<float> value (-10.f, 10.f);
+    std::uniform_real_distribution<float> maxlife (0.5f, 3.f);
+
+    Particle p;
+    p.pos = {value (engine), value (engine), value (engine)};
+    p.speed = {value (engine), value (engine), value (engine)};
+    p.down = {0.f, -1.f, 0.f};
+    p.dir = math::vector_3d (value (engine), value (engine), value (engine)).normalize();
+    p.origin = {id, 0.f, 0.f};
+    p.size = 0.f;
+    p.life = 0.f;
+    p.maxlife = maxlife (engine);
+    p.tile = static_cast<unsigned int> (id);
+    return p;
+  }
+
+  void compare_with_reference (float slowdown)
+  {
+    std::mt19937 engine (slowdown > 0 ? 7 : 3);
+    std::list<Particle> reference;
+    noggit::particle_pool pool (1000);
+
+    for (int i = 0; i < 257; ++i)
+    {
+      Particle const p (random_particle (engine, static_cast<float> (i)));
+      reference.push_back (p);
+      BOOST_REQUIRE (pool.push_back (p));
+    }
+
+    for (int step = 0; step < 120; ++step)
+    {
+      reference_update (reference, 1.f / 30.f, parameters (slowdown));
+      pool.update (1.f / 30.f, parameters (slowdown));
+
+      BOOST_REQUIRE_EQUAL (pool.size(), reference.size());
+
+      std::vector<Particle const*> by_id (257, nullptr);
+      for (Particle const& p : reference)
+      {
+        by_id[static_cast<std::size_t> (p.origin.x)] = &p;
+      }
+
+      for (std::size_t i = 0; i < pool.size(); ++i)
+      {
+        Particle const* p (by_id[pool.tile (i)]);
+        BOOST_REQUIRE (p);
+        BOOST_REQUIRE (same (pool.position (i), p->pos));
+        BOOST_REQUIRE (same (pool.color (i), p->color));
+        BOOST_REQUIRE (same (pool.size (i), p->size));
+        BOOST_REQUIRE (same (pool.life (i), p->life));
+        BOOST_REQUIRE (same (pool.origin (i), p->origin));
+      }
+    }
+
+    BOOST_CHECK (pool.empty());
+  }
+}
+
+BOOST_AUTO_TEST_CASE (update_matches_per_particle_loop)
+{
+  compare_with_reference (0.f);
+}
+
+BOOST_AUTO_TEST_CASE (update_matches_per_particle_loop_with_slowdown)
+{
+  compare_with_reference (0.5f);
+}
+
+BOOST_AUTO_TEST_CASE (push_back_stops_at_capacity)
+{
+  std::mt19937 engine (1);
+  noggit::particle_pool pool (5);
+
+  for (int i = 0; i < 5; ++i)
+  {
+    BOOST_REQUIRE (pool.push_back (random_particle (engine, static_cast<float> (i))));
+  }
+
+  BOOST_CHECK_EQUAL (pool.available(), 0);
+  BOOST_CHECK (!pool.push_back (random_particle (engine, 5.f)));
+  BOOST_CHECK_EQUAL (pool.size(), 5);
+}
@@ -0,0 +1,61 @@
+#include <boost/test/unit_test.hpp>
+
+#include <noggit/scripting/script_exception.hpp>
+#include <noggit/scripting/script_kernel.hpp>
+
+#include <cstddef>
+#include <vector>
+
+namespace
+{
+  // a kernel that remembers how often it ran and bumps its parameter,
+  // neither of which must be visible to the next job
+  char const* const counting_kernel =
+    "counter = (counter or 0) + 1\n"
+    "result = counter * 1000 + params.offset\n"
+    "params.offset = params.offset + 1\n";
+
+  std::vector<int> run_counting_kernel (std::size_t jobs, std::size_t threads)
+  {
+    std::vector<int> results (jobs, -1);
+    noggit::scripting::run_kernel
+      ( "test", counting_kernel, {{"offset", 7.0}}, jobs
+      , [&] (std::size_t i, sol::environment& env, sol::protected_function const& kernel)
+        {
+          sol::protected_function_result result (kernel());
+          if (result.valid())
+          {
+            results[i] = env.get<int> ("result");
+          }
+          return result;
+        }
+      , threads
+      );
+    return results;
+  }
+}
+
+BOOST_AUTO_TEST_CASE (kernel_globals_do_not_leak_between_jobs)
+{
+  std::vector<int> const expected (64, 1007);
+  for (std::size_t threads : {1u, 2u, 3u, 64u})
+  {
+    std::vector<int> const results (run_counting_kernel (expected.size(), threads));
+    BOOST_CHECK_EQUAL_COLLECTIONS
+      (results.begin(), results.end(), expected.begin(), expected.end());
+  }
+}
+
+BOOST_AUTO_TEST_CASE (kernel_errors_reach_the_caller)
+{
+  BOOST_CHECK_THROW
+    ( noggit::scripting::run_kernel
+        ( "test", "error('broken')", {}, 4
+        , [] (std::size_t, sol::environment&, sol::protected_function const& kernel)
+          {
+            return kernel();
+          }
+        )
+    , noggit::scripting::script_exception
+    );
+}
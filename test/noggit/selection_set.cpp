@@ -0,0 +1,67 @@
+#include <boost/test/unit_test.hpp>
+#include <boost/variant/get.hpp>
+
+#include <noggit/ModelInstance.h>
+#include <noggit/selection_set.hpp>
+
+#include <cstdint>
+#include <list>
+#include <vector>
+
+namespace
+{
+  std::list<ModelInstance> make_instances (std::size_t count)
+  {
+    std::list<ModelInstance> instances;
+    ModelInstance const prototype ("world/generic/test/selection.m2");
+    for (std::size_t i (0); i < count; ++i)
+    {
+      instances.push_back (prototype);
+      instances.back().uid = static_cast<std::uint32_t> (i + 1);
+    }
+    return instances;
+  }
+}
+
+BOOST_AUTO_TEST_CASE (deleted_instances_leave_the_selection)
+{
+  std::list<ModelInstance> instances (make_instances (4));
+  auto it (instances.begin());
+  ModelInstance* const first (&*it++);
+  ModelInstance* const second (&*it++);
+  ModelInstance* const third (&*it++);
+  ModelInstance* const unselected (&*it++);
+
+  noggit::selection_set selection;
+  selection.add (first);
+  selection.add (second);
+  selection.add (third);
+
+  // what World::delete_models() does before deleting the instances, e.g.
+  // for a script removing a selected model
+  std::vector<selection_type> const deleted {second, unselected, third};
+  BOOST_CHECK (selection.remove (deleted));
+  BOOST_CHECK (!selection.remove (deleted));
+
+  BOOST_CHECK (!second->selected);
+  BOOST_CHECK (!third->selected);
+  BOOST_CHECK (!unselected->selected);
+  BOOST_CHECK (first->selected);
+
+  instances.remove_if ( [&] (ModelInstance const& instance)
+                        {
+                          return &instance == second || &instance == third || &instance == unselected;
+                        }
+                      );
+
+  BOOST_REQUIRE_EQUAL (selection.size(), 1);
+  BOOST_CHECK (boost::get<selected_model_type> (selection.entries().front()) == first);
+  BOOST_CHECK (!selection.contains (2));
+  BOOST_CHECK (!selection.contains (3));
+  BOOST_CHECK_EQUAL (selection.instance_count(), 1);
+
+  // only touches the remaining instance
+  selection.clear();
+  BOOST_CHECK (!first->selected);
+  BOOST_CHECK (selection.empty());
+}
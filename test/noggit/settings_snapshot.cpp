@@ -0,0 +1,163 @@
+#include <boost/test/unit_test.hpp>
+
+#include <noggit/AsyncLoader.h>
+#include <noggit/settings_snapshot.hpp>
+
+#include <atomic>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace
+{
+  struct loaded_object : AsyncObject
+  {
+    loaded_object (std::string const& name) : AsyncObject (name) {}
+
+    virtual void finishLoading() override
+    {
+      finished = true;
+      _state_changed.notify_all();
+    }
+  };
+
+  std::size_t occurrences (std::string const& text, std::string const& pattern)
+  {
+    std::size_t count (0);
+    for ( std::size_t pos (text.find (pattern))
+        ; pos != std::string::npos
+        ; pos = text.find (pattern, pos + 1)
+        )
+    {
+      ++count;
+    }
+    return count;
+  }
+}
+
+BOOST_AUTO_TEST_CASE (publish_replaces_the_current_snapshot)
+{
+  noggit::settings_snapshot const& before (noggit::current_settings());
+  float const previous_far_z (before.far_z);
+
+  noggit::settings_snapshot snapshot (before);
+  snapshot.far_z = previous_far_z + 100.f;
+  snapshot.wireframe_type = 1;
+  noggit::publish_settings (snapshot);
+
+  noggit::settings_snapshot const& after (noggit::current_settings());
+  BOOST_CHECK_EQUAL (after.far_z, previous_far_z + 100.f);
+  BOOST_CHECK_EQUAL (after.wireframe_type, 1);
+  BOOST_CHECK_EQUAL (after.generation, before.generation + 1);
+
+  // references to older snapshots stay valid and unchanged
+  BOOST_CHECK_EQUAL (before.far_z, previous_far_z);
+}
+
+BOOST_AUTO_TEST_CASE (subscribers_are_notified_until_destroyed)
+{
+  int calls (0);
+  bool last_tablet (false);
+
+  {
+    noggit::settings_subscription subscription
+      ( [&] (noggit::settings_snapshot const& snapshot)
+        {
+          ++calls;
+          last_tablet = snapshot.tablet_enabled;
+        }
+      );
+
+    noggit::settings_snapshot snapshot;
+    snapshot.tablet_enabled = true;
+    noggit::publish_settings (snapshot);
+
+    BOOST_CHECK_EQUAL (calls, 1);
+    BOOST_CHECK (last_tablet);
+
+    noggit::settings_subscription moved (std::move (subscription));
+    noggit::publish_settings (noggit::settings_snapshot());
+    BOOST_CHECK_EQUAL (calls, 2);
+    BOOST_CHECK (!last_tablet);
+  }
+
+  noggit::publish_settings (noggit::settings_snapshot());
+  BOOST_CHECK_EQUAL (calls, 2);
+}
+
+BOOST_AUTO_TEST_CASE (readers_see_whole_snapshots_while_publishing)
+{
+  {
+    noggit::settings_snapshot snapshot;
+    snapshot.wireframe_radius = snapshot.wireframe_width = -1.f;
+    noggit::publish_settings (snapshot);
+  }
+
+  std::atomic<bool> done (false);
+  std::atomic<int> torn (0);
+
+  std::vector<std::thread> readers;
+  for (int i = 0; i < 4; ++i)
+  {
+    readers.emplace_back ( [&]
+                           {
+                             while (!done)
+                             {
+                               noggit::settings_snapshot const& s (noggit::current_settings());
+                               if (s.wireframe_radius != s.wireframe_width)
+                               {
+                                 ++torn;
+                               }
+                             }
+                           }
+                         );
+  }
+
+  for (int i = 0; i < 1000; ++i)
+  {
+    noggit::settings_snapshot snapshot;
+    snapshot.wireframe_radius = snapshot.wireframe_width = static_cast<float> (i);
+    noggit::publish_settings (snapshot);
+  }
+
+  done = true;
+  for (auto& reader : readers)
+  {
+    reader.join();
+  }
+
+  BOOST_CHECK_EQUAL (torn.load(), 0);
+}
+
+BOOST_AUTO_TEST_CASE (the_loader_loop_takes_its_settings_from_the_snapshot)
+{
+  // this test links the loader without Qt, so it can't read QSettings: the
+  // logging setting only gets to it through the published snapshot
+  std::stringstream log;
+  std::streambuf* const clog_buffer (std::clog.rdbuf (log.rdbuf()));
+
+  {
+    AsyncLoader loader (2);
+
+    for (bool additional_log : {false, true, false})
+    {
+      noggit::settings_snapshot snapshot (noggit::current_settings());
+      snapshot.additional_file_loading_log = additional_log;
+      noggit::publish_settings (snapshot);
+
+      loaded_object object (additional_log ? "logged" : "silent");
+      loader.queue_for_load (&object);
+      object.wait_until_loaded();
+      loader.ensure_deletable (&object);
+    }
+  }
+
+  std::clog.rdbuf (clog_buffer);
+
+  BOOST_CHECK_EQUAL (occurrences (log.str(), "Loading 'logged'"), 1);
+  BOOST_CHECK_EQUAL (occurrences (log.str(), "Loaded  'logged'"), 1);
+  BOOST_CHECK_EQUAL (occurrences (log.str(), "silent"), 0);
+}
@@ -0,0 +1,198 @@
+#include <boost/test/unit_test.hpp>
+
+#include <noggit/tile_pipeline.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace
+{
+  //! a map whose tiles are byte buffers "converted" in place, standing in
+  //! for the loading, alphamap conversion and saving of real ADTs
+  struct synthetic_map
+  {
+    synthetic_map()
+    {
+      for (std::size_t z (0); z < 64; ++z)
+      {
+        for (std::size_t x (0); x < 64; ++x)
+        {
+          if ((x * 7 + z * 3) % 5 != 0)
+          {
+            tiles.emplace_back (x, z);
+
+            std::vector<std::uint8_t>& file (files[key (tiles.back())]);
+            for (std::size_t i (0); i < 256 + (x ^ z); ++i)
+            {
+              file.push_back (static_cast<std::uint8_t> (x * 31 + z * 17 + i));
+            }
+          }
+        }
+      }
+    }
+
+    static std::pair<std::size_t, std::size_t> key (tile_index const& tile)
+    {
+      return {tile.x, tile.z};
+    }
+
+    static void convert (std::vector<std::uint8_t>& data)
+    {
+      std::uint8_t carry (0);
+      for (auto& byte : data)
+      {
+        byte = static_cast<std::uint8_t> ((byte >> 4 | byte << 4) ^ carry);
+        carry = byte;
+      }
+    }
+
+    std::vector<tile_index> tiles;
+    std::map<std::pair<std::size_t, std::size_t>, std::vector<std::uint8_t>> files;
+  };
+
+  //! the map index's side of things: tiles are created and destroyed on
+  //! the calling thread only
+  struct loaded_tiles
+  {
+    std::mutex mutex;
+    std::map<std::pair<std::size_t, std::size_t>, std::unique_ptr<std::vector<std::uint8_t>>> tiles;
+    std::size_t peak = 0;
+  };
+
+  void convert_in_pipeline ( synthetic_map& map
+                           , std::size_t threads
+                           , std::size_t max_in_flight
+                           , loaded_tiles& loaded
+                           )
+  {
+    noggit::tile_pipeline_stages stages;
+    stages.start = [&] (tile_index const& tile)
+    {
+      std::lock_guard<std::mutex> const lock (loaded.mutex);
+      loaded.tiles[synthetic_map::key (tile)].reset (new std::vector<std::uint8_t>);
+      loaded.peak = std::max (loaded.peak, loaded.tiles.size());
+      return true;
+    };
+    stages.work = [&] (tile_index const& tile)
+    {
+      std::vector<std::uint8_t>* data;
+      {
+        std::lock_guard<std::mutex> const lock (loaded.mutex);
+        data = loaded.tiles.at (synthetic_map::key (tile)).get();
+      }
+
+      // every file is written by exactly one worker
+      std::vector<std::uint8_t>& file (map.files.at (synthetic_map::key (tile)));
+      *data = file;
+      synthetic_map::convert (*data);
+      file = *data;
+    };
+    stages.finish = [&] (tile_index const& tile)
+    {
+      std::lock_guard<std::mutex> const lock (loaded.mutex);
+      loaded.tiles.erase (synthetic_map::key (tile));
+    };
+
+    BOOST_REQUIRE (noggit::run_tile_pipeline (map.tiles, stages, {}, threads, max_in_flight));
+  }
+}
+
+BOOST_AUTO_TEST_CASE (output_matches_the_serial_conversion)
+{
+  synthetic_map serial;
+  for (auto& file : serial.files)
+  {
+    synthetic_map::convert (file.second);
+  }
+
+  for (std::size_t threads : {1u, 3u, 8u})
+  {
+    synthetic_map pipelined;
+    loaded_tiles loaded;
+
+    convert_in_pipeline (pipelined, threads, 5, loaded);
+
+    BOOST_CHECK (pipelined.files == serial.files);
+    BOOST_CHECK (loaded.tiles.empty());
+    BOOST_CHECK_LE (loaded.peak, 5u);
+  }
+}
+
+BOOST_AUTO_TEST_CASE (cancelling_finishes_the_started_tiles)
+{
+  std::vector<tile_index> tiles;
+  for (std::size_t i (0); i < 100; ++i)
+  {
+    tiles.emplace_back (i % 64, i / 64);
+  }
+
+  std::size_t started (0);
+  std::atomic<std::size_t> worked (0);
+  std::size_t finished (0);
+  std::size_t last_done (0);
+
+  noggit::tile_pipeline_stages stages;
+  stages.start = [&] (tile_index const&) { ++started; return true; };
+  stages.work = [&] (tile_index const&) { ++worked; };
+  stages.finish = [&] (tile_index const&) { ++finished; };
+
+  bool const completed
+    ( noggit::run_tile_pipeline
+        ( tiles
+        , stages
+        , [&] (std::size_t done, std::size_t total)
+          {
+            BOOST_CHECK_EQUAL (total, tiles.size());
+            BOOST_CHECK_EQUAL (done, last_done + 1);
+            last_done = done;
+            return done < 10;
+          }
+        , 4
+        , 4
+        )
+    );
+
+  BOOST_CHECK (!completed);
+  BOOST_CHECK_LT (started, tiles.size());
+  BOOST_CHECK_EQUAL (worked.load(), started);
+  BOOST_CHECK_EQUAL (finished, started);
+}
+
+BOOST_AUTO_TEST_CASE (skipped_tiles_are_reported_and_errors_rethrown)
+{
+  std::vector<tile_index> tiles;
+  for (std::size_t x (0); x < 64; ++x)
+  {
+    tiles.emplace_back (x, 0);
+  }
+
+  std::size_t reported (0);
+  std::size_t finished (0);
+
+  noggit::tile_pipeline_stages stages;
+  stages.start = [&] (tile_index const& tile) { return tile.x % 2 == 0; };
+  stages.work = [&] (tile_index const& tile)
+  {
+    if (tile.x == 40)
+    {
+      throw std::runtime_error ("tile 40 is broken");
+    }
+  };
+  stages.finish = [&] (tile_index const&) { ++finished; };
+
+  BOOST_CHECK_THROW
+    ( noggit::run_tile_pipeline
+        (tiles, stages, [&] (std::size_t, std::size_t) { ++reported; return true; }, 2, 2)
+    , std::runtime_error
+    );
+
+  BOOST_CHECK_GE (reported, 40u);
+  BOOST_CHECK_LT (reported, tiles.size());
+  BOOST_CHECK_LT (finished, 32u);
+}
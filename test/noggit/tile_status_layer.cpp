@@ -0,0 +1,112 @@
+#include <boost/test/unit_test.hpp>
+
+#include <noggit/tile_status_layer.hpp>
+
+#include <QtGui/QGuiApplication>
+
+#include <cstdlib>
+
+namespace
+{
+  //! run with QT_QPA_PLATFORM=offscreen on machines without a display
+  struct gui_application
+  {
+    gui_application() : application (argc, argv) {}
+
+    int argc = 1;
+    char name[12] = "noggit-test";
+    char* argv[2] = {name, nullptr};
+    QGuiApplication application;
+  };
+
+  BOOST_GLOBAL_FIXTURE (gui_application);
+
+  //! the raster engine may round differently when clipped
+  bool nearly_equal (QImage const& lhs, QImage const& rhs)
+  {
+    if (lhs.size() != rhs.size() || lhs.format() != rhs.format())
+    {
+      return false;
+    }
+
+    for (int y (0); y < lhs.height(); ++y)
+    {
+      for (int x (0); x < lhs.width(); ++x)
+      {
+        QRgb const a (lhs.pixel (x, y));
+        QRgb const b (rhs.pixel (x, y));
+
+        for (int shift : {0, 8, 16, 24})
+        {
+          if (std::abs (int ((a >> shift) & 0xff) - int ((b >> shift) & 0xff)) > 1)
+          {
+            return false;
+          }
+        }
+      }
+    }
+
+    return true;
+  }
+}
+
+BOOST_AUTO_TEST_CASE (only_actual_changes_count)
+{
+  noggit::tile_status_layer layer;
+
+  BOOST_CHECK (layer.get (tile_index (3, 4)) == noggit::tile_status::none);
+  BOOST_CHECK_EQUAL (layer.revision(), 0u);
+
+  layer.set (tile_index (3, 4), noggit::tile_status::loaded);
+  layer.set (tile_index (3, 4), noggit::tile_status::loaded);
+  layer.set (tile_index (64, 0), noggit::tile_status::loaded);
+
+  BOOST_CHECK (layer.get (tile_index (3, 4)) == noggit::tile_status::loaded);
+  BOOST_CHECK (layer.get (tile_index (4, 3)) == noggit::tile_status::none);
+  BOOST_CHECK_EQUAL (layer.revision(), 1u);
+}
+
+BOOST_AUTO_TEST_CASE (image_is_kept_until_a_status_changes)
+{
+  noggit::tile_status_layer layer;
+  layer.set (tile_index (10, 10), noggit::tile_status::unloaded);
+
+  qint64 const key (layer.image (4).cacheKey());
+  BOOST_CHECK_EQUAL (layer.image (4).cacheKey(), key);
+
+  layer.set (tile_index (10, 10), noggit::tile_status::unloaded);
+  BOOST_CHECK_EQUAL (layer.image (4).cacheKey(), key);
+
+  layer.set (tile_index (10, 10), noggit::tile_status::changed);
+  BOOST_CHECK_NE (layer.image (4).cacheKey(), key);
+}
+
+BOOST_AUTO_TEST_CASE (partial_redraws_match_a_full_redraw)
+{
+  for (int tile_size : {1, 2, 3, 10})
+  {
+    noggit::tile_status_layer updated;
+    for (std::size_t x (0); x < 64; x += 2)
+    {
+      updated.set (tile_index (x, x / 2), noggit::tile_status::unloaded);
+    }
+    updated.image (tile_size);
+
+    updated.set (tile_index (0, 0), noggit::tile_status::loaded);
+    updated.set (tile_index (1, 0), noggit::tile_status::changed);
+    updated.set (tile_index (20, 10), noggit::tile_status::external);
+    updated.set (tile_index (63, 63), noggit::tile_status::changed);
+    updated.set (tile_index (30, 15), noggit::tile_status::none);
+
+    noggit::tile_status_layer fresh;
+    for (std::size_t x (0); x < 64; ++x)
+    {
+      for (std::size_t z (0); z < 64; ++z)
+      {
+        fresh.set (tile_index (x, z), updated.get (tile_index (x, z)));
+      }
+    }
+
+    BOOST_CHECK (nearly_equal (updated.image (tile_size), fresh.image (tile_size)));
+  }
+}
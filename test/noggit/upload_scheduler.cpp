@@ -0,0 +1,112 @@
+#include <boost/test/unit_test.hpp>
+
+#include <noggit/upload_scheduler.hpp>
+
+#include <thread>
+#include <vector>
+
+BOOST_AUTO_TEST_CASE (frames_respect_the_byte_budget)
+{
+  noggit::upload_scheduler scheduler (100);
+  std::vector<int> order;
+
+  std::vector<noggit::upload_scheduler::ticket> tickets;
+  for (int i = 0; i < 5; ++i)
+  {
+    tickets.emplace_back (scheduler.enqueue (40, [&order, i] { order.push_back (i); }));
+  }
+
+  auto const first (scheduler.run_frame());
+  BOOST_CHECK_EQUAL (first.uploads, 2u);
+  BOOST_CHECK_EQUAL (first.uploaded_bytes, 80u);
+  BOOST_CHECK_EQUAL (first.queue_depth, 3u);
+  BOOST_CHECK_EQUAL (first.queued_bytes, 120u);
+
+  auto const second (scheduler.run_frame());
+  BOOST_CHECK_EQUAL (second.uploads, 2u);
+  BOOST_CHECK_EQUAL (second.queue_depth, 1u);
+
+  auto const third (scheduler.run_frame());
+  BOOST_CHECK_EQUAL (third.uploads, 1u);
+  BOOST_CHECK_EQUAL (third.uploaded_bytes, 40u);
+  BOOST_CHECK_EQUAL (third.queue_depth, 0u);
+  BOOST_CHECK_EQUAL (third.queued_bytes, 0u);
+  BOOST_CHECK_EQUAL (scheduler.last_frame().uploads, 1u);
+
+  std::vector<int> const expected {0, 1, 2, 3, 4};
+  BOOST_CHECK_EQUAL_COLLECTIONS (order.begin(), order.end(), expected.begin(), expected.end());
+
+  for (auto const& ticket : tickets)
+  {
+    BOOST_CHECK (!ticket.pending());
+  }
+}
+
+BOOST_AUTO_TEST_CASE (oversized_jobs_still_run)
+{
+  noggit::upload_scheduler scheduler (10);
+  int runs (0);
+
+  auto const a (scheduler.enqueue (1000, [&] { ++runs; }));
+  auto const b (scheduler.enqueue (1000, [&] { ++runs; }));
+
+  BOOST_CHECK_EQUAL (scheduler.run_frame().uploaded_bytes, 1000u);
+  BOOST_CHECK_EQUAL (runs, 1);
+  BOOST_CHECK (b.pending());
+  BOOST_CHECK_EQUAL (scheduler.run_frame().uploads, 1u);
+  BOOST_CHECK_EQUAL (runs, 2);
+  BOOST_CHECK_EQUAL (scheduler.run_frame().uploads, 0u);
+}
+
+BOOST_AUTO_TEST_CASE (destroyed_tickets_cancel_their_job)
+{
+  noggit::upload_scheduler scheduler (100);
+  int runs (0);
+
+  {
+    auto const cancelled (scheduler.enqueue (100, [&] { ++runs; }));
+  }
+  auto const kept (scheduler.enqueue (100, [&] { ++runs; }));
+
+  // the cancelled job does not use up the budget
+  auto const stats (scheduler.run_frame());
+  BOOST_CHECK_EQUAL (stats.uploads, 1u);
+  BOOST_CHECK_EQUAL (stats.uploaded_bytes, 100u);
+  BOOST_CHECK_EQUAL (stats.queue_depth, 0u);
+  BOOST_CHECK_EQUAL (runs, 1);
+  BOOST_CHECK (!kept.pending());
+
+  noggit::upload_scheduler::ticket reassigned (scheduler.enqueue (1, [&] { ++runs; }));
+  reassigned = scheduler.enqueue (1, [&] { runs += 10; });
+  scheduler.run_frame();
+  BOOST_CHECK_EQUAL (runs, 11);
+}
+
+BOOST_AUTO_TEST_CASE (jobs_are_enqueued_from_several_threads)
+{
+  noggit::upload_scheduler scheduler (1 << 20);
+  int runs (0);
+
+  std::vector<std::vector<noggit::upload_scheduler::ticket>> tickets (4);
+  std::vector<std::thread> threads;
+  for (auto& thread_tickets : tickets)
+  {
+    threads.emplace_back ( [&]
+                           {
+                             for (int i = 0; i < 250; ++i)
+                             {
+                               thread_tickets.emplace_back (scheduler.enqueue (1, [&] { ++runs; }));
+                             }
+                           }
+                         );
+  }
+  for (auto& thread : threads)
+  {
+    thread.join();
+  }
+
+  auto const stats (scheduler.run_frame());
+  BOOST_CHECK_EQUAL (stats.uploads, 1000u);
+  BOOST_CHECK_EQUAL (stats.uploaded_bytes, 1000u);
+  BOOST_CHECK_EQUAL (runs, 1000);
+}
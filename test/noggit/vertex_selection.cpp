@@ -0,0 +1,324 @@
+#include <boost/test/unit_test.hpp>
+
+#include <noggit/vertex_selection.hpp>
+
+#include <math/vector_3d.hpp>
+
+#include <boost/optional.hpp>
+
+#include <array>
+#include <cmath>
+#include <random>
+#include <set>
+#include <vector>
+
+namespace
+{
+  float const chunk_size (533.33333f / 16.f);
+  float const unit_size (chunk_size / 8.f);
+
+  struct chunk
+  {
+    chunk (float xbase_, float zbase_, std::mt19937& random)
+      : xbase (xbase_), zbase (zbase_)
+    {
+      std::uniform_real_distribution<float> height (-50.f, 50.f);
+
+      math::vector_3d* v (vertices.data());
+      for (int j (0); j < 17; ++j)
+      {
+        for (int i (0); i < ((j % 2) ? 8 : 9); ++i)
+        {
+          float const x (i * unit_size + ((j % 2) ? unit_size * 0.5f : 0.f));
+          *v++ = {xbase + x, height (random), zbase + j * 0.5f * unit_size};
+        }
+      }
+    }
+
+    //! MapChunk::GetVertex
+    boost::optional<float> height (float x, float z) const
+    {
+      int const row (static_cast<int> ((z - zbase) / (unit_size * 0.5f) + 0.5f));
+      int const column
+        (static_cast<int> ((x - xbase - unit_size * 0.5f * (row % 2)) / unit_size + 0.5f));
+      if (row < 0 || column < 0 || row > 16 || column > ((row % 2) ? 8 : 9))
+      {
+        return boost::none;
+      }
+      return vertices[17 * (row / 2) + ((row % 2) ? 9 : 0) + column].y;
+    }
+
+    float xbase, zbase;
+    std::array<math::vector_3d, 145> vertices;
+  };
+
+  //! 3x3 chunks, the selection is in the middle one
+  struct grid
+  {
+    grid (std::mt19937& random)
+    {
+      for (int z (0); z < 3; ++z)
+      {
+        for (int x (0); x < 3; ++x)
+        {
+          chunks.emplace_back (x * chunk_size, z * chunk_size, random);
+        }
+      }
+
+      // shared edge vertices have the same height
+      for (int z (0); z < 3; ++z)
+      {
+        for (int x (0); x < 3; ++x)
+        {
+          for (int k (0); k <= 8; ++k)
+          {
+            if (x > 0)
+            {
+              at (x, z).vertices[k * 17].y = at (x - 1, z).vertices[k * 17 + 8].y;
+            }
+            if (z > 0)
+            {
+              at (x, z).vertices[k].y = at (x, z - 1).vertices[8 * 17 + k].y;
+            }
+          }
+        }
+      }
+    }
+
+    chunk& at (int x, int z)
+    {
+      return chunks[z * 3 + x];
+    }
+
+    //! MapTile::GetVertex
+    boost::optional<float> height (float x, float z) const
+    {
+      int const column (static_cast<int> (x / chunk_size));
+      int const row (static_cast<int> (z / chunk_size));
+      if (x < 0.f || z < 0.f || column > 2 || row > 2)
+      {
+        return boost::none;
+      }
+      return chunks[row * 3 + column].height (x, z);
+    }
+
+    //! MapChunk::compute_normals
+    std::vector<math::vector_3d> normals() const
+    {
+      std::vector<math::vector_3d> result;
+      for (auto const& c : chunks)
+      {
+        for (math::vector_3d const& v : c.vertices)
+        {
+          auto const point
+            ( [&] (float xdiff, float zdiff)
+              {
+                return math::vector_3d
+                  (v.x + xdiff, height (v.x + xdiff, v.z + zdiff).get_value_or (v.y), v.z + zdiff);
+              }
+            );
+
+          float const half_unit (unit_size / 2.f);
+          math::vector_3d const P1 (point (-half_unit, -half_unit));
+          math::vector_3d const P2 (point ( half_unit, -half_unit));
+          math::vector_3d const P3 (point ( half_unit,  half_unit));
+          math::vector_3d const P4 (point (-half_unit,  half_unit));
+
+          result.emplace_back ( ((P2 - v) % (P1 - v)) + ((P3 - v) % (P2 - v))
+                              + ((P4 - v) % (P3 - v)) + ((P1 - v) % (P4 - v))
+                              );
+        }
+      }
+      return result;
+    }
+
+    std::vector<chunk> chunks;
+  };
+
+  //! MapChunk::fixVertices before the selection became a mask
+  void old_fix_vertices (math::vector_3d* vertices, std::set<math::vector_3d*>& selected)
+  {
+    std::vector<int> ids ={ 0, 1, 17, 18 };
+    for (int i = 0; i < 64; ++i)
+    {
+      int not_selected = 0, count = 0, mid_vertex = ids[0] + 9;
+      float h = 0.0f;
+
+      for (int& index : ids)
+      {
+        if (selected.find(&vertices[index]) == selected.end())
+        {
+          not_selected = index;
+        }
+        else
+        {
+          count++;
+        }
+        h += vertices[index].y;
+        index += (((i+1) % 8) == 0) ? 10 : 1;
+      }
+
+      if (count == 2)
+      {
+        vertices[mid_vertex].y = h * 0.25f;
+      }
+      else if (count == 3)
+      {
+        vertices[mid_vertex].y = (h - vertices[not_selected].y) / 3.0f;
+      }
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE (fixing_cell_centers_matches_the_pointer_set_version)
+{
+  std::mt19937 random (1);
+
+  for (int round (0); round < 200; ++round)
+  {
+    grid g (random);
+    std::array<math::vector_3d, 145> expected (g.at (0, 0).vertices);
+    std::array<math::vector_3d, 145> actual (expected);
+
+    noggit::vertex_mask selected;
+    std::set<math::vector_3d*> selected_pointers;
+    for (std::size_t i (0); i < 145; ++i)
+    {
+      if (random() % 3 == 0)
+      {
+        selected.set (i);
+        selected_pointers.emplace (&expected[i]);
+      }
+    }
+
+    old_fix_vertices (expected.data(), selected_pointers);
+    auto const fixed (noggit::fix_cell_centers (actual.data(), selected));
+
+    for (std::size_t i (0); i < 145; ++i)
+    {
+      BOOST_REQUIRE_EQUAL (actual[i].y, expected[i].y);
+      if (!fixed[i])
+      {
+        BOOST_REQUIRE_EQUAL (actual[i].y, g.at (0, 0).vertices[i].y);
+      }
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE (normal_dependents_cover_every_changed_normal)
+{
+  std::mt19937 random (2);
+
+  for (int round (0); round < 300; ++round)
+  {
+    grid g (random);
+    auto const before (g.normals());
+
+    // moves one vertex of the middle chunk, and its copies in the neighbours
+    std::size_t const index (random() % 145);
+    float const y (g.at (1, 1).vertices[index].y + 10.f);
+    noggit::vertex_mask changed;
+    changed.set (index);
+
+    std::array<noggit::vertex_mask, 9> moved;
+    for (int z (0); z < 3; ++z)
+    {
+      for (int x (0); x < 3; ++x)
+      {
+        for (std::size_t i (0); i < 145; ++i)
+        {
+          math::vector_3d& v (g.at (x, z).vertices[i]);
+          if ( v.x == g.at (1, 1).vertices[index].x && v.z == g.at (1, 1).vertices[index].z
+            && (x != 1 || z != 1 || i == index)
+             )
+          {
+            v.y = y;
+            moved[z * 3 + x].set (i);
+          }
+        }
+      }
+    }
+
+    auto const after (g.normals());
+
+    std::array<noggit::vertex_mask, 9> predicted;
+    for (int z (0); z < 3; ++z)
+    {
+      for (int x (0); x < 3; ++x)
+      {
+        predicted[z * 3 + x] |= noggit::normal_dependents (moved[z * 3 + x]);
+        for (int dz (-1); dz <= 1; ++dz)
+        {
+          for (int dx (-1); dx <= 1; ++dx)
+          {
+            if ((dx || dz) && x + dx >= 0 && x + dx < 3 && z + dz >= 0 && z + dz < 3)
+            {
+              predicted[(z + dz) * 3 + x + dx]
+                |= noggit::neighbour_normal_dependents (moved[z * 3 + x], dx, dz);
+            }
+          }
+        }
+      }
+    }
+
+    for (std::size_t c (0); c < 9; ++c)
+    {
+      for (std::size_t i (0); i < 145; ++i)
+      {
+        if (!(before[c * 145 + i] == after[c * 145 + i]))
+        {
+          BOOST_REQUIRE_MESSAGE ( predicted[c][i]
+                                , "normal " << i << " of chunk " << c
+                                  << " changed when moving vertex " << index
+                                );
+        }
+      }
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE (vertex_ranges_span_the_set_vertices)
+{
+  BOOST_CHECK (noggit::vertex_range ({}) == std::make_pair (std::size_t (0), std::size_t (0)));
+
+  noggit::vertex_mask mask;
+  mask.set (17).set (40);
+  BOOST_CHECK (noggit::vertex_range (mask) == std::make_pair (std::size_t (17), std::size_t (41)));
+
+  mask.set (144);
+  BOOST_CHECK (noggit::vertex_range (mask) == std::make_pair (std::size_t (17), std::size_t (145)));
+}
+
+BOOST_AUTO_TEST_CASE (masks_are_kept_per_chunk)
+{
+  std::array<int, 3> chunks;
+  noggit::chunk_vertex_masks<int> masks;
+
+  BOOST_CHECK (!masks.add (&chunks[1], {}));
+  BOOST_CHECK (masks.empty());
+
+  BOOST_CHECK (masks.add (&chunks[2], noggit::vertex_mask().set (3)));
+  BOOST_CHECK (masks.add (&chunks[0], noggit::vertex_mask().set (4).set (5)));
+  BOOST_CHECK (!masks.add (&chunks[0], noggit::vertex_mask().set (4)));
+  BOOST_CHECK (masks.add (&chunks[0], noggit::vertex_mask().set (6)));
+
+  BOOST_REQUIRE_EQUAL (masks.entries().size(), 2);
+  BOOST_CHECK (masks.entries()[0].chunk == &chunks[0]);
+  BOOST_CHECK_EQUAL (masks.vertex_count(), 4);
+  BOOST_CHECK (masks.vertices (&chunks[0]) == noggit::vertex_mask().set (4).set (5).set (6));
+  BOOST_CHECK (masks.vertices (&chunks[1]).none());
+
+  BOOST_CHECK (!masks.remove (&chunks[1], noggit::vertex_mask().set()));
+  BOOST_CHECK (!masks.remove (&chunks[2], noggit::vertex_mask().set (4)));
+  BOOST_CHECK (masks.remove (&chunks[2], noggit::vertex_mask().set (3)));
+  BOOST_CHECK_EQUAL (masks.entries().size(), 1);
+
+  masks.add (&chunks[1], noggit::vertex_mask().set (7));
+  masks.add (&chunks[2], noggit::vertex_mask().set (8));
+  masks.remove_chunks ([&] (int* chunk) { return chunk != &chunks[1]; });
+  BOOST_REQUIRE_EQUAL (masks.entries().size(), 1);
+  BOOST_CHECK (masks.entries()[0].chunk == &chunks[1]);
+
+  masks.clear();
+  BOOST_CHECK (masks.empty());
+}
@@ -0,0 +1,90 @@
+#include <boost/test/unit_test.hpp>
+
+#include <opengl/debug_geometry.hpp>
+
+#include <math/matrix_4x4.hpp>
+#include <math/vector_3d.hpp>
+#include <math/vector_4d.hpp>
+
+#include <map>
+#include <tuple>
+
+namespace
+{
+  using corner = std::tuple<float, float, float>;
+
+  corner to_corner (math::vector_3d const& v)
+  {
+    return corner (v.x, v.y, v.z);
+  }
+}
+
+BOOST_AUTO_TEST_CASE (a_box_is_its_twelve_edges)
+{
+  opengl::debug_geometry geometry;
+  geometry.add_box ({0.f, 0.f, 0.f}, {1.f, 2.f, 3.f}, {1.f, 0.f, 0.f, 1.f});
+
+  auto const& vertices (geometry.vertices());
+  BOOST_REQUIRE_EQUAL (vertices.size(), opengl::debug_geometry::vertices_per_box);
+
+  std::map<corner, int> edges_per_corner;
+  for (std::size_t i = 0; i < vertices.size(); i += 2)
+  {
+    math::vector_3d const d (vertices[i + 1].position - vertices[i].position);
+    // every edge is parallel to an axis
+    BOOST_CHECK_EQUAL ((d.x != 0.f) + (d.y != 0.f) + (d.z != 0.f), 1);
+
+    ++edges_per_corner[to_corner (vertices[i].position)];
+    ++edges_per_corner[to_corner (vertices[i + 1].position)];
+  }
+
+  BOOST_REQUIRE_EQUAL (edges_per_corner.size(), 8);
+  for (auto const& corner : edges_per_corner)
+  {
+    BOOST_CHECK_EQUAL (corner.second, 3);
+  }
+
+  for (auto const& vertex : vertices)
+  {
+    BOOST_CHECK_EQUAL (vertex.color.x, 1.f);
+    BOOST_CHECK_EQUAL (vertex.color.y, 0.f);
+  }
+}
+
+BOOST_AUTO_TEST_CASE (boxes_are_transformed_on_the_cpu)
+{
+  opengl::debug_geometry geometry;
+  geometry.add_box ( {-1.f, -1.f, -1.f}
+                   , {1.f, 1.f, 1.f}
+                   , {1.f, 1.f, 1.f, 1.f}
+                   , math::matrix_4x4 (math::matrix_4x4::translation, {10.f, 20.f, 30.f})
+                   );
+
+  for (auto const& vertex : geometry.vertices())
+  {
+    BOOST_CHECK (vertex.position.x == 9.f || vertex.position.x == 11.f);
+    BOOST_CHECK (vertex.position.y == 19.f || vertex.position.y == 21.f);
+    BOOST_CHECK (vertex.position.z == 29.f || vertex.position.z == 31.f);
+  }
+}
+
+BOOST_AUTO_TEST_CASE (a_frame_of_boxes_is_one_batch)
+{
+  opengl::debug_geometry geometry;
+
+  for (int frame = 0; frame < 2; ++frame)
+  {
+    for (int i = 0; i < 1000; ++i)
+    {
+      geometry.add_box ({0.f, 0.f, 0.f}, {1.f, 1.f, 1.f}, {1.f, 1.f, 1.f, 1.f});
+    }
+    geometry.add_line ({0.f, 0.f, 0.f}, {0.f, 5.f, 0.f}, {0.f, 1.f, 0.f, 1.f});
+
+    BOOST_CHECK_EQUAL (geometry.vertices().size(), 1000 * opengl::debug_geometry::vertices_per_box + 2);
+
+    auto const capacity (geometry.vertices().capacity());
+    geometry.clear();
+    BOOST_CHECK (geometry.empty());
+    BOOST_CHECK_EQUAL (geometry.vertices().capacity(), capacity);
+  }
+}
@@ -0,0 +1,75 @@
+#include <boost/test/unit_test.hpp>
+
+#include <opengl/shader_template.hpp>
+
+#include <regex>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace
+{
+  // the regex based injection the templates replace
+  std::string reference_expand (std::string src, std::vector<std::string> const& defines)
+  {
+    if (defines.empty())
+    {
+      return src;
+    }
+
+    std::stringstream ss;
+    ss << "\n";
+    for (auto const& def : defines)
+    {
+      ss << "#define " << def << "\n";
+    }
+
+    std::regex regex ("#version[ \t]+[0-9]+.*");
+    std::smatch match;
+    std::regex_search (src, match, regex);
+    src.insert (match.length() + match.position(), ss.str());
+
+    return src;
+  }
+}
+
+BOOST_AUTO_TEST_CASE (expansion_matches_the_regex_injection)
+{
+  std::vector<std::string> const sources
+    { "// This file is part of Noggit3\n#version 330 core\n\nin vec4 position;\n"
+    , "#version 330 core\r\nvoid main() {}\r\n"
+    , "#version\t330\nvoid main() {}"
+    , "#version 330 core"
+    , "// #version later\n#version 410\n#ifdef instanced\n#endif\n"
+    };
+  std::vector<std::vector<std::string>> const define_sets
+    { {}, {"instanced"}, {"a", "b 2"} };
+
+  for (auto const& source : sources)
+  {
+    opengl::shader_template const tmpl ("test", source);
+    for (auto const& defines : define_sets)
+    {
+      BOOST_CHECK_EQUAL (tmpl.expand (defines), reference_expand (source, defines));
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE (sources_without_version_are_rejected)
+{
+  BOOST_CHECK_THROW (opengl::shader_template ("test", "void main() {}"), std::logic_error);
+  BOOST_CHECK_THROW (opengl::shader_template ("test", "#version core\n"), std::logic_error);
+}
+
+BOOST_AUTO_TEST_CASE (hashes_are_stable_and_chainable)
+{
+  // FNV-1a test vectors
+  BOOST_CHECK_EQUAL (opengl::hash_bytes ("", 0), 0xcbf29ce484222325ull);
+  BOOST_CHECK_EQUAL (opengl::hash_bytes ("a", 1), 0xaf63dc4c8601ec8cull);
+  BOOST_CHECK_EQUAL (opengl::hash_bytes ("foobar", 6), 0x85944171f73967e8ull);
+
+  BOOST_CHECK_EQUAL ( opengl::hash_bytes ("bar", 3, opengl::hash_bytes ("foo", 3))
+                    , opengl::hash_bytes ("foobar", 6)
+                    );
+}